@@ -0,0 +1,103 @@
+#include "boot_timeline.h"
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+// ----------------------------------
+// Internal state
+// ----------------------------------
+typedef struct {
+    const char *name;
+    int64_t     t_begin_us;
+    int64_t     t_end_us;   // 0 while running
+    int         core;
+} boot_phase_t;
+
+static boot_phase_t  s_phases[BOOT_TIMELINE_MAX_PHASES];
+static int           s_phase_cnt = 0;
+static int64_t       s_first_pixel_us = 0;
+static int64_t       s_first_frame_us = 0;
+static int64_t       s_interactive_us = 0;
+static portMUX_TYPE  s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+extern "C" int boot_phase_begin(const char *name)
+{
+    const int64_t now = esp_timer_get_time();
+    int idx = -1;
+
+    portENTER_CRITICAL(&s_lock);
+    if(s_phase_cnt < BOOT_TIMELINE_MAX_PHASES) {
+        idx = s_phase_cnt++;
+        s_phases[idx].name       = name;
+        s_phases[idx].t_begin_us = now;
+        s_phases[idx].t_end_us   = 0;
+        s_phases[idx].core       = xPortGetCoreID();
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    return idx;
+}
+
+extern "C" void boot_phase_end(int phase)
+{
+    if(phase < 0 || phase >= BOOT_TIMELINE_MAX_PHASES) return;
+    const int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    s_phases[phase].t_end_us = now;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void boot_mark_first_pixel(void)
+{
+    if(s_first_pixel_us) return;
+    s_first_pixel_us = esp_timer_get_time();
+}
+
+extern "C" void boot_mark_first_frame(void)
+{
+    if(s_first_frame_us) return;
+    s_first_frame_us = esp_timer_get_time();
+}
+
+extern "C" void boot_mark_interactive(void)
+{
+    if(s_interactive_us) return;
+    s_interactive_us = esp_timer_get_time();
+}
+
+extern "C" bool boot_first_frame_done(void)
+{
+    return s_first_frame_us != 0;
+}
+
+extern "C" void boot_timeline_print(void)
+{
+    Serial.println("---- boot timeline (ms since reset) ----");
+    for(int i = 0; i < s_phase_cnt; i++) {
+        const boot_phase_t *p = &s_phases[i];
+        if(p->t_end_us) {
+            Serial.printf("  %-14s core %d  %7.1f -> %7.1f  (%6.1f ms)\r\n",
+                          p->name, p->core,
+                          p->t_begin_us / 1000.0f, p->t_end_us / 1000.0f,
+                          (p->t_end_us - p->t_begin_us) / 1000.0f);
+        } else {
+            Serial.printf("  %-14s core %d  %7.1f -> (running)\r\n",
+                          p->name, p->core, p->t_begin_us / 1000.0f);
+        }
+    }
+    if(s_first_pixel_us) {
+        Serial.printf("  time-to-first-pixel: %.1f ms\r\n", s_first_pixel_us / 1000.0f);
+    }
+    if(s_first_frame_us) {
+        Serial.printf("  time-to-first-frame: %.1f ms\r\n", s_first_frame_us / 1000.0f);
+    }
+    if(s_interactive_us) {
+        Serial.printf("  time-to-interactive: %.1f ms\r\n", s_interactive_us / 1000.0f);
+    }
+}
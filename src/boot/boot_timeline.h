@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- Boot phase timeline ----------
+// Records begin/end timestamps (esp_timer, us since reset) of named boot phases.
+// Safe to call from any task / core. Names must be string literals.
+
+#define BOOT_TIMELINE_MAX_PHASES 16
+
+// Returns a phase handle (or -1 if the table is full).
+int  boot_phase_begin(const char *name);
+void boot_phase_end(int phase);
+
+// Milestones; only the first call of each is recorded.
+void boot_mark_first_pixel(void);   // backlight on with something on the panel
+void boot_mark_first_frame(void);   // first LVGL flush (call from flush cb)
+void boot_mark_interactive(void);   // LVGL running and touch input registered
+bool boot_first_frame_done(void);
+
+// Prints all phases (start, duration, core) plus the milestones.
+void boot_timeline_print(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
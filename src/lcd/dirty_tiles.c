@@ -0,0 +1,125 @@
+#include <string.h>
+#include "dirty_tiles.h"
+
+/*
+ * LVGL already knows what changed: every redraw starts as an invalidated
+ * area (LV_EVENT_INVALIDATE_AREA), and in full render mode each buffer holds
+ * the whole frame, so copying just those areas out of it leaves the panel
+ * equal to the frame. Tiles coalesce the many small areas of a busy frame
+ * (a label, its card, a bar) into a few rectangular copies; what a tile
+ * costs beyond its areas is copied for nothing, so they stay small.
+ */
+
+size_t dirty_tiles_storage_bytes(uint32_t width, uint32_t height)
+{
+    const size_t tiles = (size_t)((width + DIRTY_TILES_W - 1) / DIRTY_TILES_W) *
+                         ((height + DIRTY_TILES_H - 1) / DIRTY_TILES_H);
+    return 2 * tiles;
+}
+
+void dirty_tiles_init(dirty_tiles_t *dt, uint32_t width, uint32_t height, void *storage)
+{
+    memset(dt, 0, sizeof(*dt));
+    dt->width = width;
+    dt->height = height;
+    dt->tiles_x = (width + DIRTY_TILES_W - 1) / DIRTY_TILES_W;
+    dt->tiles_y = (height + DIRTY_TILES_H - 1) / DIRTY_TILES_H;
+    dt->dirty = (uint8_t *)storage;
+    dt->changed = dt->dirty + dt->tiles_x * dt->tiles_y;
+    memset(dt->changed, 0, dt->tiles_x * dt->tiles_y);
+    dirty_tiles_mark_all(dt);
+}
+
+void dirty_tiles_mark(dirty_tiles_t *dt, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= (int32_t)dt->width) x2 = (int32_t)dt->width - 1;
+    if (y2 >= (int32_t)dt->height) y2 = (int32_t)dt->height - 1;
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    const uint32_t tx0 = (uint32_t)x1 / DIRTY_TILES_W, tx1 = (uint32_t)x2 / DIRTY_TILES_W;
+    const uint32_t ty0 = (uint32_t)y1 / DIRTY_TILES_H, ty1 = (uint32_t)y2 / DIRTY_TILES_H;
+    for (uint32_t ty = ty0; ty <= ty1; ty++) {
+        memset(dt->dirty + ty * dt->tiles_x + tx0, 1, tx1 - tx0 + 1);
+    }
+}
+
+void dirty_tiles_mark_all(dirty_tiles_t *dt)
+{
+    memset(dt->dirty, 1, dt->tiles_x * dt->tiles_y);
+}
+
+uint32_t dirty_tiles_take(dirty_tiles_t *dt)
+{
+    const uint32_t tiles = dt->tiles_x * dt->tiles_y;
+    uint32_t changed = 0;
+
+    memcpy(dt->changed, dt->dirty, tiles);
+    memset(dt->dirty, 0, tiles);
+
+    for (uint32_t ty = 0; ty < dt->tiles_y; ty++) {
+        const uint32_t y0 = ty * DIRTY_TILES_H;
+        const uint32_t rows = (y0 + DIRTY_TILES_H <= dt->height) ? DIRTY_TILES_H : dt->height - y0;
+        const uint8_t *c = dt->changed + ty * dt->tiles_x;
+        for (uint32_t tx = 0; tx < dt->tiles_x; tx++) {
+            if (c[tx]) {
+                changed++;
+            } else {
+                const uint32_t x0 = tx * DIRTY_TILES_W;
+                const uint32_t px = (x0 + DIRTY_TILES_W <= dt->width) ? DIRTY_TILES_W : dt->width - x0;
+                dt->stats.bytes_skipped += (uint64_t)px * rows * sizeof(uint16_t);
+            }
+        }
+    }
+
+    dt->stats.frames++;
+    dt->stats.frames_unchanged += (changed == 0);
+    dt->stats.tiles += tiles;
+    dt->stats.tiles_skipped += tiles - changed;
+    dt->stats.bytes += (uint64_t)dt->width * dt->height * sizeof(uint16_t);
+    return changed;
+}
+
+bool dirty_tiles_next_span(const dirty_tiles_t *dt, uint32_t *cursor, dirty_tiles_span_t *span)
+{
+    const uint32_t tiles = dt->tiles_x * dt->tiles_y;
+    uint32_t i = *cursor;
+
+    while (i < tiles && !dt->changed[i]) {
+        i++;
+    }
+    if (i >= tiles) {
+        *cursor = tiles;
+        return false;
+    }
+
+    /* Extend to the end of the run, never past the end of the tile row */
+    const uint32_t ty = i / dt->tiles_x;
+    const uint32_t tx0 = i % dt->tiles_x;
+    uint32_t tx1 = tx0 + 1;
+    while (tx1 < dt->tiles_x && dt->changed[ty * dt->tiles_x + tx1]) {
+        tx1++;
+    }
+    /* A whole dirty tile row takes the fully dirty rows below along */
+    uint32_t ty1 = ty + 1;
+    if (tx0 == 0 && tx1 == dt->tiles_x) {
+        while (ty1 < dt->tiles_y && memchr(dt->changed + ty1 * dt->tiles_x, 0, dt->tiles_x) == NULL) {
+            ty1++;
+        }
+    }
+    *cursor = (ty1 - 1) * dt->tiles_x + tx1;
+
+    span->x = tx0 * DIRTY_TILES_W;
+    span->y = ty * DIRTY_TILES_H;
+    span->w = ((tx1 * DIRTY_TILES_W < dt->width) ? tx1 * DIRTY_TILES_W : dt->width) - span->x;
+    span->h = ((ty1 * DIRTY_TILES_H < dt->height) ? ty1 * DIRTY_TILES_H : dt->height) - span->y;
+    return true;
+}
+
+void dirty_tiles_reset_stats(dirty_tiles_t *dt)
+{
+    memset(&dt->stats, 0, sizeof(dt->stats));
+}
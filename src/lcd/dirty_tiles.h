@@ -0,0 +1,83 @@
+#ifndef _DIRTY_TILES_H
+#define _DIRTY_TILES_H
+
+/*
+ * The areas LVGL invalidates between two flushes, rounded out to a grid of
+ * tiles, so a full-frame flush can copy only what was redrawn. Marking an
+ * area only sets its tile flags; the frame itself is never read. No ESP-IDF
+ * dependencies, so the same code runs on the flush path and in the host
+ * benchmark (tools/dirty_tiles_bench).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Tile size in pixels */
+#ifndef DIRTY_TILES_W
+#define DIRTY_TILES_W  (64)
+#endif
+#ifndef DIRTY_TILES_H
+#define DIRTY_TILES_H  (16)
+#endif
+
+typedef struct {
+    uint32_t frames;            /* frames taken */
+    uint32_t frames_unchanged;  /* frames with no dirty tile at all */
+    uint64_t tiles;             /* tiles in those frames */
+    uint64_t tiles_skipped;     /* tiles nobody invalidated */
+    uint64_t bytes;             /* frame bytes */
+    uint64_t bytes_skipped;     /* bytes in skipped tiles, i.e. not copied */
+} dirty_tiles_stats_t;
+
+typedef struct {
+    uint32_t width, height;     /* frame size in pixels */
+    uint32_t tiles_x, tiles_y;
+    uint8_t *dirty;             /* one flag per tile, marked since the last take */
+    uint8_t *changed;           /* the flags of the last take */
+    dirty_tiles_stats_t stats;
+} dirty_tiles_t;
+
+/* A rectangle of dirty tiles, clipped to the frame */
+typedef struct {
+    uint32_t x, y, w, h;
+} dirty_tiles_span_t;
+
+/* Bytes of storage dirty_tiles_init() needs for a width x height frame */
+size_t dirty_tiles_storage_bytes(uint32_t width, uint32_t height);
+
+/* Every tile starts dirty, so the first frame is copied whole */
+void dirty_tiles_init(dirty_tiles_t *dt, uint32_t width, uint32_t height, void *storage);
+
+/* Mark the tiles an area touches; corners inclusive, as in lv_area_t */
+void dirty_tiles_mark(dirty_tiles_t *dt, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+/* Something else wrote the panel: the next frame is copied whole */
+void dirty_tiles_mark_all(dirty_tiles_t *dt);
+
+/*
+ * Move the marks into the flags the spans are walked from and start marking
+ * the next frame. Returns the number of dirty tiles; the caller must copy
+ * all of them, or mark everything again.
+ */
+uint32_t dirty_tiles_take(dirty_tiles_t *dt);
+
+/*
+ * Walk the dirty tiles of the last take as horizontal runs; runs that fill
+ * whole tile rows are merged with the fully dirty rows below, so a frame
+ * dirty everywhere is a single span. Start with *cursor = 0; returns false
+ * when there are no more.
+ */
+bool dirty_tiles_next_span(const dirty_tiles_t *dt, uint32_t *cursor, dirty_tiles_span_t *span);
+
+void dirty_tiles_reset_stats(dirty_tiles_t *dt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
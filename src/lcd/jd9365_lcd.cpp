@@ -7,13 +7,21 @@
 #include "esp_lcd_mipi_dsi.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_ldo_regulator.h"
+#include "esp_cache.h"
+#include "esp_attr.h"
 #include "driver/gpio.h"
+#include "soc/soc_caps.h"
+#if SOC_PPA_SUPPORTED
+#include "driver/ppa.h"
+#endif
 #include "esp_err.h"
 #include "esp_log.h"
 #include "Arduino.h"
 
 #include "esp_lcd_jd9365.h"
 #include "jd9365_lcd.h"
+#include "rgb565_rotate.h"
+#include "rgb565_prims.h"
 
 #define LCD_H_RES 800
 #define LCD_V_RES 1280
@@ -106,31 +114,389 @@ void jd9365_lcd::begin()
     ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
     ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle,true,true));
 
+    // 先写入启动画面，避免点亮背光后黑屏等待 LVGL 首帧
+    draw_splash(0x0884, 0x2B9F);
+
     // 打开背光
     example_bsp_set_lcd_backlight(EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
 }
 
+#define FB_BYTES ((size_t)LCD_H_RES * LCD_V_RES * (LCD_BIT_PER_PIXEL / 8))
+
+// DPI framebuffer, looked up once
+static uint16_t *panel_fb()
+{
+    static uint16_t *fb = NULL;
+    if (!fb && (esp_lcd_dpi_panel_get_frame_buffer(panel_handle, 1, (void **)&fb) != ESP_OK || !fb)) {
+        ESP_LOGW(TAG, "no DPI frame buffer");
+        fb = NULL;
+    }
+    return fb;
+}
+
+// After CPU writes: push whole panel rows out of the cache, DPI DMA reads memory
+static void fb_writeback_rows(uint16_t *fb, uint32_t y, uint32_t rows)
+{
+    esp_cache_msync(fb + y * LCD_H_RES, (size_t)rows * LCD_H_RES * (LCD_BIT_PER_PIXEL / 8),
+                    ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+}
+
+static bool rect_on_panel(uint32_t x, uint32_t y, uint32_t w, uint32_t h)
+{
+    return w && h && x + w <= LCD_H_RES && y + h <= LCD_V_RES;
+}
+
+/*
+ * PPA (the P4's 2D-DMA pixel engine). Operations are queued on one client per
+ * engine and complete in the background; s_ppa_pending counts the queued ones
+ * and the done callback wakes waitDone() when it drops to zero. The SRM and
+ * fill engines run concurrently, so switching engine first drains the queue to
+ * keep operations in issue order. Any PPA error disables it for good and the
+ * callers fall back to the software kernels.
+ */
+#if SOC_PPA_SUPPORTED
+#define PPA_QUEUE_DEPTH 4
+
+static ppa_client_handle_t s_ppa_srm = NULL;
+static ppa_client_handle_t s_ppa_fill = NULL;
+static ppa_client_handle_t s_ppa_last = NULL;
+static bool s_ppa_failed = false;
+static volatile uint32_t s_ppa_pending = 0;
+static SemaphoreHandle_t s_ppa_done = NULL;
+static int s_ppa_async_tag;     // user_data of queued ops; blocking ones pass NULL
+
+static bool IRAM_ATTR ppa_trans_done(ppa_client_handle_t client, ppa_event_data_t *event_data, void *user_data)
+{
+    (void)client;
+    (void)event_data;
+    BaseType_t woken = pdFALSE;
+    if (user_data == &s_ppa_async_tag && __atomic_sub_fetch(&s_ppa_pending, 1, __ATOMIC_ACQ_REL) == 0) {
+        xSemaphoreGiveFromISR(s_ppa_done, &woken);
+    }
+    return woken == pdTRUE;
+}
+
+static void ppa_disable(const char *why)
+{
+    ESP_LOGW(TAG, "PPA %s, using software 2D paths", why);
+    s_ppa_failed = true;
+}
+
+static ppa_client_handle_t ppa_client(ppa_operation_t oper, ppa_client_handle_t *slot)
+{
+    if (*slot || s_ppa_failed) {
+        return *slot;
+    }
+    if (!s_ppa_done && !(s_ppa_done = xSemaphoreCreateBinary())) {
+        ppa_disable("out of memory");
+        return NULL;
+    }
+    ppa_client_config_t cfg = {};
+    cfg.oper_type = oper;
+    cfg.max_pending_trans_num = PPA_QUEUE_DEPTH;
+    ppa_event_callbacks_t cbs = {};
+    cbs.on_trans_done = ppa_trans_done;
+    if (ppa_register_client(&cfg, slot) != ESP_OK) {
+        *slot = NULL;
+        ppa_disable("unavailable");
+        return NULL;
+    }
+    if (ppa_client_register_event_callbacks(*slot, &cbs) != ESP_OK) {
+        ppa_disable("callback registration failed");
+        return NULL;
+    }
+    return *slot;
+}
+
+static void ppa_wait()
+{
+    while (__atomic_load_n(&s_ppa_pending, __ATOMIC_ACQUIRE) != 0) {
+        xSemaphoreTake(s_ppa_done, pdMS_TO_TICKS(10));
+    }
+}
+
+// One op on `client`; a full queue is drained and the op retried once
+template <typename op_t>
+static bool ppa_submit(ppa_client_handle_t client, esp_err_t (*run)(ppa_client_handle_t, const op_t *),
+                       op_t *op, bool async)
+{
+    if (!client) {
+        return false;
+    }
+    if (s_ppa_last != client) {
+        ppa_wait();
+        s_ppa_last = client;
+    }
+    op->mode = async ? PPA_TRANS_MODE_NON_BLOCKING : PPA_TRANS_MODE_BLOCKING;
+    op->user_data = async ? &s_ppa_async_tag : NULL;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (async) {
+            __atomic_add_fetch(&s_ppa_pending, 1, __ATOMIC_ACQ_REL);
+        }
+        // The driver writes back the source and invalidates the destination itself
+        if (run(client, op) == ESP_OK) {
+            return true;
+        }
+        if (async) {
+            __atomic_sub_fetch(&s_ppa_pending, 1, __ATOMIC_ACQ_REL);
+        }
+        ppa_wait();
+    }
+    ppa_disable("transaction failed");
+    return false;
+}
+
+static ppa_srm_color_mode_t ppa_srm_mode(rgb565_src_fmt_t fmt)
+{
+    switch (fmt) {
+    case RGB565_SRC_RGB888:
+        return PPA_SRM_COLOR_MODE_RGB888;
+    case RGB565_SRC_XRGB8888:
+        return PPA_SRM_COLOR_MODE_ARGB8888;
+    default:
+        return PPA_SRM_COLOR_MODE_RGB565;
+    }
+}
+
+// Unscaled SRM into the framebuffer, rotated by `rotation` quarter turns
+// clockwise (0 for a plain blit, convert or copy)
+static bool ppa_srm_to_fb(const void *src, rgb565_src_fmt_t fmt, uint32_t src_stride, uint32_t src_rows,
+                          uint32_t sx, uint32_t sy, uint32_t w, uint32_t h, uint16_t *fb,
+                          uint32_t x, uint32_t y, uint8_t rotation, bool async)
+{
+    // PPA angles are counter-clockwise
+    static const ppa_srm_rotation_angle_t angle[4] = {
+        PPA_SRM_ROTATION_ANGLE_0, PPA_SRM_ROTATION_ANGLE_270,
+        PPA_SRM_ROTATION_ANGLE_180, PPA_SRM_ROTATION_ANGLE_90,
+    };
+    ppa_srm_oper_config_t op = {};
+    op.in.buffer = src;
+    op.in.pic_w = src_stride;
+    op.in.pic_h = src_rows;
+    op.in.block_w = w;
+    op.in.block_h = h;
+    op.in.block_offset_x = sx;
+    op.in.block_offset_y = sy;
+    op.in.srm_cm = ppa_srm_mode(fmt);
+    op.out.buffer = fb;
+    op.out.buffer_size = FB_BYTES;
+    op.out.pic_w = LCD_H_RES;
+    op.out.pic_h = LCD_V_RES;
+    op.out.block_offset_x = x;
+    op.out.block_offset_y = y;
+    op.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    op.rotation_angle = angle[rotation & 3];
+    op.scale_x = 1.0f;
+    op.scale_y = 1.0f;
+    return ppa_submit(ppa_client(PPA_OPERATION_SRM, &s_ppa_srm), ppa_do_scale_rotate_mirror, &op, async);
+}
+#endif
+
 void jd9365_lcd::lcd_draw_bitmap(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint8_t *color_data)
 {
+    waitDone();
     esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
 }
 
-void jd9365_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data)
+void jd9365_lcd::lcd_draw_bitmap_rotated(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                                         const uint16_t *color_data, uint8_t rotation, uint16_t src_stride)
 {
-    uint16_t x_start = x;
-    uint16_t y_start = y;
-    uint16_t x_end = w + x;
-    uint16_t y_end = h + y;
+    rotation &= 3;
+    if (rotation == 0 && src_stride == 0) {
+        lcd_draw_bitmap(x_start, y_start, x_end, y_end, (uint8_t *)color_data);
+        return;
+    }
 
-    esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    uint16_t *fb = panel_fb();
+    if (!fb) {
+        return;
+    }
+
+    // Top-left of the block in the panel and its rotated size, matching the
+    // touch rotation in gsl3680_touch
+    const uint32_t w = x_end - x_start;
+    const uint32_t h = y_end - y_start;
+    const uint32_t ss = src_stride ? src_stride : w;
+    uint32_t nx, ny, nh;
+    switch (rotation) {
+    case 0:
+        nx = x_start;
+        ny = y_start;
+        nh = h;
+        break;
+    case 1:
+        nx = LCD_H_RES - y_end;
+        ny = x_start;
+        nh = w;
+        break;
+    case 2:
+        nx = LCD_H_RES - x_end;
+        ny = LCD_V_RES - y_end;
+        nh = h;
+        break;
+    default:
+        nx = y_start;
+        ny = LCD_V_RES - x_end;
+        nh = w;
+        break;
+    }
+
+    // LVGL reuses the buffer as soon as the flush returns: blocking either way
+#if SOC_PPA_SUPPORTED
+    if (ppa_srm_to_fb(color_data, RGB565_SRC_RGB565, ss, h, 0, 0, w, h, fb, nx, ny, rotation, false)) {
+        return;
+    }
+#endif
+
+    waitDone();
+    rgb565_rotate(color_data, w, h, ss, fb + ny * LCD_H_RES + nx, LCD_H_RES, rotation);
+    fb_writeback_rows(fb, ny, nh);
+}
+
+bool jd9365_lcd::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    uint16_t *fb = panel_fb();
+    if (!fb || !rect_on_panel(x, y, w, h)) {
+        return false;
+    }
+
+#if SOC_PPA_SUPPORTED
+    // Expand to ARGB8888 so the engine's RGB565 output gives back `color` exactly
+    const uint32_t r = (color >> 11) & 0x1f, g = (color >> 5) & 0x3f, b = color & 0x1f;
+    ppa_fill_oper_config_t op = {};
+    op.out.buffer = fb;
+    op.out.buffer_size = FB_BYTES;
+    op.out.pic_w = LCD_H_RES;
+    op.out.pic_h = LCD_V_RES;
+    op.out.block_offset_x = x;
+    op.out.block_offset_y = y;
+    op.out.fill_cm = PPA_FILL_COLOR_MODE_RGB565;
+    op.fill_block_w = w;
+    op.fill_block_h = h;
+    op.fill_argb_color.val = 0xff000000u | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+    if (ppa_submit(ppa_client(PPA_OPERATION_FILL, &s_ppa_fill), ppa_do_fill, &op, true)) {
+        return true;
+    }
+#endif
+
+    waitDone();
+    rgb565_fill(fb + y * LCD_H_RES + x, LCD_H_RES, w, h, color);
+    fb_writeback_rows(fb, y, h);
+    return true;
+}
+
+bool jd9365_lcd::blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *src, uint16_t src_stride)
+{
+    return convert(x, y, w, h, src, RGB565_SRC_RGB565, src_stride);
+}
+
+bool jd9365_lcd::convert(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                         const void *src, rgb565_src_fmt_t fmt, uint16_t src_stride)
+{
+    uint16_t *fb = panel_fb();
+    if (!fb || !src || src_stride < w || !rect_on_panel(x, y, w, h)) {
+        return false;
+    }
+
+#if SOC_PPA_SUPPORTED
+    if (ppa_srm_to_fb(src, fmt, src_stride, h, 0, 0, w, h, fb, x, y, 0, true)) {
+        return true;
+    }
+#endif
+
+    waitDone();
+    rgb565_convert(src, fmt, src_stride, fb + y * LCD_H_RES + x, LCD_H_RES, w, h);
+    fb_writeback_rows(fb, y, h);
+    return true;
+}
+
+bool jd9365_lcd::copyRect(uint16_t src_x, uint16_t src_y, uint16_t dst_x, uint16_t dst_y, uint16_t w, uint16_t h)
+{
+    uint16_t *fb = panel_fb();
+    if (!fb || !rect_on_panel(src_x, src_y, w, h) || !rect_on_panel(dst_x, dst_y, w, h)) {
+        return false;
+    }
+
+#if SOC_PPA_SUPPORTED
+    // The engine streams rows in order, so only disjoint rectangles go to it
+    const bool overlap = src_x < dst_x + w && dst_x < src_x + w && src_y < dst_y + h && dst_y < src_y + h;
+    if (!overlap && ppa_srm_to_fb(fb, RGB565_SRC_RGB565, LCD_H_RES, LCD_V_RES, src_x, src_y, w, h,
+                                  fb, dst_x, dst_y, 0, true)) {
+        return true;
+    }
+#endif
+
+    waitDone();
+    rgb565_copy(fb + src_y * LCD_H_RES + src_x, LCD_H_RES, fb + dst_y * LCD_H_RES + dst_x, LCD_H_RES, w, h);
+    fb_writeback_rows(fb, dst_y, h);
+    return true;
+}
+
+bool jd9365_lcd::busy()
+{
+#if SOC_PPA_SUPPORTED
+    return __atomic_load_n(&s_ppa_pending, __ATOMIC_ACQUIRE) != 0;
+#else
+    return false;
+#endif
+}
+
+void jd9365_lcd::waitDone()
+{
+#if SOC_PPA_SUPPORTED
+    ppa_wait();
+#endif
+}
+
+void jd9365_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data)
+{
+    // Callers free the buffer right after: keep it synchronous
+    blit(x, y, w, h, color_data, w);
+    waitDone();
 }
 
 void jd9365_lcd::fillScreen(uint16_t color)
 {
-    uint16_t *color_data = (uint16_t *)heap_caps_malloc(480 * 272 * 2, MALLOC_CAP_INTERNAL);
-    memset(color_data, color, 480 * 272 * 2);
-    draw16bitbergbbitmap(0, 0, 480, 272, color_data);
-    free(color_data);
+    fillRect(0, 0, LCD_H_RES, LCD_V_RES, color);
+    waitDone();
+}
+
+// Writes a splash straight into the DPI framebuffer (no LVGL, no DMA2D):
+// solid background with a centered accent bar. Usable right after panel init.
+bool jd9365_lcd::draw_splash(uint16_t bg_color, uint16_t accent_color)
+{
+    void *fb = NULL;
+    if (esp_lcd_dpi_panel_get_frame_buffer(panel_handle, 1, &fb) != ESP_OK || fb == NULL) {
+        ESP_LOGW(TAG, "splash: no DPI frame buffer");
+        return false;
+    }
+
+    const uint32_t bg2 = ((uint32_t)bg_color << 16) | bg_color;
+    const uint32_t ac2 = ((uint32_t)accent_color << 16) | accent_color;
+
+    const int bar_w = LCD_H_RES / 2;
+    const int bar_h = 16;
+    const int bar_x = (LCD_H_RES - bar_w) / 2;
+    const int bar_y = (LCD_V_RES - bar_h) / 2;
+
+    // Two pixels per store; LCD_H_RES, bar_x and bar_w are even
+    uint32_t *row = (uint32_t *)fb;
+    for (int y = 0; y < LCD_V_RES; y++, row += LCD_H_RES / 2) {
+        const bool in_bar = (y >= bar_y) && (y < bar_y + bar_h);
+        for (int x = 0; x < LCD_H_RES / 2; x++) {
+            row[x] = bg2;
+        }
+        if (in_bar) {
+            for (int x = bar_x / 2; x < (bar_x + bar_w) / 2; x++) {
+                row[x] = ac2;
+            }
+        }
+    }
+
+    // Framebuffer lives in PSRAM; DPI DMA reads memory, not the cache
+    esp_cache_msync(fb, (size_t)LCD_H_RES * LCD_V_RES * (LCD_BIT_PER_PIXEL / 8),
+                    ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+    return true;
 }
 
 void jd9365_lcd::te_on()
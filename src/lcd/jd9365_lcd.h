@@ -1,6 +1,7 @@
 #ifndef _JD9165_LCD_H
 #define _JD9165_LCD_H
 #include <stdio.h>
+#include "rgb565_prims.h"
 
 class jd9365_lcd
 {
@@ -13,8 +14,28 @@ public:
     void example_bsp_set_lcd_backlight(uint32_t level);
     void lcd_draw_bitmap(uint16_t x_start, uint16_t y_start,
                          uint16_t x_end, uint16_t y_end, uint8_t *color_data);
+    // RGB565 block in UI coordinates (end exclusive), rotated clockwise by
+    // rotation quarter turns into the panel framebuffer. Uses the PPA when the
+    // chip has one, otherwise the tiled software kernel in rgb565_rotate.c.
+    // src_stride is the source row pitch in pixels, 0 for x_end - x_start.
+    void lcd_draw_bitmap_rotated(uint16_t x_start, uint16_t y_start,
+                                 uint16_t x_end, uint16_t y_end, const uint16_t *color_data, uint8_t rotation,
+                                 uint16_t src_stride = 0);
     void draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data);
     void fillScreen(uint16_t color);
+
+    // 2D primitives on the panel framebuffer, panel coordinates, strides in
+    // source pixels. With the PPA they return once queued and finish in the
+    // background: leave source buffers alone until waitDone(). Without it they
+    // complete in software before returning. false if off-panel.
+    bool fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+    bool blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *src, uint16_t src_stride);
+    bool copyRect(uint16_t src_x, uint16_t src_y, uint16_t dst_x, uint16_t dst_y, uint16_t w, uint16_t h);
+    bool convert(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 const void *src, rgb565_src_fmt_t fmt, uint16_t src_stride);
+    bool busy();
+    void waitDone();
+    bool draw_splash(uint16_t bg_color, uint16_t accent_color);
     void te_on();
     void te_off();
     uint16_t width();
@@ -0,0 +1,50 @@
+#ifndef _LV_DRAW_SW_BLEND_CUSTOM_H
+#define _LV_DRAW_SW_BLEND_CUSTOM_H
+
+/*
+ * LV_DRAW_SW_ASM_CUSTOM_INCLUDE for lv_conf.h: routes LVGL's RGB565 blend
+ * cases to rgb565_prims / rgb565_blend. Included by LVGL's
+ * lv_draw_sw_blend_to_rgb565.c after its own headers, so the descriptor types
+ * are already known. Returning LV_RESULT_INVALID hands a case back to LVGL's
+ * C loop.
+ */
+
+#include "rgb565_prims.h"
+#include "rgb565_blend.h"
+
+static inline lv_result_t lv_custom_rgb565_fill(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    rgb565_fill((uint16_t *)dsc->dest_buf, dsc->dest_stride / 2, dsc->dest_w, dsc->dest_h,
+                lv_color_to_u16(dsc->color));
+    return LV_RESULT_OK;
+}
+
+static inline lv_result_t lv_custom_rgb565_fill_opa(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    rgb565_blend_fill_opa((uint16_t *)dsc->dest_buf, dsc->dest_stride / 2, dsc->dest_w, dsc->dest_h,
+                          lv_color_to_u16(dsc->color), dsc->opa);
+    return LV_RESULT_OK;
+}
+
+/* LVGL only takes the mask-only path at opa >= LV_OPA_MAX, which is full */
+static inline lv_result_t lv_custom_rgb565_fill_mask(lv_draw_sw_blend_fill_dsc_t * dsc, lv_opa_t opa)
+{
+    rgb565_blend_fill_mask((uint16_t *)dsc->dest_buf, dsc->dest_stride / 2, dsc->dest_w, dsc->dest_h,
+                           lv_color_to_u16(dsc->color), dsc->mask_buf, dsc->mask_stride, opa);
+    return LV_RESULT_OK;
+}
+
+static inline lv_result_t lv_custom_rgb565_image_copy(lv_draw_sw_blend_image_dsc_t * dsc)
+{
+    rgb565_copy((const uint16_t *)dsc->src_buf, dsc->src_stride / 2,
+                (uint16_t *)dsc->dest_buf, dsc->dest_stride / 2, dsc->dest_w, dsc->dest_h);
+    return LV_RESULT_OK;
+}
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                   lv_custom_rgb565_fill(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)          lv_custom_rgb565_fill_opa(dsc)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_MASK(dsc)         lv_custom_rgb565_fill_mask(dsc, LV_OPA_COVER)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_MIX_MASK_OPA(dsc)      lv_custom_rgb565_fill_mask(dsc, (dsc)->opa)
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc)           lv_custom_rgb565_image_copy(dsc)
+
+#endif
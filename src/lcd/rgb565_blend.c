@@ -0,0 +1,202 @@
+#include "rgb565_blend.h"
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+/*
+ * LVGL mixes one pixel at a time with 16-bit loads and stores. Here pixels
+ * move in pairs as one word, which halves the memory operations on the
+ * PSRAM draw buffer, and the per-pixel work is cut where the result is
+ * already known:
+ *   - the foreground spread and the 5-bit weight are computed once per call;
+ *   - a pair equal to the previous pair reuses its result (card backgrounds);
+ *   - four mask bytes are tested at once: all 0 skips, all 255 at full opacity
+ *     stores the color.
+ *
+ * The mix itself is LVGL's (lv_color_16_16_mix): channels spread to
+ * 0x07E0F81F, weight (mix + 4) >> 3, one multiply.
+ *
+ * On the ESP32-P4 the opacity fill can also run on the PIE SIMD unit
+ * (rgb565_blend_pie.S), eight pixels per 128-bit register. The spread mix
+ * works out to bg + floor((fg - bg) * w5 / 32) per channel, with no carry
+ * between channels, so the lanes hold one channel each and stay
+ * bit-identical. tools/rgb565_blend_bench runs a lane-by-lane model of it
+ * (RGB565_BLEND_PIE_MODEL) through the same conformance check.
+ */
+#define SPREAD_MASK 0x07E0F81Fu
+
+static inline uint32_t spread(uint16_t c)
+{
+    return ((uint32_t)c | ((uint32_t)c << 16)) & SPREAD_MASK;
+}
+
+/* w5 is the 5-bit weight (0..32), already derived from the 8-bit opacity */
+static inline uint16_t mix_w5(uint32_t fg, uint16_t bg_c, uint32_t w5)
+{
+    const uint32_t bg = spread(bg_c);
+    const uint32_t r = ((((fg - bg) * w5) >> 5) + bg) & SPREAD_MASK;
+    return (uint16_t)((r >> 16) | r);
+}
+
+static inline uint32_t weight5(uint32_t mix)
+{
+    return (mix + 4) >> 3;
+}
+
+static void fill_opa_c(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                       uint16_t color, uint8_t opa)
+{
+    const uint32_t fg = spread(color);
+    const uint32_t w5 = weight5(opa);
+    uint32_t last_in = ~0u, last_out = 0;
+
+    for (uint32_t y = 0; y < h; y++, dst += dst_stride) {
+        uint16_t *p = dst;
+        uint32_t n = w;
+        if (n && ((uintptr_t)p & 2)) {
+            *p = mix_w5(fg, *p, w5);
+            p++;
+            n--;
+        }
+        uint32_t *q = (uint32_t *)p;
+        for (; n >= 2; n -= 2, q++) {
+            const uint32_t in = *q;
+            if (in != last_in) {
+                last_in = in;
+                last_out = (uint32_t)mix_w5(fg, (uint16_t)in, w5) |
+                           ((uint32_t)mix_w5(fg, (uint16_t)(in >> 16), w5) << 16);
+            }
+            *q = last_out;
+        }
+        if (n) {
+            p = (uint16_t *)q;
+            *p = mix_w5(fg, *p, w5);
+        }
+    }
+}
+
+#if CONFIG_IDF_TARGET_ESP32P4 || defined(RGB565_BLEND_PIE_MODEL)
+#define HAVE_PIE 1
+
+/* Lane constants for rgb565_blend_opa_pie(), in the order it loads them */
+enum {
+    PIE_W, PIE_ONE, PIE_K1024,      /* loaded once */
+    PIE_MB, PIE_FB, PIE_MG, PIE_FG, PIE_MR, PIE_FR64, PIE_KEEP_R,
+    PIE_VECTORS
+};
+
+/* rgb565_blend_pie.S: `groups` runs of 8 pixels from a 16-byte aligned dst */
+void rgb565_blend_opa_pie(uint16_t *dst, uint32_t groups, const uint16_t *k);
+
+static void fill_opa_pie(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                         uint16_t color, uint8_t opa)
+{
+    const uint32_t fg = spread(color);
+    const uint32_t w5 = weight5(opa);
+    const uint16_t lane[PIE_VECTORS] = {
+        [PIE_W] = (uint16_t)w5, [PIE_ONE] = 1, [PIE_K1024] = 1024,
+        [PIE_MB] = 0x001F, [PIE_FB] = color & 0x1F,
+        [PIE_MG] = 0x07E0, [PIE_FG] = (color >> 5) & 0x3F,
+        [PIE_MR] = 0xF800, [PIE_FR64] = (uint16_t)((color >> 11) << 6),
+        [PIE_KEEP_R] = 0xFFC0,
+    };
+    uint16_t k[PIE_VECTORS][8] __attribute__((aligned(16)));
+
+    for (uint32_t v = 0; v < PIE_VECTORS; v++) {
+        for (uint32_t i = 0; i < 8; i++) k[v][i] = lane[v];
+    }
+
+    for (uint32_t y = 0; y < h; y++, dst += dst_stride) {
+        uint16_t *p = dst;
+        uint32_t n = w;
+        for (; n && ((uintptr_t)p & 15); n--, p++) {
+            *p = mix_w5(fg, *p, w5);
+        }
+        if (n >= 8) {
+            rgb565_blend_opa_pie(p, n / 8, &k[0][0]);
+            p += n & ~7u;
+            n &= 7;
+        }
+        for (; n; n--, p++) {
+            *p = mix_w5(fg, *p, w5);
+        }
+    }
+}
+#endif
+
+static rgb565_blend_impl_t s_impl = RGB565_BLEND_C;
+
+bool rgb565_blend_use(rgb565_blend_impl_t impl)
+{
+#ifndef HAVE_PIE
+    if (impl == RGB565_BLEND_PIE) return false;
+#endif
+    s_impl = impl;
+    return true;
+}
+
+rgb565_blend_impl_t rgb565_blend_active(void)
+{
+    return s_impl;
+}
+
+void rgb565_blend_fill_opa(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                           uint16_t color, uint8_t opa)
+{
+#ifdef HAVE_PIE
+    /* Narrow fills are all head and tail */
+    if (s_impl == RGB565_BLEND_PIE && w >= 16) {
+        fill_opa_pie(dst, dst_stride, w, h, color, opa);
+        return;
+    }
+#endif
+    fill_opa_c(dst, dst_stride, w, h, color, opa);
+}
+
+static inline uint32_t mask_weight5(uint8_t m, uint8_t opa)
+{
+    return weight5(opa == 255 ? m : ((uint32_t)m * opa) >> 8);
+}
+
+void rgb565_blend_fill_mask(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                            uint16_t color, const uint8_t *mask, uint32_t mask_stride, uint8_t opa)
+{
+    const uint32_t fg = spread(color);
+    const uint32_t c2 = ((uint32_t)color << 16) | color;
+
+    for (uint32_t y = 0; y < h; y++, dst += dst_stride, mask += mask_stride) {
+        uint32_t x = 0;
+
+        /* Align the mask to a word; the destination follows the same x */
+        for (; x < w && ((uintptr_t)(mask + x) & 3); x++) {
+            dst[x] = mix_w5(fg, dst[x], mask_weight5(mask[x], opa));
+        }
+        for (; x + 4 <= w; x += 4) {
+            const uint32_t m4 = *(const uint32_t *)(mask + x);
+            if (m4 == 0) {
+                continue;
+            }
+            if (m4 == 0xffffffffu && opa == 255) {
+                if (((uintptr_t)(dst + x) & 2) == 0) {
+                    *(uint32_t *)(dst + x) = c2;
+                    *(uint32_t *)(dst + x + 2) = c2;
+                } else {
+                    dst[x] = color;
+                    dst[x + 1] = color;
+                    dst[x + 2] = color;
+                    dst[x + 3] = color;
+                }
+                continue;
+            }
+            for (uint32_t k = 0; k < 4; k++) {
+                const uint8_t m = mask[x + k];
+                if (m) {
+                    dst[x + k] = mix_w5(fg, dst[x + k], mask_weight5(m, opa));
+                }
+            }
+        }
+        for (; x < w; x++) {
+            dst[x] = mix_w5(fg, dst[x], mask_weight5(mask[x], opa));
+        }
+    }
+}
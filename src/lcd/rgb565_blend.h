@@ -0,0 +1,46 @@
+#ifndef _RGB565_BLEND_H
+#define _RGB565_BLEND_H
+
+/*
+ * Translucent RGB565 fills for LVGL's software renderer (hooked in through
+ * lv_draw_sw_blend_custom.h). Results are bit-identical to LVGL's
+ * lv_color_16_16_mix(); only the loop structure differs. No ESP-IDF
+ * dependencies, so tools/rgb565_blend_bench can check them against the
+ * reference on a host. Opaque fills and image copies reuse rgb565_prims.
+ *
+ * Strides are in pixels for RGB565 surfaces and in bytes for A8 masks.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    RGB565_BLEND_C,             /* portable word-pair loops, every target */
+    RGB565_BLEND_PIE,           /* ESP32-P4 PIE SIMD for the opacity fill */
+} rgb565_blend_impl_t;
+
+/*
+ * Kernels to use from now on; false if impl is not built for this target.
+ * Starts on RGB565_BLEND_C: select PIE only after rgb565_blend_check()
+ * passes with it (see setup()).
+ */
+bool rgb565_blend_use(rgb565_blend_impl_t impl);
+rgb565_blend_impl_t rgb565_blend_active(void);
+
+/* dst = mix(color, dst, opa) */
+void rgb565_blend_fill_opa(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                           uint16_t color, uint8_t opa);
+
+/* dst = mix(color, dst, mask * opa / 256); opa 255 uses the mask as is */
+void rgb565_blend_fill_mask(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h,
+                            uint16_t color, const uint8_t *mask, uint32_t mask_stride, uint8_t opa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rgb565_blend_check.h"
+#include "rgb565_blend.h"
+#include "rgb565_prims.h"
+
+#define LV_OPA_MAX  253
+#define SURF_W      67
+#define SURF_H      23
+#define MAX_REPORTS 8
+
+static uint32_t next_rnd(uint32_t *rng)
+{
+    *rng = *rng * 1103515245u + 12345u;
+    return *rng >> 8;
+}
+
+uint16_t rgb565_blend_ref_mix(uint16_t c1, uint16_t c2, uint8_t mix)
+{
+    if (mix == 255)
+        return c1;
+    if (mix == 0)
+        return c2;
+    if (c1 == c2)
+        return c1;
+
+    uint16_t ret;
+
+    mix = (uint32_t)((uint32_t)mix + 4) >> 3;
+
+    uint32_t bg = (uint32_t)(c2 | ((uint32_t)c2 << 16)) & 0x7E0F81F;
+    uint32_t fg = (uint32_t)(c1 | ((uint32_t)c1 << 16)) & 0x7E0F81F;
+    uint32_t result = ((((fg - bg) * mix) >> 5) + bg) & 0x7E0F81F;
+    ret = (uint16_t)(result >> 16) | result;
+
+    return ret;
+}
+
+void rgb565_blend_ref_fill(uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h, uint16_t c,
+                           uint8_t opa, const uint8_t *mask, uint32_t ms)
+{
+    uint32_t x, y;
+
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            uint16_t *d = &dst[y * ds + x];
+            if (!mask && opa >= LV_OPA_MAX)
+                *d = c;
+            else if (!mask)
+                *d = rgb565_blend_ref_mix(c, *d, opa);
+            else if (opa >= LV_OPA_MAX)
+                *d = rgb565_blend_ref_mix(c, *d, mask[y * ms + x]);
+            else
+                *d = rgb565_blend_ref_mix(c, *d, (uint8_t)(((uint16_t)mask[y * ms + x] * opa) >> 8));
+        }
+    }
+}
+
+void rgb565_blend_hook_fill(uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h, uint16_t c,
+                            uint8_t opa, const uint8_t *mask, uint32_t ms)
+{
+    if (!mask && opa >= LV_OPA_MAX)
+        rgb565_fill(dst, ds, w, h, c);
+    else if (!mask)
+        rgb565_blend_fill_opa(dst, ds, w, h, c, opa);
+    else
+        rgb565_blend_fill_mask(dst, ds, w, h, c, mask, ms, opa >= LV_OPA_MAX ? 255 : opa);
+}
+
+void rgb565_blend_make_mask(uint8_t *m, uint32_t n, int kind, uint32_t *rng)
+{
+    uint32_t i = 0;
+
+    while (i < n) {
+        /* Runs of transparent/opaque with anti-aliased edges, like glyphs and arcs */
+        const uint32_t run = 1 + next_rnd(rng) % 9;
+        const uint32_t r = next_rnd(rng) % 4;
+        const uint8_t v = kind == 0 ? (uint8_t)next_rnd(rng)
+                                    : (r == 0 ? 0 : r == 1 ? 255 : (uint8_t)next_rnd(rng));
+        for (uint32_t k = 0; k < run && i < n; k++, i++)
+            m[i] = v;
+    }
+}
+
+static void ref_image(const uint16_t *src, uint32_t ss, uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h)
+{
+    uint32_t y;
+
+    for (y = 0; y < h; y++)
+        memcpy(dst + y * ds, src + y * ss, w * 2);
+}
+
+int rgb565_blend_check(uint32_t rounds, void (*emit)(const char *line))
+{
+    const size_t surf = SURF_W * SURF_H;
+    uint16_t *a = malloc(surf * 2), *b = malloc(surf * 2), *src = malloc(surf * 2);
+    uint8_t *mask = malloc(surf + 8);
+    uint32_t rng = 777;
+    int bad = -1;
+    char line[96];
+    size_t i;
+
+    if (!a || !b || !src || !mask)
+        goto out;
+    bad = 0;
+    for (uint32_t opa = 0; opa < 256; opa++) {
+        for (uint32_t iter = 0; iter < rounds; iter++) {
+            const uint32_t w = next_rnd(&rng) % (SURF_W / 2 + 1), h = next_rnd(&rng) % (SURF_H / 2 + 1);
+            const uint32_t x = next_rnd(&rng) % (SURF_W - w + 1), y = next_rnd(&rng) % (SURF_H - h + 1);
+            const uint32_t moff = next_rnd(&rng) % 4;
+            const uint16_t c = (uint16_t)next_rnd(&rng);
+            const int kind = iter % 4;  /* 0/1: no mask, 2: random mask, 3: run mask */
+            const uint16_t bg = (uint16_t)next_rnd(&rng);
+
+            for (i = 0; i < surf; i++) {
+                /* Half the runs on a flat card background, half on noise */
+                a[i] = b[i] = (iter & 1) ? (uint16_t)next_rnd(&rng) : bg;
+                src[i] = (uint16_t)next_rnd(&rng);
+            }
+            rgb565_blend_make_mask(mask, surf + 8, kind == 2 ? 0 : 1, &rng);
+
+            const uint8_t *m = kind >= 2 ? mask + moff : NULL;
+            rgb565_blend_ref_fill(a + y * SURF_W + x, SURF_W, w, h, c, (uint8_t)opa, m, SURF_W);
+            rgb565_blend_hook_fill(b + y * SURF_W + x, SURF_W, w, h, c, (uint8_t)opa, m, SURF_W);
+            if (iter == 0) {
+                ref_image(src, SURF_W, a + y * SURF_W + x, SURF_W, w, h);
+                rgb565_copy(src, SURF_W, b + y * SURF_W + x, SURF_W, w, h);
+            }
+            if (memcmp(a, b, surf * 2) != 0) {
+                if (emit && bad < MAX_REPORTS) {
+                    snprintf(line, sizeof(line), "MISMATCH opa %u kind %d at %u,%u size %ux%u\n",
+                             (unsigned)opa, kind, (unsigned)x, (unsigned)y, (unsigned)w, (unsigned)h);
+                    emit(line);
+                }
+                bad++;
+            }
+        }
+    }
+out:
+    free(a);
+    free(b);
+    free(src);
+    free(mask);
+    return bad;
+}
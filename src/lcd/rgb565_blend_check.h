@@ -0,0 +1,43 @@
+#ifndef _RGB565_BLEND_CHECK_H
+#define _RGB565_BLEND_CHECK_H
+
+/*
+ * Conformance of the draw-SW blend hooks (lv_draw_sw_blend_custom.h) with
+ * LVGL 9.3's RGB565 path written out per pixel: lv_color_16_16_mix() and the
+ * loops of lv_draw_sw_blend_color_to_rgb565() / rgb565_image_blend() for the
+ * cases the hooks take over. Runs whichever kernels rgb565_blend_use()
+ * selected. No ESP-IDF dependencies: tools/rgb565_blend_bench runs it on a
+ * host and setup() on the panel before it trusts the PIE kernels.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* LVGL's mix of c1 over c2; the reference for every kernel */
+uint16_t rgb565_blend_ref_mix(uint16_t c1, uint16_t c2, uint8_t mix);
+
+/* A fill with LVGL's case selection, on the reference or the hooks; mask may be NULL */
+void rgb565_blend_ref_fill(uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h, uint16_t c,
+                           uint8_t opa, const uint8_t *mask, uint32_t ms);
+void rgb565_blend_hook_fill(uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h, uint16_t c,
+                            uint8_t opa, const uint8_t *mask, uint32_t ms);
+
+/* Masks like glyph and arc coverage: kind 0 random bytes, 1 runs of 0/255 with edges */
+void rgb565_blend_make_mask(uint8_t *m, uint32_t n, int kind, uint32_t *rng);
+
+/*
+ * `rounds` random cases per opacity 0..255: every fill kind on flat and
+ * noisy backgrounds at random sizes, offsets and mask alignments, plus
+ * opaque image copies. Returns the cases that differ from the reference (the
+ * first few reported through emit, which may be NULL), or -1 without memory.
+ */
+int rgb565_blend_check(uint32_t rounds, void (*emit)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,158 @@
+#include <string.h>
+#include "rgb565_prims.h"
+
+/*
+ * The target is a 32-bit core: pixels are written in pairs as one word store
+ * once the row is word aligned, with an odd pixel peeled at either end. Row
+ * copies go through memmove, which the toolchain's libc already does with
+ * word moves.
+ */
+
+uint32_t rgb565_src_bpp(rgb565_src_fmt_t fmt)
+{
+    switch (fmt) {
+    case RGB565_SRC_RGB888:
+        return 3;
+    case RGB565_SRC_XRGB8888:
+        return 4;
+    default:
+        return 2;
+    }
+}
+
+void rgb565_fill(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t color)
+{
+    const uint32_t c2 = ((uint32_t)color << 16) | color;
+
+    for (uint32_t y = 0; y < h; y++, dst += dst_stride) {
+        uint16_t *p = dst;
+        uint32_t n = w;
+        if (n && ((uintptr_t)p & 2)) {
+            *p++ = color;
+            n--;
+        }
+        uint32_t *q = (uint32_t *)p;
+        uint32_t words = n / 2;
+        for (; words >= 8; words -= 8, q += 8) {
+            q[0] = c2;
+            q[1] = c2;
+            q[2] = c2;
+            q[3] = c2;
+            q[4] = c2;
+            q[5] = c2;
+            q[6] = c2;
+            q[7] = c2;
+        }
+        while (words--) {
+            *q++ = c2;
+        }
+        if (n & 1) {
+            *(uint16_t *)q = color;
+        }
+    }
+}
+
+void rgb565_copy(const uint16_t *src, uint32_t src_stride,
+                 uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h)
+{
+    const size_t row = (size_t)w * sizeof(uint16_t);
+
+    if (src == dst || w == 0) {
+        return;
+    }
+    if (dst > src) {
+        /* Moving down a shared surface: bottom row first so no source row is
+         * overwritten before it is read */
+        for (uint32_t y = h; y-- > 0;) {
+            memmove(dst + y * dst_stride, src + y * src_stride, row);
+        }
+    } else {
+        for (uint32_t y = 0; y < h; y++) {
+            memmove(dst + y * dst_stride, src + y * src_stride, row);
+        }
+    }
+}
+
+static inline uint16_t pack565(uint32_t r, uint32_t g, uint32_t b)
+{
+    return (uint16_t)(((r & 0xf8) << 8) | ((g & 0xfc) << 3) | ((b & 0xff) >> 3));
+}
+
+/*
+ * RGB888: four pixels are three little-endian words
+ *   w0 = B0 G0 R0 B1, w1 = G1 R1 B2 G2, w2 = R2 B3 G3 R3
+ * so when source and destination line up, 12 bytes in become two word stores
+ * out with three loads. Otherwise pixels go one at a time.
+ */
+static void convert_rgb888(const uint8_t *src, uint32_t src_stride,
+                           uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h)
+{
+    for (uint32_t y = 0; y < h; y++, src += src_stride * 3, dst += dst_stride) {
+        const uint8_t *s = src;
+        uint16_t *p = dst;
+        uint32_t n = w;
+
+        /* Peel until both sides are word aligned, if they ever will be */
+        for (int k = 0; k < 4 && n && (((uintptr_t)s & 3) || ((uintptr_t)p & 2)); k++, n--, s += 3) {
+            *p++ = pack565(s[2], s[1], s[0]);
+        }
+        if (!((uintptr_t)s & 3) && !((uintptr_t)p & 2)) {
+            const uint32_t *sw = (const uint32_t *)s;
+            uint32_t *q = (uint32_t *)p;
+            for (; n >= 4; n -= 4, sw += 3, q += 2) {
+                const uint32_t w0 = sw[0], w1 = sw[1], w2 = sw[2];
+                q[0] = (uint32_t)pack565(w0 >> 16, w0 >> 8, w0 & 0xff) |
+                       ((uint32_t)pack565(w1 >> 8, w1 & 0xff, w0 >> 24) << 16);
+                q[1] = (uint32_t)pack565(w2 & 0xff, w1 >> 24, (w1 >> 16) & 0xff) |
+                       ((uint32_t)pack565(w2 >> 24, (w2 >> 16) & 0xff, (w2 >> 8) & 0xff) << 16);
+            }
+            s = (const uint8_t *)sw;
+            p = (uint16_t *)q;
+        }
+        for (; n; n--, s += 3) {
+            *p++ = pack565(s[2], s[1], s[0]);
+        }
+    }
+}
+
+static inline uint16_t xrgb_to_565(uint32_t c)
+{
+    return (uint16_t)(((c >> 8) & 0xf800) | ((c >> 5) & 0x07e0) | ((c >> 3) & 0x001f));
+}
+
+static void convert_xrgb8888(const uint32_t *src, uint32_t src_stride,
+                             uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h)
+{
+    for (uint32_t y = 0; y < h; y++, src += src_stride, dst += dst_stride) {
+        const uint32_t *s = src;
+        uint16_t *p = dst;
+        uint32_t n = w;
+        if (n && ((uintptr_t)p & 2)) {
+            *p++ = xrgb_to_565(*s++);
+            n--;
+        }
+        uint32_t *q = (uint32_t *)p;
+        for (; n >= 2; n -= 2, s += 2) {
+            *q++ = (uint32_t)xrgb_to_565(s[0]) | ((uint32_t)xrgb_to_565(s[1]) << 16);
+        }
+        if (n) {
+            *(uint16_t *)q = xrgb_to_565(*s);
+        }
+    }
+}
+
+void rgb565_convert(const void *src, rgb565_src_fmt_t fmt, uint32_t src_stride,
+                    uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h)
+{
+    switch (fmt) {
+    case RGB565_SRC_RGB888:
+        convert_rgb888((const uint8_t *)src, src_stride, dst, dst_stride, w, h);
+        break;
+    case RGB565_SRC_XRGB8888:
+        convert_xrgb8888((const uint32_t *)src, src_stride, dst, dst_stride, w, h);
+        break;
+    default:
+        rgb565_copy((const uint16_t *)src, src_stride, dst, dst_stride, w, h);
+        break;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef _RGB565_PRIMS_H
+#define _RGB565_PRIMS_H
+
+/*
+ * Software 2D primitives on RGB565 surfaces: the fallback for jd9365_lcd's
+ * PPA paths. No ESP-IDF dependencies, so the same code runs on the panel and
+ * in the host check/benchmark (tools/rgb565_prims_bench).
+ *
+ * Strides are in pixels of the surface they describe.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Source pixel formats accepted by rgb565_convert(), by memory layout */
+typedef enum {
+    RGB565_SRC_RGB565 = 0,      /* 16-bit little endian, as the panel */
+    RGB565_SRC_RGB888,          /* 3 bytes B, G, R (LVGL RGB888) */
+    RGB565_SRC_XRGB8888,        /* 32-bit little endian 0xXXRRGGBB (LVGL XRGB8888/ARGB8888) */
+} rgb565_src_fmt_t;
+
+/* Bytes per pixel of a source format */
+uint32_t rgb565_src_bpp(rgb565_src_fmt_t fmt);
+
+/* Fill a w x h rectangle with one color */
+void rgb565_fill(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t color);
+
+/* Copy a w x h rectangle; src and dst may overlap (same surface and stride) */
+void rgb565_copy(const uint16_t *src, uint32_t src_stride,
+                 uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h);
+
+/*
+ * Convert a w x h rectangle to RGB565 by truncation; src_stride is in source
+ * pixels. XRGB8888 sources must be 4-byte aligned. No overlap.
+ */
+void rgb565_convert(const void *src, rgb565_src_fmt_t fmt, uint32_t src_stride,
+                    uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
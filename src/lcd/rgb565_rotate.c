@@ -0,0 +1,107 @@
+#include <string.h>
+#include "rgb565_rotate.h"
+
+/*
+ * 90 and 270 degrees walk the source by column, which on a 1280-pixel-wide
+ * frame touches a new cache line on every read. Working in tile x tile blocks
+ * keeps those lines resident until all of their pixels have been used, and
+ * every destination row in a tile is written front to back.
+ *
+ * Destination pixels are written in pairs as one 32-bit store, peeling one
+ * pixel when the pair would straddle a word; both come from neighbouring
+ * source rows that are already in the tile.
+ */
+
+/* dst[i][j] = src[h - 1 - j][i]: source column i becomes destination row i */
+static void rotate_cw(const uint16_t *src, uint32_t w, uint32_t h, uint32_t ss,
+                      uint16_t *dst, uint32_t ds, uint32_t tile)
+{
+    for (uint32_t i0 = 0; i0 < w; i0 += tile) {
+        const uint32_t i1 = (i0 + tile < w) ? i0 + tile : w;
+        for (uint32_t j0 = 0; j0 < h; j0 += tile) {
+            const uint32_t j1 = (j0 + tile < h) ? j0 + tile : h;
+            for (uint32_t i = i0; i < i1; i++) {
+                uint16_t *d = dst + i * ds;
+                const uint16_t *s = src + (h - 1 - j0) * ss + i;
+                uint32_t j = j0;
+                if ((uintptr_t)(d + j) & 2) {
+                    d[j++] = *s;
+                    s -= ss;
+                }
+                for (; j + 1 < j1; j += 2, s -= 2 * ss) {
+                    *(uint32_t *)(d + j) = (uint32_t)s[0] | ((uint32_t)s[-(int32_t)ss] << 16);
+                }
+                if (j < j1) {
+                    d[j] = *s;
+                }
+            }
+        }
+    }
+}
+
+/* dst[i][j] = src[j][w - 1 - i]: source column w-1-i becomes destination row i */
+static void rotate_ccw(const uint16_t *src, uint32_t w, uint32_t h, uint32_t ss,
+                       uint16_t *dst, uint32_t ds, uint32_t tile)
+{
+    for (uint32_t i0 = 0; i0 < w; i0 += tile) {
+        const uint32_t i1 = (i0 + tile < w) ? i0 + tile : w;
+        for (uint32_t j0 = 0; j0 < h; j0 += tile) {
+            const uint32_t j1 = (j0 + tile < h) ? j0 + tile : h;
+            for (uint32_t i = i0; i < i1; i++) {
+                uint16_t *d = dst + i * ds;
+                const uint16_t *s = src + j0 * ss + (w - 1 - i);
+                uint32_t j = j0;
+                if ((uintptr_t)(d + j) & 2) {
+                    d[j++] = *s;
+                    s += ss;
+                }
+                for (; j + 1 < j1; j += 2, s += 2 * ss) {
+                    *(uint32_t *)(d + j) = (uint32_t)s[0] | ((uint32_t)s[ss] << 16);
+                }
+                if (j < j1) {
+                    d[j] = *s;
+                }
+            }
+        }
+    }
+}
+
+/* Row reversal is already sequential on both sides; no tiling needed */
+static void rotate_180(const uint16_t *src, uint32_t w, uint32_t h, uint32_t ss,
+                       uint16_t *dst, uint32_t ds)
+{
+    for (uint32_t i = 0; i < h; i++) {
+        const uint16_t *s = src + (h - 1 - i) * ss + (w - 1);
+        uint16_t *d = dst + i * ds;
+        for (uint32_t j = 0; j < w; j++) {
+            d[j] = *s--;
+        }
+    }
+}
+
+static void rotate_tiled(const uint16_t *src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+                         uint16_t *dst, uint32_t dst_stride, uint8_t quarter_turns, uint32_t tile)
+{
+    switch (quarter_turns & 3) {
+    case 1:
+        rotate_cw(src, src_w, src_h, src_stride, dst, dst_stride, tile);
+        break;
+    case 2:
+        rotate_180(src, src_w, src_h, src_stride, dst, dst_stride);
+        break;
+    case 3:
+        rotate_ccw(src, src_w, src_h, src_stride, dst, dst_stride, tile);
+        break;
+    default:
+        for (uint32_t i = 0; i < src_h; i++) {
+            memcpy(dst + i * dst_stride, src + i * src_stride, src_w * sizeof(uint16_t));
+        }
+        break;
+    }
+}
+
+void rgb565_rotate(const uint16_t *src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+                   uint16_t *dst, uint32_t dst_stride, uint8_t quarter_turns)
+{
+    rotate_tiled(src, src_w, src_h, src_stride, dst, dst_stride, quarter_turns, RGB565_ROTATE_TILE);
+}
@@ -0,0 +1,34 @@
+#ifndef _RGB565_ROTATE_H
+#define _RGB565_ROTATE_H
+
+/*
+ * Cache-blocked RGB565 rotation for rotate-on-flush. No ESP-IDF dependencies,
+ * so the same code runs on the panel path and in the host benchmark
+ * (tools/rgb565_rotate_bench).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Square tile edge in pixels; a tile of source rows must stay in the D-cache */
+#ifndef RGB565_ROTATE_TILE
+#define RGB565_ROTATE_TILE  (32)
+#endif
+
+/**
+ * @brief Rotate a src_w x src_h block clockwise by quarter_turns * 90 degrees
+ *
+ * dst receives a src_h x src_w block for odd turns, src_w x src_h otherwise.
+ * Strides are in pixels. The buffers must not overlap.
+ */
+void rgb565_rotate(const uint16_t *src, uint32_t src_w, uint32_t src_h, uint32_t src_stride,
+                   uint16_t *dst, uint32_t dst_stride, uint8_t quarter_turns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+#include <string.h>
+#include "blackbox.h"
+
+static const uint8_t s_event_magic[4] = { 'B', 'B', 'O', 'X' };
+
+size_t blackbox_storage_bytes(uint8_t channels, uint32_t sample_cap, uint32_t event_cap)
+{
+    /* Times first: they and the events need 4-byte alignment, the samples 2 */
+    return (size_t)sample_cap * sizeof(uint32_t) + (size_t)event_cap * sizeof(blackbox_event_t) +
+           (size_t)sample_cap * channels * sizeof(int16_t);
+}
+
+void blackbox_init(blackbox_t *bb, uint8_t channels, const uint8_t *exp, uint16_t period_ms,
+                   uint32_t sample_cap, uint32_t event_cap, void *storage)
+{
+    uint8_t *mem = (uint8_t *)storage;
+
+    memset(bb, 0, sizeof(*bb));
+    bb->channels = channels;
+    memcpy(bb->exp, exp, channels);
+    bb->exp[channels] = 0;
+    bb->period_ms = period_ms;
+    bb->sample_cap = sample_cap;
+    bb->event_cap = event_cap;
+    bb->t = (uint32_t *)mem;
+    mem += (size_t)sample_cap * sizeof(uint32_t);
+    bb->events = (blackbox_event_t *)mem;
+    mem += (size_t)event_cap * sizeof(blackbox_event_t);
+    bb->samples = (int16_t *)mem;
+    bb->state = BLACKBOX_ARMED;
+}
+
+void blackbox_event(blackbox_t *bb, uint32_t t_ms, blackbox_ev_t type, uint8_t zone, int16_t value,
+                    const char *text)
+{
+    if (bb->state == BLACKBOX_FROZEN) return;
+
+    blackbox_event_t *ev = &bb->events[bb->event_total % bb->event_cap];
+    ev->t_ms = t_ms;
+    ev->type = (uint8_t)type;
+    ev->zone = zone;
+    ev->value = value;
+    memset(ev->text, 0, sizeof(ev->text));
+    if (text) strncpy(ev->text, text, sizeof(ev->text) - 1);
+    bb->event_total++;
+}
+
+bool blackbox_trigger(blackbox_t *bb, uint32_t t_ms, const char *reason)
+{
+    if (bb->state != BLACKBOX_ARMED) return false;
+
+    blackbox_event(bb, t_ms, BLACKBOX_EV_TRIGGER, 0, 0, reason);
+    bb->state = BLACKBOX_TRIGGERED;
+    bb->trigger_ms = t_ms;
+    return true;
+}
+
+void blackbox_freeze(blackbox_t *bb)
+{
+    bb->state = BLACKBOX_FROZEN;
+}
+
+void blackbox_rearm(blackbox_t *bb)
+{
+    bb->state = BLACKBOX_ARMED;
+}
+
+/* ---- export ---- */
+void blackbox_export_begin(const blackbox_t *bb, blackbox_cursor_t *cur, uint32_t skip, uint32_t seq,
+                           uint32_t trip)
+{
+    const uint32_t held = blackbox_held(bb);
+    const uint64_t events = bb->event_total < bb->event_cap ? bb->event_total : bb->event_cap;
+
+    cur->sample = blackbox_oldest(bb) + (skip < held ? skip : held);
+    cur->event = bb->event_total - events;
+    cur->seq = seq;
+    cur->trip = trip;
+}
+
+/* As many samples as fit, each with the ms since the one before as the last channel */
+static void export_samples(const blackbox_t *bb, blackbox_cursor_t *cur, uint8_t *blk)
+{
+    const uint8_t n = bb->channels;
+    chan_log_enc_t enc;
+    int32_t q[CHAN_LOG_MAX_CHANNELS];
+    bool first = true;
+
+    chan_log_enc_init(&enc, n + 1, bb->exp, bb->period_ms, cur->trip);
+    for (; cur->sample < bb->sample_total; cur->sample++) {
+        const uint32_t slot = (uint32_t)(cur->sample % bb->sample_cap);
+        const int16_t *s = &bb->samples[(size_t)slot * n];
+        for (uint8_t ch = 0; ch < n; ch++) {
+            q[ch] = s[ch];
+        }
+        const bool older = cur->sample > blackbox_oldest(bb);
+        q[n] = older ? (int32_t)(bb->t[slot] - bb->t[(slot + bb->sample_cap - 1) % bb->sample_cap]) : 0;
+
+        if (first) {
+            chan_log_enc_begin(&enc, blk, cur->seq, bb->t[slot]);
+            first = false;
+        }
+        if (!chan_log_enc_append(&enc, q)) break;
+    }
+    chan_log_enc_finish(&enc);
+}
+
+static void export_events(const blackbox_t *bb, blackbox_cursor_t *cur, uint8_t *blk)
+{
+    uint8_t *p = blk + BLACKBOX_EVENT_HEADER;
+    uint32_t count = 0;
+
+    for (; cur->event < bb->event_total && count < BLACKBOX_EVENTS_PER_BLOCK; cur->event++, count++) {
+        const blackbox_event_t *ev = &bb->events[cur->event % bb->event_cap];
+        p = chan_log_put_u32(p, ev->t_ms);
+        *p++ = ev->type;
+        *p++ = ev->zone;
+        p = chan_log_put_u16(p, (uint16_t)ev->value);
+        memcpy(p, ev->text, BLACKBOX_TEXT);
+        p += BLACKBOX_TEXT;
+    }
+    memset(p, 0xFF, (size_t)(blk + CHAN_LOG_BLOCK - p));
+
+    uint8_t *h = blk;
+    memcpy(h, s_event_magic, sizeof(s_event_magic));
+    h += 4;
+    *h++ = BLACKBOX_VERSION;
+    *h++ = (uint8_t)count;
+    *h++ = 0;
+    *h++ = 0;
+    h = chan_log_put_u32(h, cur->seq);
+    h = chan_log_put_u32(h, cur->trip);
+    h = chan_log_put_u32(h, bb->trigger_ms);
+    const uint32_t crc = chan_log_crc32(0, blk, BLACKBOX_EVENT_HEADER - 4);
+    chan_log_put_u32(h, chan_log_crc32(crc, blk + BLACKBOX_EVENT_HEADER, (size_t)count * BLACKBOX_EVENT_BYTES));
+}
+
+bool blackbox_export_next(const blackbox_t *bb, blackbox_cursor_t *cur, uint8_t *blk)
+{
+    if (cur->sample < bb->sample_total) {
+        export_samples(bb, cur, blk);
+    } else if (cur->event < bb->event_total) {
+        export_events(bb, cur, blk);
+    } else {
+        return false;
+    }
+    cur->seq++;
+    return true;
+}
+
+/* ---- event blocks ---- */
+bool blackbox_event_peek(const uint8_t *blk, size_t len, blackbox_event_info_t *info)
+{
+    if (len < BLACKBOX_EVENT_HEADER || memcmp(blk, s_event_magic, sizeof(s_event_magic)) != 0 || blk[4] != BLACKBOX_VERSION) {
+        return false;
+    }
+    info->count = blk[5];
+    info->seq = chan_log_get_u32(blk + 8);
+    info->trip = chan_log_get_u32(blk + 12);
+    info->trigger_ms = chan_log_get_u32(blk + 16);
+    return info->count <= BLACKBOX_EVENTS_PER_BLOCK;
+}
+
+bool blackbox_event_block(const uint8_t *blk, size_t len, blackbox_event_info_t *info)
+{
+    if (!blackbox_event_peek(blk, len, info)) {
+        return false;
+    }
+    const size_t bytes = (size_t)info->count * BLACKBOX_EVENT_BYTES;
+    if (BLACKBOX_EVENT_HEADER + bytes > len) {
+        return false;
+    }
+    const uint32_t crc = chan_log_crc32(0, blk, BLACKBOX_EVENT_HEADER - 4);
+    return chan_log_get_u32(blk + BLACKBOX_EVENT_HEADER - 4) == chan_log_crc32(crc, blk + BLACKBOX_EVENT_HEADER, bytes);
+}
+
+void blackbox_event_at(const uint8_t *blk, uint32_t i, blackbox_event_t *ev)
+{
+    const uint8_t *p = blk + BLACKBOX_EVENT_HEADER + (size_t)i * BLACKBOX_EVENT_BYTES;
+
+    ev->t_ms = chan_log_get_u32(p);
+    ev->type = p[4];
+    ev->zone = p[5];
+    ev->value = (int16_t)chan_log_get_u16(p + 6);
+    memcpy(ev->text, p + 8, BLACKBOX_TEXT);
+    ev->text[BLACKBOX_TEXT - 1] = '\0';
+}
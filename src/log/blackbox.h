@@ -0,0 +1,164 @@
+#ifndef _BLACKBOX_H
+#define _BLACKBOX_H
+
+/*
+ * Black-box recorder: the last sample_cap samples of every channel and the
+ * last event_cap events (E-STOP, hose toggles, setpoints, banners) in two
+ * plain rings, written in place. Recording is a store into the next slot;
+ * nothing is encoded until the box is frozen after a trigger, when it is
+ * exported as 4 KB blocks for flash:
+ *
+ *   - samples as channel log blocks (log/chan_log.h) with one more channel
+ *     after the recorded ones: ms since the previous sample, so the timing
+ *     survives producer jitter and stalls (and costs nothing while steady).
+ *     t0_ms is the time of the first record, in the recorder's clock;
+ *   - then the events in event blocks:
+ *
+ *       'B' 'B' 'O' 'X'  magic
+ *       u8             version
+ *       u8             events in this block
+ *       u16            0
+ *       u32            seq, shared with the sample blocks
+ *       u32            trip, the session of the sample blocks
+ *       u32            t_ms of the trigger
+ *       u32            CRC-32 of the block up to the last event, skipping this field
+ *       events         BLACKBOX_EVENT_BYTES each: u32 t_ms, u8 type, u8 zone,
+ *                      i16 value, text (NUL padded)
+ *
+ * Fixed fields are little endian. No ESP-IDF dependencies, so the same code
+ * runs on the target and in the host tool (tools/blackbox_decode).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "chan_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLACKBOX_VERSION        1
+#define BLACKBOX_MAX_CHANNELS   (CHAN_LOG_MAX_CHANNELS - 1)     /* one is the time */
+#define BLACKBOX_TEXT           56
+#define BLACKBOX_EVENT_BYTES    (8 + BLACKBOX_TEXT)
+#define BLACKBOX_EVENT_HEADER   24
+#define BLACKBOX_EVENTS_PER_BLOCK ((CHAN_LOG_BLOCK - BLACKBOX_EVENT_HEADER) / BLACKBOX_EVENT_BYTES)
+
+typedef enum {
+    BLACKBOX_EV_TRIGGER = 1,    /* text: the reason */
+    BLACKBOX_EV_ESTOP,          /* value: 1 pressed, 0 reset */
+    BLACKBOX_EV_HOSE,           /* zone, value: 1 on, 0 off */
+    BLACKBOX_EV_SETPOINT,       /* zone, value: deg F */
+    BLACKBOX_EV_BANNER,         /* value: 1 error; text */
+} blackbox_ev_t;
+
+typedef enum {
+    BLACKBOX_ARMED,
+    BLACKBOX_TRIGGERED,         /* still recording until frozen */
+    BLACKBOX_FROZEN,            /* recording ignored until re-armed */
+} blackbox_state_t;
+
+typedef struct {
+    uint32_t t_ms;
+    uint8_t  type;              /* blackbox_ev_t */
+    uint8_t  zone;
+    int16_t  value;
+    char     text[BLACKBOX_TEXT];
+} blackbox_event_t;
+
+typedef struct {
+    uint8_t   channels;         /* recorded, without the time channel */
+    uint8_t   exp[CHAN_LOG_MAX_CHANNELS];
+    uint16_t  period_ms;        /* nominal, for the block header */
+    uint32_t  sample_cap;
+    uint32_t  event_cap;
+    uint32_t *t;                /* sample_cap times, ms */
+    int16_t  *samples;          /* sample i at [(i % sample_cap) * channels] */
+    blackbox_event_t *events;
+    uint32_t  head;             /* slot of the next sample, sample_total % sample_cap */
+    uint64_t  sample_total;     /* samples ever recorded */
+    uint64_t  event_total;
+    blackbox_state_t state;
+    uint32_t  trigger_ms;
+} blackbox_t;
+
+/* Export position */
+typedef struct {
+    uint64_t sample;
+    uint64_t event;
+    uint32_t seq;
+    uint32_t trip;
+} blackbox_cursor_t;
+
+/* Bytes of storage blackbox_init() needs */
+size_t blackbox_storage_bytes(uint8_t channels, uint32_t sample_cap, uint32_t event_cap);
+
+/* channels <= BLACKBOX_MAX_CHANNELS; exp[channels] as in the channel log */
+void blackbox_init(blackbox_t *bb, uint8_t channels, const uint8_t *exp, uint16_t period_ms,
+                   uint32_t sample_cap, uint32_t event_cap, void *storage);
+
+/* One sample of every channel, values clamped to int16; ignored while frozen */
+static inline void blackbox_sample(blackbox_t *bb, uint32_t t_ms, const int32_t *values)
+{
+    if (bb->state == BLACKBOX_FROZEN) return;
+
+    const uint32_t slot = bb->head;
+    int16_t *s = &bb->samples[(size_t)slot * bb->channels];
+    for (uint8_t ch = 0; ch < bb->channels; ch++) {
+        const int32_t v = values[ch];
+        s[ch] = (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+    }
+    bb->t[slot] = t_ms;
+    bb->head = (slot + 1 == bb->sample_cap) ? 0 : slot + 1;
+    bb->sample_total++;
+}
+
+/* Ignored while frozen; text may be NULL and is cut to BLACKBOX_TEXT - 1 */
+void blackbox_event(blackbox_t *bb, uint32_t t_ms, blackbox_ev_t type, uint8_t zone, int16_t value,
+                    const char *text);
+
+/* Record a trigger event and keep recording until frozen; false if already triggered */
+bool blackbox_trigger(blackbox_t *bb, uint32_t t_ms, const char *reason);
+void blackbox_freeze(blackbox_t *bb);
+/* Record again, keeping what is held */
+void blackbox_rearm(blackbox_t *bb);
+
+/* Samples held, oldest first from blackbox_oldest() */
+static inline uint32_t blackbox_held(const blackbox_t *bb)
+{
+    return bb->sample_total < bb->sample_cap ? (uint32_t)bb->sample_total : bb->sample_cap;
+}
+
+static inline uint64_t blackbox_oldest(const blackbox_t *bb)
+{
+    return bb->sample_total - blackbox_held(bb);
+}
+
+/*
+ * Export a frozen box: skip the oldest `skip` samples (to fit a smaller
+ * partition), number blocks from seq and tag them with trip. Then each
+ * blackbox_export_next() fills one CHAN_LOG_BLOCK block, samples first;
+ * false when everything is out.
+ */
+void blackbox_export_begin(const blackbox_t *bb, blackbox_cursor_t *cur, uint32_t skip, uint32_t seq,
+                           uint32_t trip);
+bool blackbox_export_next(const blackbox_t *bb, blackbox_cursor_t *cur, uint8_t *blk);
+
+/* Event block: header fields, then the events with blackbox_event_at() */
+typedef struct {
+    uint8_t  count;
+    uint32_t seq, trip, trigger_ms;
+} blackbox_event_info_t;
+
+/* Header only, no CRC check: enough to find the newest block of a log */
+bool blackbox_event_peek(const uint8_t *blk, size_t len, blackbox_event_info_t *info);
+/* Check the magic and CRC; false if it is not an intact event block */
+bool blackbox_event_block(const uint8_t *blk, size_t len, blackbox_event_info_t *info);
+void blackbox_event_at(const uint8_t *blk, uint32_t i, blackbox_event_t *ev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,274 @@
+#include "blackbox_recorder.h"
+#include "ui_main.h"
+
+#include <math.h>
+#include <cstdio>
+#include <cstring>
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+#define BLACKBOX_SAMPLE_CAP (BLACKBOX_SECONDS * BLACKBOX_SAMPLE_HZ + BLACKBOX_POST_MS * BLACKBOX_SAMPLE_HZ / 1000)
+
+typedef struct {
+    uint32_t trip;
+    uint32_t blocks;
+    uint32_t skipped;           // oldest samples left out to fit the partition
+    uint32_t write_errors;
+    uint32_t ms;                // freeze to done, pauses included
+    uint32_t flash_ms;          // in erase and write
+    uint32_t worst_block_ms;    // longest single erase + write
+} blackbox_save_t;
+
+typedef struct {
+    blackbox_t   bb;                // under s_lock
+    float        scale[UI_CH_COUNT];
+    const esp_partition_t *part;
+    uint32_t     sectors;
+    uint32_t     next_sector;
+    uint32_t     next_seq;
+    uint32_t     trip;              // newest trip in the partition
+    uint8_t     *block;             // internal RAM, the flash write source
+    TaskHandle_t task;
+    blackbox_save_t last;           // written by the task, read unlocked
+    uint32_t     saves;
+} blackbox_rec_ctx_t;
+
+static blackbox_rec_ctx_t s;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// ----------------------------------
+// Save task
+// ----------------------------------
+// Blocks of one export, counted without writing
+static uint32_t count_blocks(uint32_t skip, uint32_t stop_after, uint32_t *skip_to)
+{
+    blackbox_cursor_t cur;
+    uint32_t n = 0;
+
+    blackbox_export_begin(&s.bb, &cur, skip, 0, 0);
+    while(n < stop_after && blackbox_export_next(&s.bb, &cur, s.block)) n++;
+    if(skip_to) *skip_to = (uint32_t)(cur.sample - blackbox_oldest(&s.bb));
+    return n;
+}
+
+// Blocks are independent, so dropping the first k sample blocks leaves the
+// rest as they were: skip exactly the samples those k blocks held.
+static uint32_t fit_skip(void)
+{
+    const uint32_t n = count_blocks(0, UINT32_MAX, nullptr);
+    if(n <= s.sectors) return 0;
+    uint32_t skip = 0;
+    count_blocks(0, n - s.sectors, &skip);
+    return skip;
+}
+
+static void save(void)
+{
+    const int64_t t0 = esp_timer_get_time();
+    blackbox_save_t r = {};
+    blackbox_cursor_t cur;
+
+    r.trip = s.trip + 1;
+    r.skipped = fit_skip();
+    blackbox_export_begin(&s.bb, &cur, r.skipped, s.next_seq, r.trip);
+    int64_t flash_us = 0;
+    bool first = true;
+    while(blackbox_export_next(&s.bb, &cur, s.block)) {
+        if(!first) vTaskDelay(pdMS_TO_TICKS(BLACKBOX_SAVE_GAP_MS));
+        first = false;
+
+        const size_t off = (size_t)s.next_sector * CHAN_LOG_BLOCK;
+        const int64_t t_block = esp_timer_get_time();
+        esp_err_t err = esp_partition_erase_range(s.part, off, CHAN_LOG_BLOCK);
+        if(err == ESP_OK) err = esp_partition_write(s.part, off, s.block, CHAN_LOG_BLOCK);
+        const int64_t us = esp_timer_get_time() - t_block;
+        flash_us += us;
+        if(us / 1000 > r.worst_block_ms) r.worst_block_ms = (uint32_t)(us / 1000);
+        if(err != ESP_OK) r.write_errors++;
+        else r.blocks++;
+        s.next_sector = (s.next_sector + 1 == s.sectors) ? 0 : s.next_sector + 1;
+    }
+    s.next_seq = cur.seq;
+    s.trip = r.trip;
+    r.ms = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+    r.flash_ms = (uint32_t)(flash_us / 1000);
+    s.last = r;
+    s.saves++;
+}
+
+// Wakes on a trigger, lets the post-trigger window fill, freezes and saves
+// one block every BLACKBOX_SAVE_GAP_MS, so the screen stays responsive while
+// the operator deals with the trip.
+static void save_task(void *arg)
+{
+    (void)arg;
+
+    for(;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(BLACKBOX_POST_MS));
+
+        portENTER_CRITICAL(&s_lock);
+        blackbox_freeze(&s.bb);
+        portEXIT_CRITICAL(&s_lock);
+
+        // Frozen: producers leave the rings alone, so they are read unlocked
+        if(!s.part) continue;
+        save();
+        if(!s.last.write_errors) blackbox_rec_rearm();
+    }
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+extern "C" bool blackbox_rec_begin(void)
+{
+    if(s.task) return true;
+
+    uint8_t exp[UI_CH_COUNT];
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        const ui_channel_desc_t *d = ui_channel_desc((ui_channel_t)i);
+        exp[i] = d->decimals + d->fine;
+        s.scale[i] = powf(10.0f, (float)exp[i]);
+    }
+
+    const size_t bytes = blackbox_storage_bytes(UI_CH_COUNT, BLACKBOX_SAMPLE_CAP, BLACKBOX_EVENTS);
+    void *mem = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    s.block = (uint8_t *)heap_caps_malloc(CHAN_LOG_BLOCK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(!mem || !s.block) return false;
+    blackbox_init(&s.bb, UI_CH_COUNT, exp, 1000 / BLACKBOX_SAMPLE_HZ, BLACKBOX_SAMPLE_CAP, BLACKBOX_EVENTS, mem);
+
+    s.part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, BLACKBOX_PARTITION);
+    // Room for a full set of event blocks and some samples
+    const uint32_t min_blocks = BLACKBOX_EVENTS / BLACKBOX_EVENTS_PER_BLOCK + 4;
+    if(s.part && s.part->size < min_blocks * CHAN_LOG_BLOCK) s.part = nullptr;
+
+    // Continue after the newest block of either kind; headers are enough
+    s.sectors = s.part ? s.part->size / CHAN_LOG_BLOCK : 0;
+    bool found = false;
+    for(uint32_t i = 0; i < s.sectors; i++) {
+        uint8_t hdr[CHAN_LOG_HEADER + CHAN_LOG_MAX_CHANNELS];
+        chan_log_info_t info;
+        blackbox_event_info_t ev;
+        uint32_t seq, trip;
+        if(esp_partition_read(s.part, (size_t)i * CHAN_LOG_BLOCK, hdr, sizeof(hdr)) != ESP_OK) continue;
+        // Only the header was read; the length is that of the block it starts
+        if(chan_log_peek(hdr, CHAN_LOG_BLOCK, &info)) {
+            seq = info.seq;
+            trip = info.session;
+        } else if(blackbox_event_peek(hdr, CHAN_LOG_BLOCK, &ev)) {
+            seq = ev.seq;
+            trip = ev.trip;
+        } else {
+            continue;
+        }
+        if(!found || seq >= s.next_seq) {
+            s.next_seq = seq + 1;
+            s.next_sector = (i + 1 == s.sectors) ? 0 : i + 1;
+        }
+        if(!found || trip > s.trip) s.trip = trip;
+        found = true;
+    }
+
+    // Off the LVGL core, below the producers
+    const BaseType_t other_core = (xPortGetCoreID() == 0) ? 1 : 0;
+    xTaskCreatePinnedToCore(save_task, "blackbox", 4096, nullptr, 1, &s.task, other_core);
+    return s.task != nullptr;
+}
+
+extern "C" void blackbox_rec_values(const float *values)
+{
+    if(!s.task) return;
+
+    int32_t q[UI_CH_COUNT];
+    for(int i = 0; i < UI_CH_COUNT; i++) q[i] = (int32_t)lroundf(values[i] * s.scale[i]);
+    const uint32_t t = now_ms();
+
+    portENTER_CRITICAL(&s_lock);
+    blackbox_sample(&s.bb, t, q);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void blackbox_rec_event(blackbox_ev_t type, uint8_t zone, int16_t value, const char *text)
+{
+    if(!s.task) return;
+
+    const uint32_t t = now_ms();
+    portENTER_CRITICAL(&s_lock);
+    blackbox_event(&s.bb, t, type, zone, value, text);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" bool blackbox_rec_trigger(const char *reason)
+{
+    if(!s.task) return false;
+
+    const uint32_t t = now_ms();
+    portENTER_CRITICAL(&s_lock);
+    const bool tripped = blackbox_trigger(&s.bb, t, reason);
+    portEXIT_CRITICAL(&s_lock);
+
+    if(tripped) xTaskNotifyGive(s.task);
+    return tripped;
+}
+
+extern "C" void blackbox_rec_rearm(void)
+{
+    // A trip still filling its post-trigger window is left to the task
+    portENTER_CRITICAL(&s_lock);
+    if(s.bb.state == BLACKBOX_FROZEN) blackbox_rearm(&s.bb);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void blackbox_rec_print(void (*emit)(const char *line))
+{
+    static const char *const states[] = { "armed", "tripped", "frozen" };
+    char b[128];
+
+    if(!s.task) {
+        emit("black box: not started\r\n");
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    const blackbox_state_t state = s.bb.state;
+    const uint32_t held = blackbox_held(&s.bb);
+    const uint64_t events = s.bb.event_total;
+    const uint32_t span_ms = held ? s.bb.t[(s.bb.head + s.bb.sample_cap - 1) % s.bb.sample_cap] -
+                                    s.bb.t[blackbox_oldest(&s.bb) % s.bb.sample_cap] : 0;
+    portEXIT_CRITICAL(&s_lock);
+
+    snprintf(b, sizeof(b), "black box: %s, %lu samples over %.1f s, %llu events, %u KB PSRAM\r\n",
+             states[state], (unsigned long)held, span_ms / 1000.0, (unsigned long long)events,
+             (unsigned)(blackbox_storage_bytes(UI_CH_COUNT, BLACKBOX_SAMPLE_CAP, BLACKBOX_EVENTS) / 1024));
+    emit(b);
+    if(!s.part) {
+        emit("  no \"" BLACKBOX_PARTITION "\" partition: a trip stays frozen in PSRAM until re-armed\r\n");
+        return;
+    }
+    snprintf(b, sizeof(b), "  partition \"%s\" at 0x%lx, %lu KB: trip %lu, next block %lu (seq %lu)\r\n",
+             s.part->label, (unsigned long)s.part->address, (unsigned long)(s.part->size / 1024),
+             (unsigned long)s.trip, (unsigned long)s.next_sector, (unsigned long)s.next_seq);
+    emit(b);
+    if(s.saves) {
+        const blackbox_save_t r = s.last;
+        snprintf(b, sizeof(b), "  last save: trip %lu, %lu blocks, %lu oldest samples left out, %lu errors\r\n",
+                 (unsigned long)r.trip, (unsigned long)r.blocks, (unsigned long)r.skipped,
+                 (unsigned long)r.write_errors);
+        emit(b);
+        snprintf(b, sizeof(b), "  save took %lu ms: %lu ms in flash, longest block %lu ms, %u ms apart\r\n",
+                 (unsigned long)r.ms, (unsigned long)r.flash_ms, (unsigned long)r.worst_block_ms,
+                 (unsigned)BLACKBOX_SAVE_GAP_MS);
+        emit(b);
+    }
+}
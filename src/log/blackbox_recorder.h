@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "blackbox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- Black box ----------
+// The last BLACKBOX_SECONDS of every live channel at acquisition rate, and
+// the UI's events and banners, in PSRAM rings (log/blackbox.h). Recording is
+// one store per sample. E-STOP, an error status from ui_post_status() or
+// blackbox_rec_trigger() trips it: recording carries on for BLACKBOX_POST_MS
+// so the response is in, then the box freezes and a low-priority task writes
+// it to the "blackbox" data partition, one block every BLACKBOX_SAVE_GAP_MS,
+// as a new trip, oldest trips overwritten, and re-arms. Without the partition it stays frozen in PSRAM
+// until re-armed. Decode an image of the partition with tools/blackbox_decode.
+
+#ifndef BLACKBOX_SECONDS
+#define BLACKBOX_SECONDS    300
+#endif
+#define BLACKBOX_SAMPLE_HZ  100     // sizes the ring; the rate the producer posts at
+#define BLACKBOX_EVENTS     256
+#define BLACKBOX_POST_MS    2000
+#define BLACKBOX_PARTITION  "blackbox"
+// Pause between two saved blocks: each erase stalls both cores' caches, so
+// the LVGL task gets at least one display period between them
+#ifndef BLACKBOX_SAVE_GAP_MS
+#define BLACKBOX_SAVE_GAP_MS 50
+#endif
+
+// Allocate the rings, find the partition and the newest trip in it; from
+// setup(). False if the rings do not fit
+bool blackbox_rec_begin(void);
+
+// Any task: one acquisition of values[UI_CH_COUNT]. ui_post_channels() and
+// ui_update_live_values() call it.
+void blackbox_rec_values(const float *values);
+// Any task; text may be NULL
+void blackbox_rec_event(blackbox_ev_t type, uint8_t zone, int16_t value, const char *text);
+// Any task; false if the box is already tripped
+bool blackbox_rec_trigger(const char *reason);
+// Record again after a trip that could not be saved
+void blackbox_rec_rearm(void);
+
+void blackbox_rec_print(void (*emit)(const char *line));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
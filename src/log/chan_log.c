@@ -0,0 +1,183 @@
+#include <string.h>
+#include "chan_log.h"
+
+static const uint8_t s_magic[4] = { 'C', 'L', 'O', 'G' };
+
+uint32_t chan_log_crc32(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/* CRC-32 of the block without the CRC field: the header before it, exps and payload */
+static uint32_t block_crc(const uint8_t *blk, uint32_t channels, uint32_t payload)
+{
+    const uint32_t crc = chan_log_crc32(0, blk, CHAN_LOG_HEADER - 4);
+    return chan_log_crc32(crc, blk + CHAN_LOG_HEADER, channels + payload);
+}
+
+static uint8_t *put_varint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint32_t *v)
+{
+    uint32_t r = 0;
+
+    for (int shift = 0; shift < 35 && *p < end; shift += 7) {
+        const uint8_t b = *(*p)++;
+        r |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *v = r;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Deltas wrap in 32 bits, so any pair of int32 values round-trips */
+static inline uint32_t zigzag(uint32_t d)
+{
+    return (d << 1) ^ (0u - (d >> 31));
+}
+
+static inline uint32_t unzigzag(uint32_t z)
+{
+    return (z >> 1) ^ (0u - (z & 1));
+}
+
+/* ---- encoder ---- */
+void chan_log_enc_init(chan_log_enc_t *enc, uint8_t channels, const uint8_t *exp,
+                       uint16_t period_ms, uint32_t session)
+{
+    memset(enc, 0, sizeof(*enc));
+    enc->channels = channels > CHAN_LOG_MAX_CHANNELS ? CHAN_LOG_MAX_CHANNELS : channels;
+    enc->period_ms = period_ms;
+    enc->session = session;
+    memcpy(enc->exp, exp, enc->channels);
+}
+
+void chan_log_enc_begin(chan_log_enc_t *enc, uint8_t *buf, uint32_t seq, uint32_t t0_ms)
+{
+    enc->buf = buf;
+    enc->pos = buf + CHAN_LOG_HEADER + enc->channels;
+    enc->seq = seq;
+    enc->t0_ms = t0_ms;
+    enc->records = 0;
+    memset(enc->prev, 0, sizeof(enc->prev));
+}
+
+bool chan_log_enc_append(chan_log_enc_t *enc, const int32_t *values)
+{
+    uint8_t rec[5 * (CHAN_LOG_MAX_CHANNELS + 1)];
+    uint32_t mask = 0;
+
+    for (uint8_t i = 0; i < enc->channels; i++) {
+        if (values[i] != enc->prev[i] || enc->records == 0) mask |= 1u << i;
+    }
+
+    uint8_t *p = put_varint(rec, mask);
+    for (uint32_t m = mask; m; m &= m - 1) {
+        const int i = __builtin_ctz(m);
+        p = put_varint(p, zigzag((uint32_t)values[i] - (uint32_t)enc->prev[i]));
+    }
+
+    const size_t n = (size_t)(p - rec);
+    if (enc->pos + n > enc->buf + CHAN_LOG_BLOCK || enc->records == UINT16_MAX) {
+        return false;
+    }
+    memcpy(enc->pos, rec, n);
+    enc->pos += n;
+    memcpy(enc->prev, values, enc->channels * sizeof(int32_t));
+    enc->records++;
+    return true;
+}
+
+uint32_t chan_log_enc_finish(chan_log_enc_t *enc)
+{
+    uint8_t *payload = enc->buf + CHAN_LOG_HEADER + enc->channels;
+    const uint32_t n = (uint32_t)(enc->pos - payload);
+    uint8_t *p = enc->buf;
+
+    memcpy(p, s_magic, sizeof(s_magic));
+    p += 4;
+    *p++ = CHAN_LOG_VERSION;
+    *p++ = enc->channels;
+    p = chan_log_put_u16(p, enc->period_ms);
+    p = chan_log_put_u32(p, enc->seq);
+    p = chan_log_put_u32(p, enc->session);
+    p = chan_log_put_u32(p, enc->t0_ms);
+    p = chan_log_put_u16(p, enc->records);
+    p = chan_log_put_u16(p, (uint16_t)n);
+    memcpy(p + 4, enc->exp, enc->channels);
+    chan_log_put_u32(p, block_crc(enc->buf, enc->channels, n));
+
+    /* Pad like erased flash, so the unused tail of a sector is left as it was */
+    memset(enc->pos, 0xFF, (size_t)(enc->buf + CHAN_LOG_BLOCK - enc->pos));
+    return n;
+}
+
+/* ---- decoder ---- */
+bool chan_log_peek(const uint8_t *blk, size_t len, chan_log_info_t *info)
+{
+    if (len < CHAN_LOG_HEADER || memcmp(blk, s_magic, sizeof(s_magic)) != 0 || blk[4] != CHAN_LOG_VERSION) {
+        return false;
+    }
+    info->version = blk[4];
+    info->channels = blk[5];
+    info->period_ms = chan_log_get_u16(blk + 6);
+    info->seq = chan_log_get_u32(blk + 8);
+    info->session = chan_log_get_u32(blk + 12);
+    info->t0_ms = chan_log_get_u32(blk + 16);
+    info->records = chan_log_get_u16(blk + 20);
+    info->bytes = chan_log_get_u16(blk + 22);
+    if (info->channels == 0 || info->channels > CHAN_LOG_MAX_CHANNELS ||
+        (size_t)CHAN_LOG_HEADER + info->channels + info->bytes > len) {
+        return false;
+    }
+    memcpy(info->exp, blk + CHAN_LOG_HEADER, info->channels);
+    return true;
+}
+
+int chan_log_decode(const uint8_t *blk, size_t len, chan_log_info_t *info, int32_t *out, size_t max_values)
+{
+    if (!chan_log_peek(blk, len, info)) {
+        return -1;
+    }
+    const uint8_t *p = blk + CHAN_LOG_HEADER + info->channels;
+    const uint8_t *end = p + info->bytes;
+    if (chan_log_get_u32(blk + CHAN_LOG_HEADER - 4) != block_crc(blk, info->channels, info->bytes) || (size_t)info->records * info->channels > max_values) {
+        return -1;
+    }
+
+    int32_t prev[CHAN_LOG_MAX_CHANNELS] = { 0 };
+    for (uint32_t r = 0; r < info->records; r++) {
+        uint32_t mask, z;
+        if (!get_varint(&p, end, &mask) || (mask >> info->channels) != 0) {
+            return -1;
+        }
+        for (uint32_t m = mask; m; m &= m - 1) {
+            const int i = __builtin_ctz(m);
+            if (!get_varint(&p, end, &z)) {
+                return -1;
+            }
+            prev[i] = (int32_t)((uint32_t)prev[i] + unzigzag(z));
+        }
+        memcpy(out + (size_t)r * info->channels, prev, info->channels * sizeof(int32_t));
+    }
+    return p == end ? (int)info->records : -1;
+}
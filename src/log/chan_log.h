@@ -0,0 +1,130 @@
+#ifndef _CHAN_LOG_H
+#define _CHAN_LOG_H
+
+/*
+ * Compressed time series of the live channels in fixed-size, self-contained
+ * blocks: one block is one flash sector and decodes on its own. No ESP-IDF
+ * dependencies, so the same encoder/decoder builds into the host tool
+ * (tools/chan_log_decode).
+ *
+ * Values are integers, the reading times 10^exp of its channel. Records are
+ * taken at a fixed period, so times are implicit. Each record is
+ *
+ *   varint         mask of the channels that differ from the previous record
+ *   varint ...     zig-zag delta of each of those channels, lowest first
+ *
+ * and the first record of a block has every bit set and deltas from 0, i.e.
+ * the absolute values. A steady channel costs nothing, a slowly moving one
+ * one byte.
+ *
+ * Block layout, CHAN_LOG_BLOCK bytes, 0xFF after the payload:
+ *
+ *   'C' 'L' 'O' 'G'  magic
+ *   u8             version
+ *   u8             channels
+ *   u16            period_ms
+ *   u32            seq, block number within the log, increasing
+ *   u32            session, the logging run the block belongs to
+ *   u32            t0_ms, time of the first record since the session started
+ *   u16            records
+ *   u16            payload bytes
+ *   u32            CRC-32 of the whole block up to the end of the payload,
+ *                  skipping this field
+ *   u8[channels]   exp of each channel
+ *   payload        records
+ *
+ * Fixed fields are little endian, varints are LEB128.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHAN_LOG_VERSION        1
+#define CHAN_LOG_BLOCK          4096
+#define CHAN_LOG_MAX_CHANNELS   16
+#define CHAN_LOG_HEADER         28      /* without the exp bytes */
+
+typedef struct {
+    uint8_t *buf;               /* block being filled, CHAN_LOG_BLOCK bytes */
+    uint8_t *pos;               /* end of the payload so far */
+    uint8_t  channels;
+    uint16_t period_ms;
+    uint32_t seq, session, t0_ms;
+    uint16_t records;
+    uint8_t  exp[CHAN_LOG_MAX_CHANNELS];
+    int32_t  prev[CHAN_LOG_MAX_CHANNELS];
+} chan_log_enc_t;
+
+typedef struct {
+    uint8_t  version;
+    uint8_t  channels;
+    uint16_t period_ms;
+    uint32_t seq, session, t0_ms;
+    uint16_t records;
+    uint16_t bytes;             /* payload */
+    uint8_t  exp[CHAN_LOG_MAX_CHANNELS];
+} chan_log_info_t;
+
+/* Fixed for every block of the encoder */
+void chan_log_enc_init(chan_log_enc_t *enc, uint8_t channels, const uint8_t *exp,
+                       uint16_t period_ms, uint32_t session);
+
+/* Start filling buf as block seq, whose first record is t0_ms into the session */
+void chan_log_enc_begin(chan_log_enc_t *enc, uint8_t *buf, uint32_t seq, uint32_t t0_ms);
+
+/* Append one record of enc->channels values; false if it does not fit (nothing written) */
+bool chan_log_enc_append(chan_log_enc_t *enc, const int32_t *values);
+
+/* Write the header and CRC and pad the block; returns its payload bytes */
+uint32_t chan_log_enc_finish(chan_log_enc_t *enc);
+
+/* Header only, no CRC check: enough to find the newest block of a log */
+bool chan_log_peek(const uint8_t *blk, size_t len, chan_log_info_t *info);
+
+/*
+ * Check the CRC and decode every record into out[record * channels + ch];
+ * out must hold info->records * info->channels values. Returns the number of
+ * records, or -1 if the block is damaged.
+ */
+int chan_log_decode(const uint8_t *blk, size_t len, chan_log_info_t *info, int32_t *out, size_t max_values);
+
+/* CRC-32 (IEEE) of len bytes, continuing crc; start with 0 */
+uint32_t chan_log_crc32(uint32_t crc, const void *data, size_t len);
+
+/* Little-endian fields of the block headers; put returns the byte after */
+static inline uint8_t *chan_log_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static inline uint8_t *chan_log_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static inline uint16_t chan_log_get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t chan_log_get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
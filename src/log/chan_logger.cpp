@@ -0,0 +1,289 @@
+#include "chan_logger.h"
+#include "chan_log.h"
+#include "trend/trend_pyramid.h"
+#include "ui_main.h"
+
+#include <math.h>
+#include <cstdio>
+#include <cstring>
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+typedef struct {
+    uint32_t blocks;            // blocks written this session
+    uint32_t records;           // records this session, including the open block
+    uint64_t payload_bytes;     // of the written blocks
+    uint32_t payload_records;   // records in the written blocks
+    uint32_t write_errors;
+    uint32_t write_us_max;
+    uint64_t write_us_sum;
+    uint32_t writes;
+} chan_logger_stats_t;
+
+typedef struct {
+    const esp_partition_t *part;
+    uint32_t     sectors;
+    uint32_t     next_sector;
+    uint32_t     next_seq;
+    uint32_t     session;           // newest session in the log
+    uint8_t     *block;             // internal RAM, the flash write source
+    chan_log_enc_t enc;
+    uint8_t      exp[UI_CH_COUNT];
+    float        scale[UI_CH_COUNT];
+    TaskHandle_t task;
+    volatile uint32_t period_ms;    // 0 when stopped
+    volatile bool busy;             // session still open in the task
+    int64_t      t_start;           // us, of the open session
+    trend_pyramid_t hist;           // under hist_lock; from boot, sessions or not
+    SemaphoreHandle_t hist_lock;
+    void        *hist_mem;          // PSRAM, nullptr if it did not fit
+    uint64_t     hist_first_ms;
+    float        latest[UI_CH_COUNT];
+    bool         have_values;
+    chan_logger_stats_t stats;      // written by the task, read unlocked
+} chan_logger_ctx_t;
+
+static chan_logger_ctx_t s;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ----------------------------------
+// Logger task
+// ----------------------------------
+// One sector erase and program per block. Flash operations pause the caches
+// of both cores, so the LVGL task can lose a frame to each; at the default
+// rate a block lasts from half a minute (every channel noisy) to minutes.
+static void write_block(void)
+{
+    const uint32_t payload = chan_log_enc_finish(&s.enc);
+    const size_t off = (size_t)s.next_sector * CHAN_LOG_BLOCK;
+    const int64_t t0 = esp_timer_get_time();
+
+    esp_err_t err = esp_partition_erase_range(s.part, off, CHAN_LOG_BLOCK);
+    if(err == ESP_OK) err = esp_partition_write(s.part, off, s.block, CHAN_LOG_BLOCK);
+
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    s.stats.writes++;
+    s.stats.write_us_sum += us;
+    if(us > s.stats.write_us_max) s.stats.write_us_max = us;
+    if(err != ESP_OK) {
+        s.stats.write_errors++;
+    } else {
+        s.stats.blocks++;
+        s.stats.payload_bytes += CHAN_LOG_HEADER + UI_CH_COUNT + payload;
+        s.stats.payload_records += s.enc.records;
+    }
+
+    // A failed sector is skipped, not retried
+    s.next_sector = (s.next_sector + 1 == s.sectors) ? 0 : s.next_sector + 1;
+    s.next_seq++;
+}
+
+static void snapshot(int32_t *q)
+{
+    float v[UI_CH_COUNT];
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(v, s.latest, sizeof(v));
+    portEXIT_CRITICAL(&s_lock);
+
+    for(int i = 0; i < UI_CH_COUNT; i++) q[i] = (int32_t)lroundf(v[i] * s.scale[i]);
+}
+
+// Sessions open and close at the first tick after start and stop
+static void session_open(uint32_t period)
+{
+    s.busy = true;
+    s.session++;
+    memset(&s.stats, 0, sizeof(s.stats));
+    chan_log_enc_init(&s.enc, UI_CH_COUNT, s.exp, (uint16_t)period, s.session);
+    s.t_start = esp_timer_get_time();
+}
+
+// Ticks at the session rate while recording and at the default rate
+// otherwise; every tick also goes into the history, so the trend can scroll
+// back over the hours before a session was started.
+static void logger_task(void *arg)
+{
+    (void)arg;
+    TickType_t wake = xTaskGetTickCount();
+    bool open = false;                  // block started in s.block
+
+    for(;;) {
+        uint32_t period = s.period_ms;
+        if(period && !s.busy) session_open(period);
+        if(!period && s.busy) {
+            if(open && s.enc.records) write_block();
+            open = false;
+            s.busy = false;
+        }
+        if(s.busy) period = s.enc.period_ms;
+
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(period ? period : CHAN_LOGGER_PERIOD_MS));
+        if(!s.have_values) continue;
+
+        int32_t q[UI_CH_COUNT];
+        snapshot(q);
+        const int64_t now = esp_timer_get_time();
+
+        if(s.hist_mem) {
+            xSemaphoreTake(s.hist_lock, portMAX_DELAY);
+            if(!s.hist.started) s.hist_first_ms = (uint64_t)(now / 1000);
+            trend_pyramid_push(&s.hist, (uint64_t)(now / 1000), q);
+            xSemaphoreGive(s.hist_lock);
+        }
+        if(!s.busy || !s.period_ms) continue;
+
+        // Blocks start at their first record, so t0_ms is exact
+        const uint32_t ms = (uint32_t)((now - s.t_start) / 1000);
+        if(!open) {
+            chan_log_enc_begin(&s.enc, s.block, s.next_seq, ms);
+            open = true;
+        }
+        if(!chan_log_enc_append(&s.enc, q)) {
+            write_block();
+            chan_log_enc_begin(&s.enc, s.block, s.next_seq, ms);
+            chan_log_enc_append(&s.enc, q);
+        }
+        s.stats.records++;
+    }
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+extern "C" bool chan_logger_begin(void)
+{
+    if(s.task) return s.part != nullptr;
+
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        const ui_channel_desc_t *d = ui_channel_desc((ui_channel_t)i);
+        s.exp[i] = d->decimals + d->fine;
+        s.scale[i] = powf(10.0f, (float)s.exp[i]);
+    }
+
+    // The history needs no partition; the accumulators hold int64 sums. A
+    // mutex, not a spinlock: a query reads a few hundred scattered PSRAM
+    // buckets, too long to hold interrupts off on both cores
+    const size_t hist_bytes = trend_pyramid_storage_bytes(UI_CH_COUNT);
+    s.hist_lock = xSemaphoreCreateMutex();
+    s.hist_mem = s.hist_lock ? heap_caps_aligned_alloc(8, hist_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : nullptr;
+    if(s.hist_mem) trend_pyramid_init(&s.hist, UI_CH_COUNT, s.hist_mem);
+
+    s.part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, CHAN_LOGGER_PARTITION);
+    s.block = (uint8_t *)heap_caps_malloc(CHAN_LOG_BLOCK, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(!s.part || !s.block || s.part->size < 2 * CHAN_LOG_BLOCK) s.part = nullptr;
+
+    // Continue after the newest block; headers are enough to find it
+    s.sectors = s.part ? s.part->size / CHAN_LOG_BLOCK : 0;
+    bool found = false;
+    for(uint32_t i = 0; i < s.sectors; i++) {
+        uint8_t hdr[CHAN_LOG_HEADER + CHAN_LOG_MAX_CHANNELS];
+        chan_log_info_t info;
+        if(esp_partition_read(s.part, (size_t)i * CHAN_LOG_BLOCK, hdr, sizeof(hdr)) != ESP_OK) continue;
+        // Only the header was read; the length is that of the block it starts
+        if(!chan_log_peek(hdr, CHAN_LOG_BLOCK, &info)) continue;
+        if(!found || info.seq >= s.next_seq) {
+            s.next_seq = info.seq + 1;
+            s.next_sector = (i + 1 == s.sectors) ? 0 : i + 1;
+        }
+        if(!found || info.session > s.session) s.session = info.session;
+        found = true;
+    }
+
+    if(!s.part && !s.hist_mem) return false;
+
+    // Off the LVGL core, below the producers
+    const BaseType_t other_core = (xPortGetCoreID() == 0) ? 1 : 0;
+    xTaskCreatePinnedToCore(logger_task, "chan_log", 4096, nullptr, 1, &s.task, other_core);
+    return s.task != nullptr && s.part != nullptr;
+}
+
+extern "C" bool chan_logger_start(uint32_t period_ms)
+{
+    if(!s.part || !s.task) return false;
+    if(s.period_ms) return true;
+    if(s.busy) return false;            // the last session is still writing its block
+
+    s.period_ms = (period_ms < 10) ? 10 : period_ms;
+    return true;
+}
+
+extern "C" void chan_logger_stop(void)
+{
+    s.period_ms = 0;
+}
+
+extern "C" bool chan_logger_running(void)
+{
+    return s.period_ms != 0;
+}
+
+extern "C" void chan_logger_set_values(const float *values)
+{
+    portENTER_CRITICAL(&s_lock);
+    memcpy(s.latest, values, sizeof(s.latest));
+    s.have_values = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" int chan_logger_history(int ch, uint32_t span_ms, uint32_t columns, int32_t empty,
+                                   int32_t *mn, int32_t *mx, int32_t *mean)
+{
+    if(!s.hist_mem || ch < 0 || ch >= UI_CH_COUNT) return -1;
+
+    xSemaphoreTake(s.hist_lock, portMAX_DELAY);
+    const uint64_t to = s.hist.last_ms + 1;
+    const uint64_t from = (to > span_ms) ? to - span_ms : 0;
+    const int level = trend_pyramid_query(&s.hist, (uint32_t)ch, from, to, columns, empty, mn, mx, mean);
+    xSemaphoreGive(s.hist_lock);
+    return level;
+}
+
+extern "C" void chan_logger_print(void (*emit)(const char *line))
+{
+    char b[128];
+
+    if(s.hist_mem) {
+        xSemaphoreTake(s.hist_lock, portMAX_DELAY);
+        const uint64_t kept_ms = s.hist.started ? s.hist.last_ms - s.hist_first_ms : 0;
+        xSemaphoreGive(s.hist_lock);
+        snprintf(b, sizeof(b), "history: %u KB PSRAM, 1 s to 10 min buckets, %llu s of samples\r\n",
+                 (unsigned)(trend_pyramid_storage_bytes(UI_CH_COUNT) / 1024), (unsigned long long)(kept_ms / 1000));
+        emit(b);
+    }
+    if(!s.part) {
+        emit("channel log: no partition\r\n");
+        return;
+    }
+    const chan_logger_stats_t st = s.stats;
+    snprintf(b, sizeof(b), "channel log: %s, session %lu, every %lu ms\r\n",
+             s.period_ms ? "running" : (s.busy ? "stopping" : "stopped"),
+             (unsigned long)s.session, (unsigned long)(s.period_ms ? s.period_ms : s.enc.period_ms));
+    emit(b);
+    snprintf(b, sizeof(b), "  partition \"%s\" at 0x%lx, %lu KB: %lu blocks, next %lu (seq %lu)\r\n", s.part->label,
+             (unsigned long)s.part->address, (unsigned long)(s.part->size / 1024), (unsigned long)s.sectors,
+             (unsigned long)s.next_sector, (unsigned long)s.next_seq);
+    emit(b);
+    snprintf(b, sizeof(b), "  session: %lu records, %lu blocks written, %llu bytes\r\n",
+             (unsigned long)st.records, (unsigned long)st.blocks, (unsigned long long)st.payload_bytes);
+    emit(b);
+    if(st.payload_records) {
+        const double per_rec = (double)st.payload_bytes / st.payload_records;
+        snprintf(b, sizeof(b), "  %.1f bytes/record, %.1fx smaller than %u floats\r\n",
+                 per_rec, (double)(UI_CH_COUNT * sizeof(float)) / per_rec, (unsigned)UI_CH_COUNT);
+        emit(b);
+    }
+    if(st.writes) {
+        snprintf(b, sizeof(b), "  flash: %lu block writes, mean %.1f ms, max %.1f ms, %lu errors\r\n",
+                 (unsigned long)st.writes, st.write_us_sum / 1000.0 / st.writes, st.write_us_max / 1000.0,
+                 (unsigned long)st.write_errors);
+        emit(b);
+    }
+}
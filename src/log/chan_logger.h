@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- Channel log ----------
+// All live channels at a fixed rate, compressed into 4 KB blocks
+// (log/chan_log.h) and written a whole block at a time to a flash data
+// partition used as a circular log; the oldest blocks are overwritten. Each
+// start is a new session. Sampling, encoding and the flash writes run on a
+// low-priority task on the other core; producers only copy their latest
+// values in. Read the partition out and decode it with tools/chan_log_decode.
+//
+// The same task keeps every channel's history since boot in PSRAM as a
+// min/max/mean pyramid (trend/trend_pyramid.h), recording or not, so a
+// trend can show hours to days by reading one bucket per column.
+
+#ifndef CHAN_LOGGER_PERIOD_MS
+#define CHAN_LOGGER_PERIOD_MS   100     // default sample period
+#endif
+
+// Label of the data partition (partitions.csv); without it only the history runs
+#define CHAN_LOGGER_PARTITION   "chanlog"
+
+// Find the partition and the end of the log in it, start the history; from
+// setup(). False without a partition (the history may still run)
+bool chan_logger_begin(void);
+// Start a new session sampling every period_ms (>= 10); false without a partition
+bool chan_logger_start(uint32_t period_ms);
+// The open block is written by the logger task shortly after
+void chan_logger_stop(void);
+bool chan_logger_running(void);
+
+// Any task: the latest values[UI_CH_COUNT]
+void chan_logger_set_values(const float *values);
+
+// Any task: channel ch (ui_channel_t) over the last span_ms in `columns`
+// columns, oldest first, in units of 10^-(decimals + fine); any of mn, mx
+// and mean may be NULL, columns without samples read `empty`. Returns the
+// pyramid level read (0 = 1 s buckets), -1 without history
+int chan_logger_history(int ch, uint32_t span_ms, uint32_t columns, int32_t empty,
+                        int32_t *mn, int32_t *mx, int32_t *mean);
+
+void chan_logger_print(void (*emit)(const char *line));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -40,7 +40,8 @@
  * - LV_STDLIB_RTTHREAD:    RT-Thread implementation
  * - LV_STDLIB_CUSTOM:      Implement the functions externally
  */
-#define LV_USE_STDLIB_MALLOC    LV_STDLIB_BUILTIN
+/*CUSTOM: size-class slab heap for small blocks, ESP heap for the rest (src/mem/lv_mem_core_slab.c)*/
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM
 #define LV_USE_STDLIB_STRING    LV_STDLIB_BUILTIN
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_BUILTIN
 
@@ -53,20 +54,24 @@
 
 #if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
     /*Size of the memory available for `lv_malloc()` in bytes (>= 2kB)*/
-    #define LV_MEM_SIZE (64 * 1024U)          /*[bytes]*/
+    #define LV_MEM_SIZE (128 * 1024U)         /*[bytes]*/
 
     /*Size of the memory expand for `lv_malloc()` in bytes*/
-    #define LV_MEM_POOL_EXPAND_SIZE 0
+    #define LV_MEM_POOL_EXPAND_SIZE (64 * 1024U)
 
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #define LV_MEM_ADR 0     /*0: unused*/
     /*Instead of an address give a memory allocator that will be called to get a memory pool for LVGL. E.g. my_malloc*/
     #if LV_MEM_ADR == 0
-        #undef LV_MEM_POOL_INCLUDE
-        #undef LV_MEM_POOL_ALLOC
+        /*Pools come from the ESP heap and are counted (src/perf/lvgl_heap.c)*/
+        #define LV_MEM_POOL_INCLUDE "perf/lvgl_heap.h"
+        #define LV_MEM_POOL_ALLOC   lvgl_heap_pool_alloc
     #endif
 #endif  /*LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN*/
 
+/*1: LVGL's pools/arenas and large blocks in PSRAM, 0: internal RAM first; either falls back to the other*/
+#define LVGL_HEAP_PSRAM 0
+
 /*====================
    HAL SETTINGS
  *====================*/
@@ -181,10 +186,11 @@
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
     #endif
 
-    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
+    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_CUSTOM
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
-        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE ""
+        /* RGB565 fill/opa/mask/copy kernels, see src/lcd/rgb565_blend.c */
+        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE "lcd/lv_draw_sw_blend_custom.h"
     #endif
 
     /* Enable drawing complex gradients in software: linear at an angle, radial or conical */
@@ -887,29 +893,44 @@
 #endif /*LV_USE_SYSMON*/
 
 /*1: Enable the runtime performance profiler*/
-#define LV_USE_PROFILER 0
+#define LV_USE_PROFILER 1
 #if LV_USE_PROFILER
     /*1: Enable the built-in profiler*/
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /*Default profiler trace buffer size*/
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /*[bytes]*/
     #endif
 
-    /*Header to include for the profiler*/
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    /*Header to include for the profiler: our lock-free trace ring, armed from the
+     *serial console and dumped as Chrome trace JSON (src/perf/trace_ring.h)*/
+    #define LV_PROFILER_INCLUDE "perf/trace_ring.h"
 
     /*Profiler start point function*/
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    TRACE_RING_BEGIN
 
     /*Profiler end point function*/
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      TRACE_RING_END
 
     /*Profiler start point function with custom tag*/
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG TRACE_RING_BEGIN_TAG
 
     /*Profiler end point function with custom tag*/
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG   TRACE_RING_END_TAG
+
+    /*Per-module trace points. Style, cache, event and font lookups fire
+     *thousands of times per frame and would flush the ring in one refresh*/
+    #define LV_PROFILER_LAYOUT  1
+    #define LV_PROFILER_REFR    1
+    #define LV_PROFILER_DRAW    1
+    #define LV_PROFILER_INDEV   1
+    #define LV_PROFILER_DECODER 1
+    #define LV_PROFILER_TIMER   1
+    #define LV_PROFILER_FS      0
+    #define LV_PROFILER_FONT    0
+    #define LV_PROFILER_STYLE   0
+    #define LV_PROFILER_CACHE   0
+    #define LV_PROFILER_EVENT   0
 #endif
 
 /*1: Enable Monkey test*/
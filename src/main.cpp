@@ -2,12 +2,28 @@
 #pragma GCC optimize("O3")
 
 #include <Arduino.h>
+#include "esp_timer.h"
 #include "lvgl.h"
 #include "pins_config.h"
 #include "lcd/jd9365_lcd.h"
+#include "lcd/dirty_tiles.h"
+#include "lcd/rgb565_blend.h"
+#include "lcd/rgb565_blend_check.h"
 #include "touch/gsl3680_touch.h"
+#include "touch/gsl3680_trace.h"
+#include "boot/boot_timeline.h"
+#include "perf/touch_latency.h"
+#include "perf/frame_timing.h"
+#include "perf/trace_ring.h"
+#include "perf/lvgl_heap.h"
+#include "mem/lv_mem_core_slab.h"
+#include "log/chan_logger.h"
+#include "log/blackbox_recorder.h"
 
+#include "ui_subjects.h"
 #include "ui_main.h"   // <-- add this (create ui_main.h/.cpp as provided)
+#include "ui_calibration.h"
+#include "ui_draw_cost.h"
 
 jd9365_lcd lcd = jd9365_lcd(LCD_RST);
 gsl3680_touch touch = gsl3680_touch(TP_I2C_SDA, TP_I2C_SCL, TP_RST, TP_INT);
@@ -16,37 +32,420 @@ lv_display_t *disp_drv = nullptr;
 static uint32_t *buf  = nullptr;
 static uint32_t *buf1 = nullptr;
 
-void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *color_map)
+// Touch bring-up (reset delays + firmware download) runs on the other core during boot
+static SemaphoreHandle_t touch_ready_sem = nullptr;
+
+static void touch_init_task(void *arg)
+{
+    (void)arg;
+    const int ph = boot_phase_begin("touch");
+    touch.set_rotation(LCD_ROTATION);   // applied by begin()
+    touch.begin();
+    boot_phase_end(ph);
+
+    xSemaphoreGive(touch_ready_sem);
+    vTaskDelete(nullptr);
+}
+
+// Stand-in for the machine I/O: readings come from their own task, faster
+// than the display refreshes, and reach the UI through the subjects
+static void demo_values_task(void *arg)
+{
+    (void)arg;
+    float t = 0;
+    float v[UI_CH_COUNT];
+
+    for(;;) {
+        t += 0.03f;
+        const float iso_hp   = 1100 + 120 * sinf(t);
+        const float resin_hp = 1080 + 120 * sinf(t + 0.7f);
+
+        v[UI_CH_ISO_HP_PSI]       = iso_hp;
+        v[UI_CH_RESIN_HP_PSI]     = resin_hp;
+        v[UI_CH_ISO_LOW_PSI]      = 120;
+        v[UI_CH_RESIN_LOW_PSI]    = 115;
+        v[UI_CH_PRIMARY_AIR_PSI]  = 95;
+        v[UI_CH_GUN_AIR_PSI]      = 85;
+        v[UI_CH_ISO_HP_TEMP_F]    = 74.8f;
+        v[UI_CH_RESIN_HP_TEMP_F]  = 71.8f;
+        v[UI_CH_ISO_LOW_TEMP_F]   = 72.4f;
+        v[UI_CH_RESIN_LOW_TEMP_F] = 72.5f;
+        v[UI_CH_HOSE1_TEMP_F]     = 70.5f;
+        v[UI_CH_HOSE2_TEMP_F]     = 70.1f;
+        v[UI_CH_RATIO]            = (resin_hp > 1.0f) ? (iso_hp / resin_hp) : 1.0f;
+        ui_post_channels(v);
+        chan_logger_set_values(v);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+// Serial console diagnostics (single-character commands, see serial_poll_commands)
+#define TOUCH_TRACE_RECORDS 16384   // ~9 min of 30 Hz polling, 448 KB PSRAM
+#define PROFILE_TRACE_EVENTS 65536  // a few seconds of LVGL + app spans, 1.3 MB PSRAM (20 B each)
+
+static void serial_emit(const char *line)
+{
+    Serial.print(line);
+}
+
+static void print_touch_bus_stats()
+{
+    gsl3680_bus_stats_t st;
+    touch.getBusStats(&st);
+    const double secs = st.window_us / 1e6;
+    Serial.printf("touch i2c over %.1f s: %lu reads (%lu full re-reads), %lu writes, %lu errors\r\n", secs,
+                  (unsigned long)st.reads, (unsigned long)st.rereads, (unsigned long)st.writes, (unsigned long)st.errors);
+    Serial.printf("  %llu bytes, %.1f bytes/read, bus busy %.2f%%\r\n", (unsigned long long)st.bytes,
+                  st.reads ? (double)st.bytes / st.reads : 0.0,
+                  st.window_us > 0 ? 100.0 * st.busy_us / st.window_us : 0.0);
+    Serial.printf("  mask updates: %lu sent, %lu latched repeats skipped\r\n",
+                  (unsigned long)st.mask_writes, (unsigned long)st.mask_skipped);
+}
+
+// Frame timing histograms, fed from LVGL display events and the flush
+static frame_timing_t frame_timing;
+
+static void frame_timing_event_cb(lv_event_t *e)
+{
+    switch(lv_event_get_code(e)) {
+    case LV_EVENT_INVALIDATE_AREA:
+        frame_timing_invalidate(&frame_timing, lv_area_get_size((const lv_area_t *)lv_event_get_param(e)));
+        break;
+    case LV_EVENT_RENDER_START:
+        frame_timing_render_start(&frame_timing, esp_timer_get_time());
+        break;
+    case LV_EVENT_RENDER_READY:
+        frame_timing_render_done(&frame_timing, esp_timer_get_time());
+        lvgl_heap_frame();
+        break;
+    default:
+        break;
+    }
+}
+
+// Binary, for tools/frame_timing_decode; capture the port raw
+static void dump_frame_timing()
+{
+    static uint8_t out[FRAME_TIMING_DUMP_MAX];
+    const size_t n = frame_timing_encode(&frame_timing, esp_timer_get_time(), out, sizeof(out));
+    Serial.write(out, n);
+    Serial.flush();
+}
+
+#if LCD_FLUSH_SKIP_TILES
+// Flush stage: the tiles LVGL invalidated since the last flush
+static dirty_tiles_t flush_tiles;
+static bool flush_tiles_ready = false;
+static uint32_t flush_spans = 0;
+static int64_t flush_copy_us = 0;
+static int64_t flush_full_us = 0;       // last frame copied whole, for comparison
+
+static void print_flush_stats()
+{
+    const dirty_tiles_stats_t &st = flush_tiles.stats;
+    if(st.frames == 0) {
+        Serial.println("flush: no frames yet");
+        return;
+    }
+    Serial.printf("flush: %lu frames, %lu unchanged, %lu copies (%dx%d tiles)\r\n",
+                  (unsigned long)st.frames, (unsigned long)st.frames_unchanged, (unsigned long)flush_spans,
+                  DIRTY_TILES_W, DIRTY_TILES_H);
+    Serial.printf("  tiles skipped %.1f%%, %.1f of %.1f MB not copied\r\n",
+                  st.tiles ? 100.0 * st.tiles_skipped / st.tiles : 0.0, st.bytes_skipped / 1e6, st.bytes / 1e6);
+    const double copy_ms = flush_copy_us / 1e3 / st.frames;
+    if(flush_full_us) {
+        Serial.printf("  per frame: copy %.2f ms, whole frame %.2f ms, saved %.2f ms\r\n",
+                      copy_ms, flush_full_us / 1e3, flush_full_us / 1e3 - copy_ms);
+    } else {
+        Serial.printf("  per frame: copy %.2f ms\r\n", copy_ms);
+    }
+}
+
+static void reset_flush_stats()
+{
+    dirty_tiles_reset_stats(&flush_tiles);
+    flush_spans = 0;
+    flush_copy_us = 0;
+}
+
+static void flush_tiles_event_cb(lv_event_t *e)
+{
+    const lv_area_t *a = (const lv_area_t *)lv_event_get_param(e);
+    dirty_tiles_mark(&flush_tiles, a->x1, a->y1, a->x2, a->y2);
+}
+
+// Copy only the tiles of a full UI frame that LVGL redrew since the last one
+static void flush_dirty_tiles(const uint16_t *frame)
+{
+    const int64_t t0 = esp_timer_get_time();
+    const uint32_t dirty = dirty_tiles_take(&flush_tiles);
+
+    uint32_t cursor = 0;
+    dirty_tiles_span_t sp;
+    while(dirty_tiles_next_span(&flush_tiles, &cursor, &sp)) {
+        const uint16_t *src = frame + sp.y * UI_H_RES + sp.x;
+#if LCD_ROTATION == 0
+        lcd.blit(sp.x, sp.y, sp.w, sp.h, src, UI_H_RES);
+#else
+        lcd.lcd_draw_bitmap_rotated(sp.x, sp.y, sp.x + sp.w, sp.y + sp.h, src, LCD_ROTATION, UI_H_RES);
+#endif
+        flush_spans++;
+    }
+    // LVGL renders the next frame into this buffer once the flush returns
+    lcd.waitDone();
+
+    const int64_t us = esp_timer_get_time() - t0;
+    flush_copy_us += us;
+    if(dirty == flush_tiles.tiles_x * flush_tiles.tiles_y) flush_full_us = us;
+}
+#endif
+        flush_spans++;
+    }
+    // LVGL renders the next frame into this buffer once the flush returns
+    lcd.waitDone();
+
+    flush_hash_us += t1 - t0;
+    flush_copy_us += esp_timer_get_time() - t1;
+}
+#endif
+
+// Calibration capture finished: fit, apply and persist, or keep the old one
+static void calibration_done(const lv_point_t target[UI_CALIBRATION_POINTS],
+                             const lv_point_t sample[UI_CALIBRATION_POINTS])
+{
+    gsl3680_point_t t[UI_CALIBRATION_POINTS], m[UI_CALIBRATION_POINTS];
+    for(int i = 0; i < UI_CALIBRATION_POINTS; i++) {
+        t[i] = { (uint16_t)target[i].x, (uint16_t)target[i].y, 0 };
+        m[i] = { (uint16_t)sample[i].x, (uint16_t)sample[i].y, 0 };
+        Serial.printf("cal %d: target %d,%d  touch %d,%d\r\n", i,
+                      (int)target[i].x, (int)target[i].y, (int)sample[i].x, (int)sample[i].y);
+    }
+    if(touch.solve_calibration(m, t) && touch.save_calibration()) {
+        ui_set_banner("Touch calibration saved", false);
+    } else {
+        if(!touch.load_calibration()) touch.reset_calibration();
+        ui_set_banner("Touch calibration failed - try again", true);
+    }
+}
+
+static void serial_poll_commands()
+{
+    while(Serial.available() > 0) {
+        switch(Serial.read()) {
+        case 'T':
+            if(gsl3680_trace_start(TOUCH_TRACE_RECORDS) != ESP_OK) Serial.println("touch trace: no memory");
+            break;
+        case 't':
+            gsl3680_trace_stop();
+            Serial.println("touch trace stopped");
+            break;
+        case 'D':
+            gsl3680_trace_dump(serial_emit);
+            break;
+        case 'L':
+            touch_latency_print();
+            break;
+        case 'l':
+            touch_latency_reset();
+            Serial.println("touch latency reset");
+            break;
+        case 'B':
+            print_touch_bus_stats();
+            break;
+        case 'b':
+            touch.resetBusStats();
+            Serial.println("touch i2c counters reset");
+            break;
+#if LCD_FLUSH_SKIP_TILES
+        case 'F':
+            print_flush_stats();
+            break;
+        case 'f':
+            reset_flush_stats();
+            Serial.println("flush counters reset");
+            break;
+#endif
+        case 'P':
+            dump_frame_timing();
+            break;
+        case 'p':
+            frame_timing_reset(&frame_timing, esp_timer_get_time());
+            Serial.println("frame timing reset");
+            break;
+        case 'R':
+            if(!trace_ring_start(PROFILE_TRACE_EVENTS)) Serial.println("profile trace: no memory");
+            break;
+        case 'r':
+            trace_ring_stop();
+            Serial.println("profile trace stopped");
+            break;
+        case 'J':
+            trace_ring_dump_json(serial_emit);
+            break;
+        case 'W':
+            if(!ui_draw_cost_start(lv_screen_active())) Serial.println("draw cost: no memory");
+            break;
+        case 'w':
+            ui_draw_cost_stop();
+            ui_draw_cost_report(serial_emit);
+            break;
+        case 'M':
+            lvgl_heap_print(serial_emit);
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+            slab_heap_print(lv_mem_slab(), serial_emit);
+#endif
+            break;
+        case 'm':
+            lvgl_heap_reset();
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+            slab_heap_reset_stats(lv_mem_slab());
+#endif
+            Serial.println("lvgl heap counters reset");
+            break;
+        case 'U': {
+            ui_post_stats_t st;
+            ui_post_get_stats(&st);
+            Serial.printf("ui posts: %lu values, %lu coalesced before a drain, %lu drains applied them\r\n",
+                          (unsigned long)st.posts, (unsigned long)st.coalesced, (unsigned long)st.drains);
+            break;
+        }
+        case 'G':
+            if(chan_logger_start(CHAN_LOGGER_PERIOD_MS)) chan_logger_print(serial_emit);
+            else Serial.println("channel log: no partition, or still stopping");
+            break;
+        case 'g':
+            chan_logger_stop();
+            Serial.println("channel log stopped");
+            break;
+        case 'H':
+            chan_logger_print(serial_emit);
+            break;
+        case 'K':
+            blackbox_rec_print(serial_emit);
+            break;
+        case 'k':
+            blackbox_rec_rearm();
+            Serial.println("black box re-armed");
+            break;
+        case 'C':
+            // Capture against raw panel coordinates, not the current fit
+            touch.reset_calibration();
+            ui_calibration_start(calibration_done);
+            break;
+        case '?':
+            Serial.println("T: start touch trace  t: stop  D: dump trace");
+            Serial.println("L: touch latency  l: reset it");
+            Serial.println("B: touch i2c counters  b: reset them");
+#if LCD_FLUSH_SKIP_TILES
+            Serial.println("F: flush tile-skip counters  f: reset them");
+#endif
+            Serial.println("P: frame timing dump (binary)  p: reset it");
+            Serial.println("R: start profile trace  r: stop  J: dump as Chrome trace JSON");
+            Serial.println("W: start per-object draw cost  w: stop and print ranked table + style lint");
+            Serial.println("M: lvgl heap (used, peak, largest free, allocations per frame, slab classes)  m: reset counters");
+            Serial.println("U: ui subject posts (values posted / coalesced / drains)");
+            Serial.println("G: start channel log session  g: stop  H: channel log status");
+            Serial.println("K: black box status  k: re-arm after an unsaved trip");
+            Serial.println("C: calibrate touch (3 crosses, saved to NVS)");
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void flush_area(const lv_area_t *area, uint8_t *color_map)
 {
-    const int offsetx1 = area->x1;
-    const int offsetx2 = area->x2;
-    const int offsety1 = area->y1;
-    const int offsety2 = area->y2;
+#if LCD_ROTATION == 0
+    lcd.lcd_draw_bitmap(area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_map);
+#else
+    lcd.lcd_draw_bitmap_rotated(area->x1, area->y1, area->x2 + 1, area->y2 + 1,
+                                (const uint16_t *)color_map, LCD_ROTATION);
+#endif
+}
 
-    lcd.lcd_draw_bitmap(offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, color_map);
+void my_disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *color_map)
+{
+    TRACE_RING_BEGIN;
+    const int64_t t_start = esp_timer_get_time();
+#if LCD_FLUSH_SKIP_TILES
+    const bool full_frame = area->x1 == 0 && area->y1 == 0 &&
+                            area->x2 == UI_H_RES - 1 && area->y2 == UI_V_RES - 1;
+    if(flush_tiles_ready && full_frame) {
+        flush_dirty_tiles((const uint16_t *)color_map);
+    } else {
+        // Partial area: copy the next full frame whole
+        if(flush_tiles_ready) dirty_tiles_mark_all(&flush_tiles);
+        flush_area(area, color_map);
+    }
+#else
+    flush_area(area, color_map);
+#endif
+    frame_timing_flush(&frame_timing, t_start, esp_timer_get_time());
     lv_display_flush_ready(disp);
+    boot_mark_first_frame();
+    touch_latency_flush_done();
+    TRACE_RING_END;
 }
 
+#define TOUCH_MAX_POINTS 5   // GSL3680 reports up to five fingers
+
 void my_touchpad_read(lv_indev_t *indev_driver, lv_indev_data_t *data)
 {
     (void)indev_driver;
+    TRACE_RING_BEGIN;
 
-    bool touched;
-    uint16_t touchX, touchY;
-
-    touched = touch.getTouch(&touchX, &touchY);
+    // LVGL's pointer takes a single point: follow the finger that went down
+    // first and release once it lifts, so a second finger never makes the
+    // cursor jump. Other fingers only take part in the pinch below.
+    static int16_t primary_id = -1;
+    gsl3680_point_t pts[TOUCH_MAX_POINTS];
+    const int64_t t_int = touch.takeInterruptUs();
+    const uint8_t cnt = touch.getTouches(pts, TOUCH_MAX_POINTS);
+    const int64_t t_read = esp_timer_get_time();
 
-    if (!touched) {
+    if(ui_calibration_active()) {
+        // Samples go to the capture overlay; LVGL sees no touch meanwhile
+        primary_id = -1;
+        ui_calibration_feed(cnt > 0, cnt ? pts[0].x : 0, cnt ? pts[0].y : 0);
         data->state = LV_INDEV_STATE_REL;
+        (void)touch.getZoom();   // drop any pinch seen meanwhile
+        TRACE_RING_END;
         return;
     }
 
-    data->state = LV_INDEV_STATE_PR;
-    data->point.x = touchX;
-    data->point.y = touchY;
+    const gsl3680_point_t *p = nullptr;
+    for(uint8_t i = 0; i < cnt; i++) {
+        if(pts[i].id == primary_id) p = &pts[i];
+    }
+    if(cnt == 0) {
+        primary_id = -1;
+    } else if(primary_id < 0) {
+        primary_id = pts[0].id;
+        p = &pts[0];
+        touch_latency_press(t_int, t_read);
+    }
+
+    if(!p) {
+        data->state = LV_INDEV_STATE_REL;
+    } else {
+        data->state = LV_INDEV_STATE_PR;
+        data->point.x = p->x;
+        data->point.y = p->y;
+    }
+
+    // Pinch detected by the driver from this same read: hand it to whatever
+    // sits between the two fingers
+    const int8_t zoom = touch.getZoom();
+    if(zoom != 0 && cnt >= 2) {
+        lv_point_t mid = { (int32_t)(pts[0].x + pts[1].x) / 2, (int32_t)(pts[0].y + pts[1].y) / 2 };
+        lv_obj_t *target = lv_indev_search_obj(lv_screen_active(), &mid);
+        if(target) lv_obj_send_event(target, (lv_event_code_t)UI_EVENT_TOUCH_ZOOM, (void *)(intptr_t)zoom);
+    }
 
     // Optional debug (will spam serial fast; comment out once verified)
-    // Serial.printf("x=%u,y=%u\r\n", touchX, touchY);
+    // Serial.printf("n=%u id=%d x=%d,y=%d\r\n", cnt, primary_id, (int)data->point.x, (int)data->point.y);
+    TRACE_RING_END;
 }
 
 void setup()
@@ -54,11 +453,30 @@ void setup()
     Serial.begin(115200);
     Serial.println("ESP32P4 MIPI DSI LVGL");
 
+    // Touch runs independently of the panel/LVGL; start it first so its
+    // firmware download overlaps the JD9365 init table delays and UI build.
+    touch_ready_sem = xSemaphoreCreateBinary();
+    assert(touch_ready_sem);
+    const BaseType_t other_core = (xPortGetCoreID() == 0) ? 1 : 0;
+    xTaskCreatePinnedToCore(touch_init_task, "touch_init", 4096, nullptr, 5, nullptr, other_core);
+
+    // Panel init also paints the splash into the DPI framebuffer and lights the
+    // backlight, so operators see something while LVGL and touch come up.
+    int ph = boot_phase_begin("panel");
     lcd.begin();
-    touch.begin();
+    boot_phase_end(ph);
+    boot_mark_first_pixel();
 
+    ph = boot_phase_begin("lvgl");
     lv_init();
 
+    // PIE blend kernels only once they match LVGL bit for bit on this chip;
+    // two rounds per opacity cover the opacity fill on flat and noisy pixels
+    if(rgb565_blend_use(RGB565_BLEND_PIE) && rgb565_blend_check(2, serial_emit) != 0) {
+        rgb565_blend_use(RGB565_BLEND_C);
+        Serial.println("blend: PIE kernels differ from LVGL, using the C path");
+    }
+
     // Full screen double buffer
     const uint32_t px_count = (uint32_t)LCD_H_RES * (uint32_t)LCD_V_RES;
 
@@ -68,9 +486,30 @@ void setup()
     assert(buf);
     assert(buf1);
 
-    disp_drv = lv_display_create(LCD_H_RES, LCD_V_RES);
+#if LCD_FLUSH_SKIP_TILES
+    // ~2 KB of tile flags; without them every frame is copied whole
+    void *tile_mem = heap_caps_malloc(dirty_tiles_storage_bytes(UI_H_RES, UI_V_RES),
+                                      MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(tile_mem) {
+        dirty_tiles_init(&flush_tiles, UI_H_RES, UI_V_RES, tile_mem);
+        flush_tiles_ready = true;
+    }
+#endif
+
+    disp_drv = lv_display_create(UI_H_RES, UI_V_RES);
     lv_display_set_flush_cb(disp_drv, my_disp_flush);
 
+    frame_timing_init(&frame_timing, (uint32_t)UI_H_RES * UI_V_RES, esp_timer_get_time());
+    lv_display_add_event_cb(disp_drv, frame_timing_event_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
+    lv_display_add_event_cb(disp_drv, frame_timing_event_cb, LV_EVENT_RENDER_START, nullptr);
+    lv_display_add_event_cb(disp_drv, frame_timing_event_cb, LV_EVENT_RENDER_READY, nullptr);
+#if LCD_FLUSH_SKIP_TILES
+    // Areas are reported before full render mode widens them to the screen
+    if(flush_tiles_ready) {
+        lv_display_add_event_cb(disp_drv, flush_tiles_event_cb, LV_EVENT_INVALIDATE_AREA, nullptr);
+    }
+#endif
+
     // Render mode FULL expects full-frame buffers (you are doing that)
     lv_display_set_buffers(
         disp_drv,
@@ -79,10 +518,13 @@ void setup()
         px_count * sizeof(uint32_t),
         LV_DISPLAY_RENDER_MODE_FULL
     );
+    boot_phase_end(ph);
 
-    lv_indev_t *indev = lv_indev_create();
-    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
-    lv_indev_set_read_cb(indev, my_touchpad_read);
+    // Create the real UI (replaces Hello World)
+    ph = boot_phase_begin("ui_build");
+    ui_build_live_view(lv_scr_act());
+    ui_set_press_callback([](lv_obj_t *) { touch_latency_dispatch(); });
+    boot_phase_end(ph);
 
     // Backlight PWM
     constexpr int BIT_DEPTH = 14;
@@ -98,8 +540,26 @@ void setup()
         while (1) delay(1000);
     }
 
-    // Create the real UI (replaces Hello World)
-    ui_build_live_view(lv_scr_act());
+    // Push the first frame now instead of waiting for touch to finish
+    ph = boot_phase_begin("first_frame");
+    lv_refr_now(disp_drv);
+    boot_phase_end(ph);
+
+    // The pointer device may only be polled once the controller is up
+    ph = boot_phase_begin("touch_wait");
+    xSemaphoreTake(touch_ready_sem, portMAX_DELAY);
+    vSemaphoreDelete(touch_ready_sem);
+    touch_ready_sem = nullptr;
+    boot_phase_end(ph);
+
+    lv_indev_t *indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, my_touchpad_read);
+    boot_mark_interactive();
+
+    if(!blackbox_rec_begin()) Serial.println("black box: out of PSRAM");
+    if(!chan_logger_begin()) Serial.println("channel log: no \"" CHAN_LOGGER_PARTITION "\" partition (partitions.csv)");
+    xTaskCreatePinnedToCore(demo_values_task, "demo_values", 3072, nullptr, 2, nullptr, other_core);
 }
 
 void loop()
@@ -115,20 +575,12 @@ void loop()
     const uint32_t wait_ms = lv_timer_handler();
     delay(wait_ms > 5 ? 5 : wait_ms);
 
-    static float t = 0;
-    t += 0.03f;
-
-    float iso_hp   = 1100 + 120 * sinf(t);
-    float resin_hp = 1080 + 120 * sinf(t + 0.7f);
-    float ratio    = (resin_hp > 1.0f) ? (iso_hp / resin_hp) : 1.0f;
-
-    ui_update_live_values(
-        iso_hp, resin_hp,
-        120, 115,
-        95,  85,
-        74.8f, 71.8f,
-        72.4f, 72.5f,
-        70.5f, 70.1f,
-        ratio
-    );
+    static bool boot_reported = false;
+    if(!boot_reported && boot_first_frame_done()) {
+        // setup() has returned by now, so all milestones are in
+        boot_reported = true;
+        boot_timeline_print();
+    }
+
+    serial_poll_commands();
 }
@@ -0,0 +1,111 @@
+#include "lvgl.h"
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM
+
+#include "esp_heap_caps.h"
+#include "perf/lvgl_heap.h"
+#include "lv_mem_core_slab.h"
+
+_Static_assert(LVGL_HEAP_POOL_ALIGN >= SLAB_PAGE, "slab arenas must be page aligned");
+
+// ----------------------------------
+// Backend
+// ----------------------------------
+static size_t large_size(void *p)
+{
+    return heap_caps_get_allocated_size(p);
+}
+
+static const slab_heap_backend_t s_backend = {
+    .arena_alloc = lvgl_heap_pool_alloc,
+    .large_alloc = lvgl_heap_large_alloc,
+    .large_realloc = lvgl_heap_large_realloc,
+    .large_free = heap_caps_free,
+    .large_size = large_size,
+};
+
+static slab_heap_t s_heap;
+static bool s_ready;
+
+slab_heap_t *lv_mem_slab(void)
+{
+    return s_ready ? &s_heap : NULL;
+}
+
+// ----------------------------------
+// LVGL memory core
+// ----------------------------------
+void lv_mem_init(void)
+{
+    // Arenas are never handed back, so a re-init keeps the old ones in use
+    if (!s_ready) {
+        slab_heap_init(&s_heap, &s_backend);
+        s_ready = true;
+    }
+}
+
+void lv_mem_deinit(void)
+{
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    // Arenas are taken on demand
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size)
+{
+    return slab_heap_alloc(&s_heap, size);
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    return slab_heap_realloc(&s_heap, p, new_size);
+}
+
+void lv_free_core(void *p)
+{
+    slab_heap_free(&s_heap, p);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    const uint32_t caps = LVGL_HEAP_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL;
+    size_t carved = 0, idle = 0;
+    uint32_t blocks = s_heap.large_in_use;
+
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        const slab_class_stats_t *st = &s_heap.cls[c].st;
+        const size_t n = (size_t)st->pages * (SLAB_PAGE / st->size);
+        carved += n * st->size;
+        idle += (n - st->in_use) * st->size;
+        blocks += st->in_use;
+    }
+
+    // Slab arenas plus the large blocks; big requests are limited by the ESP heap
+    mon_p->total_size = (size_t)s_heap.arenas * SLAB_ARENA_BYTES + s_heap.large_bytes;
+    mon_p->free_size = slab_heap_free_bytes(&s_heap);
+    mon_p->free_cnt = 0;
+    mon_p->free_biggest_size = heap_caps_get_largest_free_block(caps | MALLOC_CAP_8BIT);
+    mon_p->used_cnt = blocks;
+    mon_p->max_used = s_heap.peak_bytes;
+    mon_p->used_pct = mon_p->total_size
+                      ? (uint8_t)(100 - 100 * mon_p->free_size / mon_p->total_size) : 0;
+    // Carved slab memory idling on free lists
+    mon_p->frag_pct = carved ? (uint8_t)(100 * idle / carved) : 0;
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    return LV_RESULT_OK;
+}
+
+#endif /*LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM*/
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "slab_heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- LVGL slab heap ----------
+// LV_STDLIB_CUSTOM memory core (lv_conf.h): requests up to SLAB_MAX_SIZE
+// bytes come from the slab heap, arenas from lvgl_heap_pool_alloc(), larger
+// ones from lvgl_heap_large_alloc(). LVGL task only.
+
+// NULL until lv_init() has run
+slab_heap_t *lv_mem_slab(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
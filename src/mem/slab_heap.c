@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <string.h>
+#include "slab_heap.h"
+
+/* Class sizes; 8-byte multiples keep every block 8-byte aligned */
+static const uint16_t s_class_size[SLAB_CLASSES] = { 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+
+/* Class index for (size + 7) / 8, filled on init */
+static uint8_t s_class_of[SLAB_MAX_SIZE / 8 + 1];
+
+void slab_heap_init(slab_heap_t *h, const slab_heap_backend_t *be)
+{
+    memset(h, 0, sizeof(*h));
+    h->be = *be;
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        h->cls[c].st.size = s_class_size[c];
+    }
+    for (uint32_t i = 0, c = 0; i <= SLAB_MAX_SIZE / 8; i++) {
+        while (s_class_size[c] < i * 8) {
+            c++;
+        }
+        s_class_of[i] = (uint8_t)c;
+    }
+}
+
+static slab_arena_t *arena_of(const slab_heap_t *h, const void *p)
+{
+    const uint8_t *b = (const uint8_t *)p;
+
+    for (uint32_t i = 0; i < h->arenas; i++) {
+        const slab_arena_t *a = &h->arena[i];
+        if (b >= a->base && b < a->base + SLAB_ARENA_BYTES) {
+            return (slab_arena_t *)a;
+        }
+    }
+    return NULL;
+}
+
+bool slab_heap_owns(const slab_heap_t *h, const void *p)
+{
+    return arena_of(h, p) != NULL;
+}
+
+static uint32_t class_of_block(const slab_arena_t *a, const void *p)
+{
+    return a->page_class[((const uint8_t *)p - a->base) / SLAB_PAGE];
+}
+
+/* Carve a fresh page into blocks of class c; false when arenas are exhausted */
+static bool refill(slab_heap_t *h, uint32_t c)
+{
+    slab_arena_t *a = h->arenas ? &h->arena[h->arenas - 1] : NULL;
+
+    if (!a || a->pages_used == SLAB_ARENA_PAGES) {
+        if (h->arenas == SLAB_MAX_ARENAS) {
+            return false;
+        }
+        uint8_t *base = (uint8_t *)h->be.arena_alloc(SLAB_ARENA_BYTES);
+        if (!base) {
+            return false;
+        }
+        a = &h->arena[h->arenas++];
+        memset(a, 0, sizeof(*a));
+        a->base = base;
+    }
+
+    const uint32_t size = s_class_size[c];
+    uint8_t *page = a->base + a->pages_used * SLAB_PAGE;
+    a->page_class[a->pages_used++] = (uint8_t)c;
+
+    /* Thread the page onto the free list front to back */
+    void *head = h->cls[c].free;
+    const uint32_t n = SLAB_PAGE / size;
+    for (uint32_t i = n; i-- > 0;) {
+        void **blk = (void **)(page + i * size);
+        *blk = head;
+        head = blk;
+    }
+    h->cls[c].free = head;
+    h->cls[c].st.pages++;
+    return true;
+}
+
+static void *large_alloc(slab_heap_t *h, size_t size)
+{
+    void *p = h->be.large_alloc(size);
+
+    if (p) {
+        const size_t got = h->be.large_size(p);
+        h->large_in_use++;
+        h->large_allocs++;
+        h->large_bytes += got;
+        h->used_bytes += got;
+        if (h->used_bytes > h->peak_bytes) {
+            h->peak_bytes = h->used_bytes;
+        }
+    }
+    return p;
+}
+
+static void large_free(slab_heap_t *h, void *p)
+{
+    const size_t got = h->be.large_size(p);
+
+    h->large_in_use--;
+    h->large_frees++;
+    h->large_bytes -= got;
+    h->used_bytes -= got;
+    h->be.large_free(p);
+}
+
+void *slab_heap_alloc(slab_heap_t *h, size_t size)
+{
+    if (size == 0 || size > SLAB_MAX_SIZE) {
+        return size ? large_alloc(h, size) : NULL;
+    }
+
+    const uint32_t c = s_class_of[(size + 7) / 8];
+    slab_class_t *cl = &h->cls[c];
+    if (!cl->free && !refill(h, c)) {
+        cl->st.spills++;
+        return large_alloc(h, size);
+    }
+
+    void **blk = (void **)cl->free;
+    cl->free = *blk;
+    cl->st.allocs++;
+    if (++cl->st.in_use > cl->st.peak) {
+        cl->st.peak = cl->st.in_use;
+    }
+    h->used_bytes += cl->st.size;
+    if (h->used_bytes > h->peak_bytes) {
+        h->peak_bytes = h->used_bytes;
+    }
+    return blk;
+}
+
+void slab_heap_free(slab_heap_t *h, void *p)
+{
+    if (!p) {
+        return;
+    }
+    const slab_arena_t *a = arena_of(h, p);
+    if (!a) {
+        large_free(h, p);
+        return;
+    }
+
+    slab_class_t *cl = &h->cls[class_of_block(a, p)];
+    *(void **)p = cl->free;
+    cl->free = p;
+    cl->st.frees++;
+    cl->st.in_use--;
+    h->used_bytes -= cl->st.size;
+}
+
+size_t slab_heap_block_size(const slab_heap_t *h, void *p)
+{
+    const slab_arena_t *a = arena_of(h, p);
+
+    return a ? s_class_size[class_of_block(a, p)] : h->be.large_size(p);
+}
+
+void *slab_heap_realloc(slab_heap_t *h, void *p, size_t size)
+{
+    if (!p) {
+        return slab_heap_alloc(h, size);
+    }
+    if (size == 0) {
+        slab_heap_free(h, p);
+        return NULL;
+    }
+
+    const slab_arena_t *a = arena_of(h, p);
+    if (a) {
+        /* Same class: nothing to do */
+        const uint32_t c = class_of_block(a, p);
+        if (size <= SLAB_MAX_SIZE && s_class_of[(size + 7) / 8] == c) {
+            h->cls[c].st.reuses++;
+            return p;
+        }
+    } else if (size > SLAB_MAX_SIZE) {
+        /* Large to large stays with the backend, which may grow in place */
+        const size_t old = h->be.large_size(p);
+        void *q = h->be.large_realloc(p, size);
+        if (q) {
+            const size_t got = h->be.large_size(q);
+            h->large_bytes += got - old;
+            h->used_bytes += got - old;
+            if (h->used_bytes > h->peak_bytes) {
+                h->peak_bytes = h->used_bytes;
+            }
+        }
+        return q;
+    }
+
+    void *q = slab_heap_alloc(h, size);
+    if (q) {
+        const size_t old = slab_heap_block_size(h, p);
+        memcpy(q, p, old < size ? old : size);
+        slab_heap_free(h, p);
+    }
+    return q;
+}
+
+size_t slab_heap_free_bytes(const slab_heap_t *h)
+{
+    size_t bytes = 0;
+
+    for (uint32_t i = 0; i < h->arenas; i++) {
+        bytes += (size_t)(SLAB_ARENA_PAGES - h->arena[i].pages_used) * SLAB_PAGE;
+    }
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        const slab_class_stats_t *st = &h->cls[c].st;
+        bytes += ((size_t)st->pages * (SLAB_PAGE / st->size) - st->in_use) * st->size;
+    }
+    return bytes;
+}
+
+void slab_heap_reset_stats(slab_heap_t *h)
+{
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        slab_class_stats_t *st = &h->cls[c].st;
+        st->peak = st->in_use;
+        st->allocs = st->frees = st->reuses = st->spills = 0;
+    }
+    h->large_allocs = h->large_frees = 0;
+    h->peak_bytes = h->used_bytes;
+}
+
+void slab_heap_print(const slab_heap_t *h, void (*emit)(const char *line))
+{
+    char line[128];
+
+    snprintf(line, sizeof(line), "---- slab heap: %lu arena(s), %lu KB in use, %lu KB peak ----\r\n",
+             (unsigned long)h->arenas, (unsigned long)(h->used_bytes / 1024), (unsigned long)(h->peak_bytes / 1024));
+    emit(line);
+    emit("  size pages in_use   peak   allocs    frees   reuses spills\r\n");
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        const slab_class_stats_t *st = &h->cls[c].st;
+        snprintf(line, sizeof(line), "  %4u %5lu %6lu %6lu %8lu %8lu %8lu %6lu\r\n",
+                 (unsigned)st->size, (unsigned long)st->pages, (unsigned long)st->in_use, (unsigned long)st->peak,
+                 (unsigned long)st->allocs, (unsigned long)st->frees, (unsigned long)st->reuses,
+                 (unsigned long)st->spills);
+        emit(line);
+    }
+    snprintf(line, sizeof(line), "  large: %lu live, %lu KB, %lu allocs, %lu frees\r\n",
+             (unsigned long)h->large_in_use, (unsigned long)(h->large_bytes / 1024),
+             (unsigned long)h->large_allocs, (unsigned long)h->large_frees);
+    emit(line);
+}
@@ -0,0 +1,95 @@
+#ifndef _SLAB_HEAP_H
+#define _SLAB_HEAP_H
+
+/*
+ * Size-class slab allocator for LVGL's small, frequent allocations (label
+ * text, style lists, event descriptors), with a backend heap behind it for
+ * everything larger. No ESP-IDF or LVGL dependencies: lv_mem_core_slab.c
+ * plugs it into LV_STDLIB_CUSTOM with heap_caps as backend, and the host
+ * benchmark (tools/slab_bench) runs it on malloc.
+ *
+ * Blocks of one class are carved from SLAB_PAGE pages inside arenas taken
+ * from the backend; free blocks form a singly linked list per class, so
+ * alloc and free are a pop and a push. The class of a pointer comes from a
+ * per-page byte map, so blocks carry no header. A realloc that stays in the
+ * same class returns the same block, which makes re-setting a label to text
+ * of similar length free.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLAB_PAGE           1024                /* arena alignment and carve unit */
+#define SLAB_MAX_SIZE       256                 /* larger requests go to the backend */
+#define SLAB_CLASSES        9
+#define SLAB_MAX_ARENAS     8
+#define SLAB_ARENA_PAGES    64                  /* 64 KB arenas */
+#define SLAB_ARENA_BYTES    (SLAB_PAGE * SLAB_ARENA_PAGES)
+
+typedef struct {
+    /* Memory for one arena, SLAB_ARENA_BYTES long and SLAB_PAGE aligned */
+    void *(*arena_alloc)(size_t bytes);
+    void *(*large_alloc)(size_t bytes);
+    void *(*large_realloc)(void *p, size_t bytes);
+    void (*large_free)(void *p);
+    size_t (*large_size)(void *p);              /* usable size of a large block */
+} slab_heap_backend_t;
+
+typedef struct {
+    uint16_t size;              /* block size */
+    uint32_t pages;
+    uint32_t in_use, peak;      /* blocks */
+    uint32_t allocs, frees;
+    uint32_t reuses;            /* reallocs served in place */
+    uint32_t spills;            /* requests sent to the backend for lack of arenas */
+} slab_class_stats_t;
+
+typedef struct {
+    void *free;
+    slab_class_stats_t st;
+} slab_class_t;
+
+typedef struct {
+    uint8_t *base;
+    uint32_t pages_used;
+    uint8_t page_class[SLAB_ARENA_PAGES];
+} slab_arena_t;
+
+typedef struct {
+    slab_heap_backend_t be;
+    slab_class_t cls[SLAB_CLASSES];
+    slab_arena_t arena[SLAB_MAX_ARENAS];
+    uint32_t arenas;
+    uint32_t large_in_use, large_allocs, large_frees;
+    size_t large_bytes;
+    size_t used_bytes, peak_bytes;  /* slab blocks at class size plus large blocks */
+} slab_heap_t;
+
+void slab_heap_init(slab_heap_t *h, const slab_heap_backend_t *be);
+
+void *slab_heap_alloc(slab_heap_t *h, size_t size);
+void *slab_heap_realloc(slab_heap_t *h, void *p, size_t size);
+void slab_heap_free(slab_heap_t *h, void *p);
+
+/* true if p is a slab block (as opposed to a backend block) */
+bool slab_heap_owns(const slab_heap_t *h, const void *p);
+/* Usable size of an allocated block */
+size_t slab_heap_block_size(const slab_heap_t *h, void *p);
+/* Bytes sitting on the class free lists and in uncarved arena pages */
+size_t slab_heap_free_bytes(const slab_heap_t *h);
+
+/* Zero the call counters; peaks restart from the current use */
+void slab_heap_reset_stats(slab_heap_t *h);
+/* Per-class table: pages, live and peak blocks, allocs, frees, in-place reallocs, spills */
+void slab_heap_print(const slab_heap_t *h, void (*emit)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <string.h>
+#include "draw_cost.h"
+
+#define OPA_MIN 2       /* LV_OPA_MIN: treated as transparent */
+#define OPA_MAX 253     /* LV_OPA_MAX: treated as opaque */
+
+static const char *const s_lint_name[DRAW_LINT_COUNT] = {
+    "clip_corner", "bg_opa", "radius", "pct100", "shadow", "opa",
+};
+
+static const char *const s_lint_hint[DRAW_LINT_COUNT] = {
+    "clip_corner with radius: children are drawn into a layer and masked",
+    "translucent background: blended per pixel instead of filled",
+    "large radius: anti-aliased corner masks on every redraw",
+    "label with lv_pct(100) width: any text change redraws the full row",
+    "shadow: blurred shadow mask drawn around the object",
+    "opa below cover: the object and its children are drawn into a layer",
+};
+
+static uint32_t bit_index(uint32_t bit)
+{
+    uint32_t i = 0;
+
+    while (i < DRAW_LINT_COUNT && !(bit & (1u << i))) {
+        i++;
+    }
+    return i;
+}
+
+const char *draw_cost_lint_name(uint32_t bit)
+{
+    const uint32_t i = bit_index(bit);
+    return i < DRAW_LINT_COUNT ? s_lint_name[i] : "?";
+}
+
+const char *draw_cost_lint_hint(uint32_t bit)
+{
+    const uint32_t i = bit_index(bit);
+    return i < DRAW_LINT_COUNT ? s_lint_hint[i] : "?";
+}
+
+uint32_t draw_cost_lint(const draw_cost_style_t *st)
+{
+    uint32_t lint = 0;
+    const bool bg_visible = st->bg_opa >= OPA_MIN;
+    const int32_t half = (st->w < st->h ? st->w : st->h) / 2;
+
+    if (st->clip_corner && st->radius > 0 && st->has_children) {
+        lint |= DRAW_LINT_CLIP_CORNER;
+    }
+    if (bg_visible && st->bg_opa < OPA_MAX) {
+        lint |= DRAW_LINT_TRANSLUCENT_BG;
+    }
+    /* A pill or circle is a deliberate shape; only flag big corners on big boxes */
+    if (bg_visible && st->radius >= DRAW_COST_RADIUS_LARGE && st->radius < half) {
+        lint |= DRAW_LINT_LARGE_RADIUS;
+    }
+    if (st->is_label && st->width_pct_100) {
+        lint |= DRAW_LINT_FULL_WIDTH_LABEL;
+    }
+    if (st->shadow_width > 0) {
+        lint |= DRAW_LINT_SHADOW;
+    }
+    if (st->opa < OPA_MAX) {
+        lint |= DRAW_LINT_OPA_LAYER;
+    }
+    return lint;
+}
+
+void draw_cost_reset(draw_cost_t *dc, int64_t now_us)
+{
+    memset(dc, 0, sizeof(*dc));
+    dc->since_us = now_us;
+}
+
+static uint32_t slot_of(const void *key)
+{
+    uintptr_t h = (uintptr_t)key;
+
+    h ^= h >> 7;
+    h *= 0x9e3779b1u;
+    return (uint32_t)(h >> 8) & (DRAW_COST_MAX_OBJS - 1);
+}
+
+draw_cost_obj_t *draw_cost_find(draw_cost_t *dc, const void *key)
+{
+    uint32_t i = slot_of(key);
+
+    for (uint32_t n = 0; n < DRAW_COST_MAX_OBJS; n++, i = (i + 1) & (DRAW_COST_MAX_OBJS - 1)) {
+        if (dc->obj[i].key == key) {
+            return &dc->obj[i];
+        }
+        if (!dc->obj[i].key) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+draw_cost_obj_t *draw_cost_add(draw_cost_t *dc, const void *key, const char *name, const draw_cost_style_t *st)
+{
+    uint32_t i = slot_of(key);
+
+    for (uint32_t n = 0; n < DRAW_COST_MAX_OBJS; n++, i = (i + 1) & (DRAW_COST_MAX_OBJS - 1)) {
+        draw_cost_obj_t *o = &dc->obj[i];
+        if (o->key && o->key != key) {
+            continue;
+        }
+        if (!o->key) {
+            /* Keep one slot free so lookups of unknown keys terminate early */
+            if (dc->count + 1 >= DRAW_COST_MAX_OBJS) {
+                return NULL;
+            }
+            dc->count++;
+        }
+        memset(o, 0, sizeof(*o));
+        o->key = key;
+        o->open_us = -1;
+        snprintf(o->name, sizeof(o->name), "%s", name);
+        o->lint = st ? draw_cost_lint(st) : 0;
+        return o;
+    }
+    return NULL;
+}
+
+void draw_cost_begin(draw_cost_t *dc, const void *key, int64_t now_us)
+{
+    draw_cost_obj_t *o = draw_cost_find(dc, key);
+
+    if (!o) {
+        dc->untracked++;
+        return;
+    }
+    o->open_us = now_us;
+}
+
+void draw_cost_end(draw_cost_t *dc, const void *key, int64_t now_us, uint32_t px)
+{
+    draw_cost_obj_t *o = draw_cost_find(dc, key);
+
+    if (!o || o->open_us < 0) {
+        return;
+    }
+    const int64_t us = now_us - o->open_us;
+    o->open_us = -1;
+    o->draws++;
+    o->us += (uint64_t)(us > 0 ? us : 0);
+    o->px += px;
+    dc->total_us += (uint64_t)(us > 0 ? us : 0);
+}
+
+/* ---- report ---- */
+static void lint_flags(uint32_t lint, char *out, size_t cap)
+{
+    size_t n = 0;
+
+    out[0] = '\0';
+    for (uint32_t i = 0; i < DRAW_LINT_COUNT && n < cap; i++) {
+        if (lint & (1u << i)) {
+            n += (size_t)snprintf(out + n, cap - n, "%s%s", n ? "," : "", s_lint_name[i]);
+        }
+    }
+}
+
+static void emit_row(const draw_cost_obj_t *o, uint32_t rank, uint64_t total_us, double secs,
+                     void (*emit)(const char *line))
+{
+    char flags[64], line[160];
+
+    lint_flags(o->lint, flags, sizeof(flags));
+    snprintf(line, sizeof(line), "%4lu %-40s %6lu %8.2f %6.1f %7.1f %5.1f%% %s\n",
+             (unsigned long)rank, o->name, (unsigned long)o->draws,
+             secs > 0 ? o->us / 1e3 / secs : 0.0,                 /* ms per second of UI time */
+             o->draws ? (double)o->us / o->draws : 0.0,
+             o->draws ? o->px / 1e3 / o->draws : 0.0,
+             total_us ? 100.0 * o->us / total_us : 0.0, flags);
+    emit(line);
+}
+
+void draw_cost_report(const draw_cost_t *dc, int64_t now_us, uint32_t rows, void (*emit)(const char *line))
+{
+    uint16_t order[DRAW_COST_MAX_OBJS];
+    uint32_t n = 0, lint_all = 0;
+    char line[160];
+    const double secs = (now_us - dc->since_us) / 1e6;
+
+    /* Insertion sort by draw time; at most a few hundred entries */
+    for (uint32_t i = 0; i < DRAW_COST_MAX_OBJS; i++) {
+        if (!dc->obj[i].key) {
+            continue;
+        }
+        uint32_t j = n++;
+        while (j > 0 && dc->obj[order[j - 1]].us < dc->obj[i].us) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint16_t)i;
+        lint_all |= dc->obj[i].lint;
+    }
+
+    snprintf(line, sizeof(line), "---- draw cost: %lu objects, %.1f s, %.1f ms drawing (%lu untracked draws) ----\n",
+             (unsigned long)n, secs, dc->total_us / 1e3, (unsigned long)dc->untracked);
+    emit(line);
+    snprintf(line, sizeof(line), "%4s %-40s %6s %8s %6s %7s %6s %s\n",
+             "rank", "object", "draws", "ms/s", "us/draw", "kpx/draw", "share", "lint");
+    emit(line);
+    for (uint32_t r = 0; r < n && r < rows; r++) {
+        emit_row(&dc->obj[order[r]], r + 1, dc->total_us, secs, emit);
+    }
+
+    bool header = false;
+    for (uint32_t r = rows; r < n; r++) {
+        const draw_cost_obj_t *o = &dc->obj[order[r]];
+        if (!o->lint) {
+            continue;
+        }
+        if (!header) {
+            emit("  linted, further down:\n");
+            header = true;
+        }
+        emit_row(o, r + 1, dc->total_us, secs, emit);
+    }
+
+    for (uint32_t i = 0; i < DRAW_LINT_COUNT; i++) {
+        if (lint_all & (1u << i)) {
+            snprintf(line, sizeof(line), "  %-12s %s\n", s_lint_name[i], s_lint_hint[i]);
+            emit(line);
+        }
+    }
+}
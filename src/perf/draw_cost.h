@@ -0,0 +1,91 @@
+#ifndef _DRAW_COST_H
+#define _DRAW_COST_H
+
+/*
+ * Draw time and pixel attribution per UI object, plus a linter for style
+ * combinations that are known to be expensive in LVGL's software renderer.
+ * No LVGL dependency: the UI glue (ui_draw_cost.cpp) feeds begin/end times
+ * and style facts keyed by object pointer, and the same code builds into the
+ * host check (tools/draw_cost_check).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DRAW_COST_MAX_OBJS      256     /* power of two; more objects are not tracked */
+#define DRAW_COST_NAME_LEN      40
+#define DRAW_COST_RADIUS_LARGE  16      /* px; corners this big need wide AA masks */
+
+/* Lint findings, one bit each */
+#define DRAW_LINT_CLIP_CORNER       (1u << 0)   /* children rendered in a layer and masked */
+#define DRAW_LINT_TRANSLUCENT_BG    (1u << 1)   /* background blended instead of filled */
+#define DRAW_LINT_LARGE_RADIUS      (1u << 2)
+#define DRAW_LINT_FULL_WIDTH_LABEL  (1u << 3)   /* lv_pct(100) label: every text change redraws the row */
+#define DRAW_LINT_SHADOW            (1u << 4)
+#define DRAW_LINT_OPA_LAYER         (1u << 5)   /* whole object drawn to a layer and blended */
+#define DRAW_LINT_COUNT             6
+
+/* Style facts of one object, read from LVGL by the glue */
+typedef struct {
+    int32_t w, h;
+    int32_t radius;
+    int32_t shadow_width;
+    uint8_t bg_opa;
+    uint8_t opa;
+    bool clip_corner;
+    bool has_children;
+    bool is_label;
+    bool width_pct_100;
+} draw_cost_style_t;
+
+typedef struct {
+    const void *key;            /* NULL: free slot */
+    char name[DRAW_COST_NAME_LEN];
+    uint32_t lint;
+    uint32_t draws;
+    uint64_t us;
+    uint64_t px;
+    int64_t open_us;            /* begin time of the span in progress, -1 if none */
+} draw_cost_obj_t;
+
+typedef struct {
+    draw_cost_obj_t obj[DRAW_COST_MAX_OBJS];
+    uint32_t count;
+    uint32_t untracked;         /* begin events of objects that did not fit */
+    uint64_t total_us;
+    int64_t since_us;
+} draw_cost_t;
+
+void draw_cost_reset(draw_cost_t *dc, int64_t now_us);
+
+/* Lint bits for one object's style */
+uint32_t draw_cost_lint(const draw_cost_style_t *st);
+/* Short name and explanation of a single lint bit */
+const char *draw_cost_lint_name(uint32_t bit);
+const char *draw_cost_lint_hint(uint32_t bit);
+
+/* Register an object with its display name and style; NULL if the table is full */
+draw_cost_obj_t *draw_cost_add(draw_cost_t *dc, const void *key, const char *name, const draw_cost_style_t *st);
+draw_cost_obj_t *draw_cost_find(draw_cost_t *dc, const void *key);
+
+/* One drawing span of an object; px counts toward the object once per span */
+void draw_cost_begin(draw_cost_t *dc, const void *key, int64_t now_us);
+void draw_cost_end(draw_cost_t *dc, const void *key, int64_t now_us, uint32_t px);
+
+/*
+ * Ranked table, most expensive first: the top `rows` objects by draw time,
+ * then every linted object not already listed, then the lint legend. One
+ * line per call of `emit`.
+ */
+void draw_cost_report(const draw_cost_t *dc, int64_t now_us, uint32_t rows, void (*emit)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,251 @@
+#include <string.h>
+#include "frame_timing.h"
+
+static const uint8_t s_sync[4] = { 0xa5, 0x5a, 'F', 'T' };
+
+static const uint32_t s_width[FRAME_TIMING_METRICS] = {
+    FRAME_TIMING_RENDER_US, FRAME_TIMING_FLUSH_US, FRAME_TIMING_INTERVAL_US, FRAME_TIMING_AREA_PERMILLE,
+};
+
+static void hist_add(frame_timing_hist_t *h, int64_t v)
+{
+    const uint32_t u = v < 0 ? 0 : v > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+    const uint32_t b = u / h->width;
+
+    h->bucket[b < FRAME_TIMING_BUCKETS ? b : FRAME_TIMING_BUCKETS]++;
+    if (h->count == 0 || u < h->min) {
+        h->min = u;
+    }
+    if (u > h->max) {
+        h->max = u;
+    }
+    h->count++;
+    h->sum += u;
+}
+
+void frame_timing_reset(frame_timing_t *ft, int64_t now_us)
+{
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        memset(&ft->hist[i], 0, sizeof(ft->hist[i]));
+        ft->hist[i].width = s_width[i];
+    }
+    ft->frames = 0;
+    ft->since_us = now_us;
+    ft->window_ms = 0;
+}
+
+void frame_timing_init(frame_timing_t *ft, uint32_t screen_px, int64_t now_us)
+{
+    memset(ft, 0, sizeof(*ft));
+    ft->screen_px = screen_px ? screen_px : 1;
+    ft->render_start_us = -1;
+    ft->last_flush_us = -1;
+    frame_timing_reset(ft, now_us);
+}
+
+void frame_timing_invalidate(frame_timing_t *ft, uint32_t px)
+{
+    ft->inv_px += px;
+}
+
+void frame_timing_render_start(frame_timing_t *ft, int64_t now_us)
+{
+    ft->render_start_us = now_us;
+    ft->flush_in_frame_us = 0;
+}
+
+void frame_timing_flush(frame_timing_t *ft, int64_t start_us, int64_t end_us)
+{
+    hist_add(&ft->hist[FRAME_TIMING_FLUSH], end_us - start_us);
+    if (ft->last_flush_us >= 0) {
+        hist_add(&ft->hist[FRAME_TIMING_INTERVAL], start_us - ft->last_flush_us);
+    }
+    ft->last_flush_us = start_us;
+    ft->flush_in_frame_us += end_us - start_us;
+}
+
+void frame_timing_render_done(frame_timing_t *ft, int64_t now_us)
+{
+    if (ft->render_start_us < 0) {
+        return;
+    }
+    /* LVGL flushes from inside the render pass; only count the drawing */
+    hist_add(&ft->hist[FRAME_TIMING_RENDER], now_us - ft->render_start_us - ft->flush_in_frame_us);
+
+    /* Overlapping invalidations can add up to more than the screen */
+    const uint64_t px = ft->inv_px < ft->screen_px ? ft->inv_px : ft->screen_px;
+    hist_add(&ft->hist[FRAME_TIMING_AREA], (int64_t)(px * 1000 / ft->screen_px));
+    ft->inv_px = 0;
+    ft->render_start_us = -1;
+    ft->frames++;
+}
+
+uint32_t frame_timing_percentile(const frame_timing_hist_t *h, uint32_t pct)
+{
+    if (!h->count) {
+        return 0;
+    }
+    const uint32_t want = (uint32_t)(((uint64_t)h->count * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < FRAME_TIMING_BUCKETS; b++) {
+        seen += h->bucket[b];
+        if (seen >= want) {
+            const uint32_t edge = (b + 1) * h->width;
+            return edge < h->max ? edge : h->max;
+        }
+    }
+    return h->max;
+}
+
+/* ---- dump encoding ---- */
+static uint32_t crc32(const uint8_t *p, size_t n)
+{
+    uint32_t crc = 0xffffffffu;
+
+    while (n--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static uint8_t *put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v)
+{
+    uint64_t r = 0;
+
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        const uint8_t b = *(*p)++;
+        r |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *v = r;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t frame_timing_encode(const frame_timing_t *ft, int64_t now_us, uint8_t *buf, size_t cap)
+{
+    if (cap < FRAME_TIMING_DUMP_MAX) {
+        return 0;
+    }
+
+    uint8_t *p = buf + sizeof(s_sync) + 2;
+    uint8_t *const payload = p;
+    const int64_t window_ms = (now_us - ft->since_us) / 1000;
+
+    *p++ = FRAME_TIMING_VERSION;
+    *p++ = FRAME_TIMING_METRICS;
+    *p++ = FRAME_TIMING_BUCKETS;
+    p = put_u32(p, ft->frames);
+    p = put_u32(p, window_ms < 0 ? 0 : (uint32_t)window_ms);
+    p = put_u32(p, ft->screen_px);
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        const frame_timing_hist_t *h = &ft->hist[i];
+        p = put_u32(p, h->width);
+        p = put_varint(p, h->count);
+        p = put_varint(p, h->min);
+        p = put_varint(p, h->max);
+        p = put_varint(p, h->sum);
+        for (int b = 0; b <= FRAME_TIMING_BUCKETS; b++) {
+            p = put_varint(p, h->bucket[b]);
+        }
+    }
+
+    const size_t n = (size_t)(p - payload);
+    memcpy(buf, s_sync, sizeof(s_sync));
+    buf[4] = (uint8_t)n;
+    buf[5] = (uint8_t)(n >> 8);
+    p = put_u32(p, crc32(payload, n));
+    return (size_t)(p - buf);
+}
+
+static bool decode_payload(const uint8_t *p, const uint8_t *end, frame_timing_t *out)
+{
+    uint64_t v;
+
+    if (end - p < 15 || p[0] != FRAME_TIMING_VERSION || p[1] != FRAME_TIMING_METRICS ||
+        p[2] != FRAME_TIMING_BUCKETS) {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+    out->frames = get_u32(p + 3);
+    out->window_ms = get_u32(p + 7);
+    out->screen_px = get_u32(p + 11);
+    p += 15;
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        frame_timing_hist_t *h = &out->hist[i];
+        if (end - p < 4) {
+            return false;
+        }
+        h->width = get_u32(p);
+        p += 4;
+        if (!h->width || !get_varint(&p, end, &v)) {
+            return false;
+        }
+        h->count = (uint32_t)v;
+        if (!get_varint(&p, end, &v)) {
+            return false;
+        }
+        h->min = (uint32_t)v;
+        if (!get_varint(&p, end, &v)) {
+            return false;
+        }
+        h->max = (uint32_t)v;
+        if (!get_varint(&p, end, &h->sum)) {
+            return false;
+        }
+        for (int b = 0; b <= FRAME_TIMING_BUCKETS; b++) {
+            if (!get_varint(&p, end, &v)) {
+                return false;
+            }
+            h->bucket[b] = (uint32_t)v;
+        }
+    }
+    return p == end;
+}
+
+size_t frame_timing_decode(const uint8_t *buf, size_t len, frame_timing_t *out)
+{
+    for (size_t i = 0; i + sizeof(s_sync) + 2 + 4 <= len; i++) {
+        if (memcmp(buf + i, s_sync, sizeof(s_sync)) != 0) {
+            continue;
+        }
+        const size_t n = buf[i + 4] | ((size_t)buf[i + 5] << 8);
+        const uint8_t *payload = buf + i + sizeof(s_sync) + 2;
+        if ((size_t)(payload - buf) + n + 4 > len) {
+            continue;
+        }
+        if (get_u32(payload + n) != crc32(payload, n) || !decode_payload(payload, payload + n, out)) {
+            continue;
+        }
+        return (size_t)(payload - buf) + n + 4;
+    }
+    return 0;
+}
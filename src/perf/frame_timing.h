@@ -0,0 +1,99 @@
+#ifndef _FRAME_TIMING_H
+#define _FRAME_TIMING_H
+
+/*
+ * Per-frame render/flush timing in fixed-bucket histograms, with a compact
+ * binary dump. No ESP-IDF or LVGL dependencies: the caller passes the
+ * timestamps, and the same encoder/decoder builds into the host tool
+ * (tools/frame_timing_decode).
+ *
+ * Recording is a few integer ops per event and never prints. The dump is one
+ * framed record that can sit between text lines of a serial capture:
+ *
+ *   A5 5A 'F' 'T'  sync
+ *   u16            payload length
+ *   payload        u8 version, u8 metrics, u8 buckets,
+ *                  u32 frames, u32 window_ms, u32 screen_px, then per metric
+ *                  u32 bucket width and varints count, min, max, sum and
+ *                  every bucket (the last one is the overflow)
+ *   u32            CRC-32 of the payload
+ *
+ * Fixed fields are little endian, varints are LEB128.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRAME_TIMING_VERSION      1
+#define FRAME_TIMING_BUCKETS      64        /* plus one overflow bucket */
+#define FRAME_TIMING_DUMP_MAX     1600      /* worst-case dump bytes */
+
+/* Bucket widths */
+#define FRAME_TIMING_RENDER_US    250       /* 0..16 ms */
+#define FRAME_TIMING_FLUSH_US     250       /* 0..16 ms */
+#define FRAME_TIMING_INTERVAL_US  1000      /* 0..64 ms */
+#define FRAME_TIMING_AREA_PERMILLE 16       /* 0..100 % of the screen */
+
+typedef enum {
+    FRAME_TIMING_RENDER = 0,    /* drawing, excluding the flush inside it, us */
+    FRAME_TIMING_FLUSH,         /* flush callback, us */
+    FRAME_TIMING_INTERVAL,      /* between the starts of consecutive flushes, us */
+    FRAME_TIMING_AREA,          /* invalidated area per frame, 1/1000 of the screen */
+    FRAME_TIMING_METRICS
+} frame_timing_metric_t;
+
+typedef struct {
+    uint32_t width;
+    uint32_t count;
+    uint32_t min, max;
+    uint64_t sum;
+    uint32_t bucket[FRAME_TIMING_BUCKETS + 1];
+} frame_timing_hist_t;
+
+typedef struct {
+    frame_timing_hist_t hist[FRAME_TIMING_METRICS];
+    uint32_t screen_px;
+    uint32_t frames;            /* frames whose rendering completed */
+    int64_t since_us;           /* start of the window */
+    uint32_t window_ms;         /* filled in by the decoder */
+    /* Frame in progress */
+    uint64_t inv_px;
+    int64_t render_start_us;
+    int64_t flush_in_frame_us;
+    int64_t last_flush_us;
+} frame_timing_t;
+
+void frame_timing_init(frame_timing_t *ft, uint32_t screen_px, int64_t now_us);
+/* Clear the histograms and start a new window */
+void frame_timing_reset(frame_timing_t *ft, int64_t now_us);
+
+/* An area of px pixels was invalidated; counts toward the next frame */
+void frame_timing_invalidate(frame_timing_t *ft, uint32_t px);
+void frame_timing_render_start(frame_timing_t *ft, int64_t now_us);
+/* A flush callback ran from start_us to end_us */
+void frame_timing_flush(frame_timing_t *ft, int64_t start_us, int64_t end_us);
+void frame_timing_render_done(frame_timing_t *ft, int64_t now_us);
+
+/* Upper edge of the bucket holding the pct-th percentile (at most max), 0 when empty */
+uint32_t frame_timing_percentile(const frame_timing_hist_t *h, uint32_t pct);
+
+/* Serialise into buf; returns the bytes written, 0 if cap is too small */
+size_t frame_timing_encode(const frame_timing_t *ft, int64_t now_us, uint8_t *buf, size_t cap);
+
+/*
+ * Find and check the first dump in buf[0, len). On success fills out (only the
+ * histograms, frames, window_ms and screen_px) and returns the offset just
+ * past it; returns 0 if there is no valid dump.
+ */
+size_t frame_timing_decode(const uint8_t *buf, size_t len, frame_timing_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include "esp_heap_caps.h"
+#include "lvgl.h"
+#include "lvgl_heap.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+typedef struct {
+    uint32_t pools;
+    uint32_t pool_bytes;
+    uint32_t pool_psram_bytes;
+    uint32_t frames;
+    uint32_t mallocs, reallocs, frees, failed;
+    uint32_t frame_ops;         // running count of the open frame
+    uint32_t max_per_frame;
+    uint32_t last_frame;
+} lvgl_heap_state_t;
+
+static lvgl_heap_state_t s;
+
+// ----------------------------------
+// Pool memory
+// ----------------------------------
+static void *caps_alloc(size_t bytes, size_t align, bool *psram)
+{
+    const uint32_t first = LVGL_HEAP_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL;
+    const uint32_t second = LVGL_HEAP_PSRAM ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM;
+
+    *psram = LVGL_HEAP_PSRAM;
+    void *p = heap_caps_aligned_alloc(align, bytes, first | MALLOC_CAP_8BIT);
+    if (!p) {
+        p = heap_caps_aligned_alloc(align, bytes, second | MALLOC_CAP_8BIT);
+        *psram = !*psram;
+    }
+    return p;
+}
+
+void *lvgl_heap_pool_alloc(size_t bytes)
+{
+    bool psram;
+    void *p = caps_alloc(bytes, LVGL_HEAP_POOL_ALIGN, &psram);
+
+    if (p) {
+        s.pools++;
+        s.pool_bytes += bytes;
+        if (psram) s.pool_psram_bytes += bytes;
+    }
+    return p;
+}
+
+void *lvgl_heap_large_alloc(size_t bytes)
+{
+    const uint32_t first = LVGL_HEAP_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL;
+    const uint32_t second = LVGL_HEAP_PSRAM ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM;
+
+    void *p = heap_caps_malloc(bytes, first | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_malloc(bytes, second | MALLOC_CAP_8BIT);
+    return p;
+}
+
+void *lvgl_heap_large_realloc(void *p, size_t bytes)
+{
+    const uint32_t first = LVGL_HEAP_PSRAM ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL;
+    const uint32_t second = LVGL_HEAP_PSRAM ? MALLOC_CAP_INTERNAL : MALLOC_CAP_SPIRAM;
+
+    // heap_caps_realloc grows in place when it can and leaves p alone on failure
+    void *q = heap_caps_realloc(p, bytes, first | MALLOC_CAP_8BIT);
+    if (!q) q = heap_caps_realloc(p, bytes, second | MALLOC_CAP_8BIT);
+    return q;
+}
+
+// ----------------------------------
+// Counting wraps around LVGL's allocator
+// ----------------------------------
+void *__real_lv_malloc_core(size_t size);
+void *__real_lv_realloc_core(void *p, size_t new_size);
+void __real_lv_free_core(void *p);
+
+void *__wrap_lv_malloc_core(size_t size)
+{
+    void *p = __real_lv_malloc_core(size);
+    s.mallocs++;
+    s.frame_ops++;
+    if (!p) s.failed++;
+    return p;
+}
+
+void *__wrap_lv_realloc_core(void *p, size_t new_size)
+{
+    void *q = __real_lv_realloc_core(p, new_size);
+    s.reallocs++;
+    s.frame_ops++;
+    if (!q && new_size) s.failed++;
+    return q;
+}
+
+void __wrap_lv_free_core(void *p)
+{
+    __real_lv_free_core(p);
+    s.frees++;
+    s.frame_ops++;
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+void lvgl_heap_frame(void)
+{
+    s.frames++;
+    s.last_frame = s.frame_ops;
+    if (s.frame_ops > s.max_per_frame) s.max_per_frame = s.frame_ops;
+    s.frame_ops = 0;
+}
+
+void lvgl_heap_get_stats(lvgl_heap_stats_t *out)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    out->pools = s.pools;
+    out->pool_bytes = s.pool_bytes;
+    out->pool_psram_bytes = s.pool_psram_bytes;
+    out->total = (uint32_t)mon.total_size;
+    out->used = (uint32_t)(mon.total_size - mon.free_size);
+    out->peak = (uint32_t)mon.max_used;
+    out->biggest_free = (uint32_t)mon.free_biggest_size;
+    out->frag_pct = mon.frag_pct;
+    out->blocks = mon.used_cnt;
+    out->frames = s.frames;
+    out->mallocs = s.mallocs;
+    out->reallocs = s.reallocs;
+    out->frees = s.frees;
+    out->failed = s.failed;
+    out->max_per_frame = s.max_per_frame;
+    out->last_frame = s.last_frame;
+}
+
+void lvgl_heap_reset(void)
+{
+    s.frames = 0;
+    s.mallocs = s.reallocs = s.frees = s.failed = 0;
+    s.frame_ops = 0;
+    s.max_per_frame = 0;
+    s.last_frame = 0;
+}
+
+void lvgl_heap_print(void (*emit)(const char *line))
+{
+    lvgl_heap_stats_t st;
+    char line[128];
+
+    lvgl_heap_get_stats(&st);
+    snprintf(line, sizeof(line), "---- lvgl heap: %lu pool(s), %lu KB (%lu KB PSRAM) ----\r\n",
+             (unsigned long)st.pools, (unsigned long)(st.pool_bytes / 1024), (unsigned long)(st.pool_psram_bytes / 1024));
+    emit(line);
+    snprintf(line, sizeof(line), "  used %lu KB of %lu KB (%.0f%%), peak %lu KB, %lu blocks\r\n",
+             (unsigned long)(st.used / 1024), (unsigned long)(st.total / 1024),
+             st.total ? 100.0 * st.used / st.total : 0.0, (unsigned long)(st.peak / 1024), (unsigned long)st.blocks);
+    emit(line);
+    snprintf(line, sizeof(line), "  largest free block %lu KB, fragmentation %u%%\r\n",
+             (unsigned long)(st.biggest_free / 1024), (unsigned)st.frag_pct);
+    emit(line);
+    snprintf(line, sizeof(line), "  %lu frames: %lu malloc, %lu realloc, %lu free, %lu failed\r\n",
+             (unsigned long)st.frames, (unsigned long)st.mallocs, (unsigned long)st.reallocs,
+             (unsigned long)st.frees, (unsigned long)st.failed);
+    emit(line);
+    const uint32_t ops = st.mallocs + st.reallocs + st.frees;
+    snprintf(line, sizeof(line), "  per frame: %.1f avg, %lu max, %lu last\r\n",
+             st.frames ? (double)ops / st.frames : 0.0, (unsigned long)st.max_per_frame, (unsigned long)st.last_frame);
+    emit(line);
+}
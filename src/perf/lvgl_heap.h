@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- LVGL heap monitor ----------
+// LVGL's heap gets its memory from lvgl_heap_pool_alloc(), in PSRAM or
+// internal RAM per LVGL_HEAP_PSRAM (set only in lv_conf.h): the slab arenas
+// of the custom allocator (src/mem/lv_mem_core_slab.c), or with
+// LV_STDLIB_BUILTIN the TLSF pool and its expansions (LV_MEM_POOL_ALLOC in
+// lv_conf.h). lv_malloc/lv_realloc/lv_free are counted
+// through linker wraps (-Wl,--wrap=lv_malloc_core etc. in platformio.ini), and
+// lvgl_heap_frame() closes a frame so the counts can be shown per frame.
+// Call the rest from the LVGL task.
+
+// Pool alignment; slab arenas are carved in pages of this size
+#define LVGL_HEAP_POOL_ALIGN 1024
+
+typedef struct {
+    uint32_t pools;             // slab arenas, or TLSF pool + expansions
+    uint32_t pool_bytes;
+    uint32_t pool_psram_bytes;
+    uint32_t total;             // from lv_mem_monitor()
+    uint32_t used;
+    uint32_t peak;
+    uint32_t biggest_free;
+    uint8_t  frag_pct;
+    uint32_t blocks;            // live allocations
+    // Since the last reset
+    uint32_t frames;
+    uint32_t mallocs, reallocs, frees, failed;
+    uint32_t max_per_frame;     // malloc + realloc + free in the busiest frame
+    uint32_t last_frame;
+} lvgl_heap_stats_t;
+
+// Memory for a slab arena, or LV_MEM_POOL_ALLOC for the TLSF pools
+void *lvgl_heap_pool_alloc(size_t bytes);
+// Blocks too big for the slab heap, same RAM preference as the pools;
+// release with heap_caps_free()
+void *lvgl_heap_large_alloc(size_t bytes);
+void *lvgl_heap_large_realloc(void *p, size_t bytes);
+
+// A frame was rendered: per-frame counts roll over
+void lvgl_heap_frame(void);
+void lvgl_heap_get_stats(lvgl_heap_stats_t *out);
+void lvgl_heap_reset(void);
+// Used / peak / largest free block / fragmentation and per-frame churn
+void lvgl_heap_print(void (*emit)(const char *line));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
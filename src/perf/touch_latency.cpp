@@ -0,0 +1,142 @@
+#include "touch_latency.h"
+
+#include <Arduino.h>
+#include <string.h>
+#include "esp_timer.h"
+
+// ----------------------------------
+// Internal state
+// ----------------------------------
+enum {
+    LEG_INT_READ = 0,   // controller scan + poll delay
+    LEG_READ_DISPATCH,  // LVGL indev processing
+    LEG_DISPATCH_FLUSH, // render + flush of the frame with the response
+    LEG_TOTAL,
+    LEG_COUNT
+};
+
+static const char *const s_leg_names[LEG_COUNT] = {
+    "int->read", "read->event", "event->flush", "total",
+};
+
+typedef struct {
+    uint32_t bucket[TOUCH_LATENCY_BUCKETS + 1];
+    uint32_t count;
+    uint32_t max_us;
+} latency_hist_t;
+
+typedef enum {
+    SAMPLE_IDLE,
+    SAMPLE_READ,        // press read, waiting for a watched control to get it
+    SAMPLE_DISPATCHED,  // waiting for the next flush
+} sample_state_t;
+
+// A press nobody reacts to within this window is dropped
+#define SAMPLE_TIMEOUT_US 500000
+
+static latency_hist_t  s_hist[LEG_COUNT];
+static sample_state_t  s_state = SAMPLE_IDLE;
+static int64_t         s_t_int, s_t_read, s_t_dispatch;
+
+static void hist_add(latency_hist_t *h, int64_t us)
+{
+    if(us < 0) us = 0;
+    uint32_t b = (uint32_t)(us / (TOUCH_LATENCY_BUCKET_MS * 1000));
+    if(b > TOUCH_LATENCY_BUCKETS) b = TOUCH_LATENCY_BUCKETS;
+    h->bucket[b]++;
+    h->count++;
+    if((uint32_t)us > h->max_us) h->max_us = (uint32_t)us;
+}
+
+// Upper edge (ms) of the bucket holding the pct-th percentile
+static uint32_t hist_percentile_ms(const latency_hist_t *h, uint32_t pct)
+{
+    if(!h->count) return 0;
+    const uint32_t want = (h->count * pct + 99) / 100;
+    uint32_t seen = 0;
+    for(uint32_t b = 0; b <= TOUCH_LATENCY_BUCKETS; b++) {
+        seen += h->bucket[b];
+        if(seen >= want) return (b + 1) * TOUCH_LATENCY_BUCKET_MS;
+    }
+    return (TOUCH_LATENCY_BUCKETS + 1) * TOUCH_LATENCY_BUCKET_MS;
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+extern "C" void touch_latency_press(int64_t t_int_us, int64_t t_read_us)
+{
+    // Without an edge (INT not wired / missed) the read is the earliest we know
+    s_t_int  = (t_int_us > 0 && t_int_us <= t_read_us) ? t_int_us : t_read_us;
+    s_t_read = t_read_us;
+    s_state  = SAMPLE_READ;
+}
+
+extern "C" void touch_latency_dispatch(void)
+{
+    if(s_state != SAMPLE_READ) return;
+    s_t_dispatch = esp_timer_get_time();
+    s_state = SAMPLE_DISPATCHED;
+}
+
+extern "C" void touch_latency_flush_done(void)
+{
+    if(s_state == SAMPLE_IDLE) return;
+    const int64_t now = esp_timer_get_time();
+
+    if(s_state == SAMPLE_READ) {
+        if(now - s_t_read > SAMPLE_TIMEOUT_US) s_state = SAMPLE_IDLE;
+        return;
+    }
+
+    hist_add(&s_hist[LEG_INT_READ],       s_t_read - s_t_int);
+    hist_add(&s_hist[LEG_READ_DISPATCH],  s_t_dispatch - s_t_read);
+    hist_add(&s_hist[LEG_DISPATCH_FLUSH], now - s_t_dispatch);
+    hist_add(&s_hist[LEG_TOTAL],          now - s_t_int);
+    s_state = SAMPLE_IDLE;
+}
+
+extern "C" void touch_latency_reset(void)
+{
+    memset(s_hist, 0, sizeof(s_hist));
+    s_state = SAMPLE_IDLE;
+}
+
+extern "C" void touch_latency_print(void)
+{
+    Serial.printf("---- touch-to-photon latency (%lu presses) ----\r\n",
+                  (unsigned long)s_hist[LEG_TOTAL].count);
+    Serial.println("  leg            p50    p90    p99    max  (ms)");
+    for(int i = 0; i < LEG_COUNT; i++) {
+        const latency_hist_t *h = &s_hist[i];
+        Serial.printf("  %-12s  %5lu  %5lu  %5lu  %5.1f\r\n", s_leg_names[i],
+                      (unsigned long)hist_percentile_ms(h, 50),
+                      (unsigned long)hist_percentile_ms(h, 90),
+                      (unsigned long)hist_percentile_ms(h, 99),
+                      h->max_us / 1000.0f);
+    }
+
+    const latency_hist_t *t = &s_hist[LEG_TOTAL];
+    uint32_t peak = 1;
+    for(uint32_t b = 0; b <= TOUCH_LATENCY_BUCKETS; b++) {
+        if(t->bucket[b] > peak) peak = t->bucket[b];
+    }
+    Serial.println("  total histogram:");
+    for(uint32_t b = 0; b <= TOUCH_LATENCY_BUCKETS; b++) {
+        if(!t->bucket[b]) continue;
+        char bar[41];
+        const uint32_t len = (t->bucket[b] * 40 + peak - 1) / peak;
+        memset(bar, '#', len);
+        bar[len] = '\0';
+        if(b < TOUCH_LATENCY_BUCKETS) {
+            Serial.printf("  %3lu-%3lu ms %6lu %s\r\n",
+                          (unsigned long)(b * TOUCH_LATENCY_BUCKET_MS),
+                          (unsigned long)((b + 1) * TOUCH_LATENCY_BUCKET_MS),
+                          (unsigned long)t->bucket[b], bar);
+        } else {
+            Serial.printf("    >%3lu ms %6lu %s\r\n",
+                          (unsigned long)(b * TOUCH_LATENCY_BUCKET_MS),
+                          (unsigned long)t->bucket[b], bar);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- Touch-to-photon latency ----------
+// One sample per press that reaches a watched control:
+//   INT edge -> I2C read done -> LVGL PRESSED dispatch -> flush of the next frame.
+// Each leg and the total go into fixed 2 ms histograms. Call everything from
+// the LVGL task; the INT timestamp comes from the touch driver's ISR.
+
+#define TOUCH_LATENCY_BUCKET_MS  2
+#define TOUCH_LATENCY_BUCKETS    64     // 0..128 ms, plus one overflow bucket
+
+// A read found a finger after a no-touch read. t_int_us is the first INT edge
+// since the previous read (0 if none was seen), t_read_us when the read returned.
+void touch_latency_press(int64_t t_int_us, int64_t t_read_us);
+// LVGL delivered LV_EVENT_PRESSED to a watched control.
+void touch_latency_dispatch(void);
+// The flush callback handed a complete frame to the panel.
+void touch_latency_flush_done(void);
+
+void touch_latency_reset(void);
+// Prints sample count, p50/p90/p99/max per leg and the total histogram.
+void touch_latency_print(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace_ring.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#define TRACE_TICKS_PER_US 1
+
+static inline uint32_t trace_now(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+static inline uint32_t trace_tid(void)
+{
+    return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+}
+
+static void *trace_alloc(size_t bytes)
+{
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+static void trace_free(void *p)
+{
+    heap_caps_free(p);
+}
+#else
+#include <time.h>
+
+/* Host stages take tens of nanoseconds: keep nanoseconds */
+#define TRACE_TICKS_PER_US 1000
+
+static inline uint32_t trace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+static inline uint32_t trace_tid(void)
+{
+    return 1;
+}
+
+static void *trace_alloc(size_t bytes)
+{
+    return malloc(bytes);
+}
+
+static void trace_free(void *p)
+{
+    free(p);
+}
+#endif
+
+#define TRACE_DUMP_TIDS 16      /* threads tracked for nesting in a dump */
+
+volatile bool trace_ring_armed;
+static trace_ring_rec_t *s_ring;
+static uint32_t s_mask;             /* capacity - 1 */
+static uint32_t s_head;             /* slots claimed so far */
+
+bool trace_ring_start(size_t capacity)
+{
+    uint32_t cap = 1;
+
+    while (cap < capacity && cap < 0x80000000u) {
+        cap <<= 1;
+    }
+    trace_ring_armed = false;
+    if (s_ring && s_mask + 1 != cap) {
+        trace_free(s_ring);
+        s_ring = NULL;
+    }
+    if (!s_ring) {
+        s_ring = trace_alloc(cap * sizeof(trace_ring_rec_t));
+        if (!s_ring) {
+            return false;
+        }
+        s_mask = cap - 1;
+    }
+    memset(s_ring, 0, cap * sizeof(trace_ring_rec_t));
+    __atomic_store_n(&s_head, 0, __ATOMIC_RELEASE);
+    trace_ring_armed = true;
+    return true;
+}
+
+void trace_ring_stop(void)
+{
+    trace_ring_armed = false;
+}
+
+void trace_ring_write(const char *tag, char ph)
+{
+    /* Stamp before claiming, so slot order follows time on one core */
+    const uint32_t t = trace_now();
+    const uint32_t idx = __atomic_fetch_add(&s_head, 1, __ATOMIC_RELAXED);
+    trace_ring_rec_t *rec = &s_ring[idx & s_mask];
+
+    /* A reader seeing seq != idx + 1 skips the slot as torn */
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    rec->t = t;
+    rec->tag = tag;
+    rec->tid = trace_tid();
+    rec->ph = ph;
+    __atomic_store_n(&rec->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+/* Open-span depth per thread, so ends whose begin was overwritten are dropped */
+typedef struct {
+    uint32_t tid;
+    int32_t depth;
+} trace_depth_t;
+
+static int32_t *depth_of(trace_depth_t *d, uint32_t tid)
+{
+    for (int i = 0; i < TRACE_DUMP_TIDS; i++) {
+        if (d[i].tid == tid || d[i].tid == 0) {
+            d[i].tid = tid;
+            return &d[i].depth;
+        }
+    }
+    return NULL;
+}
+
+void trace_ring_dump_json(void (*emit)(const char *line))
+{
+    trace_depth_t depth[TRACE_DUMP_TIDS];
+    char line[160];
+    const bool was_armed = trace_ring_armed;
+    bool first = true;
+
+    trace_ring_armed = false;
+    emit("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    if (s_ring) {
+        /* Writers that were already past the armed check finish within a few
+         * instructions; their slots fail the seq check below if still open */
+        const uint32_t head = __atomic_load_n(&s_head, __ATOMIC_ACQUIRE);
+        const uint32_t cap = s_mask + 1;
+        const uint32_t start = head > cap ? head - cap : 0;
+        uint32_t t0 = 0;
+        uint64_t ts = 0;
+        bool have_t0 = false;
+
+        memset(depth, 0, sizeof(depth));
+        for (uint32_t idx = start; idx != head; idx++) {
+            const trace_ring_rec_t *rec = &s_ring[idx & s_mask];
+            if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != idx + 1 || !rec->tag) {
+                continue;
+            }
+            int32_t *d = depth_of(depth, rec->tid);
+            if (!d || (rec->ph == 'E' && *d == 0)) {
+                continue;
+            }
+            *d += rec->ph == 'B' ? 1 : -1;
+
+            /* 32-bit ticks wrap (71 min in us, 4.3 s in ns), so step by deltas.
+             * Two cores can stamp a hair out of slot order: a negative delta
+             * keeps the previous time instead of jumping ahead by a wrap */
+            if (!have_t0) {
+                t0 = rec->t;
+                have_t0 = true;
+            }
+            const int32_t dt = (int32_t)(rec->t - t0);
+            if (dt > 0) {
+                ts += (uint32_t)dt;
+                t0 = rec->t;
+            }
+
+            int n = snprintf(line, sizeof(line), "%s{\"name\":\"", first ? "" : ",\n");
+            for (const char *s = rec->tag; *s && n < (int)sizeof(line) - 64; s++) {
+                line[n++] = (*s == '"' || *s == '\\') ? '_' : *s;
+            }
+            snprintf(line + n, sizeof(line) - n, "\",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%lu}",
+                     rec->ph, (unsigned long long)(ts / TRACE_TICKS_PER_US),
+                     (unsigned)(ts % TRACE_TICKS_PER_US * 1000 / TRACE_TICKS_PER_US), (unsigned long)rec->tid);
+            emit(line);
+            first = false;
+        }
+    }
+    emit("\n]}\n");
+    trace_ring_armed = was_armed;
+}
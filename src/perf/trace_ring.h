@@ -0,0 +1,62 @@
+#ifndef _TRACE_RING_H
+#define _TRACE_RING_H
+
+/*
+ * Begin/end trace events in a lock-free RAM ring, dumped as Chrome trace JSON
+ * (chrome://tracing, ui.perfetto.dev). LVGL's profiler hooks point here (see
+ * LV_USE_PROFILER in lv_conf.h) and our own code uses the same macros, so one
+ * timeline shows LVGL's refresh, layout and draw next to the flush, the touch
+ * read and the point-ID algorithm.
+ *
+ * Writers on any task or core claim a slot with one atomic add and publish it
+ * with a release store; nothing blocks. When the ring is full the oldest
+ * events are overwritten. Disarmed, an event costs one load and a branch.
+ * Builds with ESP_PLATFORM use esp_timer and the FreeRTOS task as thread id;
+ * host builds (tools/gsl_replay) use CLOCK_MONOTONIC in nanoseconds and a
+ * single thread.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t seq;               /* slot index + 1 once complete, 0 while written */
+    uint32_t t;                 /* us on the device, ns on the host */
+    const char *tag;            /* must outlive the dump: literals, __func__ */
+    uint32_t tid;
+    char ph;                    /* 'B' or 'E' */
+} trace_ring_rec_t;
+
+extern volatile bool trace_ring_armed;
+
+/*
+ * Allocate (or reuse) a ring of `capacity` events, rounded up to a power of
+ * two, and start recording. false if out of memory.
+ */
+bool trace_ring_start(size_t capacity);
+/* Stop recording; events are kept until the next start */
+void trace_ring_stop(void);
+
+void trace_ring_write(const char *tag, char ph);
+
+/*
+ * Write the recorded events, oldest first, as one Chrome trace JSON object,
+ * a line per call of `emit`. Stops recording while it runs and resumes after.
+ */
+void trace_ring_dump_json(void (*emit)(const char *line));
+
+#define TRACE_RING_BEGIN_TAG(tag)   do { if (trace_ring_armed) trace_ring_write((tag), 'B'); } while (0)
+#define TRACE_RING_END_TAG(tag)     do { if (trace_ring_armed) trace_ring_write((tag), 'E'); } while (0)
+#define TRACE_RING_BEGIN            TRACE_RING_BEGIN_TAG(__func__)
+#define TRACE_RING_END              TRACE_RING_END_TAG(__func__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
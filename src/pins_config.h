@@ -5,6 +5,29 @@
 #define LCD_H_RES 800
 #define LCD_V_RES 1280
 
+// UI orientation in quarter turns clockwise from the portrait panel
+// (e.g. -DLCD_ROTATION=1 for a landscape mount). LVGL renders at UI_H_RES x
+// UI_V_RES and the flush rotates into the panel framebuffer; touch gets the
+// same rotation.
+#ifndef LCD_ROTATION
+#define LCD_ROTATION 0
+#endif
+
+#if LCD_ROTATION & 1
+#define UI_H_RES LCD_V_RES
+#define UI_V_RES LCD_H_RES
+#else
+#define UI_H_RES LCD_H_RES
+#define UI_V_RES LCD_V_RES
+#endif
+
+// -DLCD_FLUSH_SKIP_TILES=1 copies only the DIRTY_TILES_W x DIRTY_TILES_H
+// tiles LVGL invalidated since the last flush out of each full frame
+// (lcd/dirty_tiles.h). Off until `F` shows the saving on the panel.
+#ifndef LCD_FLUSH_SKIP_TILES
+#define LCD_FLUSH_SKIP_TILES 0
+#endif
+
 #define LCD_RST 27
 #define LCD_LED 23
 
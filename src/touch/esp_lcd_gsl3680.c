@@ -6,12 +6,16 @@
 #include "esp_err.h"
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "driver/i2c_master.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_touch.h"
 #include "esp_lcd_gsl3680.h"
 #include "gsl_point_id.h"
+#include "gsl3680_report.h"
+#include "gsl3680_trace.h"
 
 #define TAG "gsl3680"
 
@@ -21,118 +25,38 @@
 /* gsl3680 support key num */
 #define ESP_gsl3680_TOUCH_MAX_BUTTONS         (9)
 
+/* Marks s_fw_tag as written by a previous successful firmware load ("GSLF") */
+#define GSL3680_FW_TAG_MAGIC                  (0x47534c46)
 
-unsigned int gsl_config_data_id[] =
-{
-	0xccb69a,  
-	0x200,
-	0,0,
-	0,
-	0,0,0,
-	0,0,0,0,0,0,0,0x1cc86fd6,
-
-
-	0x40000d00,0xa,0xe001a,0xe001a,0x3200500,0,0x5100,0x8e00,
-	0,0x320014,0,0x14,0,0,0,0,
-	0x8,0x4000,0x1000,0x10170002,0x10110000,0,0,0x4040404,
-	0x1b6db688,0x64,0xb3000f,0xad0019,0xa60023,0xa0002d,0xb3000f,0xad0019,
-	0xa60023,0xa0002d,0xb3000f,0xad0019,0xa60023,0xa0002d,0xb3000f,0xad0019,
-	0xa60023,0xa0002d,0x804000,0x90040,0x90001,0,0,0,
-	0,0,0,0x14012c,0xa003c,0xa0078,0x400,0x1081,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-
-	0,//key_map
-	0x3200384,0x64,0x503e8,//0
-	0,0,0,//1
-	0,0,0,//2
-	0,0,0,//3
-	0,0,0,//4
-	0,0,0,//5
-	0,0,0,//6
-	0,0,0,//7
-
-	0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-
-
-	0x220,
-	0,0,0,0,0,0,0,0,
-	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
-	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
-	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
-	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
-
-	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
-	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
-
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-
-	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
-	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
-
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,
-
-
-	0x3,
-	0x101,0,0x100,0,
-	0x20,0x10,0x8,0x4,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-
-	0x4,0,0,0,0,0,0,0,
-	0x3800680,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,
-};
-
-
-
-static TG_STATE_E tpc_gesture_id = TG_UNKNOWN_STATE;
-static XY_DATA_T XY_Coordinate[MAX_FINGER_NUM]={0};
-esp_lcd_touch_handle_t esp_lcd_touch_gsl3680;
-
-static uint8_t Finger_num = 0;
-static TP_STATE_E tp_event = TP_PEN_NONE;
-static uint8_t pre_pen_flag = 0;
-static uint32_t pre_distance=0;
-static uint32_t distance_flag = 0;
-static uint16_t x_new = 0;
-static uint16_t y_new = 0;
-static uint16_t x_start = 0 , y_start = 0;
-static uint8_t zoomOutDebounce = 0;
-static uint8_t zoomInDebounce = 0;
+/* Per-controller driver state; `base` must stay first so the touch handle casts to it */
+typedef struct {
+    esp_lcd_touch_t base;
+    struct gsl_alg_ctx *alg;        /* point-ID algorithm state, internal RAM */
+
+    TG_STATE_E tpc_gesture_id;
+    XY_DATA_T XY_Coordinate[MAX_FINGER_NUM];
+    uint8_t Finger_num;
+    uint32_t pre_distance;
+    uint32_t distance_flag;
+    uint8_t zoomOutDebounce;
+    uint8_t zoomInDebounce;
+    TG_STATE_E gesture_pending;     /* latched zoom until esp_lcd_touch_gsl3680_take_gesture() */
+
+    gsl3680_pen_t pen;              /* _Get_Cal_msg() pen tracking */
+
+    uint8_t read_points;            /* points fetched by the next report read */
+    uint32_t mask_last;             /* frequency-hop mask of the previous report */
+    esp_lcd_touch_gsl3680_bus_stats_t bus;
+} gsl3680_dev_t;
+
+#define GSL3680_DEV(tp) ((gsl3680_dev_t *)(tp))
+
+/* Survives software resets (not power-on): which firmware image was last loaded into the controller */
+typedef struct {
+    uint32_t magic;
+    uint32_t fw_crc;
+} gsl3680_fw_tag_t;
+static RTC_NOINIT_ATTR gsl3680_fw_tag_t s_fw_tag;
 
 static esp_err_t esp_lcd_touch_gsl3680_read_data(esp_lcd_touch_handle_t tp);
 static bool esp_lcd_touch_gsl3680_get_xy(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num);
@@ -158,19 +82,26 @@ static esp_err_t esp_lcd_touch_gsl3680_read_ram_fw(esp_lcd_touch_handle_t tp);
 static esp_err_t esp_lcd_touch_gsl3680_load_fw(esp_lcd_touch_handle_t tp);
 static esp_err_t esp_lcd_touch_gsl3680_clear_reg(esp_lcd_touch_handle_t tp);
 static esp_err_t esp_lcd_touch_gsl3680_init(esp_lcd_touch_handle_t tp);
-static TP_STATE_E _Get_Cal_msg(void);
+static uint32_t gsl3680_fw_checksum(void);
+static TP_STATE_E _Get_Cal_msg(gsl3680_dev_t *dev);
 
 esp_err_t esp_lcd_touch_new_i2c_gsl3680(esp_lcd_panel_io_handle_t io, const esp_lcd_touch_config_t *config, esp_lcd_touch_handle_t *out_touch)
 {
-     esp_err_t ret = ESP_OK;
+    esp_err_t ret = ESP_OK;
+    esp_lcd_touch_handle_t esp_lcd_touch_gsl3680 = NULL;
 
     assert(io != NULL);
     assert(config != NULL);
     assert(out_touch != NULL);
 
     /* Prepare main structure */
-    esp_lcd_touch_gsl3680 = heap_caps_calloc(1, sizeof(esp_lcd_touch_t), MALLOC_CAP_DEFAULT);
-    ESP_GOTO_ON_FALSE(esp_lcd_touch_gsl3680, ESP_ERR_NO_MEM, err, TAG, "no mem for GSL3680 controller");
+    gsl3680_dev_t *dev = heap_caps_calloc(1, sizeof(gsl3680_dev_t), MALLOC_CAP_DEFAULT);
+    ESP_GOTO_ON_FALSE(dev, ESP_ERR_NO_MEM, err, TAG, "no mem for GSL3680 controller");
+    esp_lcd_touch_gsl3680 = &dev->base;
+    dev->tpc_gesture_id = TG_UNKNOWN_STATE;
+    dev->gesture_pending = TG_NO_DETECT;
+    dev->pen.tp_event = TP_PEN_NONE;
+    dev->read_points = gsl3680_report_next_points(0);
 
     /* Communication interface */
     esp_lcd_touch_gsl3680->io = io;
@@ -192,6 +123,10 @@ esp_err_t esp_lcd_touch_new_i2c_gsl3680(esp_lcd_panel_io_handle_t io, const esp_
     memcpy(&esp_lcd_touch_gsl3680->config, config, sizeof(esp_lcd_touch_config_t));
     //esp_lcd_touch_io_gsl3680_config_t *gsl3680_config = (esp_lcd_touch_io_gsl3680_config_t *)esp_lcd_touch_gsl3680->config.driver_data;
 
+    /* Algorithm state is touched on every read: keep it in internal RAM */
+    dev->alg = heap_caps_malloc(gsl_alg_ctx_size(), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_GOTO_ON_FALSE(dev->alg, ESP_ERR_NO_MEM, err, TAG, "no mem for GSL3680 algorithm state");
+
     /* Prepare pin for touch controller reset */
     if (esp_lcd_touch_gsl3680->config.rst_gpio_num != GPIO_NUM_NC) {
         const gpio_config_t rst_gpio_config = {
@@ -243,8 +178,7 @@ esp_err_t esp_lcd_touch_new_i2c_gsl3680(esp_lcd_panel_io_handle_t io, const esp_
     /* Read status and config info */
     ESP_LOGI(TAG,"init gls3680");
     touch_gsl3680_read_cfg(esp_lcd_touch_gsl3680);
-    esp_lcd_touch_gsl3680_init(esp_lcd_touch_gsl3680);
-    ret = esp_lcd_touch_gsl3680_read_ram_fw(esp_lcd_touch_gsl3680);
+    ret = esp_lcd_touch_gsl3680_init(esp_lcd_touch_gsl3680);
     // touch_gsl3680_read_cfg(esp_lcd_touch_gsl3680);
 
     /* Prepare pin for touch interrupt */
@@ -262,6 +196,9 @@ esp_err_t esp_lcd_touch_new_i2c_gsl3680(esp_lcd_panel_io_handle_t io, const esp_
             esp_lcd_touch_register_interrupt_callback(esp_lcd_touch_gsl3680, esp_lcd_touch_gsl3680->config.interrupt_callback);
         }
     }
+
+    /* Bus counters cover runtime traffic, not the firmware download */
+    esp_lcd_touch_gsl3680_reset_bus_stats(esp_lcd_touch_gsl3680);
  
 err:
     if (ret != ESP_OK) {
@@ -304,13 +241,13 @@ static esp_err_t esp_lcd_touch_gsl3680_exit_sleep(esp_lcd_touch_handle_t tp)
 static esp_err_t esp_lcd_touch_gsl3680_read_data(esp_lcd_touch_handle_t tp)
 {
     esp_err_t err;
-    uint8_t touch_data[24];
-    uint8_t touch_cnt = 0;
-    uint16_t x_poit, y_poit, x2_poit, y2_poit;
-	uint16_t  distance = 0, chazhi = 0;
+    uint8_t touch_data[GSL3680_REPORT_LEN];
+    uint32_t distance = 0;
+    int32_t chazhi = 0;
     size_t i = 0;
 
     assert(tp != NULL);
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
 
 // #ifdef USE_GSL_NOID_VERSION
     struct gsl_touch_info cinfo = {0};
@@ -318,111 +255,122 @@ static esp_err_t esp_lcd_touch_gsl3680_read_data(esp_lcd_touch_handle_t tp)
     uint8_t buf[4] = {0};
 // #endif
 
-    memset(XY_Coordinate,0,sizeof(XY_Coordinate));
-
-    err = touch_gsl3680_i2c_read(tp, ESP_LCD_TOUCH_GSL3680_READ_XY_REG, touch_data, 24);
-    Finger_num = touch_data[0];
+    /*
+     * Only the header and the points expected from the last report are read
+     * (a 0-finger poll moves 8 bytes instead of 24). If more fingers turned up,
+     * the whole report is read again so header and points come from one frame.
+     * Bytes not read stay zero; the algorithm ignores points past the count.
+     */
+    memset(touch_data, 0, sizeof(touch_data));
+    err = touch_gsl3680_i2c_read(tp, ESP_LCD_TOUCH_GSL3680_READ_XY_REG, touch_data,
+                                 GSL3680_REPORT_BYTES(dev->read_points));
+    if (err == ESP_OK && gsl3680_report_points(touch_data) > dev->read_points) {
+        dev->bus.rereads++;
+        err = touch_gsl3680_i2c_read(tp, ESP_LCD_TOUCH_GSL3680_READ_XY_REG, touch_data, GSL3680_REPORT_LEN);
+    }
+    if (err == ESP_OK) {
+        dev->read_points = gsl3680_report_next_points(gsl3680_report_points(touch_data));
+        gsl3680_trace_record(touch_data);
+    } else {
+        memset(touch_data, 0, sizeof(touch_data));
+        dev->read_points = GSL3680_REPORT_MAX_POINTS;
+    }
     // ESP_LOGI(TAG,"0x80 = %d",touch_data[0]);
 
-    x_poit = ((touch_data[7]&0x0f)<<8 )|touch_data[6];
-	y_poit = (touch_data[5]<<8)|touch_data[4];
-	x2_poit = ((touch_data[11]&0x0f)<<8 )|touch_data[10];
-	y2_poit = (touch_data[9]<<8)|touch_data[8];
-
 // #ifdef USE_GSL_NOID_VERSION
-			cinfo.finger_num = Finger_num;	
-			cinfo.x[0] = x_poit;
-			cinfo.y[0] = y_poit;
-			cinfo.id[0] = ((touch_data[7]&0xf0)>>4);
-			cinfo.x[1] = x2_poit;
-			cinfo.y[1] = y2_poit;
-			cinfo.id[1] = ((touch_data[11]&0xf0)>>4);
-			cinfo.finger_num = (touch_data[3]<<24)|(touch_data[2]<<16)|
-				(touch_data[1]<<8)|touch_data[0];
-			
-			gsl_alg_id_main(&cinfo);
-			tmp1=gsl_mask_tiaoping();
+			gsl3680_report_decode(touch_data, &cinfo);
+			gsl_alg_ctx_id_main(dev->alg, &cinfo);
+			tmp1=gsl_alg_ctx_mask_tiaoping(dev->alg);
 			//SCI_TRACE_LOW("[tp-gsl] tmp1=%x\n", tmp1);
-			if(tmp1>0&&tmp1<0xffffffff)
+			/* The mask stays latched across reports; write it once per change */
+			if(gsl3680_mask_due(&dev->mask_last, tmp1))
 			{
 				uint8 addr = 0xf0;
 				buf[0]=0xa;buf[1]=0;buf[2]=0;buf[3]=0;
-				touch_gsl3680_i2c_write(tp,addr, buf, 4);
+				err = touch_gsl3680_i2c_write(tp,addr, buf, 4);
 				addr = 0x8;
 				buf[0]=(uint8)(tmp1 & 0xff);
 				buf[1]=(uint8)((tmp1>>8) & 0xff);
 				buf[2]=(uint8)((tmp1>>16) & 0xff);
 				buf[3]=(uint8)((tmp1>>24) & 0xff);
 				//SCI_TRACE_LOW("tmp1=%08x,buf[0]=%02x,buf[1]=%02x,buf[2]=%02x,buf[3]=%02x\n", tmp1,buf[0],buf[1],buf[2],buf[3]);
-				touch_gsl3680_i2c_write(tp,addr, buf, 4);
+				if (err == ESP_OK) {
+					err = touch_gsl3680_i2c_write(tp,addr, buf, 4);
+				}
+				if (err == ESP_OK) {
+					dev->bus.mask_writes++;
+				} else {
+					dev->mask_last = 0;     /* retry while it stays latched */
+				}
+			}
+			else if(tmp1>0&&tmp1<0xffffffff)
+			{
+				dev->bus.mask_skipped++;
 			}
-			Finger_num = cinfo.finger_num;	
 // #endif
 
+    /* Publish every tracked point; the algorithm reports them compacted from index 0 */
+    uint8_t fingers = (uint8_t)cinfo.finger_num;
+    if (fingers > MAX_FINGER_NUM) {
+        fingers = MAX_FINGER_NUM;
+    }
+    portENTER_CRITICAL(&tp->data.lock);
+    dev->Finger_num = fingers;
+    memset(dev->XY_Coordinate, 0, sizeof(dev->XY_Coordinate));
+    for (i = 0; i < fingers; i++) {
+        dev->XY_Coordinate[i].x_position = cinfo.x[i];
+        dev->XY_Coordinate[i].y_position = cinfo.y[i];
+        dev->XY_Coordinate[i].finger_id = cinfo.id[i];
+    }
+    portEXIT_CRITICAL(&tp->data.lock);
 
-// #ifdef USE_GSL_NOID_VERSION
-			XY_Coordinate[0].x_position =  cinfo.x[0];
-			XY_Coordinate[0].y_position =  cinfo.y[0];
-			XY_Coordinate[0].finger_id = cinfo.id[0];
-			XY_Coordinate[1].x_position =  cinfo.x[1];
-			XY_Coordinate[1].y_position =  cinfo.y[1];
-			XY_Coordinate[1].finger_id = cinfo.id[1];
-// #else
-// 			XY_Coordinate[0].x_position = x_poit;
-// 			XY_Coordinate[0].y_position = y_poit;
-// 			XY_Coordinate[1].x_position = x2_poit;
-// 			XY_Coordinate[1].y_position = y2_poit;
-// #endif
-    // i=0;
-    // if(Finger_num >0)
-    // printf("%s: %d[i], %d[x_position], %d[y_position], %d[finger_id], %d[finger_num]\n",
-    //       __func__, i, XY_Coordinate[i].x_position, XY_Coordinate[i].y_position, XY_Coordinate[i].finger_id,Finger_num);
-    // i=1;
-    // printf("%s: %d[i], %d[x_position], %d[y_position], %d[finger_id], %d[finger_num]\n",
-    //       __func__, i, XY_Coordinate[i].x_position, XY_Coordinate[i].y_position, XY_Coordinate[i].finger_id,Finger_num);
-    
-    if(Finger_num > 1)
+    /* Pinch: squared distance between the first two tracked points, debounced */
+    if(fingers > 1)
 	{
-		distance_flag ++;
-		distance = (x_poit-x2_poit)*(x_poit-x2_poit) + (y_poit-y2_poit)*(y_poit-y2_poit);
-		chazhi = distance - pre_distance;
-		if(distance_flag >= 3)
+		int32_t dx = (int32_t)cinfo.x[0] - cinfo.x[1];
+		int32_t dy = (int32_t)cinfo.y[0] - cinfo.y[1];
+		dev->distance_flag ++;
+		distance = (uint32_t)(dx * dx + dy * dy);
+		chazhi = (int32_t)(distance - dev->pre_distance);
+		if(dev->distance_flag >= 3)
 		{
 			if( chazhi > 900 )
 			{
-				zoomOutDebounce = 0;
-				zoomInDebounce ++;
-				if(zoomInDebounce > 3)
+				dev->zoomOutDebounce = 0;
+				dev->zoomInDebounce ++;
+				if(dev->zoomInDebounce > 3)
 				{
-					tpc_gesture_id = TG_ZOOM_IN;
-					zoomInDebounce = 0;
+					dev->tpc_gesture_id = TG_ZOOM_IN;
+					dev->gesture_pending = TG_ZOOM_IN;
+					dev->zoomInDebounce = 0;
 				}
 			}
 			else if( chazhi < -900 )
 			{
-				zoomInDebounce = 0;
-				zoomOutDebounce ++;
-				if(zoomOutDebounce > 3)
+				dev->zoomInDebounce = 0;
+				dev->zoomOutDebounce ++;
+				if(dev->zoomOutDebounce > 3)
 				{
-					tpc_gesture_id = TG_ZOOM_OUT;
-					zoomOutDebounce = 0;
+					dev->tpc_gesture_id = TG_ZOOM_OUT;
+					dev->gesture_pending = TG_ZOOM_OUT;
+					dev->zoomOutDebounce = 0;
 				}
 			}
 			else
 			{
-				tpc_gesture_id = TG_NO_DETECT;
+				dev->tpc_gesture_id = TG_NO_DETECT;
 			}
 		}
 
-		pre_distance = distance;
+		dev->pre_distance = distance;
 		}
 	else
 		{
-		tpc_gesture_id = TG_NO_DETECT;
-		distance_flag = 0;
-		pre_distance = 0;
-		zoomInDebounce = 0;
-		zoomOutDebounce = 0;
+		dev->tpc_gesture_id = TG_NO_DETECT;
+		dev->distance_flag = 0;
+		dev->pre_distance = 0;
+		dev->zoomInDebounce = 0;
+		dev->zoomOutDebounce = 0;
 	}
     
     return ESP_OK;
@@ -435,23 +383,18 @@ static bool esp_lcd_touch_gsl3680_get_xy(esp_lcd_touch_handle_t tp, uint16_t *x,
     assert(y != NULL);
     assert(point_num != NULL);
     assert(max_point_num > 0);
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
 
     portENTER_CRITICAL(&tp->data.lock);
 
-    *point_num = Finger_num;
-    x[0] = XY_Coordinate[0].x_position;
-    y[0] = XY_Coordinate[0].y_position;
-
-    if(Finger_num > 1)
-    {
-        for(int i=1;i<Finger_num;i++)
-        {
-            x[i-1] = XY_Coordinate[i].x_position;
-            y[i-1] = XY_Coordinate[i].y_position;
-            // strength[i] = XY_Coordinate[i].finger_id;
+    *point_num = (dev->Finger_num < max_point_num) ? dev->Finger_num : max_point_num;
+    for (int i = 0; i < *point_num; i++) {
+        x[i] = dev->XY_Coordinate[i].x_position;
+        y[i] = dev->XY_Coordinate[i].y_position;
+        if (strength) {
+            strength[i] = 0;    /* the GSL3680 does not report pressure */
         }
     }
-    
 
     portEXIT_CRITICAL(&tp->data.lock);
 
@@ -498,6 +441,7 @@ static esp_err_t esp_lcd_touch_gsl3680_del(esp_lcd_touch_handle_t tp)
         gpio_reset_pin(tp->config.rst_gpio_num);
     }
 
+    free(GSL3680_DEV(tp)->alg);
     free(tp);
 
     return ESP_OK;
@@ -506,7 +450,28 @@ static esp_err_t esp_lcd_touch_gsl3680_del(esp_lcd_touch_handle_t tp)
 /*===================================================================================================================================================================================================*/
 static esp_err_t esp_lcd_touch_gsl3680_init(esp_lcd_touch_handle_t tp)
 {
+    esp_err_t ret;
+    const int64_t t_start = esp_timer_get_time();
+    const uint32_t fw_crc = gsl3680_fw_checksum();
+
     ESP_LOGI(TAG,"start init");
+
+    /* Power-on reset: the controller lost its RAM too, the tag is garbage */
+    if (esp_reset_reason() == ESP_RST_POWERON) {
+        s_fw_tag.magic = 0;
+    }
+
+    /* Warm start: our image is still resident and running, only the host side needs restarting */
+    if (s_fw_tag.magic == GSL3680_FW_TAG_MAGIC && s_fw_tag.fw_crc == fw_crc &&
+        esp_lcd_touch_gsl3680_read_ram_fw(tp) == ESP_OK) {
+        esp_lcd_touch_gsl3680_startup_chip(tp);
+        ESP_LOGI(TAG,"warm start: fw %08lx resident, init took %lld ms",
+                 (unsigned long)fw_crc, (esp_timer_get_time() - t_start) / 1000);
+        return ESP_OK;
+    }
+
+    /* Cold start: full firmware download */
+    s_fw_tag.magic = 0;
     esp_lcd_touch_gsl3680_clear_reg(tp);
     touch_gsl3680_reset(tp);
     esp_lcd_touch_gsl3680_load_fw(tp);
@@ -514,7 +479,43 @@ static esp_err_t esp_lcd_touch_gsl3680_init(esp_lcd_touch_handle_t tp)
     touch_gsl3680_reset(tp);
     esp_lcd_touch_gsl3680_startup_chip(tp);
 
-    return ESP_OK;
+    ret = esp_lcd_touch_gsl3680_read_ram_fw(tp);
+    if (ret == ESP_OK) {
+        s_fw_tag.fw_crc = fw_crc;
+        s_fw_tag.magic = GSL3680_FW_TAG_MAGIC;
+    }
+    ESP_LOGI(TAG,"cold start: fw %08lx %s, init took %lld ms",
+             (unsigned long)fw_crc, (ret == ESP_OK) ? "loaded" : "NOT verified",
+             (esp_timer_get_time() - t_start) / 1000);
+
+    return ret;
+}
+
+static uint32_t gsl3680_fw_checksum(void)
+{
+    /* FNV-1a over the image table; computed once, the table is const */
+    static uint32_t crc = 0;
+    if (crc != 0) {
+        return crc;
+    }
+
+    uint32_t h = 0x811c9dc5;
+    const size_t source_len = sizeof(GSLX680_FW) / sizeof(struct fw_data);
+    for (size_t i = 0; i < source_len; i++) {
+        const uint8_t rec[5] = {
+            (uint8_t)GSLX680_FW[i].offset,
+            (uint8_t)(GSLX680_FW[i].val & 0xff),
+            (uint8_t)((GSLX680_FW[i].val >> 8) & 0xff),
+            (uint8_t)((GSLX680_FW[i].val >> 16) & 0xff),
+            (uint8_t)((GSLX680_FW[i].val >> 24) & 0xff),
+        };
+        for (size_t k = 0; k < sizeof(rec); k++) {
+            h ^= rec[k];
+            h *= 0x01000193;
+        }
+    }
+    crc = (h != 0) ? h : 1;
+    return crc;
 }
 
 
@@ -594,7 +595,7 @@ static esp_err_t esp_lcd_touch_gsl3680_startup_chip(esp_lcd_touch_handle_t tp)
     ESP_RETURN_ON_ERROR(touch_gsl3680_i2c_write(tp,addr,write_buf,1),TAG,"gsl3680 read error");
     vTaskDelay(pdMS_TO_TICKS(10));
 
-    gsl_DataInit(gsl_config_data_id);
+    gsl_alg_ctx_init(GSL3680_DEV(tp)->alg, gsl_config_data_id);
     return ret;
 }
 
@@ -614,25 +615,68 @@ static esp_err_t esp_lcd_touch_gsl3680_read_ram_fw(esp_lcd_touch_handle_t tp)
     return ESP_OK;
 }
 
+void esp_lcd_touch_gsl3680_get_bus_stats(esp_lcd_touch_handle_t tp, esp_lcd_touch_gsl3680_bus_stats_t *stats)
+{
+    assert(tp != NULL);
+    assert(stats != NULL);
+
+    portENTER_CRITICAL(&tp->data.lock);
+    *stats = GSL3680_DEV(tp)->bus;
+    portEXIT_CRITICAL(&tp->data.lock);
+}
+
+void esp_lcd_touch_gsl3680_reset_bus_stats(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
+
+    portENTER_CRITICAL(&tp->data.lock);
+    memset(&dev->bus, 0, sizeof(dev->bus));
+    dev->bus.since_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&tp->data.lock);
+}
+
+/* Counters are only written from the reading task; readers copy under the lock */
+static void touch_gsl3680_bus_account(esp_lcd_touch_handle_t tp, bool write, uint8_t len, int64_t t0, esp_err_t err)
+{
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
+    const int64_t dt = esp_timer_get_time() - t0;
+
+    portENTER_CRITICAL(&tp->data.lock);
+    if (write) {
+        dev->bus.writes++;
+    } else {
+        dev->bus.reads++;
+    }
+    if (err != ESP_OK) {
+        dev->bus.errors++;
+    }
+    dev->bus.bytes += len;
+    dev->bus.busy_us += dt;
+    portEXIT_CRITICAL(&tp->data.lock);
+}
+
 static esp_err_t touch_gsl3680_i2c_read(esp_lcd_touch_handle_t tp, uint16_t reg, uint8_t *data, uint8_t len)
 {
     assert(tp != NULL);
     assert(data != NULL);
 
-
     /* Read data */
-    return esp_lcd_panel_io_rx_param(tp->io, reg, data, len);
-  
+    const int64_t t0 = esp_timer_get_time();
+    const esp_err_t err = esp_lcd_panel_io_rx_param(tp->io, reg, data, len);
+    touch_gsl3680_bus_account(tp, false, len, t0, err);
+    return err;
 }
 
 static esp_err_t touch_gsl3680_i2c_write(esp_lcd_touch_handle_t tp, uint16_t reg, uint8_t *data,uint8_t len)
 {
     assert(tp != NULL);
 
-    // *INDENT-OFF*
-    // /* Write data */
-    return esp_lcd_panel_io_tx_param(tp->io, reg, data, len);
-    // // *INDENT-ON*
+    /* Write data */
+    const int64_t t0 = esp_timer_get_time();
+    const esp_err_t err = esp_lcd_panel_io_tx_param(tp->io, reg, data, len);
+    touch_gsl3680_bus_account(tp, true, len, t0, err);
+    return err;
 }
 
 static esp_err_t esp_lcd_touch_gsl3680_load_fw(esp_lcd_touch_handle_t tp)
@@ -686,71 +730,39 @@ static esp_err_t esp_lcd_touch_gsl3680_clear_reg(esp_lcd_touch_handle_t tp)
     return ESP_OK;
 }
 
-static TP_STATE_E _Get_Cal_msg(void)
+uint8_t esp_lcd_touch_gsl3680_get_track_ids(esp_lcd_touch_handle_t tp, uint8_t *ids, uint8_t max_point_num)
 {
-    uint8 pen_flag = 0;
-	uint16 x_poit, y_poit, x2_poit, y2_poit;
-	int32 x_delta = 0 , y_delta = 0;
+    assert(tp != NULL);
+    assert(ids != NULL);
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
+    uint8_t n;
 
-	pen_flag = Finger_num;
-	x_poit = XY_Coordinate[0].x_position;
-	y_poit = XY_Coordinate[0].y_position;
-	x2_poit = XY_Coordinate[1].x_position;
-	y2_poit = XY_Coordinate[1].y_position;
+    portENTER_CRITICAL(&tp->data.lock);
+    n = (dev->Finger_num < max_point_num) ? dev->Finger_num : max_point_num;
+    for (uint8_t i = 0; i < n; i++) {
+        ids[i] = dev->XY_Coordinate[i].finger_id;
+    }
+    portEXIT_CRITICAL(&tp->data.lock);
 
-	if(pen_flag==0)
-	{
-		if(tp_event == TP_PEN_MOVE)//the last event=move
-		{
-			x_new = x_poit;
-			y_new = y_poit;
-		}
-		else//the last event=down
-		{
-			x_new = x_start;
-			y_new = y_start;
-		}
+    return n;
+}
 
-		tp_event = TP_PEN_UP;
-	}
-	else if(pen_flag==2)
-	{
-		tp_event = TP_PEN_DOWN;
-		x_start = x_poit;
-		y_start = y_poit;
-		x_new = x_poit;
-		y_new = y_poit;
-	}
-	else if(pre_pen_flag!=1)//pen_flag=1,pre_pen_flag==0 or 2
-	{
-		tp_event = TP_PEN_DOWN;
-		x_start = x_poit;
-		y_start = y_poit;
-		x_new = x_poit;
-		y_new = y_poit;
-	 }
-	else// if((pen_flag==1)&&(pre_pen_flag==1))
-	{
-		x_delta = x_poit - x_start;
-		y_delta = y_poit - y_start;
-		if((x_delta>20)||(x_delta<-20)||(y_delta>25)||(y_delta<-25))
-		{
-			tp_event = TP_PEN_MOVE;
-		}
+TG_STATE_E esp_lcd_touch_gsl3680_take_gesture(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+    gsl3680_dev_t *dev = GSL3680_DEV(tp);
+    TG_STATE_E g;
 
-		if(tp_event == TP_PEN_MOVE)
-		{
-			x_new = x_poit;
-			y_new = y_poit;
-		}
-		else
-		{
-			x_new = x_start;
-			y_new = y_start;
-		}
+    portENTER_CRITICAL(&tp->data.lock);
+    g = dev->gesture_pending;
+    dev->gesture_pending = TG_NO_DETECT;
+    portEXIT_CRITICAL(&tp->data.lock);
 
-	 }
+    return g;
+}
 
-	pre_pen_flag = pen_flag;
-	return tp_event;
+static TP_STATE_E _Get_Cal_msg(gsl3680_dev_t *dev)
+{
+    return gsl3680_pen_update(&dev->pen, dev->Finger_num,
+                              dev->XY_Coordinate[0].x_position, dev->XY_Coordinate[0].y_position);
 }
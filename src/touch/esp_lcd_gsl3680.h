@@ -2,16 +2,12 @@
 #define _LCD_GSL3680_H
 
 #include "esp_lcd_touch.h"
+#include "gsl3680_report.h"
 
 
-#define MAX_FINGER_NUM      3
+#define MAX_FINGER_NUM      GSL3680_REPORT_MAX_POINTS
 #define TP_MULTI_SUCCESS    0
 
-#define TP_PEN_NONE         0
-#define TP_PEN_MOVE         1
-#define TP_PEN_UP           2
-#define TP_PEN_DOWN         3
-
 #define TG_NO_DETECT        0
 #define TG_ZOOM_IN          1
 #define TG_ZOOM_OUT         2
@@ -59,6 +55,28 @@ typedef struct _TPDSVR_SIG_T{
 
 esp_err_t esp_lcd_touch_new_i2c_gsl3680(esp_lcd_panel_io_handle_t io, const esp_lcd_touch_config_t *config, esp_lcd_touch_handle_t *out_touch);
 
+/* Track IDs of the points esp_lcd_touch_get_coordinates() returned, same order; returns the count */
+uint8_t esp_lcd_touch_gsl3680_get_track_ids(esp_lcd_touch_handle_t tp, uint8_t *ids, uint8_t max_point_num);
+
+/* Debounced two-finger zoom (TG_ZOOM_IN/TG_ZOOM_OUT) seen since the last call, else TG_NO_DETECT */
+TG_STATE_E esp_lcd_touch_gsl3680_take_gesture(esp_lcd_touch_handle_t tp);
+
+/* I2C traffic since the last reset; counting starts after firmware download */
+typedef struct {
+    uint32_t reads;             /* read transactions */
+    uint32_t rereads;           /* full-report reads after more fingers than expected */
+    uint32_t writes;            /* write transactions */
+    uint32_t mask_writes;       /* 0xf0/0x08 mask updates sent */
+    uint32_t mask_skipped;      /* reports whose mask was still latched and not resent */
+    uint32_t errors;            /* failed transactions */
+    uint64_t bytes;             /* payload bytes, both directions */
+    uint64_t busy_us;           /* time spent inside transactions */
+    int64_t since_us;           /* esp_timer time of the last reset */
+} esp_lcd_touch_gsl3680_bus_stats_t;
+
+void esp_lcd_touch_gsl3680_get_bus_stats(esp_lcd_touch_handle_t tp, esp_lcd_touch_gsl3680_bus_stats_t *stats);
+void esp_lcd_touch_gsl3680_reset_bus_stats(esp_lcd_touch_handle_t tp);
+
 #define ESP_LCD_TOUCH_IO_I2C_GSL3680_ADDRESS          (0x40)
 
 typedef struct {
@@ -55,6 +55,25 @@ bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x, uint1
         tp->config.process_coordinates(tp, x, y, strength, point_num, max_point_num);
     }
 
+    /* Precomputed transform: one multiply-add pass, no per-point branches */
+    esp_lcd_touch_transform_t xf;
+    portENTER_CRITICAL(&tp->data.lock);
+    const bool use_xf = tp->transform_enabled;
+    xf = tp->transform;
+    portEXIT_CRITICAL(&tp->data.lock);
+    if (use_xf) {
+        const esp_lcd_touch_transform_t *t = &xf;
+        for (int i = 0; i < *point_num; i++) {
+            const int32_t px = x[i];
+            const int32_t py = y[i];
+            int32_t tx = (int32_t)(((int64_t)t->xx * px + (int64_t)t->xy * py + t->x0) >> 16);
+            int32_t ty = (int32_t)(((int64_t)t->yx * px + (int64_t)t->yy * py + t->y0) >> 16);
+            x[i] = (uint16_t)(tx < 0 ? 0 : (tx > t->x_max ? t->x_max : tx));
+            y[i] = (uint16_t)(ty < 0 ? 0 : (ty > t->y_max ? t->y_max : ty));
+        }
+        return touched;
+    }
+
     /* Software coordinates adjustment needed */
     bool sw_adj_needed = ((tp->config.flags.mirror_x && (tp->set_mirror_x == NULL)) ||
                           (tp->config.flags.mirror_y && (tp->set_mirror_y == NULL)) ||
@@ -200,6 +219,22 @@ esp_err_t esp_lcd_touch_del(esp_lcd_touch_handle_t tp)
     return ESP_OK;
 }
 
+esp_err_t esp_lcd_touch_set_transform(esp_lcd_touch_handle_t tp, const esp_lcd_touch_transform_t *transform)
+{
+    assert(tp != NULL);
+
+    portENTER_CRITICAL(&tp->data.lock);
+    if (transform) {
+        tp->transform = *transform;
+        tp->transform_enabled = true;
+    } else {
+        tp->transform_enabled = false;
+    }
+    portEXIT_CRITICAL(&tp->data.lock);
+
+    return ESP_OK;
+}
+
 esp_err_t esp_lcd_touch_register_interrupt_callback(esp_lcd_touch_handle_t tp, esp_lcd_touch_interrupt_callback_t callback)
 {
     esp_err_t ret = ESP_OK;
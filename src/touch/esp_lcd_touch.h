@@ -67,6 +67,21 @@ typedef struct {
     esp_lcd_touch_interrupt_callback_t interrupt_callback;
 } esp_lcd_touch_config_t;
 
+/**
+ * @brief Affine coordinate transform, Q16.16 fixed point
+ *
+ *   x' = (xx * x + xy * y + x0) >> 16
+ *   y' = (yx * x + yy * y + y0) >> 16
+ *
+ * Results are clamped to [0, x_max] / [0, y_max]. Rotation, mirroring, swap
+ * and calibration are folded into one matrix by whoever builds it.
+ */
+typedef struct {
+    int32_t xx, xy, x0;
+    int32_t yx, yy, y0;
+    uint16_t x_max, y_max;
+} esp_lcd_touch_transform_t;
+
 typedef struct {
     uint8_t points; /*!< Count of touch points saved */
 
@@ -228,6 +243,12 @@ struct esp_lcd_touch_s {
      * @brief Data structure
      */
     esp_lcd_touch_data_t data;
+
+    /**
+     * @brief Coordinate transform; replaces the mirror/swap flags while enabled
+     */
+    esp_lcd_touch_transform_t transform;
+    bool transform_enabled;
 };
 
 /**
@@ -354,6 +375,20 @@ esp_err_t esp_lcd_touch_get_mirror_y(esp_lcd_touch_handle_t tp, bool *mirror);
  */
 esp_err_t esp_lcd_touch_del(esp_lcd_touch_handle_t tp);
 
+/**
+ * @brief Install a precomputed coordinate transform
+ *
+ * While installed, esp_lcd_touch_get_coordinates() applies it to every point in
+ * one pass instead of the software mirror/swap flags.
+ *
+ * @param tp: Touch handler
+ * @param transform: Transform to copy, or NULL to go back to the flags
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t esp_lcd_touch_set_transform(esp_lcd_touch_handle_t tp, const esp_lcd_touch_transform_t *transform);
+
 /**
  * @brief Register user callback called after the touch interrupt occured
  *
@@ -0,0 +1,97 @@
+#include "gsl_point_id.h"
+
+/* Panel tuning loaded into the point-ID algorithm (gsl_alg_ctx_init) */
+unsigned int gsl_config_data_id[] =
+{
+	0xccb69a,  
+	0x200,
+	0,0,
+	0,
+	0,0,0,
+	0,0,0,0,0,0,0,0x1cc86fd6,
+
+
+	0x40000d00,0xa,0xe001a,0xe001a,0x3200500,0,0x5100,0x8e00,
+	0,0x320014,0,0x14,0,0,0,0,
+	0x8,0x4000,0x1000,0x10170002,0x10110000,0,0,0x4040404,
+	0x1b6db688,0x64,0xb3000f,0xad0019,0xa60023,0xa0002d,0xb3000f,0xad0019,
+	0xa60023,0xa0002d,0xb3000f,0xad0019,0xa60023,0xa0002d,0xb3000f,0xad0019,
+	0xa60023,0xa0002d,0x804000,0x90040,0x90001,0,0,0,
+	0,0,0,0x14012c,0xa003c,0xa0078,0x400,0x1081,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+
+	0,//key_map
+	0x3200384,0x64,0x503e8,//0
+	0,0,0,//1
+	0,0,0,//2
+	0,0,0,//3
+	0,0,0,//4
+	0,0,0,//5
+	0,0,0,//6
+	0,0,0,//7
+
+	0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+
+
+	0x220,
+	0,0,0,0,0,0,0,0,
+	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
+	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
+	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
+	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
+
+	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
+	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
+
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+
+	0x10203,0x4050607,0x8090a0b,0xc0d0e0f,0x10111213,0x14151617,0x18191a1b,0x1c1d1e1f,
+	0x20212223,0x24252627,0x28292a2b,0x2c2d2e2f,0x30313233,0x34353637,0x38393a3b,0x3c3d3e3f,
+
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,
+
+
+	0x3,
+	0x101,0,0x100,0,
+	0x20,0x10,0x8,0x4,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+
+	0x4,0,0,0,0,0,0,0,
+	0x3800680,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,
+};
@@ -0,0 +1,81 @@
+#include <string.h>
+#include "gsl3680_report.h"
+
+void gsl3680_report_decode(const uint8_t *raw, struct gsl_touch_info *cinfo)
+{
+    int i;
+    const uint8_t *p;
+
+    memset(cinfo, 0, sizeof(*cinfo));
+    for (i = 0; i < GSL3680_REPORT_DECODE_POINTS; i++) {
+        p = raw + 4 + i * 4;
+        cinfo->x[i] = ((p[3] & 0x0f) << 8) | p[2];
+        cinfo->y[i] = (p[1] << 8) | p[0];
+        cinfo->id[i] = (p[3] & 0xf0) >> 4;
+    }
+    cinfo->finger_num = (raw[3] << 24) | (raw[2] << 16) | (raw[1] << 8) | raw[0];
+}
+
+uint8_t gsl3680_report_points(const uint8_t *raw)
+{
+    return raw[0] < GSL3680_REPORT_MAX_POINTS ? raw[0] : GSL3680_REPORT_MAX_POINTS;
+}
+
+uint8_t gsl3680_report_next_points(uint8_t points)
+{
+    return points < GSL3680_REPORT_MAX_POINTS ? points + 1 : GSL3680_REPORT_MAX_POINTS;
+}
+
+bool gsl3680_mask_due(uint32_t *last, uint32_t mask)
+{
+    const bool due = mask > 0 && mask < 0xffffffff && mask != *last;
+
+    *last = mask;
+    return due;
+}
+
+uint8_t gsl3680_pen_update(gsl3680_pen_t *pen, uint8_t pen_flag, uint16_t x, uint16_t y)
+{
+    int32_t x_delta = 0, y_delta = 0;
+
+    if (pen_flag == 0) {
+        if (pen->tp_event == TP_PEN_MOVE) { //the last event=move
+            pen->x_new = x;
+            pen->y_new = y;
+        } else { //the last event=down
+            pen->x_new = pen->x_start;
+            pen->y_new = pen->y_start;
+        }
+
+        pen->tp_event = TP_PEN_UP;
+    } else if (pen_flag == 2) {
+        pen->tp_event = TP_PEN_DOWN;
+        pen->x_start = x;
+        pen->y_start = y;
+        pen->x_new = x;
+        pen->y_new = y;
+    } else if (pen->pre_pen_flag != 1) { //pen_flag=1,pre_pen_flag==0 or 2
+        pen->tp_event = TP_PEN_DOWN;
+        pen->x_start = x;
+        pen->y_start = y;
+        pen->x_new = x;
+        pen->y_new = y;
+    } else { // if((pen_flag==1)&&(pre_pen_flag==1))
+        x_delta = x - pen->x_start;
+        y_delta = y - pen->y_start;
+        if ((x_delta > 20) || (x_delta < -20) || (y_delta > 25) || (y_delta < -25)) {
+            pen->tp_event = TP_PEN_MOVE;
+        }
+
+        if (pen->tp_event == TP_PEN_MOVE) {
+            pen->x_new = x;
+            pen->y_new = y;
+        } else {
+            pen->x_new = pen->x_start;
+            pen->y_new = pen->y_start;
+        }
+    }
+
+    pen->pre_pen_flag = pen_flag;
+    return pen->tp_event;
+}
@@ -0,0 +1,65 @@
+#ifndef _GSL3680_REPORT_H
+#define _GSL3680_REPORT_H
+
+/*
+ * Decoding of the GSL3680 0x80 coordinate report and the single-pen state
+ * machine. No ESP-IDF dependencies, so the same code runs in the driver and
+ * in the host replay tool (tools/gsl_replay).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gsl_point_id.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 0x80 report: 4 header bytes (finger count + flags) then 4 bytes per point */
+#define GSL3680_REPORT_LEN              (24)
+#define GSL3680_REPORT_MAX_POINTS       ((GSL3680_REPORT_LEN - 4) / 4)
+/* Points handed to the point-ID algorithm per report */
+#define GSL3680_REPORT_DECODE_POINTS    GSL3680_REPORT_MAX_POINTS
+/* Bytes of a report holding the header and n points */
+#define GSL3680_REPORT_BYTES(n)         (4 + 4 * (n))
+
+#define TP_PEN_NONE         0
+#define TP_PEN_MOVE         1
+#define TP_PEN_UP           2
+#define TP_PEN_DOWN         3
+
+typedef struct {
+    uint8_t tp_event;
+    uint8_t pre_pen_flag;
+    uint16_t x_new, y_new;
+    uint16_t x_start, y_start;
+} gsl3680_pen_t;
+
+/* Fill cinfo from a raw report, ready for gsl_alg_ctx_id_main() */
+void gsl3680_report_decode(const uint8_t *raw, struct gsl_touch_info *cinfo);
+
+/* Points the header announces, clamped to what the report holds */
+uint8_t gsl3680_report_points(const uint8_t *raw);
+
+/*
+ * Points to read next time after a report with `points`: the same fingers
+ * plus room for one more, so a new touch rarely costs a second read.
+ */
+uint8_t gsl3680_report_next_points(uint8_t points);
+
+/*
+ * Whether the algorithm's frequency-hop mask (gsl_alg_ctx_mask_tiaoping())
+ * needs writing to the controller. The algorithm latches a value for one or
+ * more reports; only a change is sent. `last` holds the previous report's
+ * value and is updated.
+ */
+bool gsl3680_mask_due(uint32_t *last, uint32_t mask);
+
+/* Feed one processed frame; returns the resulting TP_PEN_* event */
+uint8_t gsl3680_pen_update(gsl3680_pen_t *pen, uint8_t pen_flag, uint16_t x, uint16_t y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,9 +1,13 @@
+#include <math.h>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_err.h"
 #include "esp_log.h"
-#include "driver/i2c.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "driver/i2c_master.h"
 #include "esp_lcd_touch.h"
 #include "esp_lcd_gsl3680.h"
 #include "gsl3680_touch.h"
@@ -19,6 +23,22 @@ esp_lcd_panel_io_handle_t tp_io_handle;
 uint16_t touch_strength[1];
 uint8_t touch_cnt = 0;
 
+/* First INT edge since takeInterruptUs() last ran; 0 = none. 64-bit, so
+ * only read or written under s_int_lock */
+static int64_t s_int_first_us = 0;
+static portMUX_TYPE s_int_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR touch_int_isr(esp_lcd_touch_handle_t tp)
+{
+    (void)tp;
+    const int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_int_lock);
+    if (s_int_first_us == 0) {
+        s_int_first_us = now;
+    }
+    portEXIT_CRITICAL_ISR(&s_int_lock);
+}
+
 gsl3680_touch::gsl3680_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin)
 {
     _sda = sda_pin;
@@ -29,21 +49,21 @@ gsl3680_touch::gsl3680_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int
 
 void gsl3680_touch::begin()
 {
-    i2c_config_t i2c_conf = {
-        .mode = I2C_MODE_MASTER,
-        .sda_io_num = (gpio_num_t)_sda,
-        .scl_io_num = (gpio_num_t)_scl,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-    };
-    i2c_conf.master.clk_speed = 400000; // 400kHz
-
-    ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &i2c_conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_NUM_0, i2c_conf.mode, 0, 0, 0));
+    // New-style master bus; the panel IO below gets its own device handle on it
+    i2c_master_bus_config_t bus_conf = {};
+    bus_conf.i2c_port = I2C_NUM_0;
+    bus_conf.sda_io_num = (gpio_num_t)_sda;
+    bus_conf.scl_io_num = (gpio_num_t)_scl;
+    bus_conf.clk_source = I2C_CLK_SRC_DEFAULT;
+    bus_conf.glitch_ignore_cnt = 7;
+    bus_conf.flags.enable_internal_pullup = 1;
+    i2c_master_bus_handle_t i2c_bus = NULL;
+    ESP_ERROR_CHECK(i2c_new_master_bus(&bus_conf, &i2c_bus));
 
     esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GSL3680_CONFIG();
+    tp_io_config.scl_speed_hz = 400000; // 400kHz
     ESP_LOGI(TAG, "Initialize touch IO (I2C)");
-    esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_NUM_0, &tp_io_config, &tp_io_handle);
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c(i2c_bus, &tp_io_config, &tp_io_handle));
 
     esp_lcd_touch_config_t tp_cfg = {
         .x_max = CONFIG_LCD_HRES,
@@ -61,8 +81,14 @@ void gsl3680_touch::begin()
         },
     };
 
+    tp_cfg.interrupt_callback = touch_int_isr;
+
     ESP_LOGI(TAG, "Initialize touch controller gsl3680");
     ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gsl3680(tp_io_handle, &tp_cfg, &tp));
+
+    // The matrix supersedes the mirror flag above from here on
+    load_calibration();
+    apply_transform();
 }
 
 bool gsl3680_touch::getTouch(uint16_t *x, uint16_t *y)
@@ -73,28 +99,271 @@ bool gsl3680_touch::getTouch(uint16_t *x, uint16_t *y)
     return touchpad_pressed;
 }
 
-void gsl3680_touch::set_rotation(uint8_t r){
-switch(r){
-    case 0:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
-        break;
-    case 1:
-        esp_lcd_touch_set_swap_xy(tp, false);
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
-        break;
-    case 2:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
-        break;
-    case 3:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
-        break;
-    }
-
-}
\ No newline at end of file
+uint8_t gsl3680_touch::getTouches(gsl3680_point_t *points, uint8_t max_points)
+{
+    uint16_t x[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
+    uint16_t y[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
+    uint8_t ids[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
+    uint8_t cnt = 0;
+
+    if (max_points > CONFIG_ESP_LCD_TOUCH_MAX_POINTS) {
+        max_points = CONFIG_ESP_LCD_TOUCH_MAX_POINTS;
+    }
+    esp_lcd_touch_read_data(tp);
+    if (!esp_lcd_touch_get_coordinates(tp, x, y, NULL, &cnt, max_points)) {
+        return 0;
+    }
+    esp_lcd_touch_gsl3680_get_track_ids(tp, ids, cnt);
+    for (uint8_t i = 0; i < cnt; i++) {
+        points[i].x = x[i];
+        points[i].y = y[i];
+        points[i].id = ids[i];
+    }
+    return cnt;
+}
+
+int64_t gsl3680_touch::takeInterruptUs()
+{
+    portENTER_CRITICAL(&s_int_lock);
+    const int64_t t = s_int_first_us;
+    s_int_first_us = 0;
+    portEXIT_CRITICAL(&s_int_lock);
+    return t;
+}
+
+void gsl3680_touch::getBusStats(gsl3680_bus_stats_t *stats)
+{
+    esp_lcd_touch_gsl3680_bus_stats_t bus;
+
+    esp_lcd_touch_gsl3680_get_bus_stats(tp, &bus);
+    stats->reads = bus.reads;
+    stats->rereads = bus.rereads;
+    stats->writes = bus.writes;
+    stats->mask_writes = bus.mask_writes;
+    stats->mask_skipped = bus.mask_skipped;
+    stats->errors = bus.errors;
+    stats->bytes = bus.bytes;
+    stats->busy_us = bus.busy_us;
+    stats->window_us = esp_timer_get_time() - bus.since_us;
+}
+
+void gsl3680_touch::resetBusStats()
+{
+    esp_lcd_touch_gsl3680_reset_bus_stats(tp);
+}
+
+int8_t gsl3680_touch::getZoom()
+{
+    switch (esp_lcd_touch_gsl3680_take_gesture(tp)) {
+    case TG_ZOOM_IN:
+        return 1;
+    case TG_ZOOM_OUT:
+        return -1;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Coordinate pipeline, all folded into one Q16 matrix for esp_lcd_touch:
+ *   raw -> mount (panel is Y-mirrored) -> calibration -> rotation -> logical
+ * Affines are {a, b, c, d, e, f}: x' = a x + b y + c, y' = d x + e y + f.
+ */
+static void affine_compose(float out[6], const float A[6], const float B[6])
+{
+    // out = A(B(p))
+    const float r[6] = {
+        A[0] * B[0] + A[1] * B[3], A[0] * B[1] + A[1] * B[4], A[0] * B[2] + A[1] * B[5] + A[2],
+        A[3] * B[0] + A[4] * B[3], A[3] * B[1] + A[4] * B[4], A[3] * B[2] + A[4] * B[5] + A[5],
+    };
+    for (int i = 0; i < 6; i++) {
+        out[i] = r[i];
+    }
+}
+
+static bool affine_invert(float out[6], const float m[6])
+{
+    const float det = m[0] * m[4] - m[1] * m[3];
+    if (det > -1e-6f && det < 1e-6f) {
+        return false;
+    }
+    const float a = m[4] / det, b = -m[1] / det;
+    const float d = -m[3] / det, e = m[0] / det;
+    out[0] = a;
+    out[1] = b;
+    out[2] = -(a * m[2] + b * m[5]);
+    out[3] = d;
+    out[4] = e;
+    out[5] = -(d * m[2] + e * m[5]);
+    return true;
+}
+
+static void affine_apply(const float m[6], float x, float y, float *ox, float *oy)
+{
+    *ox = m[0] * x + m[1] * y + m[2];
+    *oy = m[3] * x + m[4] * y + m[5];
+}
+
+// Panel-native (portrait) to logical, r quarter turns clockwise
+static void rotation_matrix(uint8_t r, float m[6])
+{
+    const float w1 = CONFIG_LCD_HRES - 1;
+    const float h1 = CONFIG_LCD_VRES - 1;
+    const float rot[4][6] = {
+        {  1,  0,  0,   0,  1,  0 },
+        {  0,  1,  0,  -1,  0, w1 },
+        { -1,  0, w1,   0, -1, h1 },
+        {  0, -1, h1,   1,  0,  0 },
+    };
+    for (int i = 0; i < 6; i++) {
+        m[i] = rot[r & 3][i];
+    }
+}
+
+static int32_t to_q16(float v)
+{
+    return (int32_t)lroundf(v * 65536.0f);
+}
+
+void gsl3680_touch::apply_transform()
+{
+    if (!tp) {
+        return;
+    }
+    const float mount[6] = { 1, 0, 0, 0, -1, CONFIG_LCD_VRES - 1 };
+    float rot[6], m[6];
+    rotation_matrix(_rotation, rot);
+    affine_compose(m, _cal, mount);
+    affine_compose(m, rot, m);
+
+    esp_lcd_touch_transform_t xf = {
+        .xx = to_q16(m[0]),
+        .xy = to_q16(m[1]),
+        .x0 = to_q16(m[2]) + 0x8000,   // round to nearest on the >> 16
+        .yx = to_q16(m[3]),
+        .yy = to_q16(m[4]),
+        .y0 = to_q16(m[5]) + 0x8000,
+        .x_max = (uint16_t)(width() - 1),
+        .y_max = (uint16_t)(height() - 1),
+    };
+    esp_lcd_touch_set_transform(tp, &xf);
+}
+
+void gsl3680_touch::set_rotation(uint8_t r)
+{
+    _rotation = r & 3;
+    apply_transform();
+}
+
+uint16_t gsl3680_touch::width() const
+{
+    return (_rotation & 1) ? CONFIG_LCD_VRES : CONFIG_LCD_HRES;
+}
+
+uint16_t gsl3680_touch::height() const
+{
+    return (_rotation & 1) ? CONFIG_LCD_HRES : CONFIG_LCD_VRES;
+}
+
+void gsl3680_touch::set_calibration(const float c[6])
+{
+    for (int i = 0; i < 6; i++) {
+        _cal[i] = c[i];
+    }
+    apply_transform();
+}
+
+void gsl3680_touch::reset_calibration()
+{
+    const float identity[6] = { 1, 0, 0, 0, 1, 0 };
+    set_calibration(identity);
+}
+
+// Solve a x + b y + c = v through three points by Cramer's rule
+static bool solve_row(const float x[3], const float y[3], const float v[3], float out[3])
+{
+    const float det = x[0] * (y[1] - y[2]) - y[0] * (x[1] - x[2]) + (x[1] * y[2] - x[2] * y[1]);
+    if (det > -1000.0f && det < 1000.0f) {
+        return false;   // points (nearly) collinear
+    }
+    out[0] = (v[0] * (y[1] - y[2]) - y[0] * (v[1] - v[2]) + (v[1] * y[2] - v[2] * y[1])) / det;
+    out[1] = (x[0] * (v[1] - v[2]) - v[0] * (x[1] - x[2]) + (x[1] * v[2] - x[2] * v[1])) / det;
+    out[2] = (x[0] * (y[1] * v[2] - y[2] * v[1]) - y[0] * (x[1] * v[2] - x[2] * v[1]) +
+              v[0] * (x[1] * y[2] - x[2] * y[1])) / det;
+    return true;
+}
+
+bool gsl3680_touch::solve_calibration(const gsl3680_point_t measured[3], const gsl3680_point_t target[3])
+{
+    // Work in panel-native space so the result holds for every rotation
+    float rot[6], inv[6];
+    rotation_matrix(_rotation, rot);
+    if (!affine_invert(inv, rot)) {
+        return false;
+    }
+
+    float mx[3], my[3], tx[3], ty[3];
+    for (int i = 0; i < 3; i++) {
+        affine_apply(inv, measured[i].x, measured[i].y, &mx[i], &my[i]);
+        affine_apply(inv, target[i].x, target[i].y, &tx[i], &ty[i]);
+    }
+
+    float c[6];
+    if (!solve_row(mx, my, tx, &c[0]) || !solve_row(mx, my, ty, &c[3])) {
+        return false;
+    }
+    // A sane fit stays close to unit scale; anything else is a bad capture
+    const float scale = c[0] * c[4] - c[1] * c[3];
+    if (scale < 0.5f || scale > 2.0f) {
+        ESP_LOGW(TAG, "calibration rejected, scale %.3f", scale);
+        return false;
+    }
+    set_calibration(c);
+    return true;
+}
+
+#define TOUCH_CAL_NVS_NS "touch"
+#define TOUCH_CAL_NVS_KEY "cal"
+#define TOUCH_CAL_MAGIC 0x314c4143   // "CAL1"
+
+typedef struct {
+    uint32_t magic;
+    float c[6];
+} touch_cal_blob_t;
+
+bool gsl3680_touch::load_calibration()
+{
+    nvs_handle_t h;
+    if (nvs_open(TOUCH_CAL_NVS_NS, NVS_READONLY, &h) != ESP_OK) {
+        return false;
+    }
+    touch_cal_blob_t blob;
+    size_t len = sizeof(blob);
+    const esp_err_t err = nvs_get_blob(h, TOUCH_CAL_NVS_KEY, &blob, &len);
+    nvs_close(h);
+    if (err != ESP_OK || len != sizeof(blob) || blob.magic != TOUCH_CAL_MAGIC) {
+        return false;
+    }
+    set_calibration(blob.c);
+    ESP_LOGI(TAG, "touch calibration loaded");
+    return true;
+}
+
+bool gsl3680_touch::save_calibration()
+{
+    nvs_handle_t h;
+    if (nvs_open(TOUCH_CAL_NVS_NS, NVS_READWRITE, &h) != ESP_OK) {
+        return false;
+    }
+    touch_cal_blob_t blob;
+    blob.magic = TOUCH_CAL_MAGIC;
+    for (int i = 0; i < 6; i++) {
+        blob.c[i] = _cal[i];
+    }
+    esp_err_t err = nvs_set_blob(h, TOUCH_CAL_NVS_KEY, &blob, sizeof(blob));
+    if (err == ESP_OK) {
+        err = nvs_commit(h);
+    }
+    nvs_close(h);
+    return err == ESP_OK;
+}
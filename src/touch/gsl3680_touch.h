@@ -1,6 +1,25 @@
 #ifndef _GT911_TOUCH_H
 #define _GT911_TOUCH_H
 #include <stdio.h>
+#include <stdint.h>
+
+struct gsl3680_point_t
+{
+    uint16_t x;
+    uint16_t y;
+    uint8_t id;     // controller track ID, stable while the finger stays down
+};
+
+// I2C traffic since resetBusStats() (or the end of begin())
+struct gsl3680_bus_stats_t
+{
+    uint32_t reads, rereads, writes;
+    uint32_t mask_writes, mask_skipped;
+    uint32_t errors;
+    uint64_t bytes;
+    uint64_t busy_us;       // time inside transactions
+    int64_t window_us;      // time covered by the counters
+};
 
 class gsl3680_touch
 {
@@ -9,10 +28,37 @@ public:
 
     void begin();
     bool getTouch(uint16_t *x, uint16_t *y);
+    // One I2C read; fills up to max_points points and returns how many are down
+    uint8_t getTouches(gsl3680_point_t *points, uint8_t max_points);
+    // Pinch seen by the reads since the last call: +1 zoom in, -1 zoom out, 0 none
+    int8_t getZoom();
+    // esp_timer time of the first INT edge since the previous call, 0 if none
+    int64_t takeInterruptUs();
+    void getBusStats(gsl3680_bus_stats_t *stats);
+    void resetBusStats();
+    // r = quarter turns clockwise of the UI relative to the portrait panel
     void set_rotation(uint8_t r);
+    // Logical resolution for the current rotation
+    uint16_t width() const;
+    uint16_t height() const;
+
+    // Linear calibration in panel-native pixels: x' = c[0]x + c[1]y + c[2],
+    // y' = c[3]x + c[4]y + c[5]. Folded into the rotation matrix.
+    void set_calibration(const float c[6]);
+    void reset_calibration();
+    // Fit the calibration from three logical points measured with the identity
+    // calibration and where they should have landed; false if degenerate
+    bool solve_calibration(const gsl3680_point_t measured[3], const gsl3680_point_t target[3]);
+    // Persisted in NVS ("touch"/"cal"); begin() loads it
+    bool load_calibration();
+    bool save_calibration();
 
 private:
+    void apply_transform();
+
     int8_t _sda, _scl, _rst, _int;
+    uint8_t _rotation = 0;
+    float _cal[6] = { 1, 0, 0, 0, 1, 0 };
 };
 
 #endif
@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "gsl3680_trace.h"
+
+#define TAG "gsl3680_trace"
+
+static gsl3680_trace_rec_t *s_ring;
+static size_t s_capacity;
+static size_t s_head;                   /* next slot to write */
+static size_t s_count;
+static uint32_t s_dropped;              /* overwritten because the ring was full */
+static volatile bool s_armed;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t gsl3680_trace_start(size_t capacity)
+{
+    ESP_RETURN_ON_FALSE(capacity > 0, ESP_ERR_INVALID_ARG, TAG, "capacity must be > 0");
+
+    /* Taking the lock waits out a record() in flight on the other core */
+    portENTER_CRITICAL(&s_lock);
+    s_armed = false;
+    portEXIT_CRITICAL(&s_lock);
+    if (s_ring && s_capacity != capacity) {
+        heap_caps_free(s_ring);
+        s_ring = NULL;
+    }
+    if (!s_ring) {
+        s_ring = heap_caps_malloc(capacity * sizeof(gsl3680_trace_rec_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_RETURN_ON_FALSE(s_ring, ESP_ERR_NO_MEM, TAG, "no mem for %u trace records", (unsigned)capacity);
+        s_capacity = capacity;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_head = 0;
+    s_count = 0;
+    s_dropped = 0;
+    portEXIT_CRITICAL(&s_lock);
+    s_armed = true;
+
+    ESP_LOGI(TAG, "capturing up to %u reports (%u KB PSRAM)", (unsigned)capacity,
+             (unsigned)(capacity * sizeof(gsl3680_trace_rec_t) / 1024));
+    return ESP_OK;
+}
+
+void gsl3680_trace_stop(void)
+{
+    s_armed = false;
+}
+
+bool gsl3680_trace_active(void)
+{
+    return s_armed;
+}
+
+void gsl3680_trace_record(const uint8_t *raw)
+{
+    if (!s_armed) {
+        return;
+    }
+    const uint32_t now = (uint32_t)esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_armed) {
+        gsl3680_trace_rec_t *rec = &s_ring[s_head];
+        rec->t_us = now;
+        memcpy(rec->raw, raw, GSL3680_REPORT_LEN);
+        if (++s_head == s_capacity) {
+            s_head = 0;
+        }
+        if (s_count < s_capacity) {
+            s_count++;
+        } else {
+            s_dropped++;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void gsl3680_trace_dump(void (*emit)(const char *line))
+{
+    char line[16 + GSL3680_REPORT_LEN * 2];
+    const bool was_armed = s_armed;
+    size_t i, j, idx, first, count;
+    uint32_t dropped;
+
+    /* Freeze the ring while it is printed */
+    portENTER_CRITICAL(&s_lock);
+    s_armed = false;
+    count = s_count;
+    dropped = s_dropped;
+    first = (s_head + s_capacity - s_count) % (s_capacity ? s_capacity : 1);
+    portEXIT_CRITICAL(&s_lock);
+
+    snprintf(line, sizeof(line), "# gsl3680-trace v1 records=%u dropped=%lu\n", (unsigned)count, (unsigned long)dropped);
+    emit(line);
+    for (i = 0; i < count; i++) {
+        const gsl3680_trace_rec_t *rec = &s_ring[(first + i) % s_capacity];
+        int n = snprintf(line, sizeof(line), "%lu ", (unsigned long)rec->t_us);
+        for (j = 0; j < GSL3680_REPORT_LEN; j++) {
+            idx = n + j * 2;
+            line[idx] = "0123456789abcdef"[rec->raw[j] >> 4];
+            line[idx + 1] = "0123456789abcdef"[rec->raw[j] & 0x0f];
+        }
+        idx = n + GSL3680_REPORT_LEN * 2;
+        line[idx] = '\n';
+        line[idx + 1] = '\0';
+        emit(line);
+    }
+    emit("# end\n");
+    s_armed = was_armed;
+}
@@ -0,0 +1,48 @@
+#ifndef _GSL3680_TRACE_H
+#define _GSL3680_TRACE_H
+
+/*
+ * Capture of raw GSL3680 0x80 reports for off-device replay.
+ *
+ * While armed, every report the driver reads is stored with its timestamp in
+ * a PSRAM ring (oldest records are overwritten). The dump is plain text so it
+ * can be copied straight out of a serial monitor and fed to tools/gsl_replay:
+ *
+ *   # gsl3680-trace v1 records=<n> dropped=<n>
+ *   <t_us> <48 hex digits>
+ *   ...
+ *   # end
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "gsl3680_report.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t t_us;                          /* esp_timer, low 32 bits */
+    uint8_t raw[GSL3680_REPORT_LEN];
+} gsl3680_trace_rec_t;
+
+/* Allocate (or reuse) a ring of `capacity` records and start recording */
+esp_err_t gsl3680_trace_start(size_t capacity);
+/* Stop recording; captured records are kept until the next start */
+void gsl3680_trace_stop(void);
+bool gsl3680_trace_active(void);
+
+/* Called by the driver for every report read; no-op unless armed */
+void gsl3680_trace_record(const uint8_t *raw);
+
+/* Write the captured records, oldest first, one line per call of `emit` */
+void gsl3680_trace_dump(void (*emit)(const char *line));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
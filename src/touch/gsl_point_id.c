@@ -16,8 +16,14 @@
  */
 // #include "bsp/lcd_gsl3680.h"
 #include "gsl_point_id.h"
+#ifdef ESP_PLATFORM
 #include "esp_log.h"
+#else
+#define ESP_LOGI(tag, ...) do {} while (0) /* host replay build */
+#endif
 #include "stdio.h"
+#include <string.h>
+#include "../perf/trace_ring.h"
 
 #define GSL_VERSION                                                            \
 	0x20160901 /* NO GESTURE VERSION COME FROM VERSION 20150706 */
@@ -186,31 +192,212 @@ union gsl_ID_FLAG_TYPE {
 	} other;
 	unsigned int all;
 };
-static union {
-	struct {
-		unsigned char id;
-		unsigned char num;
-		unsigned char rev_1;
-		unsigned char rev_2;
-	} other;
-	unsigned int all;
-} prec_id;
-
-static union gsl_POINT_TYPE point_array[POINT_DEEP][POINT_MAX];
-static union gsl_POINT_TYPE *point_pointer[PP_DEEP];
-static union gsl_POINT_TYPE *point_stretch[PS_DEEP];
-static union gsl_POINT_TYPE *point_report[PR_DEEP];
-static union gsl_POINT_TYPE point_now[POINT_MAX];
-static union gsl_DELAY_TYPE point_delay[POINT_MAX];
-static int filter_deep[POINT_MAX];
-static int avg[AVG_DEEP];
-static struct gsl_EDGE_TYPE point_edge;
-static union gsl_DECIMAL_TYPE point_decimal[POINT_MAX];
-
-static unsigned int pressure_now[POINT_MAX];
-static unsigned int pressure_array[PRESSURE_DEEP][POINT_MAX];
-static unsigned int pressure_report[POINT_MAX];
-static unsigned int *pressure_pointer[PRESSURE_DEEP];
+
+/* All algorithm state; one instance per controller (see gsl_alg_ctx_init) */
+/*
+ * Everything a frame may modify apart from the history rings.  Kept together
+ * so the idle fast path can snapshot and compare it in one go.
+ */
+struct gsl_LIVE_TYPE {
+	union {
+		struct {
+			unsigned char id;
+			unsigned char num;
+			unsigned char rev_1;
+			unsigned char rev_2;
+		} other;
+		unsigned int all;
+	} prec_id;
+	union gsl_POINT_TYPE point_now[POINT_MAX];
+	union gsl_DELAY_TYPE point_delay[POINT_MAX];
+	int filter_deep[POINT_MAX];
+	int avg[AVG_DEEP];
+	struct gsl_EDGE_TYPE point_edge;
+	union gsl_DECIMAL_TYPE point_decimal[POINT_MAX];
+	unsigned int pressure_now[POINT_MAX];
+	unsigned int pressure_report[POINT_MAX];
+	union gsl_STATE_TYPE global_state;
+	int point_num;
+	int prev_num;
+	int point_near;
+	unsigned int point_shake;
+	unsigned int reset_mask_send;
+	unsigned int reset_mask_max;
+	unsigned int reset_mask_count;
+	union gsl_POINT_TYPE point_press_move;
+	unsigned int press_move;
+	unsigned int point_corner;
+	/* PointStretch_for() history */
+	int save_dr[POINT_MAX], save_dn[POINT_MAX];
+};
+
+struct gsl_alg_ctx {
+	struct gsl_LIVE_TYPE live;
+	/* history rings, rotated by PointPointer() */
+	union gsl_POINT_TYPE point_array[POINT_DEEP][POINT_MAX];
+	union gsl_POINT_TYPE *point_pointer[PP_DEEP];
+	union gsl_POINT_TYPE *point_stretch[PS_DEEP];
+	union gsl_POINT_TYPE *point_report[PR_DEEP];
+	unsigned int pressure_array[PRESSURE_DEEP][POINT_MAX];
+	unsigned int *pressure_pointer[PRESSURE_DEEP];
+	int point_n;
+	/* write-only counters */
+	int inte_count;
+	unsigned int csensor_count;
+	/* configuration, set by DataInit() */
+	union gsl_FLAG_TYPE global_flag;
+	union gsl_ID_FLAG_TYPE id_flag;
+	unsigned int id_first_coe;
+	unsigned int id_speed_coe;
+	unsigned int id_static_coe;
+	unsigned int average;
+	unsigned int soft_average;
+	unsigned int report_delay;
+	unsigned int delay_key;
+	unsigned int report_ahead;
+	unsigned int report_delete;
+	unsigned char median_dis[4];
+	unsigned int shake_min;
+	int match_y[2];
+	int match_x[2];
+	int ignore_y[2];
+	int ignore_x[2];
+	int screen_y_max;
+	int screen_x_max;
+	int point_num_max;
+	unsigned int drv_num;
+	unsigned int sen_num;
+	unsigned int drv_num_nokey;
+	unsigned int sen_num_nokey;
+	unsigned int coordinate_correct_able;
+	unsigned int coordinate_correct_coe_x[64];
+	unsigned int coordinate_correct_coe_y[64];
+	unsigned int edge_cut[4];
+	unsigned int stretch_array[4 * 4 * 2];
+	unsigned int stretch_active[4 * 4 * 2];
+	unsigned int shake_all_array[2 * 8];
+	unsigned int edge_start;
+	unsigned int reset_mask_dis;
+	unsigned int reset_mask_type;
+	unsigned int key_map_able;
+	unsigned int key_range_array[8 * 3];
+	int filter_able;
+	unsigned int filter_coe[4];
+	/* filter_coe unpacked to signed taps, see FilterCoeInit() */
+	int filter_ps_c[8], filter_pr_c[8];
+	unsigned int multi_x_array[4], multi_y_array[4];
+	unsigned int multi_group[4][64];
+	int ps_coe[4][8], pr_coe[4][8];
+	int point_repeat[2];
+	/* static	int near_set[2]; */
+	int diagonal;
+	int point_extend;
+	unsigned int press_mask;
+	/* unsigned int key_dead_time			; */
+	/* unsigned int point_dead_time		; */
+	/* unsigned int point_dead_time2		; */
+	/* unsigned int point_dead_distance	; */
+	/* unsigned int point_dead_distance2	; */
+	/* unsigned int pressure_able; */
+	/* unsigned int pressure_save[POINT_MAX]; */
+	unsigned int edge_first;
+	unsigned int edge_first_coe;
+	unsigned int stretch_mult;
+	unsigned int config_static[CONFIG_LENGTH];
+	/* idle fast path, see gsl_alg_ctx_id_main() */
+	struct gsl_LIVE_TYPE idle_live;
+	struct gsl_touch_info idle_in;
+	struct gsl_touch_info idle_out;
+	int idle_track;
+	int idle_ready;
+	int idle_rotate;
+};
+
+/* Every function below that touches state takes "ctx" as its first argument */
+#define prec_id (ctx->live.prec_id)
+#define point_array (ctx->point_array)
+#define point_pointer (ctx->point_pointer)
+#define point_stretch (ctx->point_stretch)
+#define point_report (ctx->point_report)
+#define point_now (ctx->live.point_now)
+#define point_delay (ctx->live.point_delay)
+#define filter_deep (ctx->live.filter_deep)
+#define avg (ctx->live.avg)
+#define point_edge (ctx->live.point_edge)
+#define point_decimal (ctx->live.point_decimal)
+#define pressure_now (ctx->live.pressure_now)
+#define pressure_array (ctx->pressure_array)
+#define pressure_report (ctx->live.pressure_report)
+#define pressure_pointer (ctx->pressure_pointer)
+#define global_state (ctx->live.global_state)
+#define inte_count (ctx->inte_count)
+#define csensor_count (ctx->csensor_count)
+#define point_n (ctx->point_n)
+#define point_num (ctx->live.point_num)
+#define prev_num (ctx->live.prev_num)
+#define point_near (ctx->live.point_near)
+#define point_shake (ctx->live.point_shake)
+#define reset_mask_send (ctx->live.reset_mask_send)
+#define reset_mask_max (ctx->live.reset_mask_max)
+#define reset_mask_count (ctx->live.reset_mask_count)
+#define global_flag (ctx->global_flag)
+#define id_flag (ctx->id_flag)
+#define id_first_coe (ctx->id_first_coe)
+#define id_speed_coe (ctx->id_speed_coe)
+#define id_static_coe (ctx->id_static_coe)
+#define average (ctx->average)
+#define soft_average (ctx->soft_average)
+#define report_delay (ctx->report_delay)
+#define delay_key (ctx->delay_key)
+#define report_ahead (ctx->report_ahead)
+#define report_delete (ctx->report_delete)
+#define median_dis (ctx->median_dis)
+#define shake_min (ctx->shake_min)
+#define match_y (ctx->match_y)
+#define match_x (ctx->match_x)
+#define ignore_y (ctx->ignore_y)
+#define ignore_x (ctx->ignore_x)
+#define screen_y_max (ctx->screen_y_max)
+#define screen_x_max (ctx->screen_x_max)
+#define point_num_max (ctx->point_num_max)
+#define drv_num (ctx->drv_num)
+#define sen_num (ctx->sen_num)
+#define drv_num_nokey (ctx->drv_num_nokey)
+#define sen_num_nokey (ctx->sen_num_nokey)
+#define coordinate_correct_able (ctx->coordinate_correct_able)
+#define coordinate_correct_coe_x (ctx->coordinate_correct_coe_x)
+#define coordinate_correct_coe_y (ctx->coordinate_correct_coe_y)
+#define edge_cut (ctx->edge_cut)
+#define stretch_array (ctx->stretch_array)
+#define stretch_active (ctx->stretch_active)
+#define shake_all_array (ctx->shake_all_array)
+#define edge_start (ctx->edge_start)
+#define reset_mask_dis (ctx->reset_mask_dis)
+#define reset_mask_type (ctx->reset_mask_type)
+#define key_map_able (ctx->key_map_able)
+#define key_range_array (ctx->key_range_array)
+#define filter_able (ctx->filter_able)
+#define filter_coe (ctx->filter_coe)
+#define filter_ps_c (ctx->filter_ps_c)
+#define filter_pr_c (ctx->filter_pr_c)
+#define multi_x_array (ctx->multi_x_array)
+#define multi_y_array (ctx->multi_y_array)
+#define multi_group (ctx->multi_group)
+#define ps_coe (ctx->ps_coe)
+#define pr_coe (ctx->pr_coe)
+#define point_repeat (ctx->point_repeat)
+#define diagonal (ctx->diagonal)
+#define point_extend (ctx->point_extend)
+#define press_mask (ctx->press_mask)
+#define point_press_move (ctx->live.point_press_move)
+#define press_move (ctx->live.press_move)
+#define edge_first (ctx->edge_first)
+#define edge_first_coe (ctx->edge_first_coe)
+#define point_corner (ctx->live.point_corner)
+#define stretch_mult (ctx->stretch_mult)
+#define config_static (ctx->config_static)
+#define save_dr (ctx->live.save_dr)
+#define save_dn (ctx->live.save_dn)
 
 #define pp point_pointer
 #define ps point_stretch
@@ -218,110 +405,49 @@ static unsigned int *pressure_pointer[PRESSURE_DEEP];
 #define point_predict pp[0]
 #define pa pressure_pointer
 
-static union gsl_STATE_TYPE global_state;
-static int inte_count;
-static unsigned int csensor_count;
-static int point_n;
-static int point_num;
-static int prev_num;
-static int point_near;
-static unsigned int point_shake;
-static unsigned int reset_mask_send;
-static unsigned int reset_mask_max;
-static unsigned int reset_mask_count;
-static union gsl_FLAG_TYPE global_flag;
-static union gsl_ID_FLAG_TYPE id_flag;
-static unsigned int id_first_coe;
-static unsigned int id_speed_coe;
-static unsigned int id_static_coe;
-static unsigned int average;
-static unsigned int soft_average;
-static unsigned int report_delay;
-static unsigned int delay_key;
-static unsigned int report_ahead;
-static unsigned int report_delete;
-static unsigned char median_dis[4];
-static unsigned int shake_min;
-static int match_y[2];
-static int match_x[2];
-static int ignore_y[2];
-static int ignore_x[2];
-static int screen_y_max;
-static int screen_x_max;
-static int point_num_max;
-static unsigned int drv_num;
-static unsigned int sen_num;
-static unsigned int drv_num_nokey;
-static unsigned int sen_num_nokey;
-static unsigned int coordinate_correct_able;
-static unsigned int coordinate_correct_coe_x[64];
-static unsigned int coordinate_correct_coe_y[64];
-static unsigned int edge_cut[4];
-static unsigned int stretch_array[4 * 4 * 2];
-static unsigned int stretch_active[4 * 4 * 2];
-static unsigned int shake_all_array[2 * 8];
-static unsigned int edge_start;
-static unsigned int reset_mask_dis;
-static unsigned int reset_mask_type;
-static unsigned int key_map_able;
-static unsigned int key_range_array[8 * 3];
-static int filter_able;
-static unsigned int filter_coe[4];
-static unsigned int multi_x_array[4], multi_y_array[4];
-static unsigned int multi_group[4][64];
-static int ps_coe[4][8], pr_coe[4][8];
-static int point_repeat[2];
-/* static	int near_set[2]; */
-static int diagonal;
-static int point_extend;
-static unsigned int press_mask;
-static union gsl_POINT_TYPE point_press_move;
-static unsigned int press_move;
-/* unsigned int key_dead_time			; */
-/* unsigned int point_dead_time		; */
-/* unsigned int point_dead_time2		; */
-/* unsigned int point_dead_distance	; */
-/* unsigned int point_dead_distance2	; */
-/* unsigned int pressure_able; */
-/* unsigned int pressure_save[POINT_MAX]; */
-static unsigned int edge_first;
-static unsigned int edge_first_coe;
-static unsigned int point_corner;
-static unsigned int stretch_mult;
-/* ------------------------------------------------- */
-static unsigned int config_static[CONFIG_LENGTH];
+/* Instance behind the legacy single-controller API */
+static struct gsl_alg_ctx gsl_default_ctx;
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 static void SortBubble(int t[], int size)
 {
-	int temp = 0;
+	int temp;
 	int m, n;
 
-	for (m = 0; m < size; m++) {
-		for (n = m + 1; n < size; n++) {
-			temp = t[m];
-			if (temp > t[n]) {
-				t[m] = t[n];
-				t[n] = temp;
-			}
-		}
+	/* insertion sort: same result, no redundant swaps on the median paths */
+	for (m = 1; m < size; m++) {
+		temp = t[m];
+		for (n = m; n > 0 && t[n - 1] > temp; n--)
+			t[n] = t[n - 1];
+		t[n] = temp;
 	}
 }
 
 static int Sqrt(int d)
 {
-	int ret = 0;
-	int i;
+	unsigned int x, bit, ret = 0;
 
-	for (i = 14; i >= 0; i--) {
-		if ((ret + (0x1 << i)) * (ret + (0x1 << i)) <= d)
-			ret |= (0x1 << i);
+	/* floor(sqrt(d)) clamped to 15 bits, as the old shift-and-multiply loop */
+	if (d <= 0)
+		return 0;
+	if (d >= 32767 * 32767)
+		return 32767;
+	x = (unsigned int)d;
+	bit = 1u << ((31 - __builtin_clz(x)) & ~1);
+	while (bit) {
+		if (x >= ret + bit) {
+			x -= ret + bit;
+			ret = (ret >> 1) + bit;
+		} else {
+			ret >>= 1;
+		}
+		bit >>= 2;
 	}
-	return ret;
+	return (int)ret;
 }
 
-static UINT PointRange(int x0, int y0, int x1, int y1)
+static UINT PointRange(struct gsl_alg_ctx *ctx, int x0, int y0, int x1, int y1)
 {
 	if (x0 < 1) /* && x1>=1 */ {
 		if (x0 != x1)
@@ -358,7 +484,7 @@ static UINT PointRange(int x0, int y0, int x1, int y1)
 	return (x0 << 16) + y0;
 }
 
-static void PointCoor(void)
+static void PointCoor(struct gsl_alg_ctx *ctx)
 {
 	int i;
 
@@ -371,7 +497,7 @@ static void PointCoor(void)
 	}
 }
 
-static void PointRepeat(void)
+static void PointRepeat(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	int x, y;
@@ -443,7 +569,7 @@ static void PointRepeat(void)
 	}
 }
 
-static void PointPointer(void)
+static void PointPointer(struct gsl_alg_ctx *ctx)
 {
 	int i, pn;
 
@@ -527,7 +653,7 @@ static unsigned int CCO(unsigned int x, unsigned int coe[], int k)
 	return 0;
 }
 
-static void CoordinateCorrect(void)
+static void CoordinateCorrect(struct gsl_alg_ctx *ctx)
 {
 	struct MULTI_TYPE {
 		unsigned int range;
@@ -653,32 +779,32 @@ static void CoordinateCorrect(void)
 #undef LINE_SIZE
 }
 
-static void PointPredictOne(unsigned int n)
+static void PointPredictOne(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	pp[0][n].all = pp[1][n].all & FLAG_COOR;
 	pp[0][n].other.predict = 0;
 }
 
-static void PointPredictD2(unsigned int n)
+static void PointPredictD2(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	int x, y;
 
 	x = (int)pp[1][n].other.x * 2 - (int)pp[3][n].other.x;
 	y = (int)pp[1][n].other.y * 2 - (int)pp[3][n].other.y;
-	pp[0][n].all = PointRange(x, y, pp[1][n].other.x, pp[1][n].other.y);
+	pp[0][n].all = PointRange(ctx, x, y, pp[1][n].other.x, pp[1][n].other.y);
 	pp[0][n].other.predict = 1;
 }
-static void PointPredictTwo(unsigned int n)
+static void PointPredictTwo(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	int x, y;
 
 	x = pp[1][n].other.x * 2 - pp[2][n].other.x;
 	y = pp[1][n].other.y * 2 - pp[2][n].other.y;
-	pp[0][n].all = PointRange(x, y, pp[1][n].other.x, pp[1][n].other.y);
+	pp[0][n].all = PointRange(ctx, x, y, pp[1][n].other.x, pp[1][n].other.y);
 	pp[0][n].other.predict = 1;
 }
 
-static void PointPredictSpeed(unsigned int n)
+static void PointPredictSpeed(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	int x, y;
 
@@ -686,10 +812,10 @@ static void PointPredictSpeed(unsigned int n)
 	    (int)pp[1][n].other.x;
 	y = ((int)pp[1][n].other.y - (int)pp[2][n].other.y) * avg[0] / avg[1] +
 	    (int)pp[1][n].other.y;
-	pp[0][n].all = PointRange(x, y, pp[1][n].other.x, pp[1][n].other.y);
+	pp[0][n].all = PointRange(ctx, x, y, pp[1][n].other.x, pp[1][n].other.y);
 	pp[0][n].other.predict = 1;
 }
-static void PointPredictD3(unsigned int n)
+static void PointPredictD3(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	int x, y;
 
@@ -699,11 +825,11 @@ static void PointPredictD3(unsigned int n)
 	y = (int)pp[1][n].other.y * 5 + (int)pp[5][n].other.y -
 	    (int)pp[3][n].other.y * 4;
 	y /= 2;
-	pp[0][n].all = PointRange(x, y, pp[1][n].other.x, pp[1][n].other.y);
+	pp[0][n].all = PointRange(ctx, x, y, pp[1][n].other.x, pp[1][n].other.y);
 	pp[0][n].other.predict = 1;
 }
 
-static void PointPredictThree(unsigned int n)
+static void PointPredictThree(struct gsl_alg_ctx *ctx, unsigned int n)
 {
 	int x, y;
 
@@ -711,11 +837,11 @@ static void PointPredictThree(unsigned int n)
 	x /= 2;
 	y = pp[1][n].other.y * 5 + pp[3][n].other.y - pp[2][n].other.y * 4;
 	y /= 2;
-	pp[0][n].all = PointRange(x, y, pp[1][n].other.x, pp[1][n].other.y);
+	pp[0][n].all = PointRange(ctx, x, y, pp[1][n].other.x, pp[1][n].other.y);
 	pp[0][n].other.predict = 1;
 }
 
-static void PointPredict(void)
+static void PointPredict(struct gsl_alg_ctx *ctx)
 {
 	int i;
 
@@ -726,25 +852,25 @@ static void PointPredict(void)
 			    pp[3][i].all && pp[3][i].other.fill == 0) {
 				if (pp[4][i].all && pp[5][i].all &&
 				    pp[5][i].other.fill == 0)
-					PointPredictD3(i);
+					PointPredictD3(ctx, i);
 				else
-					PointPredictD2(i);
+					PointPredictD2(ctx, i);
 			} else if (global_state.other.interpolation ||
 				   pp[2][i].all == 0 ||
 				   pp[2][i].other.fill != 0 ||
 				   pp[3][i].other.fill != 0 ||
 				   pp[1][i].other.key != 0 ||
 				   global_state.other.only) {
-				PointPredictOne(i);
+				PointPredictOne(ctx, i);
 			} else if (pp[2][i].all != 0 &&
 				   (avg[0] != avg[1] || avg[1] != avg[2]) &&
 				   avg[0] != 0 && avg[1] != 0) {
-				PointPredictSpeed(i);
+				PointPredictSpeed(ctx, i);
 			} else if (pp[2][i].all != 0) {
 				if (pp[3][i].all != 0)
-					PointPredictThree(i);
+					PointPredictThree(ctx, i);
 				else
-					PointPredictTwo(i);
+					PointPredictTwo(ctx, i);
 			}
 			pp[0][i].all |= FLAG_FILL;
 			pa[0][i] = pa[1][i];
@@ -755,7 +881,7 @@ static void PointPredict(void)
 	}
 }
 
-static unsigned int PointDistance(union gsl_POINT_TYPE *p1,
+static unsigned int PointDistance(struct gsl_alg_ctx *ctx, union gsl_POINT_TYPE *p1,
 				  union gsl_POINT_TYPE *p2)
 {
 	int a, b, ret;
@@ -838,7 +964,7 @@ static int SpeedGet(int d)
 	return i;
 }
 
-static void PointId(void)
+static void PointId(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	struct gsl_DISTANCE_TYPE distance;
@@ -850,8 +976,8 @@ static void PointId(void)
 			id_speed[i] = id_first_coe;
 		else {
 			id_speed[i] =
-				SpeedGet(PointDistance(&pp[1][i], &pp[0][i]));
-			j = SpeedGet(PointDistance(&pp[2][i], &pp[1][i]));
+				SpeedGet(PointDistance(ctx, &pp[1][i], &pp[0][i]));
+			j = SpeedGet(PointDistance(ctx, &pp[2][i], &pp[1][i]));
 			if (id_speed[i] < (unsigned int)j)
 				id_speed[i] = j;
 		}
@@ -861,7 +987,7 @@ static void PointId(void)
 			continue;
 		for (j = 0; j < point_num && j < POINT_MAX; j++)
 			distance.d[j][i] =
-				PointDistance(&point_now[j], &pp[0][i]);
+				PointDistance(ctx, &point_now[j], &pp[0][i]);
 	}
 	if (point_num == 0)
 		return;
@@ -900,7 +1026,7 @@ static void PointId(void)
 	}
 }
 
-static int ClearLenPP(int i)
+static int ClearLenPP(struct gsl_alg_ctx *ctx, int i)
 {
 	int n;
 
@@ -911,7 +1037,7 @@ static int ClearLenPP(int i)
 	return n;
 }
 
-static void PointNewId(void)
+static void PointNewId(struct gsl_alg_ctx *ctx)
 {
 	int id, j;
 
@@ -923,7 +1049,7 @@ static void PointNewId(void)
 			if (point_now[j].other.able)
 				continue;
 			for (id = 1; id <= POINT_MAX; id++) {
-				if (ClearLenPP(id - 1) > (int)(1 + 1)) {
+				if (ClearLenPP(ctx, id - 1) > (int)(1 + 1)) {
 					pp[0][id - 1].all = point_now[j].all;
 					pa[0][id - 1] = pressure_now[j];
 					point_now[j].all = 0;
@@ -934,7 +1060,7 @@ static void PointNewId(void)
 	}
 }
 
-static void PointOrder(void)
+static void PointOrder(struct gsl_alg_ctx *ctx)
 {
 	int i;
 
@@ -949,7 +1075,7 @@ static void PointOrder(void)
 	}
 }
 
-static void PointCross(void)
+static void PointCross(struct gsl_alg_ctx *ctx)
 {
 	unsigned int i, j;
 	unsigned int t;
@@ -978,7 +1104,7 @@ static void PointCross(void)
 	}
 }
 
-static void GetPointNum(union gsl_POINT_TYPE *pt)
+static void GetPointNum(struct gsl_alg_ctx *ctx, union gsl_POINT_TYPE *pt)
 {
 	int i;
 
@@ -988,7 +1114,7 @@ static void GetPointNum(union gsl_POINT_TYPE *pt)
 			point_num++;
 }
 
-static unsigned int PointDelayAvg(int i)
+static unsigned int PointDelayAvg(struct gsl_alg_ctx *ctx, int i)
 {
 	UINT j, len;
 	int sum_x = 0;
@@ -1039,7 +1165,7 @@ static unsigned int PointDelayAvg(int i)
 	}
 	return TRUE;
 }
-static void PointDelay(void)
+static void PointDelay(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 
@@ -1104,7 +1230,7 @@ static void PointDelay(void)
 		if (id_flag.other.first_avg && pp[0][i].all == 0 &&
 		    pp[1][i].all != 0 && point_delay[i].other.able == 0 &&
 		    point_delay[i].other.init != 0) {
-			if (PointDelayAvg(i)) {
+			if (PointDelayAvg(ctx, i)) {
 				point_delay[i].other.able = 1;
 				point_delay[i].other.report = 1;
 				point_delay[i].other.dele = 1;
@@ -1124,7 +1250,7 @@ static void PointDelay(void)
 			}
 			if (j <= (int)point_delay[i].other.delay)
 				continue;
-			if (PointDelayAvg(i))
+			if (PointDelayAvg(ctx, i))
 				point_delay[i].other.able = 1;
 			else
 				j = 0;
@@ -1140,7 +1266,7 @@ static void PointDelay(void)
 		if (point_delay[i].other.able == 0)
 			continue;
 		if (report_delete == 0 && point_delay[i].other.report) {
-			if (PointDistance(
+			if (PointDistance(ctx, 
 				    &pp[point_delay[i].other.report][i],
 				    &pp[point_delay[i].other.report - 1][i]) <
 			    3 * 3) {
@@ -1152,7 +1278,7 @@ static void PointDelay(void)
 	}
 }
 
-static unsigned int PointMOne(unsigned int x0, unsigned int x1)
+static unsigned int PointMOne(struct gsl_alg_ctx *ctx, unsigned int x0, unsigned int x1)
 {
 	int e1, e2;
 
@@ -1171,7 +1297,7 @@ static unsigned int PointMOne(unsigned int x0, unsigned int x1)
 	return 0;
 }
 
-static void PointMenu(void)
+static void PointMenu(struct gsl_alg_ctx *ctx)
 {
 	unsigned int edge_dis;
 	unsigned int edge_e;
@@ -1189,15 +1315,15 @@ static void PointMenu(void)
 	edge_e = edge_start & 0xff;
 	edge_dis = (edge_start & 0xff00) >> 8;
 	edge_dis = edge_dis == 0 ? 8 * 8 : edge_dis * edge_dis;
-	if (PointDistance(&pp[0][0], &pp[1][0]) >= edge_dis) {
-		if (PointMOne(pp[0][0].other.x, pp[1][0].other.x))
+	if (PointDistance(ctx, &pp[0][0], &pp[1][0]) >= edge_dis) {
+		if (PointMOne(ctx, pp[0][0].other.x, pp[1][0].other.x))
 			pr[1][0].other.x = 1;
-		if (PointMOne(pp[0][0].other.y, pp[1][0].other.y))
+		if (PointMOne(ctx, pp[0][0].other.y, pp[1][0].other.y))
 			pr[1][0].other.y = 1;
-		if (PointMOne(drv_num_nokey * 64 - pp[0][0].other.x,
+		if (PointMOne(ctx, drv_num_nokey * 64 - pp[0][0].other.x,
 			      drv_num_nokey * 64 - pp[1][0].other.x))
 			pr[1][0].other.x = drv_num_nokey * 64 - 1;
-		if (PointMOne(sen_num_nokey * 64 - pp[0][0].other.y,
+		if (PointMOne(ctx, sen_num_nokey * 64 - pp[0][0].other.y,
 			      sen_num_nokey * 64 - pp[1][0].other.y))
 			pr[1][0].other.y = sen_num_nokey * 64 - 1;
 	} else if (global_state.other.menu == 0) {
@@ -1213,7 +1339,7 @@ static void PointMenu(void)
 	}
 }
 
-static void FilterOne(int i, int *ps_c, int *pr_c, int denominator)
+static void FilterOne(struct gsl_alg_ctx *ctx, int i, int *ps_c, int *pr_c, int denominator)
 {
 	int j;
 	int x = 0, y = 0;
@@ -1231,26 +1357,20 @@ static void FilterOne(int i, int *ps_c, int *pr_c, int denominator)
 	}
 	x = (x + denominator / 2) / denominator;
 	y = (y + denominator / 2) / denominator;
-	if (x < 0)
-		x = 0;
-	if (x > 0xffff)
-		x = 0xffff;
-	if (y < 0)
-		y = 0;
-	if (y > 0xfff)
-		y = 0xfff;
+	x = x < 0 ? 0 : (x > 0xffff ? 0xffff : x);
+	y = y < 0 ? 0 : (y > 0xfff ? 0xfff : y);
 	pr[0][i].other.x = x;
 	pr[0][i].other.y = y;
 }
 
-static unsigned int FilterSpeed(int i)
+static unsigned int FilterSpeed(struct gsl_alg_ctx *ctx, int i)
 {
-	return (Sqrt(PointDistance(&ps[0][i], &ps[1][i])) +
-		Sqrt(PointDistance(&ps[1][i], &ps[2][i]))) /
+	return (Sqrt(PointDistance(ctx, &ps[0][i], &ps[1][i])) +
+		Sqrt(PointDistance(ctx, &ps[1][i], &ps[2][i]))) /
 	       2;
 }
 
-static int MedianSpeedOver(int id, int deep)
+static int MedianSpeedOver(struct gsl_alg_ctx *ctx, int id, int deep)
 {
 	int i;
 	unsigned int dis;
@@ -1261,7 +1381,7 @@ static int MedianSpeedOver(int id, int deep)
 		return TRUE;
 	dis = median_dis[deep] * median_dis[deep];
 	for (i = 0; i <= deep && i < POINT_DEEP; i++) {
-		if (PointDistance(&ps[i][id], &ps[i + 1][id]) > dis)
+		if (PointDistance(ctx, &ps[i][id], &ps[i + 1][id]) > dis)
 			speed_over++;
 	}
 	if (speed_over >= 2)
@@ -1269,7 +1389,7 @@ static int MedianSpeedOver(int id, int deep)
 	return FALSE;
 }
 
-static void PointMedian(void)
+static void PointMedian(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	int deep;
@@ -1284,7 +1404,7 @@ static void PointMedian(void)
 			deep = PS_DEEP - 1;
 		deep |= 1;
 		for (; deep >= 3; deep -= 2) {
-			if (MedianSpeedOver(i, deep))
+			if (MedianSpeedOver(ctx, i, deep))
 				continue;
 			for (j = 0; j < deep; j++) {
 				buf_x[j] = ps[j][i].other.x;
@@ -1300,13 +1420,26 @@ static void PointMedian(void)
 	}
 }
 
-static void PointFilter(void)
+/* Unpack the signed 8-bit taps once per DataInit() instead of every frame */
+static void FilterCoeInit(struct gsl_alg_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		filter_ps_c[i] = (filter_coe[i / 4] >> ((i % 4) * 8)) & 0xff;
+		filter_pr_c[i] = (filter_coe[i / 4 + 2] >> ((i % 4) * 8)) & 0xff;
+		if (filter_ps_c[i] >= 0x80)
+			filter_ps_c[i] |= 0xffffff00;
+		if (filter_pr_c[i] >= 0x80)
+			filter_pr_c[i] |= 0xffffff00;
+	}
+}
+
+static void PointFilter(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	int speed_now;
 	int filter_speed[6];
-	int ps_c[8];
-	int pr_c[8];
 
 	for (i = 0; i < POINT_MAX; i++)
 		pr[0][i].all = ps[0][i].all;
@@ -1322,20 +1455,11 @@ static void PointFilter(void)
 	if (filter_able >= 0 && filter_able <= 1)
 		return;
 	if (filter_able > 1) {
-		for (i = 0; i < 8; i++) {
-			ps_c[i] = (filter_coe[i / 4] >> ((i % 4) * 8)) & 0xff;
-			pr_c[i] =
-				(filter_coe[i / 4 + 2] >> ((i % 4) * 8)) & 0xff;
-			if (ps_c[i] >= 0x80)
-				ps_c[i] |= 0xffffff00;
-			if (pr_c[i] >= 0x80)
-				pr_c[i] |= 0xffffff00;
-		}
 		for (i = 0; i < POINT_MAX; i++)
-			FilterOne(i, ps_c, pr_c, filter_able);
+			FilterOne(ctx, i, filter_ps_c, filter_pr_c, filter_able);
 
 	} else if (filter_able == -1) {
-		PointMedian();
+		PointMedian(ctx);
 	} else if (filter_able < 0) {
 		for (i = 0; i < 4; i++)
 			filter_speed[i + 1] = median_dis[i];
@@ -1346,7 +1470,7 @@ static void PointFilter(void)
 				filter_deep[i] = 0;
 				continue;
 			}
-			speed_now = FilterSpeed(i);
+			speed_now = FilterSpeed(ctx, i);
 			if (filter_deep[i] > 0 &&
 			    speed_now > filter_speed[filter_deep[i] + 1 - 2])
 				filter_deep[i]--;
@@ -1355,13 +1479,13 @@ static void PointFilter(void)
 					 filter_speed[filter_deep[i] + 1 + 2])
 				filter_deep[i]++;
 
-			FilterOne(i, ps_coe[filter_deep[i]],
+			FilterOne(ctx, i, ps_coe[filter_deep[i]],
 				  pr_coe[filter_deep[i]], 0 - filter_able);
 		}
 	}
 }
 
-static unsigned int KeyMap(int *drv, int *sen)
+static unsigned int KeyMap(struct gsl_alg_ctx *ctx, int *drv, int *sen)
 {
 	struct KEY_TYPE_RANGE {
 		unsigned int up_down, left_right;
@@ -1384,7 +1508,7 @@ static unsigned int KeyMap(int *drv, int *sen)
 	return 0;
 }
 
-static unsigned int ScreenResolution(union gsl_POINT_TYPE *p)
+static unsigned int ScreenResolution(struct gsl_alg_ctx *ctx, union gsl_POINT_TYPE *p)
 {
 	int x, y;
 
@@ -1441,13 +1565,13 @@ static unsigned int ScreenResolution(union gsl_POINT_TYPE *p)
 			y = 0;
 		if (x < 0)
 			x = 0;
-		if ((key_map_able & 0x1) != FALSE && KeyMap(&x, &y) == 0)
+		if ((key_map_able & 0x1) != FALSE && KeyMap(ctx, &x, &y) == 0)
 			return 0;
 	}
 	return ((y << 16) & 0x0fff0000) + (x & 0x0000ffff);
 }
 
-static void PointReport(struct gsl_touch_info *cinfo)
+static void PointReport(struct gsl_alg_ctx *ctx, struct gsl_touch_info *cinfo)
 {
 	int i;
 	unsigned int data[POINT_MAX];
@@ -1477,7 +1601,7 @@ static void PointReport(struct gsl_touch_info *cinfo)
 			if (pr[point_delay[i].other.report][i].all) {
 				pr[point_delay[i].other.report][i].other.able =
 					1;
-				data[i] = ScreenResolution(
+				data[i] = ScreenResolution(ctx, 
 					&pr[point_delay[i].other.report][i]);
 				if (data[i]) {
 					dp[i] = pressure_report[i];
@@ -1498,7 +1622,7 @@ static void PointReport(struct gsl_touch_info *cinfo)
 			    0) {
 				pr[point_delay[i].other.report][i].other.able =
 					1;
-				data[i] = ScreenResolution(
+				data[i] = ScreenResolution(ctx, 
 					&pr[point_delay[i].other.report][i]);
 				if (data[i]) {
 					dp[i] = pressure_report[i];
@@ -1515,7 +1639,7 @@ static void PointReport(struct gsl_touch_info *cinfo)
 				continue;
 			if (point_delay[i].other.report >= PR_DEEP)
 				continue;
-			data[num] = ScreenResolution(
+			data[num] = ScreenResolution(ctx, 
 				&pr[point_delay[i].other.report][i]);
 			if (data[num]) {
 				dp[num] = pressure_report[i];
@@ -1568,7 +1692,7 @@ static void PointReport(struct gsl_touch_info *cinfo)
 		prec_id.other.num = (unsigned char)point_num;
 }
 
-static void PointRound(void)
+static void PointRound(struct gsl_alg_ctx *ctx)
 {
 	int id, i;
 	int x, y;
@@ -1705,7 +1829,7 @@ static void PointRound(void)
 	}
 }
 
-static void PointEdge(void)
+static void PointEdge(struct gsl_alg_ctx *ctx)
 {
 	struct STRETCH_TYPE {
 		int range;
@@ -1851,9 +1975,8 @@ static void PointEdge(void)
 	}
 }
 
-static void PointStretch_for(int *dc_p, int *ds_p)
+static void PointStretch_for(struct gsl_alg_ctx *ctx, int *dc_p, int *ds_p)
 {
-	static int save_dr[POINT_MAX], save_dn[POINT_MAX];
 	int i, j;
 	int dn;
 	int dr;
@@ -1932,7 +2055,7 @@ static void PointStretch_for(int *dc_p, int *ds_p)
 				}
 			}
 		} else {
-			dn = PointDistance(&pp[0][i], &ps[1][i]);
+			dn = PointDistance(ctx, &pp[0][i], &ps[1][i]);
 			dn = Sqrt(dn);
 			if (dn >= ds[0])
 				continue;
@@ -1981,7 +2104,7 @@ static void PointStretch_for(int *dc_p, int *ds_p)
 	}
 }
 
-static void PointStretch(void)
+static void PointStretch(struct gsl_alg_ctx *ctx)
 {
 	struct SHAKE_TYPE {
 		int dis;
@@ -2029,14 +2152,14 @@ static void PointStretch(void)
 						sen_num_nokey * 64 -
 						((edge_first >> 0) & 0xff);
 				if (point_edge.coor.all != ps[0][i].all) {
-					point_edge.dis = PointDistance(
+					point_edge.dis = PointDistance(ctx, 
 						&ps[0][i], &point_edge.coor);
 					if (point_edge.dis)
 						point_edge.rate = 0x1000;
 				}
 			}
 			if (point_edge.rate != 0 && point_edge.dis != 0) {
-				temp = PointDistance(&ps[0][i],
+				temp = PointDistance(ctx, &ps[0][i],
 						     &point_edge.coor);
 				if (temp >=
 				    point_edge.dis * edge_first_coe / 0x80) {
@@ -2074,8 +2197,8 @@ static void PointStretch(void)
 					break;
 			}
 			j--;
-			dn = PointDistance(&ps[0][i], &ps[j][i]);
-			if (PointDistance(&ps[0][i], &ps[j][i]) >=
+			dn = PointDistance(ctx, &ps[0][i], &ps[j][i]);
+			if (PointDistance(ctx, &ps[0][i], &ps[j][i]) >=
 			    (unsigned int)shake_min * 4) {
 				point_delay[i].other.init = 1;
 				point_delay[i].other.able = 1;
@@ -2083,7 +2206,7 @@ static void PointStretch(void)
 				point_delay[i].other.dele = 1;
 			}
 		} else if ((point_shake & (0x1 << i)) == 0) {
-			if (PointDistance(&ps[0][i], &ps[1][i]) <
+			if (PointDistance(ctx, &ps[0][i], &ps[1][i]) <
 			    (unsigned int)shake_min) {
 				if (point_delay[i].other.able)
 					ps[0][i].all = ps[1][i].all;
@@ -2115,7 +2238,7 @@ static void PointStretch(void)
 			}
 			if ((point_shake & (0x1 << i)) == 0)
 				continue;
-			dn = PointDistance(&pp[0][i], &ps[1][i]);
+			dn = PointDistance(ctx, &pp[0][i], &ps[1][i]);
 			dn = Sqrt(dn);
 			dr = dn > ds[0] ? dn - ds[0] : 0;
 			temp = ps[0][i].all;
@@ -2201,13 +2324,13 @@ static void PointStretch(void)
 					(shake_all[0].coe - shake_all[1].coe);
 			dc[0] = 128;
 		}
-		PointStretch_for(dc, ds);
+		PointStretch_for(ctx, dc, ds);
 	} else {
 		return;
 	}
 }
 
-static void ResetMask(void)
+static void ResetMask(struct gsl_alg_ctx *ctx)
 {
 	if (reset_mask_send)
 		reset_mask_send = 0;
@@ -2238,7 +2361,7 @@ static void ResetMask(void)
 	reset_mask_count++;
 	if (reset_mask_max == 0)
 		reset_mask_max = pp[0][0].all;
-	else if (PointDistance((union gsl_POINT_TYPE *)(&reset_mask_max),
+	else if (PointDistance(ctx, (union gsl_POINT_TYPE *)(&reset_mask_max),
 			       pp[0]) >
 			 (((unsigned int)reset_mask_dis) & 0xffffff) &&
 		 reset_mask_count > (((unsigned int)reset_mask_dis) >> 24))
@@ -2326,7 +2449,7 @@ static int ConfigKeyMap(unsigned int data[])
 	return TRUE;
 }
 
-static int DiagonalDistance(union gsl_POINT_TYPE *p, int type)
+static int DiagonalDistance(struct gsl_alg_ctx *ctx, union gsl_POINT_TYPE *p, int type)
 {
 	int divisor, square;
 
@@ -2347,7 +2470,7 @@ static int DiagonalDistance(union gsl_POINT_TYPE *p, int type)
 	return square * square / divisor;
 }
 
-static void DiagonalCompress(union gsl_POINT_TYPE *p, int type, int dis,
+static void DiagonalCompress(struct gsl_alg_ctx *ctx, union gsl_POINT_TYPE *p, int type, int dis,
 			     int dis_max)
 {
 	int x, y;
@@ -2388,7 +2511,7 @@ static void DiagonalCompress(union gsl_POINT_TYPE *p, int type, int dis,
 	p->other.y = y;
 }
 
-static void PointDiagonal(void)
+static void PointDiagonal(struct gsl_alg_ctx *ctx)
 {
 	int i;
 	int diagonal_size;
@@ -2422,10 +2545,10 @@ static void PointDiagonal(void)
 				point_corner |= 0x1 << i * 2;
 		}
 		if (point_corner & (0x2 << i * 2)) {
-			dis = DiagonalDistance(&(ps[0][i]),
+			dis = DiagonalDistance(ctx, &(ps[0][i]),
 					       point_corner & (0x1 << i * 2));
 			if (dis <= diagonal_size * 4) {
-				DiagonalCompress(&(ps[0][i]),
+				DiagonalCompress(ctx, &(ps[0][i]),
 						 point_corner & (0x1 << i * 2),
 						 dis, diagonal_size);
 			} else if (dis > diagonal_size * 4) {
@@ -2436,7 +2559,7 @@ static void PointDiagonal(void)
 	}
 }
 
-static int PointSlope(int i, int j)
+static int PointSlope(struct gsl_alg_ctx *ctx, int i, int j)
 {
 	int x, y;
 
@@ -2452,7 +2575,7 @@ static int PointSlope(int i, int j)
 		return y * 1024 / (x + y);
 }
 
-static void PointExtend(void)
+static void PointExtend(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	int x, y;
@@ -2470,11 +2593,11 @@ static void PointExtend(void)
 		}
 		if (j < extend_len)
 			continue;
-		if (PointDistance(&pr[1][i], &pr[2][i]) < 16 * 16)
+		if (PointDistance(ctx, &pr[1][i], &pr[2][i]) < 16 * 16)
 			continue;
-		t = PointSlope(i, 1);
+		t = PointSlope(ctx, i, 1);
 		for (j = 2; j < extend_len - 1; j++) {
-			t2 = PointSlope(i, j);
+			t2 = PointSlope(ctx, i, j);
 			if (t2 < 0 || t2 < t * (128 - point_extend) / 128 ||
 			    t2 > t * (128 + point_extend) / 128)
 				break;
@@ -2484,11 +2607,11 @@ static void PointExtend(void)
 		x = 3 * pr[1][i].other.x - 2 * pr[2][i].other.x;
 		y = 3 * pr[1][i].other.y - 2 * pr[2][i].other.y;
 		pr[0][i].all =
-			PointRange(x, y, pr[1][i].other.x, pr[1][i].other.y);
+			PointRange(ctx, x, y, pr[1][i].other.x, pr[1][i].other.y);
 	}
 }
 
-static void PressureSave(void)
+static void PressureSave(struct gsl_alg_ctx *ctx)
 {
 	int i;
 
@@ -2505,7 +2628,7 @@ static void PressureSave(void)
 	}
 }
 
-static void PointPressure(void)
+static void PointPressure(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 
@@ -2528,7 +2651,7 @@ static void PointPressure(void)
 	}
 }
 
-static void PressMask(void)
+static void PressMask(struct gsl_alg_ctx *ctx)
 {
 	int i, j;
 	unsigned int press_max = press_mask & 0xff;
@@ -2571,14 +2694,14 @@ static void PressMask(void)
 			if (pr[0][j].all == 0 || point_delay[j].other.able == 0)
 				continue;
 
-			if (PointDistance(&pp[0][i], &pp[0][j]) <
+			if (PointDistance(ctx, &pp[0][i], &pp[0][j]) <
 			    press_range * press_range)
 				point_delay[j].other.able = 0;
 		}
 	}
 }
 
-static void PressMove(void)
+static void PressMove(struct gsl_alg_ctx *ctx)
 {
 	int i;
 	/* POINT_TYPE_ID point_press_move; */
@@ -2596,7 +2719,7 @@ static void PressMove(void)
 	if (point_press_move.all == 0) {
 		point_press_move.all = pr[0][0].all;
 	} else if (point_press_move.other.x && point_press_move.other.y) {
-		if (PointDistance(&point_press_move, &pr[0][0]) >
+		if (PointDistance(ctx, &point_press_move, &pr[0][0]) >
 		    (press_move >> 16) * (press_move >> 16)) {
 			/* #define	x0		point_press_move.x */
 			/* #define	y0		point_press_move.y */
@@ -2654,16 +2777,21 @@ press_move_err:
 	point_press_move.all = 0;
 }
 
-int gsl_PressMove(void)
+int gsl_alg_ctx_press_move(struct gsl_alg_ctx *ctx)
 {
 	if (point_press_move.all <= 4)
 		return point_press_move.all;
 	else
 		return 0;
 }
+
+int gsl_PressMove(void)
+{
+	return gsl_alg_ctx_press_move(&gsl_default_ctx);
+}
 /* EXPORT_SYMBOL(gsl_PressMove); */
 
-void gsl_ReportPressure(unsigned int *p)
+void gsl_alg_ctx_report_pressure(struct gsl_alg_ctx *ctx, unsigned int *p)
 {
 	int i;
 
@@ -2681,6 +2809,11 @@ void gsl_ReportPressure(unsigned int *p)
 			p[i] = 0;
 	}
 }
+
+void gsl_ReportPressure(unsigned int *p)
+{
+	gsl_alg_ctx_report_pressure(&gsl_default_ctx, p);
+}
 /* EXPORT_SYMBOL(gsl_ReportPressure); */
 
 int gsl_TouchNear(void)
@@ -2689,7 +2822,7 @@ int gsl_TouchNear(void)
 }
 /* EXPORT_SYMBOL(gsl_TouchNear); */
 
-static void gsl_id_reg_init(int flag)
+static void gsl_id_reg_init(struct gsl_alg_ctx *ctx, int flag)
 {
 	int i, j;
 
@@ -2732,7 +2865,7 @@ static void gsl_id_reg_init(int flag)
 	}
 }
 
-static int DataCheck(void)
+static int DataCheck(struct gsl_alg_ctx *ctx)
 {
 	if (drv_num == 0 || drv_num_nokey == 0 || sen_num == 0 ||
 	    sen_num_nokey == 0)
@@ -2742,14 +2875,14 @@ static int DataCheck(void)
 	return 1;
 }
 
-void gsl_DataInit(unsigned int *conf_in)
+static void DataInit(struct gsl_alg_ctx *ctx, unsigned int *conf_in)
 {
 	ESP_LOGI(TAG,"gsl_DataInit");
 	int i, j;
 	unsigned int *conf;
 	int len;
 
-	gsl_id_reg_init(1);
+	gsl_id_reg_init(ctx, 1);
 	for (i = 0; i < POINT_MAX; i++)
 		point_now[i].all = 0;
 	conf = config_static;
@@ -3009,7 +3142,7 @@ void gsl_DataInit(unsigned int *conf_in)
 		}
 	}
 	/* --------------------------------------------- */
-	gsl_id_reg_init(0);
+	gsl_id_reg_init(ctx, 0);
 	/* --------------------------------------------- */
 	if (average == 0)
 		average = 4;
@@ -3030,10 +3163,29 @@ void gsl_DataInit(unsigned int *conf_in)
 		if (ignore_y[i] & 0x8000)
 			ignore_y[i] |= 0xffff0000;
 	}
+	FilterCoeInit(ctx);
 	for (i = 0; i < CONFIG_LENGTH; i++)
 		config_static[i] = 0;
+	ctx->idle_track = 0;
+	ctx->idle_ready = 0;
+}
+
+size_t gsl_alg_ctx_size(void)
+{
+	return sizeof(struct gsl_alg_ctx);
 }
 
+void gsl_alg_ctx_init(struct gsl_alg_ctx *ctx, unsigned int *conf_in)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	DataInit(ctx, conf_in);
+}
+
+/* Legacy entry: re-init keeps the state DataInit() does not touch */
+void gsl_DataInit(unsigned int *conf_in)
+{
+	DataInit(&gsl_default_ctx, conf_in);
+}
 
 unsigned int gsl_version_id(void)
 {
@@ -3041,13 +3193,18 @@ unsigned int gsl_version_id(void)
 }
 
 
-unsigned int gsl_mask_tiaoping(void)
+unsigned int gsl_alg_ctx_mask_tiaoping(struct gsl_alg_ctx *ctx)
 {
 	// printf("reset_mask_send:%d\r\n",reset_mask_send);
 	return reset_mask_send;
 }
 
-static void GetFlag(void)
+unsigned int gsl_mask_tiaoping(void)
+{
+	return gsl_alg_ctx_mask_tiaoping(&gsl_default_ctx);
+}
+
+static void GetFlag(struct gsl_alg_ctx *ctx)
 {
 	int i = 0;
 	int num_save;
@@ -3062,7 +3219,7 @@ static void GetFlag(void)
 	}
 	if (((point_num & 0x100) != 0) ||
 	    ((point_num & 0x200) != 0 && global_state.other.reset == 1)) {
-		gsl_id_reg_init(0);
+		gsl_id_reg_init(ctx, 0);
 	}
 	if ((point_num & 0x300) == 0)
 		global_state.other.reset = 1;
@@ -3089,13 +3246,13 @@ static void GetFlag(void)
 		    global_state.other.active_prev) {
 			if (global_state.other.active) {
 				if (prec_id.other.num)
-					gsl_id_reg_init(1);
+					gsl_id_reg_init(ctx, 1);
 				else
-					gsl_id_reg_init(0);
+					gsl_id_reg_init(ctx, 0);
 				global_state.other.active = 1;
 				global_state.other.active_prev = 1;
 			} else
-				gsl_id_reg_init(0);
+				gsl_id_reg_init(ctx, 0);
 		}
 	}
 	inte_count++;
@@ -3110,7 +3267,7 @@ static void GetFlag(void)
 	point_num = (point_num & (~0xff)) + num_save;
 }
 
-static void PointIgnore(void)
+static void PointIgnore(struct gsl_alg_ctx *ctx)
 {
 	int i, x, y;
 
@@ -3151,7 +3308,12 @@ static void PointIgnore(void)
 	point_num = x;
 }
 
-void gsl_alg_id_main(struct gsl_touch_info *cinfo)
+/* Host replay builds (tools/gsl_replay) define GSL_STAGE() to time each stage */
+#ifndef GSL_STAGE
+#define GSL_STAGE(call) call
+#endif
+
+static void AlgMain(struct gsl_alg_ctx *ctx, struct gsl_touch_info *cinfo)
 {
 	int i;
 	// ESP_LOGI(TAG,"gsl_alg_id_main");
@@ -3160,42 +3322,206 @@ void gsl_alg_id_main(struct gsl_touch_info *cinfo)
 		point_now[i].all = (cinfo->id[i] << 28) | (cinfo->x[i] << 16) |
 				   cinfo->y[i];
 
-	GetFlag();
-	if (DataCheck() == 0) {
+	GSL_STAGE(GetFlag(ctx));
+	if (DataCheck(ctx) == 0) {
 		point_num = 0;
 		cinfo->finger_num = 0;
 		return;
 	}
-	PressureSave();
+	GSL_STAGE(PressureSave(ctx));
 	point_num &= 0xff;
-	PointIgnore();
-	PointCoor();
-	CoordinateCorrect();
-	PointEdge();
-	PointRound();
-	PointRepeat();
-	GetPointNum(point_now);
-	PointPointer();
-	PointPredict();
-	PointId();
-	PointNewId();
-	PointOrder();
-	PointCross();
-	GetPointNum(pp[0]);
+	GSL_STAGE(PointIgnore(ctx));
+	GSL_STAGE(PointCoor(ctx));
+	GSL_STAGE(CoordinateCorrect(ctx));
+	GSL_STAGE(PointEdge(ctx));
+	GSL_STAGE(PointRound(ctx));
+	GSL_STAGE(PointRepeat(ctx));
+	GSL_STAGE(GetPointNum(ctx, point_now));
+	GSL_STAGE(PointPointer(ctx));
+	GSL_STAGE(PointPredict(ctx));
+	GSL_STAGE(PointId(ctx));
+	GSL_STAGE(PointNewId(ctx));
+	GSL_STAGE(PointOrder(ctx));
+	GSL_STAGE(PointCross(ctx));
+	GSL_STAGE(GetPointNum(ctx, pp[0]));
 
 	prev_num = point_num;
-	ResetMask();
-	PointStretch();
-	PointDiagonal();
-	PointFilter();
-	GetPointNum(pr[0]);
+	GSL_STAGE(ResetMask(ctx));
+	GSL_STAGE(PointStretch(ctx));
+	GSL_STAGE(PointDiagonal(ctx));
+	GSL_STAGE(PointFilter(ctx));
+	GSL_STAGE(GetPointNum(ctx, pr[0]));
 
-	PointDelay();
-	PointMenu();
-	PointExtend();
-	PointPressure();
-	PressMove();
-	PressMask();
-	PointReport(cinfo);
+	GSL_STAGE(PointDelay(ctx));
+	GSL_STAGE(PointMenu(ctx));
+	GSL_STAGE(PointExtend(ctx));
+	GSL_STAGE(PointPressure(ctx));
+	GSL_STAGE(PressMove(ctx));
+	GSL_STAGE(PressMask(ctx));
+	GSL_STAGE(PointReport(ctx, cinfo));
 }
 
+static int HistoryClear(struct gsl_alg_ctx *ctx)
+{
+	const unsigned int *p;
+	unsigned int acc = 0;
+	int i;
+
+	p = (const unsigned int *)point_array;
+	for (i = 0; i < POINT_DEEP * POINT_MAX; i++)
+		acc |= p[i];
+	p = (const unsigned int *)pressure_array;
+	for (i = 0; i < PRESSURE_DEEP * POINT_MAX; i++)
+		acc |= p[i];
+	return acc == 0;
+}
+
+/*
+ * Idle fast path.  Once the controller keeps sending the same report and
+ * every history row has drained to zero, a full AlgMain() pass no longer
+ * changes anything except the ring rotation and inte_count.  After two
+ * consecutive frames prove that (same input, same live state, rings clear),
+ * later identical frames only replay those side effects and the stored
+ * output.  Any other input falls back to the full pipeline, so the result is
+ * bit-identical to always running it.
+ */
+static void IdleTrack(struct gsl_alg_ctx *ctx, const struct gsl_touch_info *in,
+		      const struct gsl_touch_info *out, int n_prev,
+		      int inte_prev)
+{
+	if (!HistoryClear(ctx)) {
+		ctx->idle_track = 0;
+		return;
+	}
+	if (ctx->idle_track && inte_count == inte_prev + 1 && inte_count > 1 &&
+	    memcmp(in, &ctx->idle_in, sizeof(*in)) == 0 &&
+	    memcmp(&ctx->live, &ctx->idle_live, sizeof(ctx->live)) == 0) {
+		ctx->idle_rotate = point_n != n_prev;
+		ctx->idle_out = *out;
+		ctx->idle_ready = 1;
+		return;
+	}
+	ctx->idle_in = *in;
+	ctx->idle_live = ctx->live;
+	ctx->idle_track = 1;
+}
+
+void gsl_alg_ctx_id_main(struct gsl_alg_ctx *ctx, struct gsl_touch_info *cinfo)
+{
+	struct gsl_touch_info in;
+	int n_prev, inte_prev;
+
+	TRACE_RING_BEGIN_TAG("gsl_alg_id_main");
+	if (ctx->idle_ready &&
+	    memcmp(cinfo, &ctx->idle_in, sizeof(*cinfo)) == 0) {
+		inte_count++;
+		if (ctx->idle_rotate)
+			PointPointer(ctx);
+		*cinfo = ctx->idle_out;
+		TRACE_RING_END_TAG("gsl_alg_id_main");
+		return;
+	}
+	ctx->idle_ready = 0;
+	in = *cinfo;
+	n_prev = point_n;
+	inte_prev = inte_count;
+	AlgMain(ctx, cinfo);
+	IdleTrack(ctx, &in, cinfo, n_prev, inte_prev);
+	TRACE_RING_END_TAG("gsl_alg_id_main");
+}
+
+void gsl_alg_id_main(struct gsl_touch_info *cinfo)
+{
+	gsl_alg_ctx_id_main(&gsl_default_ctx, cinfo);
+}
+
+/* The field aliases above are private to this file; tools/gsl_replay includes it */
+#undef average
+#undef avg
+#undef config_static
+#undef coordinate_correct_able
+#undef coordinate_correct_coe_x
+#undef coordinate_correct_coe_y
+#undef csensor_count
+#undef delay_key
+#undef diagonal
+#undef drv_num
+#undef drv_num_nokey
+#undef edge_cut
+#undef edge_first
+#undef edge_first_coe
+#undef edge_start
+#undef filter_able
+#undef filter_coe
+#undef filter_deep
+#undef filter_pr_c
+#undef filter_ps_c
+#undef global_flag
+#undef global_state
+#undef id_first_coe
+#undef id_flag
+#undef id_speed_coe
+#undef id_static_coe
+#undef ignore_x
+#undef ignore_y
+#undef inte_count
+#undef key_map_able
+#undef key_range_array
+#undef match_x
+#undef match_y
+#undef median_dis
+#undef multi_group
+#undef multi_x_array
+#undef multi_y_array
+#undef pa
+#undef point_array
+#undef point_corner
+#undef point_decimal
+#undef point_delay
+#undef point_edge
+#undef point_extend
+#undef point_n
+#undef point_near
+#undef point_now
+#undef point_num
+#undef point_num_max
+#undef point_pointer
+#undef point_predict
+#undef point_press_move
+#undef point_repeat
+#undef point_report
+#undef point_shake
+#undef point_stretch
+#undef pp
+#undef pr
+#undef pr_coe
+#undef prec_id
+#undef press_mask
+#undef press_move
+#undef pressure_array
+#undef pressure_now
+#undef pressure_pointer
+#undef pressure_report
+#undef prev_num
+#undef ps
+#undef ps_coe
+#undef report_ahead
+#undef report_delay
+#undef report_delete
+#undef reset_mask_count
+#undef reset_mask_dis
+#undef reset_mask_max
+#undef reset_mask_send
+#undef reset_mask_type
+#undef save_dn
+#undef save_dr
+#undef screen_x_max
+#undef screen_y_max
+#undef sen_num
+#undef sen_num_nokey
+#undef shake_all_array
+#undef shake_min
+#undef soft_average
+#undef stretch_active
+#undef stretch_array
+#undef stretch_mult
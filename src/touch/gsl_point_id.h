@@ -1,6 +1,8 @@
 #ifndef _GSL_POINT_ID_H
 #define _GSL_POINT_ID_H
 
+#include <stddef.h>
+
 struct gsl_touch_info
 {
     int x[10];
@@ -9,10 +11,24 @@ struct gsl_touch_info
     int finger_num;
 };
 
+/* Per-controller algorithm state. Opaque: allocate gsl_alg_ctx_size() bytes
+ * wherever it is fastest (e.g. internal SRAM) and call gsl_alg_ctx_init(). */
+struct gsl_alg_ctx;
+
+size_t gsl_alg_ctx_size(void);
+void gsl_alg_ctx_init(struct gsl_alg_ctx *ctx, unsigned int *conf_in);
+void gsl_alg_ctx_id_main(struct gsl_alg_ctx *ctx, struct gsl_touch_info *cinfo);
+unsigned int gsl_alg_ctx_mask_tiaoping(struct gsl_alg_ctx *ctx);
+int gsl_alg_ctx_press_move(struct gsl_alg_ctx *ctx);
+void gsl_alg_ctx_report_pressure(struct gsl_alg_ctx *ctx, unsigned int *p);
+
+/* Tuning table for the panel this firmware ships with (gsl3680_config.c) */
+extern unsigned int gsl_config_data_id[];
+
+/* Legacy single-instance API (shared default context) */
 unsigned int gsl_mask_tiaoping(void);
 unsigned int gsl_version_id(void);
 void gsl_alg_id_main(struct gsl_touch_info *cinfo);
 void gsl_DataInit(unsigned int *conf_in);
 
 #endif
-
@@ -0,0 +1,200 @@
+#include <string.h>
+#include "trend_pyramid.h"
+
+/*
+ * Bucket i of a level covers [i * bucket_ms, (i + 1) * bucket_ms) and every
+ * bucket length divides the next, so a closed bucket lies inside exactly one
+ * bucket of the level above. Sums and counts are carried up, not means, so a
+ * 10 min mean is the mean of its samples, not of its minutes.
+ *
+ * A level only moves on when something is folded into it. Until then its
+ * open bucket keeps the last data it got and the buckets after it read as
+ * empty, which is what they are: the samples since sit in the open buckets
+ * below (at most one bucket length of the level underneath).
+ */
+
+static const uint32_t s_bucket_ms[TREND_PYRAMID_LEVELS] = TREND_PYRAMID_BUCKET_MS;
+static const uint32_t s_cap[TREND_PYRAMID_LEVELS] = TREND_PYRAMID_CAP;
+
+size_t trend_pyramid_storage_bytes(uint32_t channels)
+{
+    size_t n = 0;
+
+    for (int k = 0; k < TREND_PYRAMID_LEVELS; k++) {
+        n += (size_t)channels * sizeof(trend_acc_t);
+        n += (size_t)s_cap[k] * channels * sizeof(trend_bucket_t);
+    }
+    return n;
+}
+
+static void acc_reset(trend_acc_t *a, uint32_t channels)
+{
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        a[ch].min = INT32_MAX;
+        a[ch].max = INT32_MIN;
+        a[ch].sum = 0;
+        a[ch].n = 0;
+    }
+}
+
+void trend_pyramid_init(trend_pyramid_t *p, uint32_t channels, void *storage)
+{
+    uint8_t *mem = (uint8_t *)storage;
+
+    memset(p, 0, sizeof(*p));
+    p->channels = channels;
+    memset(storage, 0, trend_pyramid_storage_bytes(channels));
+    for (int k = 0; k < TREND_PYRAMID_LEVELS; k++) {
+        trend_level_t *l = &p->level[k];
+        l->bucket_ms = s_bucket_ms[k];
+        l->cap = s_cap[k];
+        l->acc = (trend_acc_t *)mem;
+        mem += (size_t)channels * sizeof(trend_acc_t);
+        l->ring = (trend_bucket_t *)mem;
+        mem += (size_t)l->cap * channels * sizeof(trend_bucket_t);
+        acc_reset(l->acc, channels);
+    }
+}
+
+/* Mean rounded to nearest, halves away from zero */
+static int32_t mean_of(int64_t sum, uint32_t n)
+{
+    return (int32_t)(sum >= 0 ? (sum + n / 2) / n : -((-sum + n / 2) / n));
+}
+
+static void store(trend_bucket_t *b, const trend_acc_t *a)
+{
+    if (a->n == 0) {
+        memset(b, 0, sizeof(*b));
+        return;
+    }
+    b->min = (int16_t)a->min;
+    b->max = (int16_t)a->max;
+    b->mean = (int16_t)mean_of(a->sum, a->n);
+    b->n = (uint16_t)(a->n > UINT16_MAX ? UINT16_MAX : a->n);
+}
+
+static void advance(trend_pyramid_t *p, int k, uint64_t target);
+
+/* Store the open bucket of level k, fold it into level k + 1 and open the next */
+static void close_bucket(trend_pyramid_t *p, int k)
+{
+    trend_level_t *l = &p->level[k];
+    trend_bucket_t *slot = &l->ring[(size_t)(l->next % l->cap) * p->channels];
+
+    for (uint32_t ch = 0; ch < p->channels; ch++) {
+        store(&slot[ch], &l->acc[ch]);
+    }
+    if (k + 1 < TREND_PYRAMID_LEVELS) {
+        trend_level_t *up = &p->level[k + 1];
+        advance(p, k + 1, l->next * l->bucket_ms / up->bucket_ms);
+        for (uint32_t ch = 0; ch < p->channels; ch++) {
+            const trend_acc_t *a = &l->acc[ch];
+            trend_acc_t *u = &up->acc[ch];
+            if (a->n == 0) continue;
+            if (a->min < u->min) u->min = a->min;
+            if (a->max > u->max) u->max = a->max;
+            u->sum += a->sum;
+            u->n += a->n;
+        }
+    }
+    acc_reset(l->acc, p->channels);
+    l->next++;
+}
+
+/* Make target the open bucket of level k; the buckets skipped are empty */
+static void advance(trend_pyramid_t *p, int k, uint64_t target)
+{
+    trend_level_t *l = &p->level[k];
+
+    if (l->next >= target) return;
+    close_bucket(p, k);
+
+    if (target - l->next >= l->cap) {
+        /* A gap longer than the ring: nothing in it is left */
+        memset(l->ring, 0, (size_t)l->cap * p->channels * sizeof(trend_bucket_t));
+        l->next = target;
+        return;
+    }
+    for (; l->next < target; l->next++) {
+        memset(&l->ring[(size_t)(l->next % l->cap) * p->channels], 0, p->channels * sizeof(trend_bucket_t));
+    }
+}
+
+void trend_pyramid_push(trend_pyramid_t *p, uint64_t t_ms, const int32_t *values)
+{
+    if (!p->started) {
+        for (int k = 0; k < TREND_PYRAMID_LEVELS; k++) {
+            p->level[k].next = t_ms / p->level[k].bucket_ms;
+        }
+        p->started = true;
+    } else if (t_ms < p->last_ms) {
+        t_ms = p->last_ms;
+    }
+    p->last_ms = t_ms;
+
+    trend_level_t *l = &p->level[0];
+    advance(p, 0, t_ms / l->bucket_ms);
+
+    for (uint32_t ch = 0; ch < p->channels; ch++) {
+        const int32_t v = values[ch] > INT16_MAX ? INT16_MAX : values[ch] < INT16_MIN ? INT16_MIN : values[ch];
+        trend_acc_t *a = &l->acc[ch];
+        if (v < a->min) a->min = v;
+        if (v > a->max) a->max = v;
+        a->sum += v;
+        a->n++;
+    }
+}
+
+/* Bucket i of level l for channel ch; false if it holds no samples */
+static bool read_bucket(const trend_pyramid_t *p, const trend_level_t *l, uint64_t i, uint32_t ch,
+                        int32_t *mn, int32_t *mx, int32_t *mean)
+{
+    if (i == l->next) {
+        const trend_acc_t *a = &l->acc[ch];
+        if (a->n == 0) return false;
+        *mn = a->min;
+        *mx = a->max;
+        *mean = mean_of(a->sum, a->n);
+        return true;
+    }
+    if (i > l->next || l->next - i > l->cap) return false;
+
+    const trend_bucket_t *b = &l->ring[(size_t)(i % l->cap) * p->channels + ch];
+    if (b->n == 0) return false;
+    *mn = b->min;
+    *mx = b->max;
+    *mean = b->mean;
+    return true;
+}
+
+int trend_pyramid_query(const trend_pyramid_t *p, uint32_t ch, uint64_t from_ms, uint64_t to_ms,
+                        uint32_t columns, int32_t empty, int32_t *mn, int32_t *mx, int32_t *mean)
+{
+    if (!p->started || ch >= p->channels || to_ms <= from_ms || columns == 0) {
+        return -1;
+    }
+
+    /* Finest level with no more buckets than columns that still holds from_ms */
+    int k = 0;
+    for (; k < TREND_PYRAMID_LEVELS - 1; k++) {
+        const trend_level_t *l = &p->level[k];
+        const uint64_t first = from_ms / l->bucket_ms;
+        const uint64_t buckets = (to_ms - 1) / l->bucket_ms - first + 1;
+        if (buckets <= columns && (first >= l->next || l->next - first <= l->cap)) break;
+    }
+
+    const trend_level_t *l = &p->level[k];
+    const uint64_t span = to_ms - from_ms;
+    for (uint32_t c = 0; c < columns; c++) {
+        const uint64_t t = from_ms + span * c / columns;
+        int32_t a = empty, b = empty, m = empty;
+        if (!read_bucket(p, l, t / l->bucket_ms, ch, &a, &b, &m)) {
+            a = b = m = empty;
+        }
+        if (mn) mn[c] = a;
+        if (mx) mx[c] = b;
+        if (mean) mean[c] = m;
+    }
+    return k;
+}
@@ -0,0 +1,83 @@
+#ifndef _TREND_PYRAMID_H
+#define _TREND_PYRAMID_H
+
+/*
+ * Hours-to-days channel history as a pyramid of aggregates: min, max and
+ * mean per bucket at 1 s, 10 s, 1 min and 10 min, each level a fixed ring.
+ * A sample only touches the open bucket of the finest level; a bucket that
+ * closes is folded into the open bucket of the next level, so the whole
+ * pyramid costs O(1) per sample. A query picks the finest level that spans
+ * the window in at most `columns` buckets and reads one bucket per column,
+ * so drawing a day costs the same as drawing a minute. No ESP-IDF
+ * dependencies, so the same code runs on the target and in the host check
+ * (tools/trend_pyramid_check).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TREND_PYRAMID_LEVELS    4
+
+/* Bucket length and buckets kept per level: 1 h, 6 h, 1 day and 1 week */
+#define TREND_PYRAMID_BUCKET_MS { 1000, 10000, 60000, 600000 }
+#define TREND_PYRAMID_CAP       { 3600, 2160, 1440, 1008 }
+
+/* A closed bucket; n == 0 means no samples fell in it */
+typedef struct {
+    int16_t  min, max, mean;
+    uint16_t n;                 /* samples, saturating */
+} trend_bucket_t;
+
+/* The open bucket of a level, per channel */
+typedef struct {
+    int32_t  min, max;
+    int64_t  sum;
+    uint32_t n;
+} trend_acc_t;
+
+typedef struct {
+    uint32_t        bucket_ms;
+    uint32_t        cap;
+    uint64_t        next;       /* absolute index (time / bucket_ms) of the open bucket */
+    trend_bucket_t *ring;       /* bucket i of channel ch at [(i % cap) * channels + ch] */
+    trend_acc_t    *acc;        /* channels entries */
+} trend_level_t;
+
+typedef struct {
+    uint32_t      channels;
+    bool          started;
+    uint64_t      last_ms;      /* time of the newest sample */
+    trend_level_t level[TREND_PYRAMID_LEVELS];
+} trend_pyramid_t;
+
+/* Bytes of storage trend_pyramid_init() needs */
+size_t trend_pyramid_storage_bytes(uint32_t channels);
+
+/* storage must be trend_pyramid_storage_bytes() long and 8-byte aligned */
+void trend_pyramid_init(trend_pyramid_t *p, uint32_t channels, void *storage);
+
+/*
+ * One sample of every channel at t_ms (never decreasing; any epoch). Values
+ * are clamped to int16. Time without samples reads as empty buckets.
+ */
+void trend_pyramid_push(trend_pyramid_t *p, uint64_t t_ms, const int32_t *values);
+
+/*
+ * Channel ch over [from_ms, to_ms) in `columns` columns, oldest first: min,
+ * max and mean (any may be NULL), `empty` where there is no data. The open
+ * buckets are included, so the newest column is live. Returns the level
+ * read, -1 if the pyramid is empty.
+ */
+int trend_pyramid_query(const trend_pyramid_t *p, uint32_t ch, uint64_t from_ms, uint64_t to_ms,
+                        uint32_t columns, int32_t empty, int32_t *mn, int32_t *mx, int32_t *mean);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
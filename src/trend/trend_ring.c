@@ -0,0 +1,179 @@
+#include <string.h>
+#include "trend_ring.h"
+
+/*
+ * Columns are aligned to the absolute sample count: column c covers samples
+ * c * per_col .. c * per_col + per_col - 1. Pushing only ever touches the
+ * newest column, so a column that has scrolled past is final and the chart
+ * sees the same min/max for it until it leaves the window. When a column
+ * completes, the slot of the one that just fell off the left edge becomes
+ * the new newest column and starts out empty.
+ */
+
+size_t trend_ring_storage_bytes(uint32_t cap, uint32_t columns)
+{
+    return (size_t)columns * 2 * sizeof(int32_t) + (size_t)cap * sizeof(int16_t);
+}
+
+void trend_ring_init(trend_ring_t *r, uint32_t cap, uint32_t columns, int32_t empty, void *storage)
+{
+    memset(r, 0, sizeof(*r));
+    r->cap = cap;
+    r->columns = columns;
+    r->per_col = 1;
+    r->empty = empty;
+    r->col_min = (int32_t *)storage;
+    r->col_max = r->col_min + columns;
+    r->samples = (int16_t *)(r->col_max + columns);
+    for (uint32_t i = 0; i < columns; i++) {
+        r->col_min[i] = r->col_max[i] = empty;
+    }
+}
+
+void trend_ring_push(trend_ring_t *r, int16_t v)
+{
+    r->samples[r->head] = v;
+    r->head = (r->head + 1 == r->cap) ? 0 : r->head + 1;
+    r->total++;
+
+    int32_t *mn = &r->col_min[r->slot], *mx = &r->col_max[r->slot];
+    if (r->col_n == 0) {
+        *mn = *mx = v;
+    } else if (v < *mn) {
+        *mn = v;
+    } else if (v > *mx) {
+        *mx = v;
+    }
+
+    if (++r->col_n == r->per_col) {
+        r->col++;
+        r->col_n = 0;
+        r->slot = (r->slot + 1 == r->columns) ? 0 : r->slot + 1;
+        r->col_min[r->slot] = r->col_max[r->slot] = r->empty;
+    }
+    r->version++;
+}
+
+uint32_t trend_ring_fold_begin(const trend_ring_t *r, uint32_t samples, int32_t *scratch, trend_ring_fold_t *f)
+{
+    if (samples > r->cap) samples = r->cap;
+    uint32_t per = (samples + r->columns - 1) / r->columns;
+    if (per == 0) per = 1;
+    if (per * r->columns > r->cap) per = r->cap / r->columns;
+
+    f->total = r->total;
+    f->per_col = per;
+    f->col_min = scratch;
+    f->col_max = scratch + r->columns;
+    return per * r->columns;
+}
+
+void trend_ring_fold(const trend_ring_t *r, trend_ring_fold_t *f)
+{
+    const uint32_t per = f->per_col;
+    const uint64_t total = f->total;
+    const uint64_t col = total / per;
+
+    for (uint32_t i = 0; i < r->columns; i++) {
+        f->col_min[i] = f->col_max[i] = r->empty;
+    }
+
+    /* Walk the retained samples oldest first; sample number n sits in column
+     * n / per and in raw slot n % cap (head is always total % cap) */
+    const uint32_t held = (total < r->cap) ? (uint32_t)total : r->cap;
+    const uint64_t first_col = (col + 1 >= r->columns) ? col + 1 - r->columns : 0;
+    uint64_t n = total - held;
+    if (n < first_col * per) n = first_col * per;
+
+    uint32_t idx = (uint32_t)(n % r->cap);
+    uint64_t c = n / per;
+    uint32_t left = per - (uint32_t)(n % per);
+    uint32_t slot = (uint32_t)(c % r->columns);
+    int32_t mn = INT32_MAX, mx = INT32_MIN;
+
+    for (; n < total; n++) {
+        const int32_t v = r->samples[idx];
+        if (v < mn) mn = v;
+        if (v > mx) mx = v;
+        idx = (idx + 1 == r->cap) ? 0 : idx + 1;
+        if (--left == 0 || n + 1 == total) {
+            f->col_min[slot] = mn;
+            f->col_max[slot] = mx;
+            mn = INT32_MAX;
+            mx = INT32_MIN;
+            left = per;
+            slot = (slot + 1 == r->columns) ? 0 : slot + 1;
+        }
+    }
+}
+
+/*
+ * Samples pushed after _begin() are replayed onto the folded columns the way
+ * trend_ring_push() adds them. Any of them, or any sample the fold read
+ * after a push overwrote its slot, is older than total - cap; every column
+ * such a sample can land in has scrolled off by the time the replay ends,
+ * and its slot restarted empty.
+ */
+void trend_ring_fold_end(trend_ring_t *r, const trend_ring_fold_t *f)
+{
+    const uint32_t per = f->per_col;
+    uint32_t idx = (uint32_t)(f->total % r->cap);
+    uint32_t col_n = (uint32_t)(f->total % per);
+    uint32_t slot = (uint32_t)((f->total / per) % r->columns);
+
+    for (uint64_t n = f->total; n < r->total; n++) {
+        const int32_t v = r->samples[idx];
+        idx = (idx + 1 == r->cap) ? 0 : idx + 1;
+        if (col_n == 0) {
+            f->col_min[slot] = f->col_max[slot] = v;
+        } else if (v < f->col_min[slot]) {
+            f->col_min[slot] = v;
+        } else if (v > f->col_max[slot]) {
+            f->col_max[slot] = v;
+        }
+        if (++col_n == per) {
+            col_n = 0;
+            slot = (slot + 1 == r->columns) ? 0 : slot + 1;
+            f->col_min[slot] = f->col_max[slot] = r->empty;
+        }
+    }
+
+    r->per_col = per;
+    r->col = r->total / per;
+    r->col_n = (uint32_t)(r->total % per);
+    r->slot = (uint32_t)(r->col % r->columns);
+    if (f->col_min != r->col_min) {
+        memcpy(r->col_min, f->col_min, r->columns * sizeof(int32_t));
+        memcpy(r->col_max, f->col_max, r->columns * sizeof(int32_t));
+    }
+    r->version++;
+}
+
+uint32_t trend_ring_set_window(trend_ring_t *r, uint32_t samples)
+{
+    trend_ring_fold_t f;
+
+    /* col_max follows col_min in the storage, so they are their own scratch */
+    const uint32_t window = trend_ring_fold_begin(r, samples, r->col_min, &f);
+    trend_ring_fold(r, &f);
+    trend_ring_fold_end(r, &f);
+    return window;
+}
+
+bool trend_ring_range(const trend_ring_t *r, int32_t *lo, int32_t *hi)
+{
+    int32_t mn = INT32_MAX, mx = INT32_MIN;
+    bool any = false;
+
+    for (uint32_t i = 0; i < r->columns; i++) {
+        if (r->col_min[i] == r->empty) continue;
+        if (r->col_min[i] < mn) mn = r->col_min[i];
+        if (r->col_max[i] > mx) mx = r->col_max[i];
+        any = true;
+    }
+    if (any) {
+        *lo = mn;
+        *hi = mx;
+    }
+    return any;
+}
@@ -0,0 +1,96 @@
+#ifndef _TREND_RING_H
+#define _TREND_RING_H
+
+/*
+ * Fixed-memory sample history for a trend chart. Every sample is kept in a
+ * raw ring at acquisition rate and folded into the newest of a fixed number
+ * of chart columns as it arrives, each column holding the min and max of the
+ * samples it covers. Drawing therefore touches `columns` points however fast
+ * samples come and however long the window is; only a window change walks
+ * the raw ring to rebuild the columns. No ESP-IDF dependencies, so the same
+ * code runs on the target and in the host check (tools/trend_ring_check).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int16_t *samples;           /* raw ring, cap entries, oldest overwritten */
+    uint32_t cap;
+    uint32_t head;              /* next sample slot */
+    uint64_t total;             /* samples pushed since init */
+    uint32_t columns;
+    uint32_t per_col;           /* samples per column, window = per_col * columns */
+    int32_t *col_min;           /* column ring, column c lives in slot c % columns */
+    int32_t *col_max;
+    uint64_t col;               /* column being filled: total / per_col */
+    uint32_t col_n;             /* samples in it so far */
+    uint32_t slot;              /* col % columns */
+    int32_t  empty;             /* value of a column without samples */
+    uint32_t version;           /* bumped whenever a column changes */
+} trend_ring_t;
+
+/* Bytes of storage trend_ring_init() needs */
+size_t trend_ring_storage_bytes(uint32_t cap, uint32_t columns);
+
+/*
+ * storage must be trend_ring_storage_bytes() long and 4-byte aligned; cap
+ * must be at least columns. Columns start at `empty` (the chart's "no point"
+ * value) and the window at one sample per column.
+ */
+void trend_ring_init(trend_ring_t *r, uint32_t cap, uint32_t columns, int32_t empty, void *storage);
+
+/* Record one sample: O(1) */
+void trend_ring_push(trend_ring_t *r, int16_t v);
+
+/*
+ * Show the last `samples` samples: rounded up to a whole number of samples
+ * per column, and down to what the raw ring holds. Rebuilds every column
+ * from the raw ring, O(window). Returns the window actually used.
+ */
+uint32_t trend_ring_set_window(trend_ring_t *r, uint32_t samples);
+
+/*
+ * trend_ring_set_window() in three steps, for a ring another task pushes to
+ * under a lock: only the O(1) _begin() and the O(columns + pushes since
+ * _begin()) _end() need the lock, the O(window) fold runs without it.
+ * scratch holds 2 * columns entries and is copied into the ring by _end().
+ */
+typedef struct {
+    uint64_t total;             /* samples the fold covers */
+    uint32_t per_col;
+    int32_t *col_min;           /* scratch */
+    int32_t *col_max;
+} trend_ring_fold_t;
+
+/* Lock held: fix the window and the samples to fold; returns the window */
+uint32_t trend_ring_fold_begin(const trend_ring_t *r, uint32_t samples, int32_t *scratch, trend_ring_fold_t *f);
+/* No lock: rebuild the columns into scratch from the raw ring */
+void trend_ring_fold(const trend_ring_t *r, trend_ring_fold_t *f);
+/* Lock held: add what was pushed meanwhile and switch the ring to the new columns */
+void trend_ring_fold_end(trend_ring_t *r, const trend_ring_fold_t *f);
+
+static inline uint32_t trend_ring_window(const trend_ring_t *r)
+{
+    return r->per_col * r->columns;
+}
+
+/* Slot of the oldest column on screen; the newest (partial) one is the slot before it */
+static inline uint32_t trend_ring_first_slot(const trend_ring_t *r)
+{
+    return (r->slot + 1 == r->columns) ? 0 : r->slot + 1;
+}
+
+/* Lowest min and highest max over the columns; false if all are empty */
+bool trend_ring_range(const trend_ring_t *r, int32_t *lo, int32_t *hi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+#include "ui_calibration.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+#define CAL_MIN_SAMPLES 4   // reads averaged per target before release counts
+#define CAL_CROSS_LEN   48
+
+typedef struct {
+    ui_calibration_done_cb_t done_cb;
+    lv_obj_t  *overlay;
+    lv_obj_t  *cross_h;
+    lv_obj_t  *cross_v;
+    lv_obj_t  *lbl_hint;
+
+    uint8_t    step;
+    bool       was_pressed;
+    int32_t    sum_x, sum_y;
+    uint32_t   n;
+
+    lv_point_t target[UI_CALIBRATION_POINTS];
+    lv_point_t sample[UI_CALIBRATION_POINTS];
+} ui_cal_t;
+
+static ui_cal_t c;
+
+// Spread over the screen, away from the edges the controller filters hardest
+static const float k_target_frac[UI_CALIBRATION_POINTS][2] = {
+    { 0.1f, 0.1f },
+    { 0.9f, 0.5f },
+    { 0.5f, 0.9f },
+};
+
+// ----------------------------------
+// Drawing
+// ----------------------------------
+static lv_obj_t *make_bar(lv_obj_t *parent, int32_t w, int32_t h)
+{
+    lv_obj_t *o = lv_obj_create(parent);
+    lv_obj_remove_style_all(o);
+    lv_obj_set_size(o, w, h);
+    lv_obj_set_style_bg_color(o, lv_color_hex(0xFFFFFF), 0);
+    lv_obj_set_style_bg_opa(o, LV_OPA_COVER, 0);
+    lv_obj_remove_flag(o, LV_OBJ_FLAG_CLICKABLE);
+    return o;
+}
+
+static void show_target(uint8_t i)
+{
+    const lv_point_t *t = &c.target[i];
+    lv_obj_set_pos(c.cross_h, t->x - CAL_CROSS_LEN / 2, t->y - 1);
+    lv_obj_set_pos(c.cross_v, t->x - 1, t->y - CAL_CROSS_LEN / 2);
+    lv_label_set_text_fmt(c.lbl_hint, "Touch the cross and lift  (%u/%u)", i + 1, UI_CALIBRATION_POINTS);
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+void ui_calibration_start(ui_calibration_done_cb_t cb)
+{
+    if (c.overlay) return;
+
+    lv_display_t *disp = lv_display_get_default();
+    const int32_t w = lv_display_get_horizontal_resolution(disp);
+    const int32_t h = lv_display_get_vertical_resolution(disp);
+
+    c.done_cb = cb;
+    c.step = 0;
+    c.was_pressed = false;
+    c.sum_x = c.sum_y = 0;
+    c.n = 0;
+    for (uint8_t i = 0; i < UI_CALIBRATION_POINTS; i++) {
+        c.target[i].x = (int32_t)(k_target_frac[i][0] * w);
+        c.target[i].y = (int32_t)(k_target_frac[i][1] * h);
+    }
+
+    c.overlay = lv_obj_create(lv_layer_top());
+    lv_obj_remove_style_all(c.overlay);
+    lv_obj_set_size(c.overlay, w, h);
+    lv_obj_set_style_bg_color(c.overlay, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(c.overlay, LV_OPA_COVER, 0);
+
+    c.cross_h = make_bar(c.overlay, CAL_CROSS_LEN, 3);
+    c.cross_v = make_bar(c.overlay, 3, CAL_CROSS_LEN);
+
+    c.lbl_hint = lv_label_create(c.overlay);
+    lv_obj_set_style_text_color(c.lbl_hint, lv_color_hex(0xE6E6E6), 0);
+    lv_obj_set_style_text_font(c.lbl_hint, &lv_font_montserrat_24, 0);
+    lv_obj_center(c.lbl_hint);
+
+    show_target(0);
+}
+
+bool ui_calibration_active(void)
+{
+    return c.overlay != NULL;
+}
+
+void ui_calibration_feed(bool pressed, int32_t x, int32_t y)
+{
+    if (!c.overlay) return;
+
+    if (pressed) {
+        c.sum_x += x;
+        c.sum_y += y;
+        c.n++;
+        c.was_pressed = true;
+        return;
+    }
+    if (!c.was_pressed) return;
+
+    // Release: a tap too short to average is ignored, the cross stays put
+    c.was_pressed = false;
+    if (c.n >= CAL_MIN_SAMPLES) {
+        c.sample[c.step].x = c.sum_x / (int32_t)c.n;
+        c.sample[c.step].y = c.sum_y / (int32_t)c.n;
+        c.step++;
+    }
+    c.sum_x = c.sum_y = 0;
+    c.n = 0;
+
+    if (c.step < UI_CALIBRATION_POINTS) {
+        show_target(c.step);
+        return;
+    }
+
+    lv_obj_delete(c.overlay);
+    c.overlay = NULL;
+    if (c.done_cb) c.done_cb(c.target, c.sample);
+}
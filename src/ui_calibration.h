@@ -0,0 +1,26 @@
+#pragma once
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Three-point touch calibration capture. Draws crosshairs on the top layer of
+// the default display; the input glue feeds raw (uncalibrated) pointer samples
+// while it is active instead of handing them to LVGL.
+#define UI_CALIBRATION_POINTS 3
+
+// target[i] is where crosshair i was drawn, sample[i] the averaged touch
+typedef void (*ui_calibration_done_cb_t)(const lv_point_t target[UI_CALIBRATION_POINTS],
+                                         const lv_point_t sample[UI_CALIBRATION_POINTS]);
+
+void ui_calibration_start(ui_calibration_done_cb_t cb);
+bool ui_calibration_active(void);
+void ui_calibration_feed(bool pressed, int32_t x, int32_t y);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
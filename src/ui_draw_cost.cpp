@@ -0,0 +1,159 @@
+#include "ui_draw_cost.h"
+#include "perf/draw_cost.h"
+
+#include <cstdio>
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+#define DRAW_COST_REPORT_ROWS 25
+
+typedef struct {
+    draw_cost_t *dc;            // PSRAM, allocated on first start
+    lv_obj_t    *root;
+    bool         active;
+    int64_t      stopped_us;    // end of the window once stopped
+} ui_draw_cost_ctx_t;
+
+static ui_draw_cost_ctx_t s;
+
+// Drawing with LV_OS_NONE is synchronous: the draw tasks an object creates in
+// DRAW_MAIN / DRAW_POST run before the matching *_END event, so the spans
+// below are its own rendering time. Children draw between MAIN_END and
+// POST_BEGIN and are not counted for the parent.
+static void draw_event(lv_event_t *e)
+{
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_current_target(e);
+
+    switch(lv_event_get_code(e)) {
+    case LV_EVENT_DRAW_MAIN_BEGIN:
+    case LV_EVENT_DRAW_POST_BEGIN:
+        draw_cost_begin(s.dc, obj, esp_timer_get_time());
+        break;
+    case LV_EVENT_DRAW_MAIN_END: {
+        const int64_t now = esp_timer_get_time();
+        lv_area_t a;
+        lv_obj_get_coords(obj, &a);
+        const uint32_t px = lv_obj_area_is_visible(obj, &a) ? lv_area_get_size(&a) : 0;
+        draw_cost_end(s.dc, obj, now, px);
+        break;
+    }
+    case LV_EVENT_DRAW_POST_END:
+        draw_cost_end(s.dc, obj, esp_timer_get_time(), 0);
+        break;
+    default:
+        break;
+    }
+}
+
+// ----------------------------------
+// Tree walk
+// ----------------------------------
+static void describe(lv_obj_t *obj, const char *path, char *name, size_t cap)
+{
+    if(lv_obj_check_type(obj, &lv_label_class)) {
+        // First line of the text is the best handle on a label
+        char text[20];
+        snprintf(text, sizeof(text), "%s", lv_label_get_text(obj));
+        for(char *p = text; *p; p++) {
+            if(*p == '\n') *p = ' ';
+        }
+        snprintf(name, cap, "%s label \"%s\"", path, text);
+    } else if(lv_obj_check_type(obj, &lv_button_class)) {
+        snprintf(name, cap, "%s button", path);
+    } else if(lv_obj_check_type(obj, &lv_arc_class)) {
+        snprintf(name, cap, "%s arc", path);
+    } else if(lv_obj_check_type(obj, &lv_bar_class)) {
+        snprintf(name, cap, "%s bar", path);
+    } else if(lv_obj_check_type(obj, &lv_chart_class)) {
+        snprintf(name, cap, "%s chart", path);
+    } else {
+        snprintf(name, cap, "%s obj", path);
+    }
+}
+
+static void style_facts(lv_obj_t *obj, draw_cost_style_t *st)
+{
+    st->w = lv_obj_get_width(obj);
+    st->h = lv_obj_get_height(obj);
+    st->radius = lv_obj_get_style_radius(obj, LV_PART_MAIN);
+    st->shadow_width = lv_obj_get_style_shadow_width(obj, LV_PART_MAIN);
+    st->bg_opa = lv_obj_get_style_bg_opa(obj, LV_PART_MAIN);
+    st->opa = lv_obj_get_style_opa(obj, LV_PART_MAIN);
+    st->clip_corner = lv_obj_get_style_clip_corner(obj, LV_PART_MAIN);
+    st->has_children = lv_obj_get_child_count(obj) > 0;
+    st->is_label = lv_obj_check_type(obj, &lv_label_class);
+    st->width_pct_100 = lv_obj_get_style_width(obj, LV_PART_MAIN) == lv_pct(100);
+}
+
+// Register obj and its subtree; path is the child-index path from the root
+static void attach(lv_obj_t *obj, char *path, size_t len, size_t cap, bool hook)
+{
+    if(hook) {
+        char name[DRAW_COST_NAME_LEN];
+        draw_cost_style_t st;
+        describe(obj, len ? path : "root", name, sizeof(name));
+        style_facts(obj, &st);
+        if(draw_cost_add(s.dc, obj, name, &st)) {
+            lv_obj_add_event_cb(obj, draw_event, LV_EVENT_ALL, &s);
+        }
+    } else {
+        lv_obj_remove_event_cb_with_user_data(obj, draw_event, &s);
+    }
+
+    const uint32_t n = lv_obj_get_child_count(obj);
+    for(uint32_t i = 0; i < n; i++) {
+        const int w = snprintf(path + len, cap - len, "%s%lu", len ? "." : "", (unsigned long)i);
+        if(w < 0 || len + (size_t)w >= cap) continue;
+        attach(lv_obj_get_child(obj, (int32_t)i), path, len + (size_t)w, cap, hook);
+        path[len] = '\0';
+    }
+}
+
+// ----------------------------------
+// Public API
+// ----------------------------------
+extern "C" bool ui_draw_cost_start(lv_obj_t *root)
+{
+    char path[32] = "";
+
+    ui_draw_cost_stop();
+    if(!s.dc) {
+        s.dc = (draw_cost_t *)heap_caps_malloc(sizeof(draw_cost_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if(!s.dc) return false;
+    }
+    draw_cost_reset(s.dc, esp_timer_get_time());
+    s.root = root;
+    attach(root, path, 0, sizeof(path), true);
+    s.active = true;
+
+    // Every object draws at least once in the window
+    lv_obj_invalidate(root);
+    return true;
+}
+
+extern "C" void ui_draw_cost_stop(void)
+{
+    char path[32] = "";
+
+    if(!s.active) return;
+    attach(s.root, path, 0, sizeof(path), false);
+    s.active = false;
+    s.stopped_us = esp_timer_get_time();
+}
+
+extern "C" bool ui_draw_cost_active(void)
+{
+    return s.active;
+}
+
+extern "C" void ui_draw_cost_report(void (*emit)(const char *line))
+{
+    if(!s.dc) {
+        emit("draw cost: not started\n");
+        return;
+    }
+    draw_cost_report(s.dc, s.active ? esp_timer_get_time() : s.stopped_us, DRAW_COST_REPORT_ROWS, emit);
+}
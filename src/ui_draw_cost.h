@@ -0,0 +1,20 @@
+#pragma once
+
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Draw cost attribution for every object under a root, see perf/draw_cost.h.
+// Start hooks the draw events of the objects that exist now (rebuilt screens
+// need a new start), report prints the ranked table with lint flags.
+// Call from the LVGL task.
+bool ui_draw_cost_start(lv_obj_t *root);
+void ui_draw_cost_stop(void);
+bool ui_draw_cost_active(void);
+void ui_draw_cost_report(void (*emit)(const char *line));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
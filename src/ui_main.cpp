@@ -1,4 +1,8 @@
 #include "ui_main.h"
+#include "ui_subjects.h"
+#include "ui_trend.h"
+#include "perf/trace_ring.h"
+#include "log/blackbox_recorder.h"
 
 #include <math.h>
 #include <cstring>  // strstr
@@ -13,107 +17,113 @@ typedef struct {
     lv_obj_t *banner_lbl;
     bool      banner_is_error;
 
-    // HP ISO
-    lv_obj_t *arc_iso_hp;
-    lv_obj_t *lbl_iso_hp_psi;
-    lv_obj_t *lbl_iso_hp_temp;
-    lv_obj_t *lbl_iso_hp_lowtemp;
-
-    // HP RESIN
-    lv_obj_t *arc_resin_hp;
-    lv_obj_t *lbl_resin_hp_psi;
-    lv_obj_t *lbl_resin_hp_temp;
-    lv_obj_t *lbl_resin_hp_lowtemp;
-
-    // Ratio
-    lv_obj_t *ratio_bar_bg;
-    lv_obj_t *ratio_bar_fill;
-    lv_obj_t *lbl_ratio;
-
     // Controls
     lv_obj_t *btn_spray;
     lv_obj_t *btn_drum_air;
 
     // Hose heat (center)
     lv_obj_t *lbl_h1_status;
-    lv_obj_t *lbl_h1_temp;
     lv_obj_t *lbl_h1_set;
     lv_obj_t *btn_h1_toggle;
     lv_obj_t *btn_h1_up;
     lv_obj_t *btn_h1_down;
 
     lv_obj_t *lbl_h2_status;
-    lv_obj_t *lbl_h2_temp;
     lv_obj_t *lbl_h2_set;
     lv_obj_t *btn_h2_toggle;
     lv_obj_t *btn_h2_up;
     lv_obj_t *btn_h2_down;
 
-    // Bottom row
-    lv_obj_t *arc_iso_low;
-    lv_obj_t *lbl_iso_low_psi;
-    lv_obj_t *lbl_iso_low_temp;
-
-    lv_obj_t *arc_resin_low;
-    lv_obj_t *lbl_resin_low_psi;
-    lv_obj_t *lbl_resin_low_temp;
-
-    lv_obj_t *arc_primary_air;
-    lv_obj_t *lbl_primary_air_psi;
-
-    lv_obj_t *arc_gun_air;
-    lv_obj_t *lbl_gun_air_psi;
-
     // Center column cards
     lv_obj_t *lbl_sys_status;
     lv_obj_t *lbl_interlock;
     lv_obj_t *lbl_status_card;
     lv_obj_t *btn_estop;
     lv_obj_t *lbl_estop;
-
-    // Internal values
-    int  hose1_set_f;
-    int  hose2_set_f;
-    bool hose1_on;
-    bool hose2_on;
-
 } ui_live_t;
 
 static ui_live_t g = {0};
 
+// ----------------------------------
+// Channel table
+// ----------------------------------
+#define DEG_F " \xC2\xB0""F"
+
+static constexpr ui_channel_desc_t s_channels[UI_CH_COUNT] = {
+    // id                      name                unit     lo     hi     dec fine binds                             echo
+    { UI_CH_ISO_HP_PSI,        "iso_hp_psi",       "\nPSI", 0,     1600,  0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_RESIN_HP_PSI,      "resin_hp_psi",     "\nPSI", 0,     1600,  0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_ISO_LOW_PSI,       "iso_low_psi",      "\nPSI", 0,     500,   0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_RESIN_LOW_PSI,     "resin_low_psi",    "\nPSI", 0,     500,   0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_PRIMARY_AIR_PSI,   "primary_air_psi",  "\nPSI", 0,     300,   0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_GUN_AIR_PSI,       "gun_air_psi",      "\nPSI", 0,     300,   0,  0,   UI_BIND_ARC | UI_BIND_VALUE,      nullptr },
+    { UI_CH_ISO_HP_TEMP_F,     "iso_hp_temp_f",    DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE,                    nullptr },
+    { UI_CH_RESIN_HP_TEMP_F,   "resin_hp_temp_f",  DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE,                    nullptr },
+    { UI_CH_ISO_LOW_TEMP_F,    "iso_low_temp_f",   DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE | UI_BIND_ECHO,     "Low: " },
+    { UI_CH_RESIN_LOW_TEMP_F,  "resin_low_temp_f", DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE | UI_BIND_ECHO,     "Low: " },
+    { UI_CH_HOSE1_TEMP_F,      "hose1_temp_f",     DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE,                    nullptr },
+    { UI_CH_HOSE2_TEMP_F,      "hose2_temp_f",     DEG_F,   0,     250,   1,  0,   UI_BIND_VALUE,                    nullptr },
+    // Bar spans +/-10% around 1:1; fine keeps it moving between label steps
+    { UI_CH_RATIO,             "ratio",            "",      0.90f, 1.10f, 2,  1,   UI_BIND_VALUE | UI_BIND_DEV_BAR,  nullptr },
+};
+
+static constexpr bool channels_in_order()
+{
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        if(s_channels[i].id != i || s_channels[i].decimals + s_channels[i].fine > 3) return false;
+    }
+    return true;
+}
+static_assert(channels_in_order(), "s_channels must list every ui_channel_t in order");
+
+// Pending bits: one per channel, then the hose zones and the status
+#define UI_PENDING_HOSE(zone)   (1u << (UI_CH_COUNT + (zone) - 1))
+#define UI_PENDING_STATUS       (1u << (UI_CH_COUNT + UI_HOSE_ZONES))
+static_assert(UI_CH_COUNT + UI_HOSE_ZONES < 31, "pending bits must fit 32 bits");
+
+// Bound widgets, one array per role, and what the next refresh has to redo
+typedef struct {
+    uint8_t   bound[UI_CH_COUNT];       // UI_BIND_* actually wired up
+    lv_obj_t *arc[UI_CH_COUNT];
+    lv_obj_t *value[UI_CH_COUNT];
+    lv_obj_t *echo[UI_CH_COUNT];
+    lv_obj_t *bar[UI_CH_COUNT];         // bar background
+    lv_obj_t *bar_fill[UI_CH_COUNT];    // its first child, moved and resized
+    int32_t   label_q[UI_CH_COUNT];     // value on the labels (decimals only)
+    int32_t   bar_h[UI_CH_COUNT];       // last fill geometry
+    int32_t   bar_y[UI_CH_COUNT];
+    uint32_t  pending;                  // subjects notified since the last refresh
+} ui_channels_t;
+
+static ui_channels_t s_ch = {};
+
+uint32_t UI_EVENT_TOUCH_ZOOM = 0;
+
 static ui_hose_toggle_cb_t   s_hose_toggle_cb   = nullptr;
 static ui_hose_setpoint_cb_t s_hose_setpoint_cb = nullptr;
+static ui_press_cb_t         s_press_cb         = nullptr;
 
 // ----------------------------------
 // Helpers
 // ----------------------------------
 
-// Forward declaration (ui_set_banner is defined before banner_apply_style)
+// Forward declarations
 static void banner_apply_style(bool error);
+static void refr_start_event(lv_event_t *e);
+static void drain_timer(lv_timer_t *t);
+static lv_timer_t *s_drain_timer;
 
 extern "C" void ui_set_banner(const char* msg, bool is_error)
 {
     // If your UI hasn't been built yet, just ignore.
     if(!g.banner) return;
 
-    // Treat nullptr / empty as "hide banner"
-    const bool hide = (msg == nullptr) || (msg[0] == '\0');
-
-    if(hide) {
-        lv_obj_add_flag(g.banner, LV_OBJ_FLAG_HIDDEN);
-        return;
-    }
-
-    // Apply style and show
-    banner_apply_style(is_error);
-
-    if(g.banner_lbl) lv_label_set_text(g.banner_lbl, msg);
-    if(g.lbl_status_card) lv_label_set_text(g.lbl_status_card, msg);
-
-    lv_obj_clear_flag(g.banner, LV_OBJ_FLAG_HIDDEN);
+    // nullptr / empty hides the banner; widgets follow at the next refresh
+    blackbox_rec_event(BLACKBOX_EV_BANNER, 0, is_error, msg);
+    lv_subject_set_int(ui_subject_status_error(), is_error);
+    lv_subject_copy_string(ui_subject_status(), msg ? msg : "");
 }
 
-
 static inline float clampf(float v, float lo, float hi) {
     return (v < lo) ? lo : (v > hi) ? hi : v;
 }
@@ -199,6 +209,68 @@ static void arc_make_visual_only(lv_obj_t *arc)
     lv_obj_clear_state(arc, LV_STATE_PRESSED);
 }
 
+// ----------------------------------
+// Channel binding
+// ----------------------------------
+extern "C" const ui_channel_desc_t *ui_channel_desc(ui_channel_t ch)
+{
+    return (ch < UI_CH_COUNT) ? &s_channels[ch] : nullptr;
+}
+
+// Every subject notification just marks its widgets for the next refresh, so
+// any number of writes in between costs one widget update. LVGL pauses the
+// refresh timer while nothing is invalidated; the first mark resumes it.
+static void pending_observer(lv_observer_t *observer, lv_subject_t *subject)
+{
+    (void)subject;
+    if(!s_ch.pending) {
+        lv_display_t *disp = lv_display_get_default();
+        if(disp) lv_timer_resume(lv_display_get_refr_timer(disp));
+    }
+    s_ch.pending |= (uint32_t)(uintptr_t)lv_observer_get_user_data(observer);
+}
+
+static void bind(ui_channel_t ch, uint8_t role, lv_obj_t *obj)
+{
+    if(ch >= UI_CH_COUNT || !obj) return;
+    const ui_channel_desc_t *d = &s_channels[ch];
+
+    switch(role) {
+        case UI_BIND_ARC:
+            lv_arc_set_range(obj, (int32_t)d->lo, (int32_t)d->hi);
+            lv_arc_set_value(obj, (int32_t)d->lo);
+            s_ch.arc[ch] = obj;
+            break;
+        case UI_BIND_VALUE:   s_ch.value[ch] = obj; break;
+        case UI_BIND_ECHO:    s_ch.echo[ch] = obj; break;
+        case UI_BIND_DEV_BAR:
+            if(!lv_obj_get_child(obj, 0)) return;
+            s_ch.bar[ch] = obj;
+            s_ch.bar_fill[ch] = lv_obj_get_child(obj, 0);
+            s_ch.bar_h[ch] = -1;
+            break;
+        default: return;
+    }
+    s_ch.bound[ch] |= role;
+    lv_subject_add_observer_obj(ui_subject_channel(ch), pending_observer, obj, (void *)(uintptr_t)(1u << ch));
+}
+
+// prefix + value (q / 10^decimals) + unit, integer math only
+static void format_channel(char *b, size_t n, const ui_channel_desc_t *d, const char *prefix, int32_t q)
+{
+    static const uint32_t pow10[] = {1, 10, 100, 1000};
+    const uint32_t mag = (q < 0) ? 0u - (uint32_t)q : (uint32_t)q;
+    const uint32_t p = pow10[d->decimals];
+    const char *sign = (q < 0) ? "-" : "";
+
+    if(d->decimals == 0) {
+        snprintf(b, n, "%s%s%lu%s", prefix, sign, (unsigned long)mag, d->unit);
+    } else {
+        snprintf(b, n, "%s%s%lu.%0*lu%s", prefix, sign, (unsigned long)(mag / p),
+                 (int)d->decimals, (unsigned long)(mag % p), d->unit);
+    }
+}
+
 static void hose_set_label(lv_obj_t *lbl_set, int set_f)
 {
     if(!lbl_set) return;
@@ -250,16 +322,30 @@ extern "C" void ui_set_hose_setpoint_callback(ui_hose_setpoint_cb_t cb)
     s_hose_setpoint_cb = cb;
 }
 
+extern "C" void ui_set_press_callback(ui_press_cb_t cb)
+{
+    s_press_cb = cb;
+}
+
+static void press_event(lv_event_t *e)
+{
+    if(s_press_cb) s_press_cb((lv_obj_t *)lv_event_get_target(e));
+}
+
+static void watch_press(lv_obj_t *obj)
+{
+    if(obj) lv_obj_add_event_cb(obj, press_event, LV_EVENT_PRESSED, nullptr);
+}
+
 // ----------------------------------
 // Gauge cards
 // ----------------------------------
 static void make_hp_card(
     lv_obj_t *parent,
     const char *title,
-    lv_obj_t **out_arc,
-    lv_obj_t **out_psi,
-    lv_obj_t **out_temp,
-    lv_obj_t **out_lowtemp)
+    ui_channel_t ch_psi,
+    ui_channel_t ch_temp,
+    ui_channel_t ch_lowtemp)
 {
     lv_obj_t *card = card_begin(parent);
 
@@ -279,10 +365,8 @@ static void make_hp_card(
     lv_obj_set_size(arc, 250, 250);
     lv_obj_align(arc, LV_ALIGN_TOP_MID, 0, 52);
 
-    lv_arc_set_range(arc, 0, 1600);
     lv_arc_set_rotation(arc, 135);
     lv_arc_set_bg_angles(arc, 0, 270);
-    lv_arc_set_value(arc, 0);
     arc_make_visual_only(arc);
 
     lv_obj_t *psi = lv_label_create(card);
@@ -303,20 +387,18 @@ static void make_hp_card(
     lv_obj_set_width(lowt, lv_pct(100));
     lv_obj_align(lowt, LV_ALIGN_BOTTOM_MID, 0, -6);
 
-    if(out_arc)     *out_arc = arc;
-    if(out_psi)     *out_psi = psi;
-    if(out_temp)    *out_temp = temp;
-    if(out_lowtemp) *out_lowtemp = lowt;
+    bind(ch_psi, UI_BIND_ARC, arc);
+    bind(ch_psi, UI_BIND_VALUE, psi);
+    bind(ch_temp, UI_BIND_VALUE, temp);
+    bind(ch_lowtemp, UI_BIND_ECHO, lowt);
 }
 
+// ch_temp_optional: UI_CH_COUNT for a card without temperature
 static void make_small_gauge_card(
     lv_obj_t *parent,
     const char *title,
-    int32_t minv,
-    int32_t maxv,
-    lv_obj_t **out_arc,
-    lv_obj_t **out_psi,
-    lv_obj_t **out_temp_optional)
+    ui_channel_t ch_psi,
+    ui_channel_t ch_temp_optional)
 {
     lv_obj_t *card = card_begin(parent);
 
@@ -333,10 +415,8 @@ static void make_small_gauge_card(
     lv_obj_set_size(arc, 200, 200);
     lv_obj_align(arc, LV_ALIGN_TOP_MID, 0, 48);
 
-    lv_arc_set_range(arc, minv, maxv);
     lv_arc_set_rotation(arc, 135);
     lv_arc_set_bg_angles(arc, 0, 270);
-    lv_arc_set_value(arc, minv);
     arc_make_visual_only(arc);
 
     lv_obj_t *psi = lv_label_create(card);
@@ -350,20 +430,19 @@ static void make_small_gauge_card(
     lv_obj_set_style_text_align(psi, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align_to(psi, arc, LV_ALIGN_CENTER, 0, -12);
 
-    lv_obj_t *temp = nullptr;
-    if(out_temp_optional) {
-        temp = lv_label_create(card);
+    if(ch_temp_optional < UI_CH_COUNT) {
+        lv_obj_t *temp = lv_label_create(card);
         lv_label_set_text(temp, "0.0 \xC2\xB0""F");
         // Temperature is secondary to PSI, but still needs to be easy to read.
         style_value_med(temp);
         lv_obj_set_width(temp, 180);
         lv_obj_set_style_text_align(temp, LV_TEXT_ALIGN_CENTER, 0);
         lv_obj_align_to(temp, arc, LV_ALIGN_CENTER, 0, 56);
-        *out_temp_optional = temp;
+        bind(ch_temp_optional, UI_BIND_VALUE, temp);
     }
 
-    if(out_arc) *out_arc = arc;
-    if(out_psi) *out_psi = psi;
+    bind(ch_psi, UI_BIND_ARC, arc);
+    bind(ch_psi, UI_BIND_VALUE, psi);
 }
 
 // ----------------------------------
@@ -381,32 +460,35 @@ static void make_ratio_card(lv_obj_t *parent)
     style_title(t);
 
     // Tall bar in the center
-    g.ratio_bar_bg = lv_obj_create(card);
-    noscroll(g.ratio_bar_bg);
-    lv_obj_set_style_radius(g.ratio_bar_bg, 18, 0);
-    lv_obj_set_style_bg_opa(g.ratio_bar_bg, LV_OPA_40, 0);
-    lv_obj_set_style_bg_color(g.ratio_bar_bg, lv_color_hex(0x24304A), 0);
-    lv_obj_set_style_border_width(g.ratio_bar_bg, 0, 0);
-    lv_obj_set_style_pad_all(g.ratio_bar_bg, 0, 0);
+    lv_obj_t *bar_bg = lv_obj_create(card);
+    noscroll(bar_bg);
+    lv_obj_set_style_radius(bar_bg, 18, 0);
+    lv_obj_set_style_bg_opa(bar_bg, LV_OPA_40, 0);
+    lv_obj_set_style_bg_color(bar_bg, lv_color_hex(0x24304A), 0);
+    lv_obj_set_style_border_width(bar_bg, 0, 0);
+    lv_obj_set_style_pad_all(bar_bg, 0, 0);
 
     // Wider than last iteration; looks better from distance
-    lv_obj_set_size(g.ratio_bar_bg, lv_pct(55), lv_pct(72));
-    lv_obj_set_flex_grow(g.ratio_bar_bg, 1);
+    lv_obj_set_size(bar_bg, lv_pct(55), lv_pct(72));
+    lv_obj_set_flex_grow(bar_bg, 1);
 
-    g.ratio_bar_fill = lv_obj_create(g.ratio_bar_bg);
-    noscroll(g.ratio_bar_fill);
-    lv_obj_set_style_radius(g.ratio_bar_fill, 18, 0);
-    lv_obj_set_style_bg_opa(g.ratio_bar_fill, LV_OPA_90, 0);
-    lv_obj_set_style_bg_color(g.ratio_bar_fill, lv_color_hex(0x2D73FF), 0);
-    lv_obj_set_style_border_width(g.ratio_bar_fill, 0, 0);
+    lv_obj_t *fill = lv_obj_create(bar_bg);
+    noscroll(fill);
+    lv_obj_set_style_radius(fill, 18, 0);
+    lv_obj_set_style_bg_opa(fill, LV_OPA_90, 0);
+    lv_obj_set_style_bg_color(fill, lv_color_hex(0x2D73FF), 0);
+    lv_obj_set_style_border_width(fill, 0, 0);
 
     // Initialize centered baseline chunk
-    lv_obj_set_size(g.ratio_bar_fill, lv_pct(100), lv_pct(18));
-    lv_obj_align(g.ratio_bar_fill, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_size(fill, lv_pct(100), lv_pct(18));
+    lv_obj_align(fill, LV_ALIGN_CENTER, 0, 0);
+
+    lv_obj_t *lbl = lv_label_create(card);
+    lv_label_set_text(lbl, "1.00");
+    style_value_big(lbl);
 
-    g.lbl_ratio = lv_label_create(card);
-    lv_label_set_text(g.lbl_ratio, "1.00");
-    style_value_big(g.lbl_ratio);
+    bind(UI_CH_RATIO, UI_BIND_DEV_BAR, bar_bg);
+    bind(UI_CH_RATIO, UI_BIND_VALUE, lbl);
 }
 
 // ----------------------------------
@@ -442,6 +524,10 @@ static void estop_event(lv_event_t *e)
     const char *cur = lv_label_get_text(g.lbl_estop);
     const bool is_reset = (cur && strstr(cur, "RESET") != nullptr);
 
+    // Before the banner, so the trip is recorded as the E-STOP's
+    blackbox_rec_event(BLACKBOX_EV_ESTOP, 0, !is_reset, nullptr);
+    if(!is_reset) blackbox_rec_trigger("E-STOP");
+
     if(is_reset) {
         lv_label_set_text(g.lbl_estop, "E-STOP");
         if(g.lbl_interlock) lv_label_set_text(g.lbl_interlock, "");
@@ -514,7 +600,7 @@ static void make_hose_subcard(
     lv_obj_t *parent,
     const char *title,
     lv_obj_t **out_status,
-    lv_obj_t **out_temp,
+    ui_channel_t ch_temp,
     lv_obj_t **out_set,
     lv_obj_t **out_toggle,
     lv_obj_t **out_up,
@@ -605,7 +691,7 @@ static void make_hose_subcard(
     lv_obj_set_style_text_color(lbl_up, lv_color_white(), 0);
     lv_obj_center(lbl_up);
     if(out_status) *out_status = status;
-    if(out_temp)   *out_temp   = temp;
+    bind(ch_temp, UI_BIND_VALUE, temp);
     if(out_set)    *out_set    = setp;
     if(out_toggle) *out_toggle = btn_toggle;
     if(out_up)     *out_up     = btn_up;
@@ -642,65 +728,48 @@ static void make_hose_center_card(lv_obj_t *parent)
     lv_obj_set_size(right, lv_pct(50), lv_pct(100));
 
     make_hose_subcard(left, "HOSE 1",
-                      &g.lbl_h1_status, &g.lbl_h1_temp, &g.lbl_h1_set,
+                      &g.lbl_h1_status, UI_CH_HOSE1_TEMP_F, &g.lbl_h1_set,
                       &g.btn_h1_toggle, &g.btn_h1_up, &g.btn_h1_down);
 
     make_hose_subcard(right, "HOSE 2",
-                      &g.lbl_h2_status, &g.lbl_h2_temp, &g.lbl_h2_set,
+                      &g.lbl_h2_status, UI_CH_HOSE2_TEMP_F, &g.lbl_h2_set,
                       &g.btn_h2_toggle, &g.btn_h2_up, &g.btn_h2_down);
 }
 
 // ----------------------------------
 // Events
 // ----------------------------------
-static void hose1_toggle_event(lv_event_t *e)
+// user data: the zone
+static void hose_toggle_event(lv_event_t *e)
 {
-    (void)e;
-    g.hose1_on = !g.hose1_on;
-    if(g.lbl_h1_status) lv_label_set_text(g.lbl_h1_status, g.hose1_on ? "ON" : "OFF");
-    hose_toggle_button_text(g.btn_h1_toggle, g.hose1_on);
-    if(s_hose_toggle_cb) s_hose_toggle_cb(1, g.hose1_on);
-}
+    const uint8_t zone = (uint8_t)(uintptr_t)lv_event_get_user_data(e);
+    lv_subject_t *on = ui_subject_hose_on(zone);
+    const bool enabled = !lv_subject_get_int(on);
 
-static void hose2_toggle_event(lv_event_t *e)
-{
-    (void)e;
-    g.hose2_on = !g.hose2_on;
-    if(g.lbl_h2_status) lv_label_set_text(g.lbl_h2_status, g.hose2_on ? "ON" : "OFF");
-    hose_toggle_button_text(g.btn_h2_toggle, g.hose2_on);
-    if(s_hose_toggle_cb) s_hose_toggle_cb(2, g.hose2_on);
+    lv_subject_set_int(on, enabled);
+    blackbox_rec_event(BLACKBOX_EV_HOSE, zone, enabled, nullptr);
+    if(s_hose_toggle_cb) s_hose_toggle_cb(zone, enabled);
 }
 
-static void hose1_up_event(lv_event_t *e)
+static void hose_setpoint_step(lv_event_t *e, int step)
 {
-    (void)e;
-    g.hose1_set_f += 1;
-    hose_set_label(g.lbl_h1_set, g.hose1_set_f);
-    if(s_hose_setpoint_cb) s_hose_setpoint_cb(1, g.hose1_set_f);
-}
+    const uint8_t zone = (uint8_t)(uintptr_t)lv_event_get_user_data(e);
+    lv_subject_t *set = ui_subject_hose_setpoint(zone);
+    const int set_f = lv_subject_get_int(set) + step;
 
-static void hose1_down_event(lv_event_t *e)
-{
-    (void)e;
-    g.hose1_set_f -= 1;
-    hose_set_label(g.lbl_h1_set, g.hose1_set_f);
-    if(s_hose_setpoint_cb) s_hose_setpoint_cb(1, g.hose1_set_f);
+    lv_subject_set_int(set, set_f);
+    blackbox_rec_event(BLACKBOX_EV_SETPOINT, zone, (int16_t)set_f, nullptr);
+    if(s_hose_setpoint_cb) s_hose_setpoint_cb(zone, set_f);
 }
 
-static void hose2_up_event(lv_event_t *e)
+static void hose_up_event(lv_event_t *e)
 {
-    (void)e;
-    g.hose2_set_f += 1;
-    hose_set_label(g.lbl_h2_set, g.hose2_set_f);
-    if(s_hose_setpoint_cb) s_hose_setpoint_cb(2, g.hose2_set_f);
+    hose_setpoint_step(e, +1);
 }
 
-static void hose2_down_event(lv_event_t *e)
+static void hose_down_event(lv_event_t *e)
 {
-    (void)e;
-    g.hose2_set_f -= 1;
-    hose_set_label(g.lbl_h2_set, g.hose2_set_f);
-    if(s_hose_setpoint_cb) s_hose_setpoint_cb(2, g.hose2_set_f);
+    hose_setpoint_step(e, -1);
 }
 
 // ----------------------------------
@@ -714,11 +783,12 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_size(root, 800, 1280);
     lv_obj_set_style_pad_all(root, 0, 0);
 
-    // Defaults
-    g.hose1_set_f = 125;
-    g.hose2_set_f = 125;
-    g.hose1_on = false;
-    g.hose2_on = false;
+    if(!UI_EVENT_TOUCH_ZOOM) UI_EVENT_TOUCH_ZOOM = lv_event_register_id();
+
+    // Defaults live in the subjects
+    ui_subjects_init();
+    s_ch = {};
+    for(int i = 0; i < UI_CH_COUNT; i++) s_ch.label_q[i] = INT32_MIN;
 
     // Geometry
     const int PAD = 10;
@@ -773,7 +843,8 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_width(g.banner_lbl, lv_pct(100));
     lv_obj_set_style_text_align(g.banner_lbl, LV_TEXT_ALIGN_CENTER, 0);
 
-    ui_set_banner("OK", false);
+    lv_subject_add_observer_obj(ui_subject_status(), pending_observer, g.banner, (void *)(uintptr_t)UI_PENDING_STATUS);
+    lv_subject_add_observer_obj(ui_subject_status_error(), pending_observer, g.banner, (void *)(uintptr_t)UI_PENDING_STATUS);
 
     // Main container (absolute positioning)
     lv_obj_t *main = lv_obj_create(root);
@@ -787,7 +858,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_pos(cell_iso_hp, 0, 0);
     lv_obj_set_size(cell_iso_hp, big_w, big_h);
     make_hp_card(cell_iso_hp, "ISO PRESSURE (HP)",
-                 &g.arc_iso_hp, &g.lbl_iso_hp_psi, &g.lbl_iso_hp_temp, &g.lbl_iso_hp_lowtemp);
+                 UI_CH_ISO_HP_PSI, UI_CH_ISO_HP_TEMP_F, UI_CH_ISO_LOW_TEMP_F);
 
     lv_obj_t *cell_ratio = lv_obj_create(main);
     transparent_container(cell_ratio);
@@ -800,7 +871,13 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_pos(cell_resin_hp, big_w + GAP + ratio_w + GAP, 0);
     lv_obj_set_size(cell_resin_hp, big_w, big_h);
     make_hp_card(cell_resin_hp, "RESIN PRESSURE (HP)",
-                 &g.arc_resin_hp, &g.lbl_resin_hp_psi, &g.lbl_resin_hp_temp, &g.lbl_resin_hp_lowtemp);
+                 UI_CH_RESIN_HP_PSI, UI_CH_RESIN_HP_TEMP_F, UI_CH_RESIN_LOW_TEMP_F);
+
+    // Tapping either pressure card opens their trend over the top row
+    if(ui_trend_build(main, 0, 0, avail_w, big_h)) {
+        ui_trend_add_opener(cell_iso_hp);
+        ui_trend_add_opener(cell_resin_hp);
+    }
 
     // --- Controls row: SPRAY | HOSE 1 | HOSE 2 | DRUM AIR ---
     const int ctrl_y_rel = y_ctrl - y_top;
@@ -816,7 +893,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_pos(cell_h1, ctrl_w1 + GAP, ctrl_y_rel);
     lv_obj_set_size(cell_h1, ctrl_w2, ctrl_h);
     make_hose_subcard(cell_h1, "HOSE 1 HEAT",
-                      &g.lbl_h1_status, &g.lbl_h1_temp, &g.lbl_h1_set,
+                      &g.lbl_h1_status, UI_CH_HOSE1_TEMP_F, &g.lbl_h1_set,
                       &g.btn_h1_toggle, &g.btn_h1_up, &g.btn_h1_down);
 
     lv_obj_t *cell_h2 = lv_obj_create(main);
@@ -824,7 +901,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_pos(cell_h2, ctrl_w1 + GAP + ctrl_w2 + GAP, ctrl_y_rel);
     lv_obj_set_size(cell_h2, ctrl_w3, ctrl_h);
     make_hose_subcard(cell_h2, "HOSE 2 HEAT",
-                      &g.lbl_h2_status, &g.lbl_h2_temp, &g.lbl_h2_set,
+                      &g.lbl_h2_status, UI_CH_HOSE2_TEMP_F, &g.lbl_h2_set,
                       &g.btn_h2_toggle, &g.btn_h2_up, &g.btn_h2_down);
 
     lv_obj_t *cell_drum = lv_obj_create(main);
@@ -833,21 +910,21 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     lv_obj_set_size(cell_drum, ctrl_w4, ctrl_h);
     g.btn_drum_air = make_big_button_card(cell_drum, "DRUM AIR", "ON/OFF");
 
-    // Init hose labels
-    hose_set_label(g.lbl_h1_set, g.hose1_set_f);
-    hose_set_label(g.lbl_h2_set, g.hose2_set_f);
-    hose_toggle_button_text(g.btn_h1_toggle, g.hose1_on);
-    hose_toggle_button_text(g.btn_h2_toggle, g.hose2_on);
-    if(g.lbl_h1_status) lv_label_set_text(g.lbl_h1_status, g.hose1_on ? "ON" : "OFF");
-    if(g.lbl_h2_status) lv_label_set_text(g.lbl_h2_status, g.hose2_on ? "ON" : "OFF");
+    // Hose widgets follow their subjects
+    lv_obj_t *hose_toggle[UI_HOSE_ZONES] = { g.btn_h1_toggle, g.btn_h2_toggle };
+    for(uint8_t z = 1; z <= UI_HOSE_ZONES; z++) {
+        void *bit = (void *)(uintptr_t)UI_PENDING_HOSE(z);
+        lv_subject_add_observer_obj(ui_subject_hose_on(z), pending_observer, hose_toggle[z - 1], bit);
+        lv_subject_add_observer_obj(ui_subject_hose_setpoint(z), pending_observer, hose_toggle[z - 1], bit);
+    }
 
     // Wire hose events
-    lv_obj_add_event_cb(g.btn_h1_toggle, hose1_toggle_event, LV_EVENT_CLICKED, nullptr);
-    lv_obj_add_event_cb(g.btn_h2_toggle, hose2_toggle_event, LV_EVENT_CLICKED, nullptr);
-    lv_obj_add_event_cb(g.btn_h1_up, hose1_up_event, LV_EVENT_CLICKED, nullptr);
-    lv_obj_add_event_cb(g.btn_h1_down, hose1_down_event, LV_EVENT_CLICKED, nullptr);
-    lv_obj_add_event_cb(g.btn_h2_up, hose2_up_event, LV_EVENT_CLICKED, nullptr);
-    lv_obj_add_event_cb(g.btn_h2_down, hose2_down_event, LV_EVENT_CLICKED, nullptr);
+    lv_obj_add_event_cb(g.btn_h1_toggle, hose_toggle_event, LV_EVENT_CLICKED, (void *)1);
+    lv_obj_add_event_cb(g.btn_h2_toggle, hose_toggle_event, LV_EVENT_CLICKED, (void *)2);
+    lv_obj_add_event_cb(g.btn_h1_up, hose_up_event, LV_EVENT_CLICKED, (void *)1);
+    lv_obj_add_event_cb(g.btn_h1_down, hose_down_event, LV_EVENT_CLICKED, (void *)1);
+    lv_obj_add_event_cb(g.btn_h2_up, hose_up_event, LV_EVENT_CLICKED, (void *)2);
+    lv_obj_add_event_cb(g.btn_h2_down, hose_down_event, LV_EVENT_CLICKED, (void *)2);
 
     // --- Row 3 (small cards): ISO LOW | SYSTEM STATUS | RESIN LOW ---
     const int row3_y_rel = y_row3 - y_top;
@@ -856,8 +933,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     transparent_container(cell_iso_low);
     lv_obj_set_pos(cell_iso_low, 0, row3_y_rel);
     lv_obj_set_size(cell_iso_low, small_w1, small_h);
-    make_small_gauge_card(cell_iso_low, "ISO LOW", 0, 500,
-                          &g.arc_iso_low, &g.lbl_iso_low_psi, &g.lbl_iso_low_temp);
+    make_small_gauge_card(cell_iso_low, "ISO LOW", UI_CH_ISO_LOW_PSI, UI_CH_ISO_LOW_TEMP_F);
 
     lv_obj_t *cell_status = lv_obj_create(main);
     transparent_container(cell_status);
@@ -869,8 +945,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     transparent_container(cell_resin_low);
     lv_obj_set_pos(cell_resin_low, small_w1 + GAP + small_w2 + GAP, row3_y_rel);
     lv_obj_set_size(cell_resin_low, small_w3, small_h);
-    make_small_gauge_card(cell_resin_low, "RESIN LOW", 0, 500,
-                          &g.arc_resin_low, &g.lbl_resin_low_psi, &g.lbl_resin_low_temp);
+    make_small_gauge_card(cell_resin_low, "RESIN LOW", UI_CH_RESIN_LOW_PSI, UI_CH_RESIN_LOW_TEMP_F);
 
     // --- Row 4 (small cards): GUN AIR | E-STOP / RESET | PRIMARY AIR ---
     const int row4_y_rel = y_row4 - y_top;
@@ -879,8 +954,7 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     transparent_container(cell_gun);
     lv_obj_set_pos(cell_gun, 0, row4_y_rel);
     lv_obj_set_size(cell_gun, small_w1, h_row4);
-    make_small_gauge_card(cell_gun, "GUN AIR", 0, 300,
-                          &g.arc_gun_air, &g.lbl_gun_air_psi, nullptr);
+    make_small_gauge_card(cell_gun, "GUN AIR", UI_CH_GUN_AIR_PSI, UI_CH_COUNT);
 
     lv_obj_t *cell_estop = lv_obj_create(main);
     transparent_container(cell_estop);
@@ -892,8 +966,32 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
     transparent_container(cell_primary);
     lv_obj_set_pos(cell_primary, small_w1 + GAP + small_w2 + GAP, row4_y_rel);
     lv_obj_set_size(cell_primary, small_w3, h_row4);
-    make_small_gauge_card(cell_primary, "PRIMARY AIR", 0, 300,
-                          &g.arc_primary_air, &g.lbl_primary_air_psi, nullptr);
+    make_small_gauge_card(cell_primary, "PRIMARY AIR", UI_CH_PRIMARY_AIR_PSI, UI_CH_COUNT);
+
+    // Controls whose press-to-photon latency is measured
+    watch_press(g.btn_estop);
+    watch_press(g.btn_h1_toggle);
+    watch_press(g.btn_h2_toggle);
+    watch_press(g.btn_h1_up);
+    watch_press(g.btn_h1_down);
+    watch_press(g.btn_h2_up);
+    watch_press(g.btn_h2_down);
+    watch_press(g.btn_spray);
+    watch_press(g.btn_drum_air);
+
+    // Every widget the channel table lists must have been created
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        if(s_ch.bound[i] != s_channels[i].binds) {
+            LV_LOG_WARN("channel %s: widgets 0x%x, table says 0x%x",
+                        s_channels[i].name, s_ch.bound[i], s_channels[i].binds);
+        }
+    }
+
+    // Posts reach the subjects every display period, whether or not anything
+    // redraws; subjects written since the last frame reach the widgets as the
+    // next one starts
+    if(!s_drain_timer) s_drain_timer = lv_timer_create(drain_timer, LV_DEF_REFR_PERIOD, nullptr);
+    lv_display_add_event_cb(lv_obj_get_display(root), refr_start_event, LV_EVENT_REFR_START, nullptr);
 
     // Final safety: main not scrollable
     noscroll(main);
@@ -902,113 +1000,123 @@ extern "C" void ui_build_live_view(lv_obj_t *root)
 // ----------------------------------
 // Public: Update values
 // ----------------------------------
-extern "C" void ui_update_live_values(
-    float iso_hp_psi,      float resin_hp_psi,
-    float iso_low_psi,     float resin_low_psi,
-    float primary_air_psi, float gun_air_psi,
-    float iso_hp_temp_f,   float resin_hp_temp_f,
-    float iso_low_temp_f,  float resin_low_temp_f,
-    float hose1_temp_f,    float hose2_temp_f,
-    float ratio)
-{
-    char b[64];
-
-    // ISO HP
-    if(g.arc_iso_hp) lv_arc_set_value(g.arc_iso_hp, (int32_t)clampf(iso_hp_psi, 0, 1600));
-    if(g.lbl_iso_hp_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(iso_hp_psi));
-        lv_label_set_text(g.lbl_iso_hp_psi, b);
-    }
-    if(g.lbl_iso_hp_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", iso_hp_temp_f);
-        lv_label_set_text(g.lbl_iso_hp_temp, b);
-    }
-    if(g.lbl_iso_hp_lowtemp) {
-        snprintf(b, sizeof(b), "Low: %.1f \xC2\xB0""F", iso_low_temp_f);
-        lv_label_set_text(g.lbl_iso_hp_lowtemp, b);
-    }
+// Ratio-style bar: a chunk from the middle of the background, up for values
+// above the middle of lo..hi, down below it, taller the further out
+static void update_dev_bar(int ch, float v)
+{
+    const ui_channel_desc_t *d = &s_channels[ch];
+    const float mid = 0.5f * (d->lo + d->hi);
+    const float half = 0.5f * (d->hi - d->lo);
+    const float dev = clampf(v, d->lo, d->hi) - mid;
+    const float mag = fabsf(dev) / half;
+
+    lv_obj_t *bg = s_ch.bar[ch];
+    const int bg_h = lv_obj_get_height(bg);
+    const int bg_w = lv_obj_get_width(bg);
+
+    const int min_h = (bg_h * 12) / 100;
+    const int max_h = (bg_h * 92) / 100;
+    const int fill_h = (int)lroundf(min_h + (max_h - min_h) * mag);
+
+    const int center_y = bg_h / 2;
+    const int y = (dev >= 0) ? (center_y - fill_h) : center_y;
+
+    // Setting the same size still restyles and invalidates the fill
+    if(fill_h == s_ch.bar_h[ch] && y == s_ch.bar_y[ch]) return;
+    s_ch.bar_h[ch] = fill_h;
+    s_ch.bar_y[ch] = y;
+    lv_obj_set_size(s_ch.bar_fill[ch], bg_w, fill_h);
+    lv_obj_set_pos(s_ch.bar_fill[ch], 0, y);
+}
 
-    // RESIN HP
-    if(g.arc_resin_hp) lv_arc_set_value(g.arc_resin_hp, (int32_t)clampf(resin_hp_psi, 0, 1600));
-    if(g.lbl_resin_hp_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(resin_hp_psi));
-        lv_label_set_text(g.lbl_resin_hp_psi, b);
-    }
-    if(g.lbl_resin_hp_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", resin_hp_temp_f);
-        lv_label_set_text(g.lbl_resin_hp_temp, b);
-    }
-    if(g.lbl_resin_hp_lowtemp) {
-        snprintf(b, sizeof(b), "Low: %.1f \xC2\xB0""F", resin_low_temp_f);
-        lv_label_set_text(g.lbl_resin_hp_lowtemp, b);
-    }
+static void apply_channel(int ch)
+{
+    static const int32_t pow10[] = {1, 10, 100, 1000};
+    const ui_channel_desc_t *d = &s_channels[ch];
+    const int32_t v = lv_subject_get_int(ui_subject_channel((ui_channel_t)ch));
+    const float x = (float)v / (float)pow10[d->decimals + d->fine];
 
-    // ISO LOW
-    if(g.arc_iso_low) lv_arc_set_value(g.arc_iso_low, (int32_t)clampf(iso_low_psi, 0, 500));
-    if(g.lbl_iso_low_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(iso_low_psi));
-        lv_label_set_text(g.lbl_iso_low_psi, b);
-    }
-    if(g.lbl_iso_low_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", iso_low_temp_f);
-        lv_label_set_text(g.lbl_iso_low_temp, b);
+    if(s_ch.arc[ch]) {
+        lv_arc_set_value(s_ch.arc[ch], (int32_t)lroundf(clampf(x, d->lo, d->hi)));
     }
 
-    // RESIN LOW
-    if(g.arc_resin_low) lv_arc_set_value(g.arc_resin_low, (int32_t)clampf(resin_low_psi, 0, 500));
-    if(g.lbl_resin_low_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(resin_low_psi));
-        lv_label_set_text(g.lbl_resin_low_psi, b);
-    }
-    if(g.lbl_resin_low_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", resin_low_temp_f);
-        lv_label_set_text(g.lbl_resin_low_temp, b);
+    // Drop the fine digits, rounding half away from zero like lroundf
+    const int32_t p = pow10[d->fine];
+    const int32_t q = (v >= 0) ? (v + p / 2) / p : -((-v + p / 2) / p);
+    if(q != s_ch.label_q[ch]) {
+        char b[64];
+        s_ch.label_q[ch] = q;
+        if(s_ch.value[ch]) {
+            format_channel(b, sizeof(b), d, "", q);
+            lv_label_set_text(s_ch.value[ch], b);
+        }
+        if(s_ch.echo[ch]) {
+            format_channel(b, sizeof(b), d, d->echo_prefix, q);
+            lv_label_set_text(s_ch.echo[ch], b);
+        }
     }
 
-    // Air
-    if(g.arc_primary_air) lv_arc_set_value(g.arc_primary_air, (int32_t)clampf(primary_air_psi, 0, 300));
-    if(g.lbl_primary_air_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(primary_air_psi));
-        lv_label_set_text(g.lbl_primary_air_psi, b);
-    }
+    if(s_ch.bar[ch]) update_dev_bar(ch, x);
+}
 
-    if(g.arc_gun_air) lv_arc_set_value(g.arc_gun_air, (int32_t)clampf(gun_air_psi, 0, 300));
-    if(g.lbl_gun_air_psi) {
-        snprintf(b, sizeof(b), "%d\nPSI", (int)lroundf(gun_air_psi));
-        lv_label_set_text(g.lbl_gun_air_psi, b);
-    }
+static void apply_hose(uint8_t zone)
+{
+    lv_obj_t *status = (zone == 1) ? g.lbl_h1_status : g.lbl_h2_status;
+    lv_obj_t *set    = (zone == 1) ? g.lbl_h1_set : g.lbl_h2_set;
+    lv_obj_t *toggle = (zone == 1) ? g.btn_h1_toggle : g.btn_h2_toggle;
+    const bool on = lv_subject_get_int(ui_subject_hose_on(zone));
+
+    if(status) lv_label_set_text(status, on ? "ON" : "OFF");
+    hose_toggle_button_text(toggle, on);
+    hose_set_label(set, lv_subject_get_int(ui_subject_hose_setpoint(zone)));
+}
 
-    // Hose temps
-    if(g.lbl_h1_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", hose1_temp_f);
-        lv_label_set_text(g.lbl_h1_temp, b);
-    }
-    if(g.lbl_h2_temp) {
-        snprintf(b, sizeof(b), "%.1f \xC2\xB0""F", hose2_temp_f);
-        lv_label_set_text(g.lbl_h2_temp, b);
-    }
+static void apply_status(void)
+{
+    const char *msg = lv_subject_get_string(ui_subject_status());
 
-    // Ratio numeric + bar (center baseline, deviates up/down)
-    if(g.lbl_ratio) {
-        snprintf(b, sizeof(b), "%.2f", ratio);
-        lv_label_set_text(g.lbl_ratio, b);
+    if(msg[0] == '\0') {
+        lv_obj_add_flag(g.banner, LV_OBJ_FLAG_HIDDEN);
+        return;
     }
 
-    if(g.ratio_bar_bg && g.ratio_bar_fill) {
-        const float dev = clampf(ratio - 1.0f, -0.10f, 0.10f); // +/-10%
-        const float mag = fabsf(dev) / 0.10f;
+    banner_apply_style(lv_subject_get_int(ui_subject_status_error()) != 0);
+    if(g.banner_lbl) lv_label_set_text(g.banner_lbl, msg);
+    if(g.lbl_status_card) lv_label_set_text(g.lbl_status_card, msg);
+    lv_obj_clear_flag(g.banner, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void apply_pending(void)
+{
+    TRACE_RING_BEGIN;
+    const uint32_t pending = s_ch.pending;
+    s_ch.pending = 0;
 
-        const int bg_h = lv_obj_get_height(g.ratio_bar_bg);
-        const int bg_w = lv_obj_get_width(g.ratio_bar_bg);
+    for(uint32_t m = pending & ((1u << UI_CH_COUNT) - 1); m; m &= m - 1) {
+        apply_channel(__builtin_ctz(m));
+    }
+    for(uint8_t z = 1; z <= UI_HOSE_ZONES; z++) {
+        if(pending & UI_PENDING_HOSE(z)) apply_hose(z);
+    }
+    if(pending & UI_PENDING_STATUS) apply_status();
+    TRACE_RING_END;
+}
 
-        const int min_h = (bg_h * 12) / 100;
-        const int max_h = (bg_h * 92) / 100;
-        int fill_h = (int)lroundf(min_h + (max_h - min_h) * mag);
+static void drain_timer(lv_timer_t *t)
+{
+    (void)t;
+    ui_subjects_drain();
+}
 
-        const int center_y = bg_h / 2;
-        int y = (dev >= 0) ? (center_y - fill_h) : center_y;
+static void refr_start_event(lv_event_t *e)
+{
+    (void)e;
+    if(s_ch.pending) apply_pending();
+}
 
-        lv_obj_set_size(g.ratio_bar_fill, bg_w, fill_h);
-        lv_obj_set_pos(g.ratio_bar_fill, 0, y);
-    }
+extern "C" void ui_update_live_values(const float *values)
+{
+    ui_subjects_set_channels(values, (1u << UI_CH_COUNT) - 1);
+    ui_trend_record(values);
+    blackbox_rec_values(values);
 }
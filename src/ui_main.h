@@ -11,19 +11,60 @@ extern "C" {
 // ---------- Public UI API ----------
 void ui_build_live_view(lv_obj_t * parent);
 
-// NOTE: Keep this signature EXACTLY matching what your main.cpp calls.
-// If your main.cpp call differs, adjust this prototype to match main.cpp.
-void ui_update_live_values(
-    float iso_hp_psi,      float resin_hp_psi,
-    float iso_low_psi,     float resin_low_psi,
-    float primary_air_psi, float gun_air_psi,
-    float iso_hp_temp_f,   float resin_hp_temp_f,
-    float iso_low_temp_f,  float resin_low_temp_f,
-    float hose1_temp_f,    float hose2_temp_f,
-    float ratio
-);
-
-// Banner
+// ---------- Live channels ----------
+// One id per measured value. ui_update_live_values() takes the values packed
+// in this order; the descriptor table in ui_main.cpp gives each channel its
+// range, unit, precision and the widgets it drives.
+typedef enum {
+    UI_CH_ISO_HP_PSI,
+    UI_CH_RESIN_HP_PSI,
+    UI_CH_ISO_LOW_PSI,
+    UI_CH_RESIN_LOW_PSI,
+    UI_CH_PRIMARY_AIR_PSI,
+    UI_CH_GUN_AIR_PSI,
+    UI_CH_ISO_HP_TEMP_F,
+    UI_CH_RESIN_HP_TEMP_F,
+    UI_CH_ISO_LOW_TEMP_F,
+    UI_CH_RESIN_LOW_TEMP_F,
+    UI_CH_HOSE1_TEMP_F,
+    UI_CH_HOSE2_TEMP_F,
+    UI_CH_RATIO,
+    UI_CH_COUNT
+} ui_channel_t;
+
+// Widget roles a channel can drive (bit mask in ui_channel_desc_t::binds)
+enum {
+    UI_BIND_ARC     = 1 << 0,   // gauge arc, range lo..hi
+    UI_BIND_VALUE   = 1 << 1,   // value label: number + unit
+    UI_BIND_ECHO    = 1 << 2,   // second label elsewhere: echo_prefix + number + unit
+    UI_BIND_DEV_BAR = 1 << 3,   // bar growing up/down from the middle of lo..hi;
+                                // binds the background, its first child is the fill
+};
+
+typedef struct {
+    uint8_t     id;             // ui_channel_t, same as the table index
+    const char *name;           // short name for logs
+    const char *unit;           // appended to the number, with its separator
+    float       lo, hi;         // gauge / bar range; labels show the raw value
+    uint8_t     decimals;       // 0..3, as shown on labels
+    uint8_t     fine;           // extra decimals kept for widgets finer than the label
+    uint8_t     binds;          // UI_BIND_*
+    const char *echo_prefix;    // UI_BIND_ECHO only
+} ui_channel_desc_t;
+
+const ui_channel_desc_t *ui_channel_desc(ui_channel_t ch);
+
+// values[UI_CH_COUNT] into the channel subjects (ui_subjects.h), LVGL task
+// only; other tasks use ui_post_channels(). Widgets follow at the next refresh,
+// and only those whose value changed.
+void ui_update_live_values(const float *values);
+
+// Two-finger zoom detected by the touch controller. The input glue sends it to
+// the object under the fingers; lv_event_get_param() is (void *)(intptr_t)
+// +1 for zoom in, -1 for zoom out. Registered by ui_build_live_view().
+extern uint32_t UI_EVENT_TOUCH_ZOOM;
+
+// Banner: sets the status subjects, LVGL task only (others: ui_post_status())
 void ui_set_banner(const char * msg, bool is_error);
 
 // Hose heat callbacks (UI -> your application logic)
@@ -33,6 +74,11 @@ typedef void (*ui_hose_setpoint_cb_t)(uint8_t zone, int setpoint_f);
 void ui_set_hose_toggle_callback(ui_hose_toggle_cb_t cb);
 void ui_set_hose_setpoint_callback(ui_hose_setpoint_cb_t cb);
 
+// Called when a control (E-STOP, hose toggle/TEMP +/-, SPRAY, DRUM AIR)
+// receives LV_EVENT_PRESSED; used for input latency measurement
+typedef void (*ui_press_cb_t)(lv_obj_t *target);
+void ui_set_press_callback(ui_press_cb_t cb);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,216 @@
+#include "ui_subjects.h"
+#include "ui_trend.h"
+#include "log/blackbox_recorder.h"
+
+#include <math.h>
+#include <cstring>
+#include "freertos/FreeRTOS.h"
+
+// ----------------------------------
+// Subjects (LVGL task)
+// ----------------------------------
+typedef struct {
+    lv_subject_t ch[UI_CH_COUNT];
+    float        scale[UI_CH_COUNT];    // 10^(decimals + fine)
+    int32_t      value[UI_CH_COUNT];    // mirror of ch[], flat for the compare pass
+    lv_subject_t hose_on[UI_HOSE_ZONES];
+    lv_subject_t hose_set[UI_HOSE_ZONES];
+    lv_subject_t status;
+    lv_subject_t status_error;
+    char         status_buf[UI_STATUS_MAX];
+    char         status_prev[UI_STATUS_MAX];
+    bool         ready;
+} ui_subjects_t;
+
+static ui_subjects_t s;
+
+// ----------------------------------
+// Staged posts (any task)
+// ----------------------------------
+typedef struct {
+    uint32_t ch_dirty;
+    float    ch[UI_CH_COUNT];
+    uint8_t  hose_on_dirty, hose_set_dirty;     // bit per zone
+    bool     hose_on[UI_HOSE_ZONES];
+    int32_t  hose_set[UI_HOSE_ZONES];
+    bool     status_dirty;
+    bool     status_error;
+    char     status[UI_STATUS_MAX];
+    ui_post_stats_t stats;
+} ui_mailbox_t;
+
+static ui_mailbox_t s_box;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+extern "C" void ui_subjects_init(void)
+{
+    if(s.ready) return;
+
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        const ui_channel_desc_t *d = ui_channel_desc((ui_channel_t)i);
+        s.scale[i] = powf(10.0f, (float)(d->decimals + d->fine));
+        s.value[i] = 0;
+        lv_subject_init_int(&s.ch[i], 0);
+    }
+    for(int z = 0; z < UI_HOSE_ZONES; z++) {
+        lv_subject_init_int(&s.hose_on[z], 0);
+        lv_subject_init_int(&s.hose_set[z], UI_HOSE_SETPOINT_DEFAULT_F);
+    }
+    lv_subject_init_string(&s.status, s.status_buf, s.status_prev, UI_STATUS_MAX, "OK");
+    lv_subject_init_int(&s.status_error, 0);
+    s.ready = true;
+}
+
+extern "C" void ui_subjects_set_channels(const float *values, uint32_t mask)
+{
+    // Round everything first, then notify only what moved
+    uint32_t changed = 0;
+    for(int i = 0; i < UI_CH_COUNT; i++) {
+        const int32_t v = (int32_t)lroundf(values[i] * s.scale[i]);
+        changed |= (uint32_t)(v != s.value[i]) << i;
+        if(mask & (1u << i)) s.value[i] = v;
+    }
+    changed &= mask;
+
+    for(uint32_t m = changed; m; m &= m - 1) {
+        const int i = __builtin_ctz(m);
+        lv_subject_set_int(&s.ch[i], s.value[i]);
+    }
+}
+
+extern "C" void ui_subjects_drain(void)
+{
+    ui_mailbox_t box;
+
+    portENTER_CRITICAL(&s_lock);
+    const bool any = s_box.ch_dirty || s_box.hose_on_dirty || s_box.hose_set_dirty || s_box.status_dirty;
+    if(any) {
+        memcpy(&box, &s_box, sizeof(box));
+        s_box.ch_dirty = 0;
+        s_box.hose_on_dirty = s_box.hose_set_dirty = 0;
+        s_box.status_dirty = false;
+        s_box.stats.drains++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if(!any || !s.ready) return;
+
+    if(box.ch_dirty) ui_subjects_set_channels(box.ch, box.ch_dirty);
+    for(int z = 0; z < UI_HOSE_ZONES; z++) {
+        if((box.hose_on_dirty >> z) & 1) {
+            if(lv_subject_get_int(&s.hose_on[z]) != box.hose_on[z]) lv_subject_set_int(&s.hose_on[z], box.hose_on[z]);
+        }
+        if((box.hose_set_dirty >> z) & 1) {
+            if(lv_subject_get_int(&s.hose_set[z]) != box.hose_set[z]) lv_subject_set_int(&s.hose_set[z], box.hose_set[z]);
+        }
+    }
+    if(box.status_dirty) {
+        // An error status from the machine side is an alarm: it trips the black box
+        blackbox_rec_event(BLACKBOX_EV_BANNER, 0, box.status_error, box.status);
+        if(box.status_error && box.status[0]) blackbox_rec_trigger(box.status);
+        lv_subject_set_int(&s.status_error, box.status_error);
+        if(strcmp(lv_subject_get_string(&s.status), box.status) != 0) lv_subject_copy_string(&s.status, box.status);
+    }
+}
+
+extern "C" lv_subject_t *ui_subject_channel(ui_channel_t ch)
+{
+    return (ch < UI_CH_COUNT) ? &s.ch[ch] : nullptr;
+}
+
+extern "C" lv_subject_t *ui_subject_hose_on(uint8_t zone)
+{
+    return (zone >= 1 && zone <= UI_HOSE_ZONES) ? &s.hose_on[zone - 1] : nullptr;
+}
+
+extern "C" lv_subject_t *ui_subject_hose_setpoint(uint8_t zone)
+{
+    return (zone >= 1 && zone <= UI_HOSE_ZONES) ? &s.hose_set[zone - 1] : nullptr;
+}
+
+extern "C" lv_subject_t *ui_subject_status(void)
+{
+    return &s.status;
+}
+
+extern "C" lv_subject_t *ui_subject_status_error(void)
+{
+    return &s.status_error;
+}
+
+// ----------------------------------
+// Producers
+// ----------------------------------
+extern "C" void ui_post_channel(ui_channel_t ch, float value)
+{
+    if(ch >= UI_CH_COUNT) return;
+
+    portENTER_CRITICAL(&s_lock);
+    if(s_box.ch_dirty & (1u << ch)) s_box.stats.coalesced++;
+    s_box.ch[ch] = value;
+    s_box.ch_dirty |= 1u << ch;
+    s_box.stats.posts++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void ui_post_channels(const float *values)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_box.stats.coalesced += __builtin_popcount(s_box.ch_dirty);
+    memcpy(s_box.ch, values, sizeof(s_box.ch));
+    s_box.ch_dirty = (1u << UI_CH_COUNT) - 1;
+    s_box.stats.posts += UI_CH_COUNT;
+    portEXIT_CRITICAL(&s_lock);
+
+    // Every acquisition, not just the last one before a refresh
+    ui_trend_record(values);
+    blackbox_rec_values(values);
+}
+
+extern "C" void ui_post_hose_on(uint8_t zone, bool on)
+{
+    if(zone < 1 || zone > UI_HOSE_ZONES) return;
+    const uint8_t bit = 1u << (zone - 1);
+
+    portENTER_CRITICAL(&s_lock);
+    if(s_box.hose_on_dirty & bit) s_box.stats.coalesced++;
+    s_box.hose_on[zone - 1] = on;
+    s_box.hose_on_dirty |= bit;
+    s_box.stats.posts++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void ui_post_hose_setpoint(uint8_t zone, int setpoint_f)
+{
+    if(zone < 1 || zone > UI_HOSE_ZONES) return;
+    const uint8_t bit = 1u << (zone - 1);
+
+    portENTER_CRITICAL(&s_lock);
+    if(s_box.hose_set_dirty & bit) s_box.stats.coalesced++;
+    s_box.hose_set[zone - 1] = setpoint_f;
+    s_box.hose_set_dirty |= bit;
+    s_box.stats.posts++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void ui_post_status(const char *msg, bool is_error)
+{
+    // Copy outside the lock; only the short memcpy is inside
+    char buf[UI_STATUS_MAX];
+    strncpy(buf, msg ? msg : "", sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    portENTER_CRITICAL(&s_lock);
+    if(s_box.status_dirty) s_box.stats.coalesced++;
+    memcpy(s_box.status, buf, sizeof(buf));
+    s_box.status_error = is_error;
+    s_box.status_dirty = true;
+    s_box.stats.posts++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+extern "C" void ui_post_get_stats(ui_post_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_box.stats;
+    portEXIT_CRITICAL(&s_lock);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "lvgl.h"
+#include "ui_main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The live view's state as LV_USE_OBSERVER subjects:
+// - one int per channel, the value times 10^(decimals + fine) of its descriptor
+// - hose on/off (0/1) and setpoint (deg F) per zone
+// - the system status: message ("" hides the banner) and error flag (0/1)
+// Widgets observe these; ui_main.cpp folds every notification of a frame into
+// one widget update at the start of the next refresh.
+//
+// ui_post_*() may be called from any task (not from ISRs): the write is staged
+// and moved into the subject within one display period, the last write of
+// each value winning. Everything else belongs to the LVGL task.
+
+#define UI_HOSE_ZONES   2
+#define UI_STATUS_MAX   96
+
+// Hose setpoint (deg F) shown from boot until the machine side posts one; the
+// live view has always started at 125
+#define UI_HOSE_SETPOINT_DEFAULT_F  125
+
+void ui_subjects_init(void);
+// Move staged posts into the subjects; ui_main.cpp calls it from an lv_timer
+// every LV_DEF_REFR_PERIOD
+void ui_subjects_drain(void);
+// Set the subjects of the channels in mask from values[UI_CH_COUNT] where their
+// rounded value changed
+void ui_subjects_set_channels(const float *values, uint32_t mask);
+
+lv_subject_t *ui_subject_channel(ui_channel_t ch);
+lv_subject_t *ui_subject_hose_on(uint8_t zone);         // zone 1..UI_HOSE_ZONES
+lv_subject_t *ui_subject_hose_setpoint(uint8_t zone);
+lv_subject_t *ui_subject_status(void);
+lv_subject_t *ui_subject_status_error(void);
+
+// Any task
+void ui_post_channel(ui_channel_t ch, float value);
+void ui_post_channels(const float *values);             // all UI_CH_COUNT
+void ui_post_hose_on(uint8_t zone, bool on);
+void ui_post_hose_setpoint(uint8_t zone, int setpoint_f);
+void ui_post_status(const char *msg, bool is_error);
+
+typedef struct {
+    uint32_t posts;             // values posted
+    uint32_t coalesced;         // posts overwritten by a later one before a drain
+    uint32_t drains;            // drain passes that found staged posts
+} ui_post_stats_t;
+
+void ui_post_get_stats(ui_post_stats_t *out);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,333 @@
+#include "ui_trend.h"
+#include "ui_main.h"
+#include "trend/trend_ring.h"
+#include "log/chan_logger.h"
+
+#include <math.h>
+#include <cstdio>
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+// ----------------------------------
+// State
+// ----------------------------------
+#define TREND_COLUMNS       250     // 3 px each on the panel; divides every window below
+#define TREND_CAP           (UI_TREND_SAMPLE_HZ * UI_TREND_MAX_S)
+#define TREND_REFRESH_MS    100
+#define TREND_Y_STEP        50      // y axis snaps to this, in channel units
+#define TREND_HISTORY_TICKS 10      // refreshes per history read: once a second
+
+// Windows up to UI_TREND_MAX_S come from the sample rings, longer ones from
+// the logger's history pyramid
+static const uint32_t s_window_s[] = { 5, 10, 30, 60, 10 * 60, 60 * 60, 4 * 60 * 60, 12 * 60 * 60 };
+#define TREND_WINDOWS (sizeof(s_window_s) / sizeof(s_window_s[0]))
+#define TREND_WINDOW_LIVE   3       // 60 s, the longest from the rings; opens with it
+
+typedef struct {
+    ui_channel_t ch;
+    const char  *name;
+    uint32_t     color;
+} trend_source_t;
+
+static const trend_source_t s_src[] = {
+    { UI_CH_ISO_HP_PSI,   "ISO",   0xFF8A3D },
+    { UI_CH_RESIN_HP_PSI, "RESIN", 0x2D73FF },
+};
+
+#define TREND_N (sizeof(s_src) / sizeof(s_src[0]))
+
+static_assert(TREND_CAP % TREND_COLUMNS == 0, "the longest window must be whole columns");
+
+typedef struct {
+    trend_ring_t ring[TREND_N];         // under s_lock: pushed by any task, read by the timer
+    float        scale[TREND_N];        // 10^decimals of the channel
+    lv_obj_t    *panel;
+    lv_obj_t    *chart;
+    lv_obj_t    *title;
+    lv_chart_series_t *ser_min[TREND_N];
+    lv_chart_series_t *ser_max[TREND_N];
+    int32_t     *hist_min[TREND_N];     // TREND_COLUMNS each, hist_max right after; LVGL task only
+    int32_t     *hist_max[TREND_N];
+    int32_t      hist_div[TREND_N];     // 10^fine: history units to chart units
+    lv_timer_t  *timer;
+    uint32_t     shown_version;         // sum of the ring versions on screen
+    int32_t      y_lo, y_hi;
+    uint8_t      window;                // index into s_window_s
+    bool         history;               // the series show hist_min/hist_max
+    uint8_t      hist_ticks;            // refreshes since the last history read
+    volatile bool ready;
+} ui_trend_ctx_t;
+
+static ui_trend_ctx_t s;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ----------------------------------
+// Recording (any task)
+// ----------------------------------
+extern "C" void ui_trend_record(const float *values)
+{
+    if(!s.ready) return;
+
+    int16_t v[TREND_N];
+    for(size_t i = 0; i < TREND_N; i++) {
+        const float q = values[s_src[i].ch] * s.scale[i];
+        v[i] = (q >= 32767.0f) ? 32767 : (q <= -32768.0f) ? -32768 : (int16_t)lroundf(q);
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    for(size_t i = 0; i < TREND_N; i++) trend_ring_push(&s.ring[i], v[i]);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ----------------------------------
+// Chart (LVGL task)
+// ----------------------------------
+static void set_title(void)
+{
+    const uint32_t w = s_window_s[s.window];
+    char b[64];
+
+    if(w < 60) snprintf(b, sizeof(b), "HP TREND  %u s", (unsigned)w);
+    else if(w < 3600) snprintf(b, sizeof(b), "HP TREND  %u min", (unsigned)(w / 60));
+    else snprintf(b, sizeof(b), "HP TREND  %u h", (unsigned)(w / 3600));
+    lv_label_set_text(s.title, b);
+}
+
+// Fit the data with a step of headroom, so a steady signal keeps its axis
+static void fit_y(int32_t lo, int32_t hi, bool force)
+{
+    if(lo > hi) return;
+    const int32_t y_lo = (int32_t)floorf((float)lo / TREND_Y_STEP) * TREND_Y_STEP - TREND_Y_STEP;
+    const int32_t y_hi = (int32_t)ceilf((float)hi / TREND_Y_STEP) * TREND_Y_STEP + TREND_Y_STEP;
+    if(force || lo < s.y_lo || hi > s.y_hi || y_hi - y_lo < (s.y_hi - s.y_lo) / 2) {
+        s.y_lo = y_lo;
+        s.y_hi = y_hi;
+        lv_chart_set_range(s.chart, LV_CHART_AXIS_PRIMARY_Y, y_lo, y_hi);
+    }
+}
+
+// Long windows: one pyramid bucket per column, read whole into the series'
+// arrays. Buckets of 1 s and up change slowly, so once a second is enough.
+static void history_refresh(bool force)
+{
+    if(!force && ++s.hist_ticks < TREND_HISTORY_TICKS) return;
+    s.hist_ticks = 0;
+
+    const uint32_t span_ms = s_window_s[s.window] * 1000u;
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+
+    for(size_t i = 0; i < TREND_N; i++) {
+        int32_t *mn = s.hist_min[i], *mx = s.hist_max[i];
+        chan_logger_history(s_src[i].ch, span_ms, TREND_COLUMNS, LV_CHART_POINT_NONE, mn, mx, nullptr);
+        for(uint32_t c = 0; c < TREND_COLUMNS; c++) {
+            if(mn[c] == LV_CHART_POINT_NONE) continue;
+            mn[c] /= s.hist_div[i];
+            mx[c] /= s.hist_div[i];
+            if(mn[c] < lo) lo = mn[c];
+            if(mx[c] > hi) hi = mx[c];
+        }
+    }
+    fit_y(lo, hi, force);
+    lv_chart_refresh(s.chart);
+}
+
+// The chart reads the column arrays directly (lv_chart_set_ext_y_array), so a
+// refresh is only the start slot and the y range. A column written by another
+// core while it is being drawn is at worst one frame behind.
+static void trend_refresh(bool force)
+{
+    if(s.history) {
+        history_refresh(force);
+        return;
+    }
+
+    uint32_t first[TREND_N];
+    uint32_t version = 0;
+    int32_t lo = INT32_MAX, hi = INT32_MIN;
+
+    portENTER_CRITICAL(&s_lock);
+    for(size_t i = 0; i < TREND_N; i++) {
+        int32_t l, h;
+        version += s.ring[i].version;
+        first[i] = trend_ring_first_slot(&s.ring[i]);
+        if(trend_ring_range(&s.ring[i], &l, &h)) {
+            if(l < lo) lo = l;
+            if(h > hi) hi = h;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if(!force && version == s.shown_version) return;
+    s.shown_version = version;
+
+    for(size_t i = 0; i < TREND_N; i++) {
+        lv_chart_set_x_start_point(s.chart, s.ser_min[i], first[i]);
+        lv_chart_set_x_start_point(s.chart, s.ser_max[i], first[i]);
+    }
+
+    fit_y(lo, hi, force);
+    lv_chart_refresh(s.chart);
+}
+
+static void trend_timer(lv_timer_t *t)
+{
+    (void)t;
+    if(!lv_obj_has_flag(s.panel, LV_OBJ_FLAG_HIDDEN)) trend_refresh(false);
+}
+
+// Point the series at the ring columns or at the history arrays
+static void set_source(bool history)
+{
+    s.history = history;
+    for(size_t i = 0; i < TREND_N; i++) {
+        lv_chart_set_ext_y_array(s.chart, s.ser_max[i], history ? s.hist_max[i] : s.ring[i].col_max);
+        lv_chart_set_ext_y_array(s.chart, s.ser_min[i], history ? s.hist_min[i] : s.ring[i].col_min);
+        if(history) {
+            lv_chart_set_x_start_point(s.chart, s.ser_max[i], 0);
+            lv_chart_set_x_start_point(s.chart, s.ser_min[i], 0);
+        }
+    }
+}
+
+static void set_window(uint8_t idx)
+{
+    const bool history = s_window_s[idx] > UI_TREND_MAX_S;
+
+    if(!history) {
+        // Rebuild the columns from the raw rings, up to TREND_CAP samples each,
+        // outside the lock: only fixing the window and switching to the new
+        // columns hold up ui_trend_record(). The history arrays are free in
+        // this mode and serve as scratch; nothing draws before set_source().
+        const uint32_t samples = s_window_s[idx] * UI_TREND_SAMPLE_HZ;
+        trend_ring_fold_t fold[TREND_N];
+
+        portENTER_CRITICAL(&s_lock);
+        for(size_t i = 0; i < TREND_N; i++) trend_ring_fold_begin(&s.ring[i], samples, s.hist_min[i], &fold[i]);
+        portEXIT_CRITICAL(&s_lock);
+
+        for(size_t i = 0; i < TREND_N; i++) trend_ring_fold(&s.ring[i], &fold[i]);
+
+        portENTER_CRITICAL(&s_lock);
+        for(size_t i = 0; i < TREND_N; i++) trend_ring_fold_end(&s.ring[i], &fold[i]);
+        portEXIT_CRITICAL(&s_lock);
+    }
+    if(history != s.history) set_source(history);
+
+    s.window = idx;
+    set_title();
+    trend_refresh(true);
+}
+
+static void panel_event(lv_event_t *e)
+{
+    const uint32_t code = lv_event_get_code(e);
+
+    if(code == LV_EVENT_CLICKED) {
+        lv_obj_add_flag(s.panel, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_pause(s.timer);
+    } else if(code == UI_EVENT_TOUCH_ZOOM) {
+        // Zoom in shows less time
+        const int zoom = (int)(intptr_t)lv_event_get_param(e);
+        if(zoom > 0 && s.window > 0) set_window(s.window - 1);
+        else if(zoom < 0 && s.window + 1 < (int)TREND_WINDOWS) set_window(s.window + 1);
+    }
+}
+
+static void opener_event(lv_event_t *e)
+{
+    (void)e;
+    if(!s.panel) return;
+    lv_obj_clear_flag(s.panel, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_move_foreground(s.panel);
+    trend_refresh(true);
+    lv_timer_resume(s.timer);
+}
+
+static void legend(lv_obj_t *parent, const trend_source_t *src, int32_t x_ofs)
+{
+    lv_obj_t *lbl = lv_label_create(parent);
+    lv_label_set_text(lbl, src->name);
+    lv_obj_set_style_text_color(lbl, lv_color_hex(src->color), 0);
+    lv_obj_align(lbl, LV_ALIGN_TOP_RIGHT, x_ofs, 0);
+    lv_obj_add_flag(lbl, LV_OBJ_FLAG_EVENT_BUBBLE);
+}
+
+extern "C" bool ui_trend_build(lv_obj_t *parent, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    if(s.panel) return true;
+
+    const size_t bytes = trend_ring_storage_bytes(TREND_CAP, TREND_COLUMNS);
+    for(size_t i = 0; i < TREND_N; i++) {
+        void *mem = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if(!mem) return false;
+        trend_ring_init(&s.ring[i], TREND_CAP, TREND_COLUMNS, LV_CHART_POINT_NONE, mem);
+        s.scale[i] = powf(10.0f, (float)ui_channel_desc(s_src[i].ch)->decimals);
+
+        s.hist_min[i] = (int32_t *)heap_caps_malloc(2 * TREND_COLUMNS * sizeof(int32_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if(!s.hist_min[i]) return false;
+        s.hist_max[i] = s.hist_min[i] + TREND_COLUMNS;
+        s.hist_div[i] = 1;
+        for(uint8_t f = 0; f < ui_channel_desc(s_src[i].ch)->fine; f++) s.hist_div[i] *= 10;
+    }
+
+    // Same look as the cards, opaque since it covers them
+    s.panel = lv_obj_create(parent);
+    lv_obj_set_pos(s.panel, x, y);
+    lv_obj_set_size(s.panel, w, h);
+    lv_obj_clear_flag(s.panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_style_radius(s.panel, 14, 0);
+    lv_obj_set_style_bg_opa(s.panel, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(s.panel, lv_color_hex(0x0B1220), 0);
+    lv_obj_set_style_border_width(s.panel, 2, 0);
+    lv_obj_set_style_border_opa(s.panel, LV_OPA_50, 0);
+    lv_obj_set_style_border_color(s.panel, lv_color_hex(0x6B7A99), 0);
+    lv_obj_set_style_pad_all(s.panel, 12, 0);
+    lv_obj_add_event_cb(s.panel, panel_event, LV_EVENT_CLICKED, nullptr);
+    lv_obj_add_event_cb(s.panel, panel_event, (lv_event_code_t)UI_EVENT_TOUCH_ZOOM, nullptr);
+
+    s.title = lv_label_create(s.panel);
+    lv_obj_set_style_text_opa(s.title, LV_OPA_90, 0);
+    lv_obj_align(s.title, LV_ALIGN_TOP_LEFT, 0, 0);
+    lv_obj_add_flag(s.title, LV_OBJ_FLAG_EVENT_BUBBLE);
+    legend(s.panel, &s_src[0], -90);
+    legend(s.panel, &s_src[1], 0);
+
+    // Below the title line, inside padding and border
+    s.chart = lv_chart_create(s.panel);
+    lv_obj_set_size(s.chart, lv_pct(100), h - 2 * (12 + 2) - 36);
+    lv_obj_align(s.chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_add_flag(s.chart, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_obj_set_style_bg_opa(s.chart, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(s.chart, 0, 0);
+    lv_obj_set_style_pad_all(s.chart, 0, 0);
+    lv_obj_set_style_line_color(s.chart, lv_color_hex(0x24304A), LV_PART_MAIN);
+    lv_obj_set_style_line_width(s.chart, 2, LV_PART_ITEMS);
+    lv_obj_set_style_size(s.chart, 0, 0, LV_PART_INDICATOR);
+    lv_chart_set_type(s.chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_div_line_count(s.chart, 5, 6);
+    lv_chart_set_point_count(s.chart, TREND_COLUMNS);
+
+    // Max then min per channel; both read the ring's column arrays in place
+    for(size_t i = 0; i < TREND_N; i++) {
+        const lv_color_t c = lv_color_hex(s_src[i].color);
+        s.ser_max[i] = lv_chart_add_series(s.chart, c, LV_CHART_AXIS_PRIMARY_Y);
+        s.ser_min[i] = lv_chart_add_series(s.chart, c, LV_CHART_AXIS_PRIMARY_Y);
+        lv_chart_set_ext_y_array(s.chart, s.ser_max[i], s.ring[i].col_max);
+        lv_chart_set_ext_y_array(s.chart, s.ser_min[i], s.ring[i].col_min);
+    }
+
+    s.timer = lv_timer_create(trend_timer, TREND_REFRESH_MS, nullptr);
+    lv_timer_pause(s.timer);
+    lv_obj_add_flag(s.panel, LV_OBJ_FLAG_HIDDEN);
+
+    set_window(TREND_WINDOW_LIVE);
+    s.ready = true;
+    return true;
+}
+
+extern "C" void ui_trend_add_opener(lv_obj_t *obj)
+{
+    if(!obj) return;
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(obj, opener_event, LV_EVENT_CLICKED, nullptr);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "lvgl.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---------- HP pressure trend ----------
+// A chart over the top row with the ISO and RESIN HP pressures of the last
+// UI_TREND_MAX_S seconds, each drawn as its min and max per column so sag and
+// pulsation both show. Samples are kept at acquisition rate in
+// trend/trend_ring.h and decimated as they arrive; the chart always draws a
+// fixed number of columns. Zooming out past UI_TREND_MAX_S switches to the
+// channel logger's history (log/chan_logger.h), 10 min to 12 h at one
+// aggregate bucket per column. Tap an opener to show it, tap it to hide,
+// pinch to change the window.
+
+#define UI_TREND_SAMPLE_HZ  100     // rate the producer posts channels at
+#define UI_TREND_MAX_S      60      // longest window, sizes the sample ring
+
+// LVGL task. x/y/w/h place the overlay in parent; false if out of memory
+bool ui_trend_build(lv_obj_t *parent, int32_t x, int32_t y, int32_t w, int32_t h);
+// Clicking obj opens the trend
+void ui_trend_add_opener(lv_obj_t *obj);
+
+// Any task: record one acquisition of values[UI_CH_COUNT]. ui_post_channels()
+// and ui_update_live_values() call it.
+void ui_trend_record(const float *values);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
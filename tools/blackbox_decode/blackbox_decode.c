@@ -0,0 +1,507 @@
+/*
+ * blackbox_decode - decode the black box (src/log/blackbox.c) from an image
+ * of its flash partition, and check and benchmark the recorder.
+ *
+ *   cc -O2 -o blackbox_decode tools/blackbox_decode/blackbox_decode.c
+ *   ./blackbox_decode [-b] [-e] [partition.bin]
+ *
+ * A partition image is printed as CSV, one line per sample: trip, time in ms
+ * on the recorder's clock, then every channel. -e prints the events of each
+ * trip instead: trip, time, event, zone, value, text. Blocks are put back in
+ * order by their sequence number; damaged blocks are reported and skipped.
+ *
+ * Without a file it only runs the check: twelve minutes of jittered 100 Hz
+ * channels with a stall, and UI events, are recorded into a five-minute box
+ * that is triggered, frozen and exported into a partition image that wraps.
+ * Decoding the image must give back exactly the samples (with their times)
+ * and events the box held, also when the oldest samples are skipped to fit,
+ * and nothing recorded after the freeze. -b times recording a sample, which
+ * is all the recorder costs until a trip, and the export.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/log/chan_log.c"
+#include "../../src/log/blackbox.c"
+
+/* ui_channel_t order (src/ui_main.h) */
+#define CHANNELS 13
+
+static const char *const s_names[CHANNELS] = {
+    "iso_hp_psi", "resin_hp_psi", "iso_low_psi", "resin_low_psi", "primary_air_psi", "gun_air_psi",
+    "iso_hp_temp_f", "resin_hp_temp_f", "iso_low_temp_f", "resin_low_temp_f", "hose1_temp_f", "hose2_temp_f",
+    "ratio",
+};
+
+/* decimals + fine of each channel in the table in src/ui_main.cpp */
+static const uint8_t s_exp[CHANNELS] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 3 };
+
+static const char *const s_ev_names[] = { "?", "trigger", "estop", "hose", "setpoint", "banner" };
+
+static uint32_t s_rng = 1312;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Triangle wave of the given period and peak-to-peak amplitude */
+static int32_t tri(uint32_t n, uint32_t period, int32_t amp)
+{
+    const uint32_t p = n % period, half = period / 2;
+    return (int32_t)((p < half ? p : period - p) * (uint32_t)amp / half);
+}
+
+/* Sample n at 100 Hz, in channel units times 10^exp, like the demo producer */
+static void synth(uint32_t n, int32_t *q)
+{
+    static const int32_t base[CHANNELS] = { 1100, 1080, 120, 115, 95, 85, 748, 718, 724, 725, 705, 701, 1000 };
+
+    for (int i = 0; i < CHANNELS; i++) {
+        q[i] = base[i];
+    }
+    q[0] += tri(n, 209, 240) - 120;
+    q[1] += tri(n + 23, 209, 240) - 120;
+    q[10] += (int32_t)(n / 3000 % 5);
+    q[12] = q[0] * 1000 / q[1];
+}
+
+/* ---- partition image ---- */
+typedef struct {
+    uint32_t seq;
+    size_t off;
+} block_ref_t;
+
+static int by_seq(const void *a, const void *b)
+{
+    const uint32_t x = ((const block_ref_t *)a)->seq, y = ((const block_ref_t *)b)->seq;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    void (*sample)(void *ctx, uint32_t trip, uint32_t t_ms, const int32_t *v, const uint8_t *exp, int channels);
+    void (*event)(void *ctx, uint32_t trip, const blackbox_event_t *ev);
+    void *ctx;
+} sink_t;
+
+/* Every intact block in seq order; returns the number of damaged ones */
+static size_t decode_image(const uint8_t *img, size_t len, const sink_t *sink)
+{
+    const size_t n = len / CHAN_LOG_BLOCK;
+    block_ref_t *refs = malloc(sizeof(block_ref_t) * (n ? n : 1));
+    int32_t *vals = malloc(sizeof(int32_t) * CHAN_LOG_MAX_CHANNELS * CHAN_LOG_BLOCK);
+    size_t used = 0, damaged = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        chan_log_info_t info;
+        blackbox_event_info_t ev;
+        const uint8_t *blk = img + i * CHAN_LOG_BLOCK;
+        if (chan_log_peek(blk, CHAN_LOG_BLOCK, &info)) {
+            refs[used].seq = info.seq;
+        } else if (blackbox_event_peek(blk, CHAN_LOG_BLOCK, &ev)) {
+            refs[used].seq = ev.seq;
+        } else {
+            continue;
+        }
+        refs[used++].off = i * CHAN_LOG_BLOCK;
+    }
+    qsort(refs, used, sizeof(block_ref_t), by_seq);
+
+    for (size_t b = 0; b < used; b++) {
+        const uint8_t *blk = img + refs[b].off;
+        chan_log_info_t info;
+        blackbox_event_info_t ev;
+
+        if (blackbox_event_peek(blk, CHAN_LOG_BLOCK, &ev)) {
+            if (!blackbox_event_block(blk, CHAN_LOG_BLOCK, &ev)) {
+                fprintf(stderr, "block at 0x%zx (seq %u): damaged, skipped\n", refs[b].off, refs[b].seq);
+                damaged++;
+                continue;
+            }
+            for (uint32_t i = 0; i < ev.count; i++) {
+                blackbox_event_t e;
+                blackbox_event_at(blk, i, &e);
+                sink->event(sink->ctx, ev.trip, &e);
+            }
+            continue;
+        }
+
+        const int r = chan_log_decode(blk, CHAN_LOG_BLOCK, &info, vals, (size_t)CHAN_LOG_MAX_CHANNELS * CHAN_LOG_BLOCK);
+        if (r < 0 || info.channels < 2) {
+            fprintf(stderr, "block at 0x%zx (seq %u): damaged, skipped\n", refs[b].off, refs[b].seq);
+            damaged++;
+            continue;
+        }
+        /* The last channel is the ms since the sample before */
+        uint32_t t = info.t0_ms;
+        for (int k = 0; k < r; k++) {
+            const int32_t *v = vals + (size_t)k * info.channels;
+            if (k > 0) t += (uint32_t)v[info.channels - 1];
+            sink->sample(sink->ctx, info.session, t, v, info.exp, info.channels - 1);
+        }
+    }
+    free(refs);
+    free(vals);
+    return damaged;
+}
+
+/* ---- check ---- */
+#define CAP_S       300
+#define RATE_HZ     100
+#define SAMPLE_CAP  (CAP_S * RATE_HZ)
+#define EVENT_CAP   64
+#define RUN_S       720
+#define MAX_SAMPLES (RUN_S * RATE_HZ + 1000)
+#define MAX_EVENTS  4096
+#define SECTORS     400
+
+static uint32_t s_t[MAX_SAMPLES];
+static int32_t s_v[MAX_SAMPLES][CHANNELS];
+static blackbox_event_t s_ev[MAX_EVENTS];
+
+typedef struct {
+    uint64_t sample, event;     /* next expected */
+    uint64_t sample_end, event_end;
+    uint32_t trip;
+    int bad;
+} expect_t;
+
+static void expect_sample(void *ctx, uint32_t trip, uint32_t t_ms, const int32_t *v, const uint8_t *exp, int channels)
+{
+    expect_t *x = ctx;
+    const uint64_t i = x->sample++;
+
+    (void)exp;
+    if (x->bad) return;
+    if (trip != x->trip || channels != CHANNELS || i >= x->sample_end || t_ms != s_t[i] ||
+        memcmp(v, s_v[i], sizeof(s_v[i])) != 0) {
+        fprintf(stderr, "sample %llu: trip %u t %u differs (expected t %u)\n", (unsigned long long)i, trip, t_ms,
+                i < MAX_SAMPLES ? s_t[i] : 0);
+        x->bad = 1;
+    }
+}
+
+static void expect_event(void *ctx, uint32_t trip, const blackbox_event_t *ev)
+{
+    expect_t *x = ctx;
+    const uint64_t i = x->event++;
+
+    if (x->bad) return;
+    const blackbox_event_t *e = &s_ev[i];
+    if (trip != x->trip || i >= x->event_end || ev->t_ms != e->t_ms || ev->type != e->type || ev->zone != e->zone ||
+        ev->value != e->value || strncmp(ev->text, e->text, BLACKBOX_TEXT - 1) != 0) {
+        fprintf(stderr, "event %llu differs: %u %s \"%s\"\n", (unsigned long long)i, ev->t_ms,
+                s_ev_names[ev->type < 6 ? ev->type : 0], ev->text);
+        x->bad = 1;
+    }
+}
+
+/* Export into img starting at sector `at`, wrapping; returns blocks written */
+static uint32_t export_box(const blackbox_t *bb, uint8_t *img, uint32_t at, uint32_t skip, uint32_t seq, uint32_t trip)
+{
+    blackbox_cursor_t cur;
+    uint32_t n = 0;
+
+    blackbox_export_begin(bb, &cur, skip, seq, trip);
+    while (blackbox_export_next(bb, &cur, img + (size_t)((at + n) % SECTORS) * CHAN_LOG_BLOCK)) {
+        n++;
+    }
+    return n;
+}
+
+static int verify(const blackbox_t *bb, const uint8_t *img, uint64_t first_sample, uint64_t samples, uint64_t events,
+                  uint32_t trip)
+{
+    expect_t x = { first_sample, events > EVENT_CAP ? events - EVENT_CAP : 0, samples, events, trip, 0 };
+    const sink_t sink = { expect_sample, expect_event, &x };
+
+    (void)bb;
+    if (decode_image(img, (size_t)SECTORS * CHAN_LOG_BLOCK, &sink) || x.bad) return 1;
+    if (x.sample != samples || x.event != events) {
+        fprintf(stderr, "decoded up to sample %llu and event %llu, expected %llu and %llu\n",
+                (unsigned long long)x.sample, (unsigned long long)x.event, (unsigned long long)samples,
+                (unsigned long long)events);
+        return 1;
+    }
+    return 0;
+}
+
+static void add_event(blackbox_t *bb, uint32_t *ne, uint32_t t, blackbox_ev_t type, uint8_t zone, int16_t value,
+                      const char *text)
+{
+    blackbox_event(bb, t, type, zone, value, text);
+    blackbox_event_t *e = &s_ev[(*ne)++];
+    memset(e, 0, sizeof(*e));
+    e->t_ms = t;
+    e->type = (uint8_t)type;
+    e->zone = zone;
+    e->value = value;
+    if (text) strncpy(e->text, text, BLACKBOX_TEXT - 1);
+}
+
+static int check(void)
+{
+    static const char *const banners[] = {
+        "OK", "Hose 1 heater fault - check the breaker and the RTD wiring at the manifold", "Low ISO level",
+    };
+    const size_t bytes = blackbox_storage_bytes(CHANNELS, SAMPLE_CAP, EVENT_CAP);
+    void *mem = malloc(bytes);
+    uint8_t *img = malloc((size_t)SECTORS * CHAN_LOG_BLOCK);
+    blackbox_t bb;
+    uint32_t ns = 0, ne = 0, t = 5000;
+    int bad = 0;
+
+    memset(img, 0xFF, (size_t)SECTORS * CHAN_LOG_BLOCK);
+    blackbox_init(&bb, CHANNELS, s_exp, 1000 / RATE_HZ, SAMPLE_CAP, EVENT_CAP, mem);
+
+    /* Jittered 100 Hz with a 1.5 s stall, events now and then, a trip near the end */
+    const uint32_t trip_at = RUN_S * RATE_HZ - 2 * RATE_HZ;
+    uint32_t frozen_at = 0;
+    for (uint32_t n = 0; n < RUN_S * RATE_HZ; n++) {
+        int32_t q[CHANNELS];
+        synth(n, q);
+        if (n % 10007 == 0) q[3] = 40000;                   /* clamped to int16 */
+        blackbox_sample(&bb, t, q);
+        if (!frozen_at) {
+            s_t[ns] = t;
+            for (int i = 0; i < CHANNELS; i++) {
+                s_v[ns][i] = q[i] > INT16_MAX ? INT16_MAX : q[i];
+            }
+            ns++;
+        }
+
+        if (rnd() % 500 == 0 && ne < MAX_EVENTS - 8 && !frozen_at) {
+            switch (rnd() % 3) {
+            case 0: add_event(&bb, &ne, t, BLACKBOX_EV_HOSE, 1 + rnd() % 2, rnd() & 1, NULL); break;
+            case 1: add_event(&bb, &ne, t, BLACKBOX_EV_SETPOINT, 1 + rnd() % 2, 100 + rnd() % 60, NULL); break;
+            default: add_event(&bb, &ne, t, BLACKBOX_EV_BANNER, 0, 1, banners[rnd() % 3]); break;
+            }
+        }
+        if (n == trip_at) {
+            add_event(&bb, &ne, t, BLACKBOX_EV_ESTOP, 0, 1, NULL);
+            /* The trigger records its own event */
+            blackbox_trigger(&bb, t, "E-STOP");
+            memset(&s_ev[ne], 0, sizeof(s_ev[ne]));
+            s_ev[ne].t_ms = t;
+            s_ev[ne].type = BLACKBOX_EV_TRIGGER;
+            strcpy(s_ev[ne].text, "E-STOP");
+            ne++;
+            if (blackbox_trigger(&bb, t, "again")) {
+                fprintf(stderr, "second trigger accepted\n");
+                bad = 1;
+            }
+        }
+        if (n == trip_at + RATE_HZ) {
+            blackbox_freeze(&bb);
+            frozen_at = n;
+        }
+        if (frozen_at && n == frozen_at + 5) {
+            blackbox_event(&bb, t, BLACKBOX_EV_BANNER, 0, 1, "after the freeze");
+        }
+        t += (n == 3000) ? 1500 : 8 + rnd() % 5;
+    }
+
+    const uint64_t first = ns > SAMPLE_CAP ? ns - SAMPLE_CAP : 0;
+    if (!bad) {
+        const uint32_t nb = export_box(&bb, img, SECTORS - 37, 0, 1000, 7);
+        bad = verify(&bb, img, first, ns, ne, 7);
+        if (!bad) {
+            fprintf(stderr, "check:      %u of %u samples and %u of %u events back exactly from %u blocks (%.2f B/sample)\n",
+                    (unsigned)(ns - first), ns, ne < EVENT_CAP ? ne : EVENT_CAP, ne, nb,
+                    (double)nb * CHAN_LOG_BLOCK / (double)(ns - first));
+        }
+    }
+
+    /* Skipping the oldest samples leaves the newest ones intact */
+    if (!bad) {
+        memset(img, 0xFF, (size_t)SECTORS * CHAN_LOG_BLOCK);
+        export_box(&bb, img, 11, SAMPLE_CAP / 3, 5000, 8);
+        bad = verify(&bb, img, first + SAMPLE_CAP / 3, ns, ne, 8);
+    }
+
+    /* Any flipped bit in an event block must be caught */
+    for (int k = 0; k < 200 && !bad; k++) {
+        uint8_t *blk = NULL;
+        blackbox_event_info_t info;
+        for (uint32_t i = 0; i < SECTORS && !blk; i++) {
+            if (blackbox_event_block(img + (size_t)i * CHAN_LOG_BLOCK, CHAN_LOG_BLOCK, &info)) {
+                blk = img + (size_t)i * CHAN_LOG_BLOCK;
+            }
+        }
+        if (!blk) {
+            fprintf(stderr, "no event block\n");
+            bad = 1;
+            break;
+        }
+        const size_t at = rnd() % (BLACKBOX_EVENT_HEADER + (size_t)info.count * BLACKBOX_EVENT_BYTES);
+        const uint8_t bit = (uint8_t)(1u << (rnd() % 8));
+        blk[at] ^= bit;
+        blackbox_event_info_t again;
+        if (blackbox_event_block(blk, CHAN_LOG_BLOCK, &again)) {
+            fprintf(stderr, "damaged event block at byte %zu accepted\n", at);
+            bad = 1;
+        }
+        blk[at] ^= bit;
+    }
+
+    free(mem);
+    free(img);
+    if (!bad) {
+        fprintf(stderr, "check:      skip, second trigger, freeze and damaged event blocks ok\n");
+    }
+    return bad;
+}
+
+static void bench(void)
+{
+    const size_t bytes = blackbox_storage_bytes(CHANNELS, SAMPLE_CAP, EVENT_CAP);
+    void *mem = malloc(bytes);
+    uint8_t *img = malloc((size_t)SECTORS * CHAN_LOG_BLOCK);
+    blackbox_t bb;
+    const uint32_t n = 5000000;
+    int32_t q[CHANNELS];
+
+    blackbox_init(&bb, CHANNELS, s_exp, 1000 / RATE_HZ, SAMPLE_CAP, EVENT_CAP, mem);
+    synth(0, q);
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        q[0] = 1000 + (int32_t)(i % 200);
+        blackbox_sample(&bb, i * 10, q);
+    }
+    const uint64_t t_sample = now_ns() - t0;
+
+    /* Realistic content for the export */
+    for (uint32_t i = 0; i < SAMPLE_CAP; i++) {
+        synth(i, q);
+        blackbox_sample(&bb, 10 * i + (rnd() % 3), q);
+    }
+    blackbox_freeze(&bb);
+    t0 = now_ns();
+    const uint32_t nb = export_box(&bb, img, 0, 0, 0, 1);
+    const uint64_t t_export = now_ns() - t0;
+
+    printf("ring:       %zu KB for %d s of %d channels at %d Hz and %d events\n", bytes / 1024, CAP_S, CHANNELS,
+           RATE_HZ, EVENT_CAP);
+    printf("sample:     %.1f ns (the steady-state cost, before the lock and quantizing)\n", (double)t_sample / n);
+    printf("export:     %.1f ms for %u blocks, %u KB of flash (%.2f B/sample)\n", (double)t_export / 1e6, nb,
+           nb * CHAN_LOG_BLOCK / 1024, (double)nb * CHAN_LOG_BLOCK / SAMPLE_CAP);
+    free(mem);
+    free(img);
+}
+
+/* ---- CSV ---- */
+static void print_value(int32_t v, uint8_t exp)
+{
+    if (exp == 0) {
+        printf(",%ld", (long)v);
+        return;
+    }
+    int32_t div = 1;
+    for (uint8_t i = 0; i < exp; i++) {
+        div *= 10;
+    }
+    const int64_t a = v < 0 ? -(int64_t)v : v;
+    printf(",%s%lld.%0*lld", v < 0 ? "-" : "", (long long)(a / div), (int)exp, (long long)(a % div));
+}
+
+static void print_sample(void *ctx, uint32_t trip, uint32_t t_ms, const int32_t *v, const uint8_t *exp, int channels)
+{
+    (void)ctx;
+    printf("%u,%u", trip, t_ms);
+    for (int i = 0; i < channels; i++) {
+        print_value(v[i], exp[i]);
+    }
+    printf("\n");
+}
+
+static void print_event(void *ctx, uint32_t trip, const blackbox_event_t *ev)
+{
+    (void)ctx;
+    printf("%u,%u,%s,%u,%d,\"%s\"\n", trip, ev->t_ms, s_ev_names[ev->type < 6 ? ev->type : 0], ev->zone,
+           ev->value, ev->text);
+}
+
+static void skip_sample(void *ctx, uint32_t trip, uint32_t t_ms, const int32_t *v, const uint8_t *exp, int channels)
+{
+    (void)ctx, (void)trip, (void)t_ms, (void)v, (void)exp, (void)channels;
+}
+
+static void skip_event(void *ctx, uint32_t trip, const blackbox_event_t *ev)
+{
+    (void)ctx, (void)trip, (void)ev;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int do_bench = 0, events = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-b")) {
+            do_bench = 1;
+        } else if (!strcmp(argv[i], "-e")) {
+            events = 1;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-b] [-e] [partition.bin]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (check()) {
+        return 1;
+    }
+    if (do_bench) {
+        bench();
+    }
+    if (!path) {
+        return 0;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    size_t cap = 1 << 20, len = 0, n;
+    uint8_t *buf = malloc(cap);
+    while (buf && (n = fread(buf + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            buf = realloc(buf, cap);
+        }
+    }
+    fclose(f);
+    if (!buf) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    if (events) {
+        printf("trip,t_ms,event,zone,value,text\n");
+    } else {
+        printf("trip,t_ms");
+        for (int i = 0; i < CHANNELS; i++) {
+            printf(",%s", s_names[i]);
+        }
+        printf("\n");
+    }
+    const sink_t sink = { events ? skip_sample : print_sample, events ? print_event : skip_event, NULL };
+    const size_t damaged = decode_image(buf, len, &sink);
+    fprintf(stderr, "%zu damaged blocks\n", damaged);
+    free(buf);
+    return 0;
+}
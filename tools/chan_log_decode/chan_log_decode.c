@@ -0,0 +1,378 @@
+/*
+ * chan_log_decode - decode the channel log (src/log/chan_log.c) from an
+ * image of its flash partition, and check and benchmark the block codec.
+ *
+ *   cc -O2 -o chan_log_decode tools/chan_log_decode/chan_log_decode.c
+ *   ./chan_log_decode [-b] [partition.bin]
+ *
+ * A partition image is printed as CSV, one line per record: session, time
+ * in ms since the session started, then every channel. Blocks are put back
+ * in order by their sequence number, so a log that wrapped around reads
+ * oldest first; damaged blocks are reported and skipped.
+ *
+ * Without a file it only runs the round-trip check: synthetic channels are
+ * encoded into blocks and decoded, extreme values and jumps must survive,
+ * and damaged blocks must be rejected. -b also times encoding and decoding
+ * on a few signal shapes and prints bytes per record against raw floats.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/log/chan_log.c"
+
+/* ui_channel_t order (src/ui_main.h) */
+#define CHANNELS 13
+
+static const char *const s_names[CHANNELS] = {
+    "iso_hp_psi", "resin_hp_psi", "iso_low_psi", "resin_low_psi", "primary_air_psi", "gun_air_psi",
+    "iso_hp_temp_f", "resin_hp_temp_f", "iso_low_temp_f", "resin_low_temp_f", "hose1_temp_f", "hose2_temp_f",
+    "ratio",
+};
+
+/* decimals + fine of each channel in the table in src/ui_main.cpp */
+static const uint8_t s_exp[CHANNELS] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 3 };
+
+static uint32_t s_rng = 48;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- synthetic channels ---- */
+typedef enum { SIG_DEMO, SIG_NOISY, SIG_STEPS, SIG_RANDOM, SIG_SHAPES } sig_t;
+
+static const char *const s_sig_names[SIG_SHAPES] = {
+    "demo (2 s sine on HP, rest steady)",
+    "noisy (every channel +/-2 counts)",
+    "steps (setpoint changes)",
+    "random (incompressible)",
+};
+
+/* Triangle wave of the given period and peak-to-peak amplitude */
+static int32_t tri(uint32_t n, uint32_t period, int32_t amp)
+{
+    const uint32_t p = n % period, half = period / 2;
+    return (int32_t)((p < half ? p : period - p) * (uint32_t)amp / half);
+}
+
+/* Record n at 10 Hz, in channel units times 10^exp */
+static void synth(sig_t sig, uint32_t n, int32_t *q)
+{
+    static const int32_t base[CHANNELS] = { 1100, 1080, 120, 115, 95, 85, 748, 718, 724, 725, 705, 701, 1000 };
+
+    for (int i = 0; i < CHANNELS; i++) {
+        q[i] = base[i];
+    }
+    switch (sig) {
+    case SIG_DEMO:
+        q[0] += tri(n, 20, 240) - 120;
+        q[1] += tri(n + 3, 20, 240) - 120;
+        q[12] = q[0] * 1000 / q[1];
+        break;
+    case SIG_NOISY:
+        for (int i = 0; i < CHANNELS; i++) {
+            q[i] += (int32_t)(rnd() % 5) - 2;
+        }
+        break;
+    case SIG_STEPS:
+        for (int i = 0; i < CHANNELS; i++) {
+            q[i] += (int32_t)((n / 600 + i) % 4) * 50;
+        }
+        break;
+    case SIG_RANDOM:
+    default:
+        for (int i = 0; i < CHANNELS; i++) {
+            q[i] = (int32_t)(rnd() ^ (rnd() << 16));
+        }
+        break;
+    }
+}
+
+/* Encode records into consecutive blocks; returns the number of blocks */
+static uint32_t encode(sig_t sig, uint32_t records, uint8_t *blocks, uint32_t max_blocks, int32_t *values)
+{
+    chan_log_enc_t enc;
+    uint32_t nb = 0;
+
+    chan_log_enc_init(&enc, CHANNELS, s_exp, 100, 7);
+    chan_log_enc_begin(&enc, blocks, 0, 0);
+    for (uint32_t n = 0; n < records; n++) {
+        int32_t *q = values + (size_t)n * CHANNELS;
+        synth(sig, n, q);
+        if (!chan_log_enc_append(&enc, q)) {
+            chan_log_enc_finish(&enc);
+            if (++nb == max_blocks) {
+                return 0;
+            }
+            chan_log_enc_begin(&enc, blocks + (size_t)nb * CHAN_LOG_BLOCK, nb, n * 100);
+            chan_log_enc_append(&enc, q);
+        }
+    }
+    chan_log_enc_finish(&enc);
+    return nb + 1;
+}
+
+/* Decode consecutive blocks into values; returns records or -1 */
+static int64_t decode_all(const uint8_t *blocks, uint32_t nb, int32_t *values, size_t max_values)
+{
+    int64_t total = 0;
+
+    for (uint32_t b = 0; b < nb; b++) {
+        chan_log_info_t info;
+        const int r = chan_log_decode(blocks + (size_t)b * CHAN_LOG_BLOCK, CHAN_LOG_BLOCK, &info,
+                                      values + total * CHANNELS, max_values - (size_t)total * CHANNELS);
+        if (r < 0 || info.seq != b) {
+            return -1;
+        }
+        total += r;
+    }
+    return total;
+}
+
+#define CHECK_RECORDS 20000
+#define MAX_BLOCKS    1024
+
+static int check(void)
+{
+    uint8_t *blocks = malloc((size_t)MAX_BLOCKS * CHAN_LOG_BLOCK);
+    int32_t *in = malloc(sizeof(int32_t) * CHANNELS * CHECK_RECORDS);
+    int32_t *out = malloc(sizeof(int32_t) * CHANNELS * CHECK_RECORDS);
+    int bad = 0;
+
+    for (int sig = 0; sig < SIG_SHAPES && !bad; sig++) {
+        const uint32_t nb = encode((sig_t)sig, CHECK_RECORDS, blocks, MAX_BLOCKS, in);
+        if (!nb || decode_all(blocks, nb, out, (size_t)CHANNELS * CHECK_RECORDS) != CHECK_RECORDS ||
+            memcmp(in, out, sizeof(int32_t) * CHANNELS * CHECK_RECORDS) != 0) {
+            fprintf(stderr, "round trip failed: %s\n", s_sig_names[sig]);
+            bad = 1;
+        }
+    }
+
+    /* Extremes: deltas that wrap, channels flipping between INT32_MIN and MAX */
+    chan_log_enc_t enc;
+    chan_log_info_t info;
+    int32_t ext[4][CHANNELS];
+    for (int r = 0; r < 4; r++) {
+        for (int i = 0; i < CHANNELS; i++) {
+            ext[r][i] = ((r + i) & 1) ? INT32_MAX : INT32_MIN;
+            if (i == 0) ext[r][i] = r == 2 ? 0 : -1;
+        }
+    }
+    chan_log_enc_init(&enc, CHANNELS, s_exp, 100, 1);
+    chan_log_enc_begin(&enc, blocks, 42, 0);
+    for (int r = 0; r < 4; r++) {
+        chan_log_enc_append(&enc, ext[r]);
+    }
+    chan_log_enc_finish(&enc);
+    if (chan_log_decode(blocks, CHAN_LOG_BLOCK, &info, out, (size_t)CHANNELS * CHECK_RECORDS) != 4 ||
+        memcmp(ext, out, sizeof(ext)) != 0 || info.seq != 42 || info.session != 1) {
+        fprintf(stderr, "extreme values did not round-trip\n");
+        bad = 1;
+    }
+
+    /* Any flipped bit in header or payload must be caught */
+    const size_t used = CHAN_LOG_HEADER + CHANNELS + info.bytes;
+    for (int k = 0; k < 200 && !bad; k++) {
+        const size_t at = rnd() % used;
+        const uint8_t bit = (uint8_t)(1u << (rnd() % 8));
+        blocks[at] ^= bit;
+        if (chan_log_decode(blocks, CHAN_LOG_BLOCK, &info, out, (size_t)CHANNELS * CHECK_RECORDS) >= 0) {
+            fprintf(stderr, "damaged block at byte %zu accepted\n", at);
+            bad = 1;
+        }
+        blocks[at] ^= bit;
+    }
+
+    free(blocks);
+    free(in);
+    free(out);
+    if (!bad) {
+        fprintf(stderr, "check:      round trips, extremes and damaged blocks ok\n");
+    }
+    return bad;
+}
+
+static void bench(void)
+{
+    const uint32_t records = 200000;
+    uint8_t *blocks = malloc((size_t)8192 * CHAN_LOG_BLOCK);
+    int32_t *in = malloc(sizeof(int32_t) * CHANNELS * records);
+    int32_t *out = malloc(sizeof(int32_t) * CHANNELS * records);
+
+    double demo_per_rec = 0;
+
+    printf("%-36s %9s %9s %10s %10s\n", "signal", "B/record", "vs float", "enc ns/rec", "dec ns/rec");
+    for (int sig = 0; sig < SIG_SHAPES; sig++) {
+        /* Fill the values once so only the codec is timed */
+        uint32_t nb = encode((sig_t)sig, records, blocks, 8192, in);
+
+        chan_log_enc_t enc;
+        uint64_t t0 = now_ns();
+        chan_log_enc_init(&enc, CHANNELS, s_exp, 100, 7);
+        chan_log_enc_begin(&enc, blocks, 0, 0);
+        nb = 0;
+        for (uint32_t n = 0; n < records; n++) {
+            const int32_t *q = in + (size_t)n * CHANNELS;
+            if (!chan_log_enc_append(&enc, q)) {
+                chan_log_enc_finish(&enc);
+                nb++;
+                chan_log_enc_begin(&enc, blocks + (size_t)nb * CHAN_LOG_BLOCK, nb, n * 100);
+                chan_log_enc_append(&enc, q);
+            }
+        }
+        chan_log_enc_finish(&enc);
+        nb++;
+        const uint64_t t_enc = now_ns() - t0;
+
+        t0 = now_ns();
+        const int64_t got = decode_all(blocks, nb, out, (size_t)CHANNELS * records);
+        const uint64_t t_dec = now_ns() - t0;
+
+        const double per_rec = (double)nb * CHAN_LOG_BLOCK / records;
+        if (sig == SIG_DEMO) demo_per_rec = per_rec;
+        printf("%-36s %9.2f %8.1fx %10.1f %10.1f%s\n", s_sig_names[sig], per_rec,
+               CHANNELS * sizeof(float) / per_rec, (double)t_enc / records, (double)t_dec / records,
+               got == (int64_t)records ? "" : "  DECODE FAILED");
+    }
+    printf("(flash bytes per record, counting whole 4 KB blocks; the demo at 10 Hz fills one every %.0f s)\n",
+           CHAN_LOG_BLOCK / (demo_per_rec * 10));
+    free(blocks);
+    free(in);
+    free(out);
+}
+
+/* ---- partition image ---- */
+typedef struct {
+    uint32_t seq;
+    size_t off;
+} block_ref_t;
+
+static int by_seq(const void *a, const void *b)
+{
+    const uint32_t x = ((const block_ref_t *)a)->seq, y = ((const block_ref_t *)b)->seq;
+    return (x > y) - (x < y);
+}
+
+static void print_value(int32_t v, uint8_t exp)
+{
+    if (exp == 0) {
+        printf(",%ld", (long)v);
+        return;
+    }
+    int32_t div = 1;
+    for (uint8_t i = 0; i < exp; i++) {
+        div *= 10;
+    }
+    const int64_t a = v < 0 ? -(int64_t)v : v;
+    printf(",%s%lld.%0*lld", v < 0 ? "-" : "", (long long)(a / div), (int)exp, (long long)(a % div));
+}
+
+static int decode_image(const uint8_t *img, size_t len)
+{
+    const size_t n = len / CHAN_LOG_BLOCK;
+    block_ref_t *refs = malloc(sizeof(block_ref_t) * (n ? n : 1));
+    int32_t *vals = malloc(sizeof(int32_t) * CHAN_LOG_MAX_CHANNELS * CHAN_LOG_BLOCK);
+    size_t used = 0, damaged = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        chan_log_info_t info;
+        if (chan_log_peek(img + i * CHAN_LOG_BLOCK, CHAN_LOG_BLOCK, &info)) {
+            refs[used].seq = info.seq;
+            refs[used].off = i * CHAN_LOG_BLOCK;
+            used++;
+        }
+    }
+    qsort(refs, used, sizeof(block_ref_t), by_seq);
+
+    printf("session,t_ms");
+    for (int i = 0; i < CHANNELS; i++) {
+        printf(",%s", s_names[i]);
+    }
+    printf("\n");
+
+    uint64_t records = 0;
+    for (size_t b = 0; b < used; b++) {
+        chan_log_info_t info;
+        const int r = chan_log_decode(img + refs[b].off, CHAN_LOG_BLOCK, &info, vals,
+                                      (size_t)CHAN_LOG_MAX_CHANNELS * CHAN_LOG_BLOCK);
+        if (r < 0) {
+            fprintf(stderr, "block at 0x%zx (seq %u): damaged, skipped\n", refs[b].off, refs[b].seq);
+            damaged++;
+            continue;
+        }
+        for (int k = 0; k < r; k++) {
+            printf("%u,%llu", info.session, (unsigned long long)info.t0_ms + (unsigned long long)k * info.period_ms);
+            for (int i = 0; i < info.channels; i++) {
+                print_value(vals[k * info.channels + i], info.exp[i]);
+            }
+            printf("\n");
+        }
+        records += (uint64_t)r;
+    }
+    fprintf(stderr, "%zu blocks, %zu damaged, %llu records\n", used, damaged, (unsigned long long)records);
+    free(refs);
+    free(vals);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int do_bench = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-b")) {
+            do_bench = 1;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-b] [partition.bin]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (check()) {
+        return 1;
+    }
+    if (do_bench) {
+        bench();
+    }
+    if (!path) {
+        return 0;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    size_t cap = 1 << 20, len = 0, n;
+    uint8_t *buf = malloc(cap);
+    while (buf && (n = fread(buf + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            buf = realloc(buf, cap);
+        }
+    }
+    fclose(f);
+    if (!buf) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    const int rc = decode_image(buf, len);
+    free(buf);
+    return rc;
+}
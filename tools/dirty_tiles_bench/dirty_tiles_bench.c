@@ -0,0 +1,296 @@
+/*
+ * dirty_tiles_bench - check and time the dirty-tile flush stage
+ * (src/lcd/dirty_tiles.c) on a Linux host.
+ *
+ *   cc -O2 -o dirty_tiles_bench tools/dirty_tiles_bench/dirty_tiles_bench.c
+ *   ./dirty_tiles_bench [-r frames] [-w width] [-h height]
+ *
+ * A dashboard-like frame (flat cards, text-like value labels) is redrawn
+ * under a few scenarios: one value changing, every value changing, and a
+ * full screen change. As LVGL does, each redrawn card is invalidated (the
+ * whole screen for a screen change); after each frame only the spans the
+ * stage reports are copied into a "panel" buffer, which must then equal the
+ * frame exactly. Random rectangles, areas hanging off the frame and odd frame
+ * sizes are checked the same way. Per scenario it prints the time of marking,
+ * taking and the span copies against one whole-frame copy, and the net time
+ * saved per frame. The copies here are memcpy; on the panel they are PPA
+ * blits, which `F` times there.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/lcd/dirty_tiles.c"
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t s_rng = 4242;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+/* ---- synthetic frames ---- */
+#define LABELS 13   /* readouts on the live view */
+
+typedef struct {
+    uint32_t x, y, w, h;
+} rect_t;
+
+static void fill(uint16_t *f, uint32_t stride, rect_t r, uint16_t c)
+{
+    for (uint32_t y = r.y; y < r.y + r.h; y++)
+        for (uint32_t x = r.x; x < r.x + r.w; x++)
+            f[y * stride + x] = c;
+}
+
+/* "Text": a pattern that depends on the value, with anti-aliased-like noise */
+static void label(uint16_t *f, uint32_t stride, rect_t r, uint32_t value)
+{
+    uint32_t seed = value * 2654435761u + 1;
+
+    for (uint32_t y = r.y; y < r.y + r.h; y++) {
+        for (uint32_t x = r.x; x < r.x + r.w; x++) {
+            seed = seed * 1103515245u + 12345u;
+            f[y * stride + x] = ((seed >> 16) & 3) ? 0x2104 : (uint16_t)(seed >> 8);
+        }
+    }
+}
+
+static void layout(uint32_t w, uint32_t h, rect_t *cards)
+{
+    for (int i = 0; i < LABELS; i++) {
+        const uint32_t col = i % 2, row = i / 2;
+        cards[i].w = w / 4 + 16;
+        cards[i].h = h / 32 + 16;
+        cards[i].x = col * (w / 2) + w / 8 - 8;
+        cards[i].y = (row + 1) * (h / 8) + h / 40 - 8;
+    }
+}
+
+static void render_card(uint16_t *f, uint32_t w, rect_t card, uint32_t value)
+{
+    const rect_t text = { card.x + 8, card.y + 8, card.w - 16, card.h - 16 };
+
+    fill(f, w, card, 0x2945);
+    label(f, w, text, value);
+}
+
+static void render(uint16_t *f, uint32_t w, uint32_t h, const rect_t *cards, const uint32_t *values, uint16_t bg)
+{
+    const rect_t all = { 0, 0, w, h };
+
+    fill(f, w, all, bg);
+    for (int i = 0; i < LABELS; i++)
+        render_card(f, w, cards[i], values[i]);
+}
+
+static void mark(dirty_tiles_t *dt, rect_t r)
+{
+    dirty_tiles_mark(dt, (int32_t)r.x, (int32_t)r.y, (int32_t)(r.x + r.w - 1), (int32_t)(r.y + r.h - 1));
+}
+
+/* Copy the reported spans the way the flush does; returns the span count */
+static uint32_t apply(const dirty_tiles_t *dt, const uint16_t *frame, uint16_t *panel, uint32_t stride)
+{
+    dirty_tiles_span_t sp;
+    uint32_t cursor = 0, n = 0;
+
+    while (dirty_tiles_next_span(dt, &cursor, &sp)) {
+        for (uint32_t y = sp.y; y < sp.y + sp.h; y++)
+            memcpy(panel + y * stride + sp.x, frame + y * stride + sp.x, sp.w * sizeof(uint16_t));
+        n++;
+    }
+    return n;
+}
+
+/* ---- checks ---- */
+static int check_size(uint32_t w, uint32_t h)
+{
+    const size_t px = (size_t)w * h;
+    uint16_t *frame = malloc(px * 2), *panel = malloc(px * 2);
+    void *mem = malloc(dirty_tiles_storage_bytes(w, h));
+    dirty_tiles_t dt;
+    int bad = 0;
+
+    dirty_tiles_init(&dt, w, h, mem);
+    for (size_t i = 0; i < px; i++)
+        frame[i] = (uint16_t)rnd();
+    memset(panel, 0, px * 2);
+
+    if (dirty_tiles_take(&dt) != dt.tiles_x * dt.tiles_y) {
+        fprintf(stderr, "%ux%u: first frame not dirty everywhere\n", w, h);
+        bad = 1;
+    }
+    apply(&dt, frame, panel, w);
+    if (dirty_tiles_take(&dt) != 0) {
+        fprintf(stderr, "%ux%u: dirty tiles without a mark\n", w, h);
+        bad = 1;
+    }
+
+    for (int iter = 0; iter < 3000 && !bad; iter++) {
+        /* A few rectangles, some hanging off the frame; sometimes the screen */
+        const uint32_t n = rnd() % 4;
+        for (uint32_t k = 0; k < n; k++) {
+            const int32_t x1 = (int32_t)(rnd() % (w + 40)) - 20, y1 = (int32_t)(rnd() % (h + 40)) - 20;
+            const int32_t x2 = x1 + (int32_t)(rnd() % (w / 3)), y2 = y1 + (int32_t)(rnd() % (h / 3));
+            const uint16_t c = (uint16_t)rnd();
+            for (int32_t y = y1 < 0 ? 0 : y1; y <= y2 && y < (int32_t)h; y++)
+                for (int32_t x = x1 < 0 ? 0 : x1; x <= x2 && x < (int32_t)w; x++)
+                    frame[(size_t)y * w + x] = c;
+            dirty_tiles_mark(&dt, x1, y1, x2, y2);
+        }
+        if (iter % 97 == 0) {
+            for (size_t i = 0; i < px; i++)
+                frame[i] = (uint16_t)rnd();
+            dirty_tiles_mark_all(&dt);
+        }
+
+        const uint32_t changed = dirty_tiles_take(&dt);
+        apply(&dt, frame, panel, w);
+        if (memcmp(frame, panel, px * 2) != 0) {
+            fprintf(stderr, "%ux%u: panel differs after frame %d (%u dirty tiles)\n", w, h, iter, changed);
+            bad = 1;
+        }
+        if (n == 0 && iter % 97 != 0 && changed != 0) {
+            fprintf(stderr, "%ux%u: %u dirty tiles without a mark\n", w, h, changed);
+            bad = 1;
+        }
+    }
+    free(frame);
+    free(panel);
+    free(mem);
+    return bad;
+}
+
+/* ---- scenarios ---- */
+enum { SC_ONE, SC_ALL, SC_SCREEN, SC_COUNT };
+
+static const char *const sc_name[SC_COUNT] = {
+    "one value", "all 13 values", "screen change",
+};
+
+int main(int argc, char **argv)
+{
+    uint32_t w = 800, h = 1280;
+    int frames = 60, i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            w = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-h") && i + 1 < argc) {
+            h = (uint32_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-r frames] [-w width] [-h height]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1 || w < 64 || h < 64) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    if (check_size(800, 1280) || check_size(1280, 800) || check_size(803, 1283) || check_size(99, 67)) {
+        return 1;
+    }
+    fprintf(stderr, "check:      spans rebuild every frame exactly from the marked areas\n");
+
+    const size_t px = (size_t)w * h;
+    uint16_t *frame = malloc(px * 2), *panel = malloc(px * 2);
+    void *mem = malloc(dirty_tiles_storage_bytes(w, h));
+    rect_t cards[LABELS];
+    uint32_t values[LABELS];
+    dirty_tiles_t dt;
+
+    if (!frame || !panel || !mem) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    layout(w, h, cards);
+    dirty_tiles_init(&dt, w, h, mem);
+
+    fprintf(stderr, "\n%ux%u frame, %dx%d tiles, %d frames per scenario, times per frame\n",
+            w, h, DIRTY_TILES_W, DIRTY_TILES_H, frames);
+    fprintf(stderr, "%-15s %8s %6s %10s %10s %10s\n",
+            "scenario", "skipped", "spans", "stage", "full copy", "saved");
+    for (int sc = 0; sc < SC_COUNT; sc++) {
+        uint64_t t_stage = 0, t_full = 0;
+        uint32_t spans = 0;
+        uint16_t bg = 0x1082;
+
+        for (int k = 0; k < LABELS; k++)
+            values[k] = k;
+        render(frame, w, h, cards, values, bg);
+        dirty_tiles_mark_all(&dt);
+        dirty_tiles_take(&dt);
+        apply(&dt, frame, panel, w);
+        dirty_tiles_reset_stats(&dt);
+
+        for (int f = 0; f < frames; f++) {
+            /* Redraw outside the timed region; LVGL renders the frame anyway */
+            switch (sc) {
+            case SC_ONE:
+                values[f % LABELS] += 1;
+                render_card(frame, w, cards[f % LABELS], values[f % LABELS]);
+                break;
+            case SC_ALL:
+                for (int k = 0; k < LABELS; k++) {
+                    values[k] += 1;
+                    render_card(frame, w, cards[k], values[k]);
+                }
+                break;
+            default:
+                bg ^= 0x0841;
+                render(frame, w, h, cards, values, bg);
+                break;
+            }
+
+            uint64_t t0 = now_ns();
+            switch (sc) {
+            case SC_ONE:
+                mark(&dt, cards[f % LABELS]);
+                break;
+            case SC_ALL:
+                for (int k = 0; k < LABELS; k++)
+                    mark(&dt, cards[k]);
+                break;
+            default:
+                dirty_tiles_mark_all(&dt);
+                break;
+            }
+            dirty_tiles_take(&dt);
+            spans += apply(&dt, frame, panel, w);
+            t_stage += now_ns() - t0;
+
+            t0 = now_ns();
+            memcpy(panel, frame, px * 2);
+            t_full += now_ns() - t0;
+        }
+        if (memcmp(frame, panel, px * 2) != 0) {
+            fprintf(stderr, "%s: panel differs\n", sc_name[sc]);
+            return 1;
+        }
+
+        const dirty_tiles_stats_t *st = &dt.stats;
+        const double stage = t_stage / 1e6 / frames, full = t_full / 1e6 / frames;
+        fprintf(stderr, "%-15s %7.1f%% %6.1f %8.3fms %8.3fms %8.3fms\n", sc_name[sc],
+                100.0 * st->tiles_skipped / st->tiles, (double)spans / frames, stage, full, full - stage);
+    }
+    free(frame);
+    free(panel);
+    free(mem);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * draw_cost_check - check the draw cost attribution and style linter
+ * (src/perf/draw_cost.c) on a Linux host.
+ *
+ *   cc -O2 -o draw_cost_check tools/draw_cost_check/draw_cost_check.c
+ *   ./draw_cost_check [-v]
+ *
+ * The lint rules are run over style facts shaped like the live view's
+ * objects (hose pill, cards, ratio bar, value labels) against the expected
+ * findings. Then a few hundred objects, more than the table holds, draw
+ * synthetic spans for many frames; per-object totals must match what was
+ * fed in, objects that did not fit must be counted as untracked, and the
+ * report must come out ranked by draw time. -v prints the report.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../../src/perf/draw_cost.c"
+
+static uint32_t s_rng = 2024;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+/* ---- lint ---- */
+typedef struct {
+    const char *what;
+    draw_cost_style_t st;
+    uint32_t expect;
+} lint_case_t;
+
+static const lint_case_t s_cases[] = {
+    /*                           w    h  rad sh  bg   opa  clip  kids  label pct */
+    { "hose pill",           { 170,  64,  14, 0, 255, 255, true,  true,  false, false }, DRAW_LINT_CLIP_CORNER },
+    { "card 30% bg",         { 380, 300,  14, 0,  76, 255, false, true,  false, false }, DRAW_LINT_TRANSLUCENT_BG },
+    { "ratio bar (pill)",    {  36, 400,  18, 0, 102, 255, false, true,  false, false }, DRAW_LINT_TRANSLUCENT_BG },
+    { "big rounded panel",   { 600, 300,  24, 0, 255, 255, false, false, false, false }, DRAW_LINT_LARGE_RADIUS },
+    { "value label 100%",    { 380,  40,   0, 0,   0, 255, false, false, true,  true },  DRAW_LINT_FULL_WIDTH_LABEL },
+    { "fixed-width label",   { 120,  40,   0, 0,   0, 255, false, false, true,  false }, 0 },
+    { "container 100%",      { 380, 300,   0, 0,   0, 255, false, true,  false, true },  0 },
+    { "button with shadow",  { 200,  80,  10, 8, 255, 255, false, true,  false, false }, DRAW_LINT_SHADOW },
+    { "faded overlay",       { 800, 200,   0, 0, 255, 180, false, true,  false, false }, DRAW_LINT_OPA_LAYER },
+    { "clip without radius", { 170,  64,   0, 0, 255, 255, true,  true,  false, false }, 0 },
+    { "transparent box",     { 800,1280,  30, 0,   0, 255, false, true,  false, false }, 0 },
+};
+
+static int check_lint(void)
+{
+    int bad = 0;
+
+    for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+        const uint32_t got = draw_cost_lint(&s_cases[i].st);
+        if (got != s_cases[i].expect) {
+            fprintf(stderr, "lint %s: got 0x%x, expected 0x%x\n", s_cases[i].what, got, s_cases[i].expect);
+            bad = 1;
+        }
+    }
+    return bad;
+}
+
+/* ---- attribution ---- */
+#define OBJS 300
+
+static char s_report[64 * 1024];
+static size_t s_report_len;
+
+static void collect(const char *line)
+{
+    const size_t n = strlen(line);
+    if (s_report_len + n < sizeof(s_report)) {
+        memcpy(s_report + s_report_len, line, n + 1);
+        s_report_len += n;
+    }
+}
+
+static int check_attribution(int verbose)
+{
+    static draw_cost_t dc;
+    static uint64_t want_us[OBJS], want_px[OBJS];
+    static uint32_t want_draws[OBJS];
+    static int keys[OBJS];
+    uint32_t cost[OBJS];
+    int64_t t = 5000000;
+    uint32_t added = 0, want_untracked = 0;
+    int bad = 0;
+
+    draw_cost_reset(&dc, t);
+    for (int i = 0; i < OBJS; i++) {
+        char name[DRAW_COST_NAME_LEN];
+        draw_cost_style_t st = s_cases[i % (sizeof(s_cases) / sizeof(s_cases[0]))].st;
+        snprintf(name, sizeof(name), "0.%d obj", i);
+        added += draw_cost_add(&dc, &keys[i], name, &st) != NULL;
+        cost[i] = 1 + rnd() % 400;
+    }
+    if (added != DRAW_COST_MAX_OBJS - 1 || dc.count != added) {
+        fprintf(stderr, "table took %u of %d objects, expected %d\n", added, OBJS, DRAW_COST_MAX_OBJS - 1);
+        bad = 1;
+    }
+
+    for (int frame = 0; frame < 200; frame++) {
+        for (int i = 0; i < OBJS; i++) {
+            /* MAIN then POST span, like the draw events; POST carries no pixels */
+            const uint32_t us = cost[i] + rnd() % 5, post = rnd() % 3, px = 1000 + i;
+            const bool tracked = draw_cost_find(&dc, &keys[i]) != NULL;
+            draw_cost_begin(&dc, &keys[i], t);
+            t += us;
+            draw_cost_end(&dc, &keys[i], t, px);
+            draw_cost_begin(&dc, &keys[i], t);
+            t += post;
+            draw_cost_end(&dc, &keys[i], t, 0);
+            if (tracked) {
+                want_us[i] += us + post;
+                want_px[i] += px;
+                want_draws[i] += 2;
+            } else {
+                want_untracked += 2;
+            }
+        }
+    }
+
+    for (int i = 0; i < OBJS && !bad; i++) {
+        const draw_cost_obj_t *o = draw_cost_find(&dc, &keys[i]);
+        if (o && (o->us != want_us[i] || o->px != want_px[i] || o->draws != want_draws[i])) {
+            fprintf(stderr, "object %d: %llu us %llu px %u draws, expected %llu %llu %u\n", i,
+                    (unsigned long long)o->us, (unsigned long long)o->px, o->draws,
+                    (unsigned long long)want_us[i], (unsigned long long)want_px[i], want_draws[i]);
+            bad = 1;
+        }
+    }
+    if (dc.untracked != want_untracked) {
+        fprintf(stderr, "untracked %u, expected %u\n", dc.untracked, want_untracked);
+        bad = 1;
+    }
+
+    /* Ranked: the ms/s column never increases down the top rows */
+    s_report_len = 0;
+    draw_cost_report(&dc, t, 40, collect);
+    double prev = 1e18;
+    int rows = 0;
+    for (char *line = strtok(s_report, "\n"); line; line = strtok(NULL, "\n")) {
+        unsigned long rank, draws;
+        char name[64], obj[16];
+        double ms_s;
+        if (sscanf(line, "%lu %63s %15s %lu %lf", &rank, name, obj, &draws, &ms_s) == 5 && rank <= 40) {
+            if (ms_s > prev + 1e-9) {
+                fprintf(stderr, "report not ranked at row %lu\n", rank);
+                bad = 1;
+            }
+            prev = ms_s;
+            rows++;
+        }
+    }
+    if (rows != 40) {
+        fprintf(stderr, "report has %d ranked rows, expected 40\n", rows);
+        bad = 1;
+    }
+    if (verbose) {
+        s_report_len = 0;
+        draw_cost_report(&dc, t, 20, collect);
+        fputs(s_report, stdout);
+    }
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    const int verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+    if (argc > 1 && !verbose) {
+        fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+        return 2;
+    }
+    if (check_lint() || check_attribution(verbose)) {
+        return 1;
+    }
+    fprintf(stderr, "check:      lint rules, per-object totals, table overflow and ranking ok\n");
+    return 0;
+}
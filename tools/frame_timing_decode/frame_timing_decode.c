@@ -0,0 +1,206 @@
+/*
+ * frame_timing_decode - read the binary frame timing dumps ('P' on the serial
+ * console) from a raw serial capture.
+ *
+ *   cc -O2 -o frame_timing_decode tools/frame_timing_decode/frame_timing_decode.c
+ *   ./frame_timing_decode [-v] capture.bin
+ *
+ * The capture may hold text around the dumps (boot log, other commands);
+ * every dump with a valid CRC is decoded with the device's own code
+ * (src/perf/frame_timing.c) and printed as count, mean and p50/p90/p99/max
+ * per metric; -v adds the histograms. Without a file it only runs the
+ * round-trip check: synthetic frames are encoded, wrapped in text, decoded
+ * and compared, and damaged dumps must be rejected.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../../src/perf/frame_timing.c"
+
+static uint32_t s_rng = 99;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static const char *const s_names[FRAME_TIMING_METRICS] = { "render", "flush", "interval", "area" };
+
+/* Times in ms, area in percent of the screen */
+static double scaled(int metric, double v)
+{
+    return metric == FRAME_TIMING_AREA ? v / 10.0 : v / 1000.0;
+}
+
+static void print_dump(const frame_timing_t *ft, int verbose)
+{
+    printf("%lu frames in %.1f s (%.1f fps), screen %lu px\n", (unsigned long)ft->frames, ft->window_ms / 1000.0,
+           ft->window_ms ? ft->frames * 1000.0 / ft->window_ms : 0.0, (unsigned long)ft->screen_px);
+    printf("  %-9s %7s %8s %8s %8s %8s %8s  (ms, area in %%)\n", "metric", "count", "mean", "p50", "p90", "p99", "max");
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        const frame_timing_hist_t *h = &ft->hist[i];
+        printf("  %-9s %7lu %8.2f %8.2f %8.2f %8.2f %8.2f\n", s_names[i], (unsigned long)h->count,
+               h->count ? scaled(i, (double)h->sum / h->count) : 0.0,
+               scaled(i, frame_timing_percentile(h, 50)), scaled(i, frame_timing_percentile(h, 90)),
+               scaled(i, frame_timing_percentile(h, 99)), scaled(i, h->max));
+    }
+    if (!verbose) {
+        return;
+    }
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        const frame_timing_hist_t *h = &ft->hist[i];
+        uint32_t peak = 1;
+        for (int b = 0; b <= FRAME_TIMING_BUCKETS; b++) {
+            if (h->bucket[b] > peak) {
+                peak = h->bucket[b];
+            }
+        }
+        printf("  %s:\n", s_names[i]);
+        for (int b = 0; b <= FRAME_TIMING_BUCKETS; b++) {
+            if (!h->bucket[b]) {
+                continue;
+            }
+            char bar[41];
+            const uint32_t len = (h->bucket[b] * 40 + peak - 1) / peak;
+            memset(bar, '#', len);
+            bar[len] = '\0';
+            if (b < FRAME_TIMING_BUCKETS) {
+                printf("  %7.2f-%7.2f %7lu %s\n", scaled(i, (double)b * h->width),
+                       scaled(i, (double)(b + 1) * h->width), (unsigned long)h->bucket[b], bar);
+            } else {
+                printf("        >%7.2f %7lu %s\n", scaled(i, (double)b * h->width), (unsigned long)h->bucket[b], bar);
+            }
+        }
+    }
+}
+
+/* ---- round-trip check ---- */
+static int same(const frame_timing_t *a, const frame_timing_t *b)
+{
+    if (a->frames != b->frames || a->screen_px != b->screen_px) {
+        return 0;
+    }
+    for (int i = 0; i < FRAME_TIMING_METRICS; i++) {
+        if (memcmp(&a->hist[i], &b->hist[i], sizeof(a->hist[i])) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check(void)
+{
+    static uint8_t dump[FRAME_TIMING_DUMP_MAX], wrapped[FRAME_TIMING_DUMP_MAX + 256];
+    frame_timing_t ft, back;
+    int64_t t = 1000000;
+
+    frame_timing_init(&ft, 800 * 1280, t);
+    for (int f = 0; f < 20000; f++) {
+        /* A few invalidations, a render with a flush inside, sometimes a stall */
+        for (uint32_t k = rnd() % 4; k; k--) {
+            frame_timing_invalidate(&ft, rnd() % 300000);
+        }
+        frame_timing_render_start(&ft, t);
+        t += 2000 + rnd() % 9000;
+        const int64_t fl = t;
+        t += 500 + rnd() % (f % 500 ? 6000 : 40000);
+        frame_timing_flush(&ft, fl, t);
+        frame_timing_render_done(&ft, t);
+        t += rnd() % 20000;
+    }
+
+    const size_t n = frame_timing_encode(&ft, t, dump, sizeof(dump));
+    if (n == 0 || n > FRAME_TIMING_DUMP_MAX) {
+        fprintf(stderr, "encode failed\n");
+        return 1;
+    }
+    /* As it arrives from the serial monitor: text before and after */
+    const char pre[] = "P\r\nframe timing\r\n\xa5\x5a", post[] = "\r\nL\r\n";
+    memcpy(wrapped, pre, sizeof(pre) - 1);
+    memcpy(wrapped + sizeof(pre) - 1, dump, n);
+    memcpy(wrapped + sizeof(pre) - 1 + n, post, sizeof(post) - 1);
+    const size_t wn = sizeof(pre) - 1 + n + sizeof(post) - 1;
+
+    if (frame_timing_decode(wrapped, wn, &back) != sizeof(pre) - 1 + n || !same(&ft, &back) ||
+        back.window_ms != (uint32_t)((t - 1000000) / 1000)) {
+        fprintf(stderr, "round trip differs\n");
+        return 1;
+    }
+    for (size_t cut = 0; cut < n; cut += 7) {
+        if (frame_timing_decode(dump, cut, &back) != 0) {
+            fprintf(stderr, "truncated dump (%zu of %zu bytes) accepted\n", cut, n);
+            return 1;
+        }
+    }
+    for (size_t at = 0; at < n; at++) {
+        dump[at] ^= 0x10;
+        if (frame_timing_decode(dump, n, &back) != 0) {
+            fprintf(stderr, "dump with byte %zu damaged accepted\n", at);
+            return 1;
+        }
+        dump[at] ^= 0x10;
+    }
+    fprintf(stderr, "check:      round trip exact, %zu-byte dump for 20000 frames, damage rejected\n", n);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int verbose = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-v")) {
+            verbose = 1;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [-v] [capture.bin]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (check()) {
+        return 1;
+    }
+    if (!path) {
+        return 0;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    size_t cap = 1 << 16, len = 0, n;
+    uint8_t *buf = malloc(cap);
+    while (buf && (n = fread(buf + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            buf = realloc(buf, cap);
+        }
+    }
+    fclose(f);
+    if (!buf) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    size_t pos = 0, used;
+    int dumps = 0;
+    frame_timing_t ft;
+    while (pos < len && (used = frame_timing_decode(buf + pos, len - pos, &ft)) != 0) {
+        printf("---- dump %d ----\n", ++dumps);
+        print_dump(&ft, verbose);
+        pos += used;
+    }
+    free(buf);
+    if (!dumps) {
+        fprintf(stderr, "%s: no frame timing dump found\n", path);
+        return 1;
+    }
+    return 0;
+}
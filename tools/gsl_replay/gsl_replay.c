@@ -0,0 +1,441 @@
+/*
+ * gsl_replay - run a captured GSL3680 touch trace through the point-ID stack
+ * on a Linux host.
+ *
+ * Capture on the device with the serial console ('T' to arm, 'D' to dump),
+ * save the dump to a file, then:
+ *
+ *   cc -O2 -o gsl_replay tools/gsl_replay/gsl_replay.c tools/gsl_replay/gsl_point_id_ref.c
+ *   ./gsl_replay [-r repeats] [-v] [-j profile.json] trace.txt
+ *
+ * tools/gsl_replay/synthetic.txt is a committed trace to run without a device.
+ *
+ * Every report goes through the same code the driver runs:
+ * gsl3680_report_decode(), gsl_alg_ctx_id_main() and the _Get_Cal_msg() pen
+ * state machine. The tool prints throughput, the cost of each algorithm stage
+ * and a digest of all reported coordinates. With -v it also prints one CSV line
+ * per report. The digest is the regression check: an optimisation must not
+ * change it for a given trace. With -j the timed pass is also recorded into
+ * the same trace ring the device uses (src/perf/trace_ring.c) and written as
+ * Chrome trace JSON: gsl_alg_id_main and every stage inside it.
+ *
+ * Every run also feeds each report to the original algorithm
+ * (gsl_point_id_ref.c) and the current one side by side, compares the
+ * coordinates, IDs, mask, press-move and pressure of every frame, and times
+ * both. The tool fails on the first frame that differs.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- per-stage timing hook, see GSL_STAGE in gsl_point_id.c ---- */
+#define MAX_STAGES 40
+
+typedef struct {
+    const char *name;
+    uint64_t calls;
+    uint64_t ns;
+} stage_t;
+
+static stage_t s_stages[MAX_STAGES];
+static int s_stage_cnt;
+static int s_stage_timing;
+static uint64_t s_stage_calls_frame;
+
+static void stage_add(const char *name, uint64_t ns)
+{
+    int i;
+
+    s_stage_calls_frame++;
+    for (i = 0; i < s_stage_cnt; i++) {
+        if (s_stages[i].name == name)
+            break;
+    }
+    if (i == s_stage_cnt) {
+        if (s_stage_cnt == MAX_STAGES)
+            return;
+        s_stages[s_stage_cnt++].name = name;
+    }
+    s_stages[i].calls++;
+    s_stages[i].ns += ns;
+}
+
+#define GSL_STAGE(call)                                         \
+    do {                                                        \
+        if (s_stage_timing) {                                   \
+            TRACE_RING_BEGIN_TAG(#call);                        \
+            uint64_t t0_ = now_ns();                            \
+            call;                                               \
+            stage_add(#call, now_ns() - t0_);                   \
+            TRACE_RING_END_TAG(#call);                          \
+        } else {                                                \
+            call;                                               \
+        }                                                       \
+    } while (0)
+
+#include "../../src/perf/trace_ring.c"
+#include "../../src/touch/gsl_point_id.c"
+#include "../../src/touch/gsl3680_report.c"
+#include "../../src/touch/gsl3680_config.c"
+
+/* ---- reference: the original algorithm, gsl_point_id_ref.c ---- */
+void ref_gsl_DataInit(unsigned int *conf_in);
+void ref_gsl_alg_id_main(struct gsl_touch_info *cinfo);
+unsigned int ref_gsl_mask_tiaoping(void);
+int ref_gsl_PressMove(void);
+void ref_gsl_ReportPressure(unsigned int *p);
+
+/* ---- trace loading ---- */
+typedef struct {
+    uint32_t t_us;
+    uint8_t raw[GSL3680_REPORT_LEN];
+} rec_t;
+
+static int hexval(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+/* Accepts the device dump as-is; lines that are not records are skipped */
+static rec_t *load_trace(FILE *f, size_t *out_n)
+{
+    char line[256];
+    char hex[GSL3680_REPORT_LEN * 2 + 2];
+    unsigned long t;
+    rec_t *recs = NULL;
+    size_t n = 0, cap = 0;
+    int i, hi, lo;
+
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%lu %49s", &t, hex) != 2 || strlen(hex) != GSL3680_REPORT_LEN * 2)
+            continue;
+        if (n == cap) {
+            cap = cap ? cap * 2 : 1024;
+            recs = realloc(recs, cap * sizeof(*recs));
+            if (!recs) {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+            }
+        }
+        for (i = 0; i < GSL3680_REPORT_LEN; i++) {
+            hi = hexval(hex[i * 2]);
+            lo = hexval(hex[i * 2 + 1]);
+            if (hi < 0 || lo < 0)
+                break;
+            recs[n].raw[i] = (uint8_t)(hi << 4 | lo);
+        }
+        if (i != GSL3680_REPORT_LEN)
+            continue;
+        recs[n++].t_us = (uint32_t)t;
+    }
+    *out_n = n;
+    return recs;
+}
+
+/* ---- replay ---- */
+typedef struct {
+    uint64_t digest;
+    uint64_t pen[4];            /* TP_PEN_* counts */
+    uint64_t touched;           /* reports with at least one finger out */
+    uint64_t mask_latched;      /* reports with a frequency-hop mask latched */
+    uint64_t mask_writes;       /* 0xf0/0x08 updates the driver sends (changes only) */
+    uint64_t read_bytes;        /* 0x80 payload bytes with reads sized by finger count */
+    uint64_t rereads;           /* second, full-size reads */
+    uint64_t fast;              /* reports that skipped every stage */
+} result_t;
+
+static void replay(const rec_t *recs, size_t n, struct gsl_alg_ctx *ctx, int verbose, result_t *res)
+{
+    struct gsl_touch_info cinfo;
+    gsl3680_pen_t pen = { .tp_event = TP_PEN_NONE };
+    uint8_t raw[GSL3680_REPORT_LEN];
+    uint8_t read_points = gsl3680_report_next_points(0);
+    uint32_t mask_last = 0;
+    unsigned int mask;
+    uint8_t ev, fingers;
+    size_t i;
+    int k;
+
+    memset(res, 0, sizeof(*res));
+    res->digest = 1469598103934665603ull;
+    gsl_alg_ctx_init(ctx, gsl_config_data_id);
+
+    for (i = 0; i < n; i++) {
+        /* Same sized read as the driver: unread bytes are zero */
+        memset(raw, 0, sizeof(raw));
+        memcpy(raw, recs[i].raw, GSL3680_REPORT_BYTES(read_points));
+        res->read_bytes += GSL3680_REPORT_BYTES(read_points);
+        if (gsl3680_report_points(raw) > read_points) {
+            memcpy(raw, recs[i].raw, GSL3680_REPORT_LEN);
+            res->read_bytes += GSL3680_REPORT_LEN;
+            res->rereads++;
+        }
+        read_points = gsl3680_report_next_points(gsl3680_report_points(raw));
+
+        gsl3680_report_decode(raw, &cinfo);
+        s_stage_calls_frame = 0;
+        gsl_alg_ctx_id_main(ctx, &cinfo);
+        mask = gsl_alg_ctx_mask_tiaoping(ctx);
+        fingers = (uint8_t)cinfo.finger_num;
+        ev = gsl3680_pen_update(&pen, fingers, (uint16_t)cinfo.x[0], (uint16_t)cinfo.y[0]);
+
+        if (s_stage_timing && s_stage_calls_frame == 0)
+            res->fast++;
+        if (mask > 0 && mask < 0xffffffff)
+            res->mask_latched++;
+        if (gsl3680_mask_due(&mask_last, mask))
+            res->mask_writes++;
+        if (fingers)
+            res->touched++;
+        res->pen[ev & 3]++;
+        for (k = 0; k < (int)sizeof(cinfo); k++) {
+            res->digest ^= ((const uint8_t *)&cinfo)[k];
+            res->digest *= 1099511628211ull;
+        }
+        res->digest ^= ev;
+        res->digest *= 1099511628211ull;
+
+        if (verbose) {
+            printf("%lu,%u,%u,%d,%d,%d,%d,%d,%d,%u,%u,%u\n",
+                   (unsigned long)recs[i].t_us, recs[i].raw[0], fingers,
+                   cinfo.x[0], cinfo.y[0], cinfo.id[0], cinfo.x[1], cinfo.y[1], cinfo.id[1],
+                   ev, pen.x_new, pen.y_new);
+        }
+    }
+}
+
+static void print_info(const char *who, const struct gsl_touch_info *c)
+{
+    int k;
+
+    fprintf(stderr, "  %-9s fingers %d:", who, c->finger_num);
+    for (k = 0; k < 10; k++) {
+        if (c->x[k] || c->y[k] || c->id[k])
+            fprintf(stderr, " %d:(%d,%d)", c->id[k], c->x[k], c->y[k]);
+    }
+    fprintf(stderr, "\n");
+}
+
+/* Both algorithms on the same reports from a fresh start; the first frame
+ * whose output differs, or n */
+static size_t compare_ref(const rec_t *recs, size_t n, struct gsl_alg_ctx *ctx)
+{
+    struct gsl_touch_info in, cur, ref;
+    unsigned int p_cur[10], p_ref[10];
+    size_t i;
+
+    gsl_alg_ctx_init(ctx, gsl_config_data_id);
+    ref_gsl_DataInit(gsl_config_data_id);
+    for (i = 0; i < n; i++) {
+        gsl3680_report_decode(recs[i].raw, &in);
+        cur = in;
+        ref = in;
+        gsl_alg_ctx_id_main(ctx, &cur);
+        ref_gsl_alg_id_main(&ref);
+        gsl_alg_ctx_report_pressure(ctx, p_cur);
+        ref_gsl_ReportPressure(p_ref);
+        if (memcmp(&cur, &ref, sizeof(cur)) != 0 ||
+            gsl_alg_ctx_mask_tiaoping(ctx) != ref_gsl_mask_tiaoping() ||
+            gsl_alg_ctx_press_move(ctx) != ref_gsl_PressMove() ||
+            memcmp(p_cur, p_ref, sizeof(p_cur)) != 0) {
+            fprintf(stderr, "frame %zu (t_us %lu) differs from the original algorithm:\n",
+                    i, (unsigned long)recs[i].t_us);
+            print_info("original", &ref);
+            print_info("current", &cur);
+            fprintf(stderr, "  mask %08x / %08x, press-move %d / %d\n", ref_gsl_mask_tiaoping(),
+                    gsl_alg_ctx_mask_tiaoping(ctx), ref_gsl_PressMove(), gsl_alg_ctx_press_move(ctx));
+            return i;
+        }
+    }
+    return n;
+}
+
+/* ns per frame of the algorithm alone, reports decoded up front */
+static double time_alg(const struct gsl_touch_info *in, size_t n, struct gsl_alg_ctx *ctx, int repeats)
+{
+    struct gsl_touch_info c;
+    uint64_t t0 = now_ns();
+    size_t i;
+    int r;
+
+    for (r = 0; r < repeats; r++) {
+        if (ctx)
+            gsl_alg_ctx_init(ctx, gsl_config_data_id);
+        else
+            ref_gsl_DataInit(gsl_config_data_id);
+        for (i = 0; i < n; i++) {
+            c = in[i];
+            if (ctx)
+                gsl_alg_ctx_id_main(ctx, &c);
+            else
+                ref_gsl_alg_id_main(&c);
+        }
+    }
+    return (double)(now_ns() - t0) / ((double)n * repeats);
+}
+
+#define PROFILE_EVENTS_MAX (1u << 20)    /* newest events kept, 24 MB */
+
+static FILE *s_json;
+
+static void json_emit(const char *line)
+{
+    fputs(line, s_json);
+}
+
+static int cmp_stage(const void *a, const void *b)
+{
+    const stage_t *sa = a, *sb = b;
+
+    return sa->ns < sb->ns ? 1 : (sa->ns > sb->ns ? -1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL, *json = NULL;
+    int repeats = 20, verbose = 0, i;
+    FILE *f;
+    rec_t *recs;
+    size_t n;
+    struct gsl_alg_ctx *ctx;
+    result_t res, check;
+    struct gsl_touch_info *decoded;
+    uint64_t t0, ns, total_stage_ns = 0;
+    double span_s, ns_ref, ns_cur;
+    size_t diff;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            repeats = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-v"))
+            verbose = 1;
+        else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+            json = argv[++i];
+        else if (argv[i][0] != '-' || !strcmp(argv[i], "-"))
+            path = argv[i];
+        else
+            path = NULL, i = argc;
+    }
+    if (!path || repeats < 1) {
+        fprintf(stderr, "usage: %s [-r repeats] [-v] [-j profile.json] trace.txt|-\n", argv[0]);
+        return 2;
+    }
+    f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    recs = load_trace(f, &n);
+    if (f != stdin)
+        fclose(f);
+    if (n == 0) {
+        fprintf(stderr, "%s: no trace records\n", path);
+        return 1;
+    }
+    ctx = malloc(gsl_alg_ctx_size());
+    if (!ctx) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    /* Frame by frame against the original algorithm, then both timed */
+    diff = compare_ref(recs, n, ctx);
+    if (diff != n)
+        return 1;
+    decoded = malloc(n * sizeof(*decoded));
+    if (!decoded) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < (int)n; i++)
+        gsl3680_report_decode(recs[i].raw, &decoded[i]);
+    ns_ref = time_alg(decoded, n, NULL, repeats);
+    ns_cur = time_alg(decoded, n, ctx, repeats);
+    free(decoded);
+
+    /* Coordinates (and with -v the CSV) from one untimed pass */
+    if (verbose)
+        printf("t_us,raw_fingers,fingers,x0,y0,id0,x1,y1,id1,pen_event,pen_x,pen_y\n");
+    replay(recs, n, ctx, verbose, &res);
+
+    /* Throughput with the stage hook off */
+    t0 = now_ns();
+    for (i = 0; i < repeats; i++) {
+        replay(recs, n, ctx, 0, &check);
+        if (check.digest != res.digest) {
+            fprintf(stderr, "non-deterministic replay on pass %d\n", i);
+            return 1;
+        }
+    }
+    ns = now_ns() - t0;
+
+    /* One pass with per-stage timing, traced with -j */
+    if (json && !trace_ring_start(n * 64 < PROFILE_EVENTS_MAX ? n * 64 : PROFILE_EVENTS_MAX)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    s_stage_timing = 1;
+    replay(recs, n, ctx, 0, &check);
+    s_stage_timing = 0;
+    if (json) {
+        trace_ring_stop();
+        s_json = fopen(json, "w");
+        if (!s_json) {
+            perror(json);
+            return 1;
+        }
+        trace_ring_dump_json(json_emit);
+        fclose(s_json);
+    }
+
+    span_s = (double)(uint32_t)(recs[n - 1].t_us - recs[0].t_us) / 1e6;
+    fprintf(stderr, "trace:      %zu reports over %.1f s, %llu with fingers\n",
+            n, span_s, (unsigned long long)res.touched);
+    fprintf(stderr, "i2c:        %.1f bytes/report read (%d unsized), %llu full re-reads, "
+            "%llu mask writes for %llu latched reports\n",
+            (double)res.read_bytes / n, GSL3680_REPORT_LEN, (unsigned long long)res.rereads,
+            (unsigned long long)res.mask_writes, (unsigned long long)res.mask_latched);
+    fprintf(stderr, "pen events: none %llu  move %llu  up %llu  down %llu\n",
+            (unsigned long long)res.pen[TP_PEN_NONE], (unsigned long long)res.pen[TP_PEN_MOVE],
+            (unsigned long long)res.pen[TP_PEN_UP], (unsigned long long)res.pen[TP_PEN_DOWN]);
+    fprintf(stderr, "throughput: %.0f reports/s, %.1f ns/report (%d passes)\n",
+            (double)n * repeats * 1e9 / (double)ns, (double)ns / ((double)n * repeats), repeats);
+    fprintf(stderr, "idle fast path: %llu of %zu reports\n", (unsigned long long)check.fast, n);
+    fprintf(stderr, "original:   all %zu frames identical; algorithm %.1f ns/frame, now %.1f ns/frame (%.1fx)\n",
+            n, ns_ref, ns_cur, ns_ref / ns_cur);
+
+    qsort(s_stages, s_stage_cnt, sizeof(s_stages[0]), cmp_stage);
+    for (i = 0; i < s_stage_cnt; i++)
+        total_stage_ns += s_stages[i].ns;
+    fprintf(stderr, "\n%-32s %10s %10s %6s\n", "stage", "calls", "ns/call", "share");
+    for (i = 0; i < s_stage_cnt; i++) {
+        fprintf(stderr, "%-32s %10llu %10.1f %5.1f%%\n", s_stages[i].name,
+                (unsigned long long)s_stages[i].calls,
+                (double)s_stages[i].ns / (double)s_stages[i].calls,
+                total_stage_ns ? 100.0 * (double)s_stages[i].ns / (double)total_stage_ns : 0.0);
+    }
+    fprintf(stderr, "\ndigest: %016llx\n", (unsigned long long)res.digest);
+
+    free(ctx);
+    free(recs);
+    return 0;
+}
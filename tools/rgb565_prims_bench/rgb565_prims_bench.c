@@ -0,0 +1,218 @@
+/*
+ * rgb565_prims_bench - check and time jd9365_lcd's software 2D primitives on
+ * a Linux host.
+ *
+ *   cc -O2 -o rgb565_prims_bench tools/rgb565_prims_bench/rgb565_prims_bench.c
+ *   ./rgb565_prims_bench [-r repeats] [-w width] [-h height]
+ *
+ * Every primitive in src/lcd/rgb565_prims.c is compared with a per-pixel
+ * reference over many rectangle sizes, odd offsets and overlapping copies,
+ * with guard pixels around each rectangle. Then full-surface throughput
+ * (800x1280 by default) is printed for the kernels and the references. Host
+ * numbers only rank the kernels; the panel path is bounded by PSRAM bandwidth.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/lcd/rgb565_prims.c"
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t s_rng = 12345;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+/* ---- references ---- */
+static void ref_fill(uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h, uint16_t c)
+{
+    uint32_t x, y;
+
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            dst[y * ds + x] = c;
+}
+
+static void ref_copy(const uint16_t *src, uint32_t ss, uint16_t *dst, uint32_t ds, uint32_t w, uint32_t h)
+{
+    uint16_t *tmp = malloc((size_t)w * h * sizeof(uint16_t) + 2);
+    uint32_t x, y;
+
+    /* Through a temporary so overlap never matters */
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            tmp[y * w + x] = src[y * ss + x];
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++)
+            dst[y * ds + x] = tmp[y * w + x];
+    free(tmp);
+}
+
+static void ref_convert(const void *src, rgb565_src_fmt_t fmt, uint32_t ss, uint16_t *dst, uint32_t ds,
+                        uint32_t w, uint32_t h)
+{
+    uint32_t x, y, r, g, b;
+
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            if (fmt == RGB565_SRC_RGB888) {
+                const uint8_t *p = (const uint8_t *)src + (y * ss + x) * 3;
+                b = p[0], g = p[1], r = p[2];
+            } else if (fmt == RGB565_SRC_XRGB8888) {
+                const uint32_t v = ((const uint32_t *)src)[y * ss + x];
+                r = (v >> 16) & 0xff, g = (v >> 8) & 0xff, b = v & 0xff;
+            } else {
+                dst[y * ds + x] = ((const uint16_t *)src)[y * ss + x];
+                continue;
+            }
+            dst[y * ds + x] = (uint16_t)((r >> 3) << 11 | (g >> 2) << 5 | (b >> 3));
+        }
+    }
+}
+
+/* ---- correctness ---- */
+#define SURF_W 97
+#define SURF_H 41
+
+static int check(void)
+{
+    static uint16_t a[SURF_W * SURF_H], b[SURF_W * SURF_H];
+    static uint32_t src[SURF_W * SURF_H];
+    int iter, bad = 0;
+    size_t i;
+
+    for (iter = 0; iter < 20000; iter++) {
+        const uint32_t w = rnd() % (SURF_W / 2 + 1);
+        const uint32_t h = rnd() % (SURF_H / 2 + 1);
+        const uint32_t x = rnd() % (SURF_W - w + 1), y = rnd() % (SURF_H - h + 1);
+        const uint32_t op = iter % 5;
+
+        for (i = 0; i < SURF_W * SURF_H; i++) {
+            a[i] = b[i] = (uint16_t)rnd();
+            src[i] = rnd() ^ (rnd() << 16);
+        }
+        if (op == 0) {
+            const uint16_t c = (uint16_t)rnd();
+            ref_fill(a + y * SURF_W + x, SURF_W, w, h, c);
+            rgb565_fill(b + y * SURF_W + x, SURF_W, w, h, c);
+        } else if (op == 1) {
+            /* Overlapping move inside one surface, any direction */
+            const uint32_t sx = rnd() % (SURF_W - w + 1), sy = rnd() % (SURF_H - h + 1);
+            ref_copy(a + sy * SURF_W + sx, SURF_W, a + y * SURF_W + x, SURF_W, w, h);
+            rgb565_copy(b + sy * SURF_W + sx, SURF_W, b + y * SURF_W + x, SURF_W, w, h);
+        } else {
+            const rgb565_src_fmt_t fmt = (rgb565_src_fmt_t)(op - 2);
+            const uint32_t ss = w + rnd() % 5;
+            ref_convert(src, fmt, ss, a + y * SURF_W + x, SURF_W, w, h);
+            rgb565_convert(src, fmt, ss, b + y * SURF_W + x, SURF_W, w, h);
+        }
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            fprintf(stderr, "MISMATCH op %u at %u,%u size %ux%u\n", op, x, y, w, h);
+            bad = 1;
+        }
+    }
+    return bad;
+}
+
+/* ---- throughput ---- */
+typedef struct {
+    const char *name;
+    int op;                 /* 0 fill, 1 copy, 2.. convert from fmt op-2 */
+} bench_t;
+
+static double run(int op, int ref, const void *src, uint16_t *dst, uint32_t w, uint32_t h, int repeats)
+{
+    uint64_t t0 = now_ns();
+    int i;
+
+    for (i = 0; i < repeats; i++) {
+        const uint16_t c = (uint16_t)(0x1234 + i);
+        if (op == 0) {
+            if (ref)
+                ref_fill(dst, w, w, h, c);
+            else
+                rgb565_fill(dst, w, w, h, c);
+        } else if (op == 1) {
+            if (ref)
+                ref_copy(src, w, dst, w, w, h);
+            else
+                rgb565_copy(src, w, dst, w, w, h);
+        } else {
+            if (ref)
+                ref_convert(src, (rgb565_src_fmt_t)(op - 2), w, dst, w, w, h);
+            else
+                rgb565_convert(src, (rgb565_src_fmt_t)(op - 2), w, dst, w, w, h);
+        }
+    }
+    return (double)(now_ns() - t0) / 1e6 / repeats;
+}
+
+int main(int argc, char **argv)
+{
+    static const bench_t benches[] = {
+        { "fill", 0 },
+        { "copy", 1 },
+        { "convert rgb888", 3 },
+        { "convert xrgb8888", 4 },
+    };
+    uint32_t w = 800, h = 1280;
+    int repeats = 20, i;
+    size_t k;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            w = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-h") && i + 1 < argc) {
+            h = (uint32_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-r repeats] [-w width] [-h height]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats < 1 || w == 0 || h == 0) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    if (check()) {
+        return 1;
+    }
+    fprintf(stderr, "check:      fill, copy and convert match the references\n");
+
+    uint32_t *src = malloc((size_t)w * h * sizeof(uint32_t));
+    uint16_t *dst = malloc((size_t)w * h * sizeof(uint16_t));
+    if (!src || !dst) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (k = 0; k < (size_t)w * h; k++) {
+        src[k] = rnd();
+    }
+
+    fprintf(stderr, "\n%ux%u surface, %d passes\n", w, h, repeats);
+    fprintf(stderr, "%-18s %10s %10s %12s %8s\n", "primitive", "ms", "ref ms", "Mpix/s", "speedup");
+    for (k = 0; k < sizeof(benches) / sizeof(benches[0]); k++) {
+        const double ms = run(benches[k].op, 0, src, dst, w, h, repeats);
+        const double ref = run(benches[k].op, 1, src, dst, w, h, repeats);
+        fprintf(stderr, "%-18s %10.3f %10.3f %12.1f %7.1fx\n", benches[k].name, ms, ref,
+                (double)w * h / (ms * 1e3), ref / ms);
+    }
+    free(src);
+    free(dst);
+    return 0;
+}
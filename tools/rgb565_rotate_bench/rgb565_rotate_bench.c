@@ -0,0 +1,175 @@
+/*
+ * rgb565_rotate_bench - check and time the rotate-on-flush kernel on a Linux
+ * host.
+ *
+ *   cc -O2 -o rgb565_rotate_bench tools/rgb565_rotate_bench/rgb565_rotate_bench.c
+ *   ./rgb565_rotate_bench [-r repeats] [-w width] [-h height]
+ *
+ * The kernel is compared pixel for pixel against a plain per-pixel loop for
+ * every rotation, on odd sizes and misaligned destinations. Then a full frame
+ * (1280x800 landscape by default) is rotated into the panel orientation with
+ * the plain loop and with each tile size, so the RGB565_ROTATE_TILE default
+ * can be rechecked when the target or frame size changes. Host caches are not
+ * the P4's, so compare tile sizes relative to each other rather than trusting
+ * the absolute numbers.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/lcd/rgb565_rotate.c"
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Reference: one pixel at a time, straight from the definition */
+static void rotate_ref(const uint16_t *src, uint32_t w, uint32_t h, uint32_t ss,
+                       uint16_t *dst, uint32_t ds, uint8_t turns)
+{
+    uint32_t x, y;
+
+    for (y = 0; y < h; y++) {
+        for (x = 0; x < w; x++) {
+            const uint16_t p = src[y * ss + x];
+            switch (turns & 3) {
+            case 1:
+                dst[x * ds + (h - 1 - y)] = p;
+                break;
+            case 2:
+                dst[(h - 1 - y) * ds + (w - 1 - x)] = p;
+                break;
+            case 3:
+                dst[(w - 1 - x) * ds + y] = p;
+                break;
+            default:
+                dst[y * ds + x] = p;
+                break;
+            }
+        }
+    }
+}
+
+static int check(uint32_t w, uint32_t h, uint32_t pad, uint32_t dst_off, uint32_t tile)
+{
+    const uint32_t ss = w + pad;
+    const uint32_t ds = (w > h ? w : h) + pad;
+    const size_t dst_len = (size_t)ds * ds + dst_off;
+    uint16_t *src = malloc((size_t)ss * h * sizeof(uint16_t));
+    uint16_t *a = malloc(dst_len * sizeof(uint16_t));
+    uint16_t *b = malloc(dst_len * sizeof(uint16_t));
+    int bad = 0;
+    uint8_t turns;
+    size_t i;
+
+    if (!src || !a || !b) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < (size_t)ss * h; i++) {
+        src[i] = (uint16_t)(i * 2654435761u >> 13);
+    }
+    for (turns = 0; turns < 4; turns++) {
+        memset(a, 0xa5, dst_len * sizeof(uint16_t));
+        memset(b, 0xa5, dst_len * sizeof(uint16_t));
+        rotate_ref(src, w, h, ss, a + dst_off, ds, turns);
+        rotate_tiled(src, w, h, ss, b + dst_off, ds, turns, tile);
+        if (memcmp(a, b, dst_len * sizeof(uint16_t)) != 0) {
+            fprintf(stderr, "MISMATCH %ux%u pad %u dst+%u tile %u turns %u\n",
+                    w, h, pad, dst_off, tile, turns);
+            bad = 1;
+        }
+    }
+    free(src);
+    free(a);
+    free(b);
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t tiles[] = { 8, 16, 32, 64, 128 };
+    static const uint32_t sizes[][2] = { { 1, 1 }, { 7, 5 }, { 33, 17 }, { 64, 64 }, { 129, 70 } };
+    uint32_t w = 1280, h = 800;
+    int repeats = 20;
+    int bad = 0;
+    size_t t, k;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            w = (uint32_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-h") && i + 1 < argc) {
+            h = (uint32_t)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [-r repeats] [-w width] [-h height]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats < 1 || w == 0 || h == 0) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    for (t = 0; t < sizeof(tiles) / sizeof(tiles[0]); t++) {
+        for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            bad |= check(sizes[k][0], sizes[k][1], 0, 0, tiles[t]);
+            bad |= check(sizes[k][0], sizes[k][1], 3, 1, tiles[t]);
+        }
+    }
+    if (bad) {
+        return 1;
+    }
+    fprintf(stderr, "check:      all rotations match the reference\n");
+
+    uint16_t *src = malloc((size_t)w * h * sizeof(uint16_t));
+    uint16_t *dst = malloc((size_t)w * h * sizeof(uint16_t));
+    if (!src || !dst) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (k = 0; k < (size_t)w * h; k++) {
+        src[k] = (uint16_t)k;
+    }
+
+    fprintf(stderr, "\n%ux%u -> %ux%u, %d passes\n", w, h, h, w, repeats);
+    fprintf(stderr, "%-12s %12s %12s %12s\n", "kernel", "90 ms", "270 ms", "Mpix/s");
+    for (t = 0; t <= sizeof(tiles) / sizeof(tiles[0]); t++) {
+        double ms[2];
+        int d;
+
+        for (d = 0; d < 2; d++) {
+            const uint8_t turns = d ? 3 : 1;
+            uint64_t t0;
+
+            t0 = now_ns();
+            for (i = 0; i < repeats; i++) {
+                if (t == 0) {
+                    rotate_ref(src, w, h, w, dst, h, turns);
+                } else {
+                    rotate_tiled(src, w, h, w, dst, h, turns, tiles[t - 1]);
+                }
+            }
+            ms[d] = (double)(now_ns() - t0) / 1e6 / repeats;
+        }
+        if (t == 0) {
+            fprintf(stderr, "%-12s", "per-pixel");
+        } else {
+            fprintf(stderr, "tile %-3u%s  ", tiles[t - 1], tiles[t - 1] == RGB565_ROTATE_TILE ? " *" : "  ");
+        }
+        fprintf(stderr, " %12.3f %12.3f %12.1f\n", ms[0], ms[1],
+                (double)w * h / ((ms[0] + ms[1]) / 2 * 1e3));
+    }
+    free(src);
+    free(dst);
+    return 0;
+}
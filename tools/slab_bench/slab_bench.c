@@ -0,0 +1,314 @@
+/*
+ * slab_bench - check and time LVGL's slab heap (src/mem/slab_heap.c) on a
+ * Linux host.
+ *
+ *   cc -O2 -o slab_bench tools/slab_bench/slab_bench.c
+ *   ./slab_bench [-r frames] [-v]
+ *
+ * A random alloc / realloc / free mix first checks that blocks never
+ * overlap, keep their contents across reallocs and land in the right size
+ * class, and that the per-class counts add up. Then two LVGL-shaped traces
+ * are timed against the host's malloc: the live view's frame (draw tasks
+ * and descriptors created and dropped every frame, 13 value labels re-set,
+ * an occasional layer buffer) and a screen built and torn down. -v prints
+ * the per-class table.
+ *
+ * The baseline is glibc's malloc, not LVGL's builtin TLSF heap or the ESP
+ * heap the slab heap replaces on the panel: LVGL is not part of this tree
+ * off target. glibc serves small blocks from per-thread caches, so the
+ * ratio is no measure of the gain over TLSF on the panel.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <malloc.h>
+
+#include "../../src/mem/slab_heap.c"
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t s_rng = 4404;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+/* ---- backends ---- */
+static void *host_arena_alloc(size_t bytes)
+{
+    return aligned_alloc(SLAB_PAGE, bytes);
+}
+
+static size_t host_large_size(void *p)
+{
+    return malloc_usable_size(p);
+}
+
+static const slab_heap_backend_t s_backend = {
+    .arena_alloc = host_arena_alloc,
+    .large_alloc = malloc,
+    .large_realloc = realloc,
+    .large_free = free,
+    .large_size = host_large_size,
+};
+
+static slab_heap_t s_heap;
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t);
+    void *(*realloc)(void *, size_t);
+    void (*free)(void *);
+} allocator_t;
+
+static void *slab_alloc(size_t n) { return slab_heap_alloc(&s_heap, n); }
+static void *slab_realloc(void *p, size_t n) { return slab_heap_realloc(&s_heap, p, n); }
+static void slab_free(void *p) { slab_heap_free(&s_heap, p); }
+
+static const allocator_t s_allocators[] = {
+    { "slab",   slab_alloc, slab_realloc, slab_free },
+    { "glibc",  malloc,     realloc,      free },
+};
+
+/* ---- correctness ---- */
+#define LIVE 2000
+
+typedef struct {
+    uint8_t *p;
+    size_t n;
+    uint8_t tag;
+} live_t;
+
+static void fill(live_t *b)
+{
+    memset(b->p, b->tag, b->n);
+}
+
+static int intact(const live_t *b)
+{
+    for (size_t i = 0; i < b->n; i++) {
+        if (b->p[i] != b->tag) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static size_t rnd_size(void)
+{
+    /* Mostly small, like label text and descriptors; some large */
+    const uint32_t r = rnd() % 100;
+    if (r < 85) return 1 + rnd() % SLAB_MAX_SIZE;
+    if (r < 97) return SLAB_MAX_SIZE + 1 + rnd() % 2048;
+    return 8192 + rnd() % 65536;
+}
+
+static int check_fuzz(void)
+{
+    static live_t live[LIVE];
+    int bad = 0;
+
+    for (uint32_t op = 0; op < 400000 && !bad; op++) {
+        live_t *b = &live[rnd() % LIVE];
+        const uint32_t what = rnd() % 3;
+
+        if (b->p && !intact(b)) {
+            fprintf(stderr, "fuzz: block of %zu clobbered at op %u\n", b->n, op);
+            bad = 1;
+        } else if (!b->p) {
+            b->n = rnd_size();
+            b->p = (uint8_t *)slab_heap_alloc(&s_heap, b->n);
+            b->tag = (uint8_t)rnd();
+            fill(b);
+        } else if (what == 0) {
+            slab_heap_free(&s_heap, b->p);
+            b->p = NULL;
+        } else {
+            const size_t n = rnd_size();
+            b->p = (uint8_t *)slab_heap_realloc(&s_heap, b->p, n);
+            if (n < b->n) b->n = n;
+            if (!intact(b)) {
+                fprintf(stderr, "fuzz: realloc to %zu lost contents\n", n);
+                bad = 1;
+            }
+            b->n = n;
+            fill(b);
+        }
+        if (b->p && slab_heap_block_size(&s_heap, b->p) < b->n) {
+            fprintf(stderr, "fuzz: %zu bytes in a %zu block\n", b->n, slab_heap_block_size(&s_heap, b->p));
+            bad = 1;
+        }
+        if (b->p && slab_heap_owns(&s_heap, b->p) != (b->n <= SLAB_MAX_SIZE)) {
+            fprintf(stderr, "fuzz: %zu bytes in the wrong heap\n", b->n);
+            bad = 1;
+        }
+    }
+
+    /* Counts must match the live set */
+    uint32_t small = 0, large = 0;
+    size_t used = 0;
+    for (int i = 0; i < LIVE; i++) {
+        if (!live[i].p) continue;
+        if (!intact(&live[i])) bad = 1;
+        used += slab_heap_block_size(&s_heap, live[i].p);
+        if (slab_heap_owns(&s_heap, live[i].p)) small++;
+        else large++;
+    }
+    uint32_t in_use = 0;
+    for (int c = 0; c < SLAB_CLASSES; c++) {
+        const slab_class_stats_t *st = &s_heap.cls[c].st;
+        in_use += st->in_use;
+        if (st->allocs - st->frees != st->in_use) {
+            fprintf(stderr, "fuzz: class %u: %u allocs - %u frees != %u in use\n",
+                    st->size, st->allocs, st->frees, st->in_use);
+            bad = 1;
+        }
+    }
+    if (in_use != small || s_heap.large_in_use != large || s_heap.used_bytes != used) {
+        fprintf(stderr, "fuzz: counted %u small %u large %zu bytes, have %u %u %zu\n",
+                in_use, s_heap.large_in_use, s_heap.used_bytes, small, large, used);
+        bad = 1;
+    }
+
+    for (int i = 0; i < LIVE; i++) {
+        slab_heap_free(&s_heap, live[i].p);
+        live[i].p = NULL;
+    }
+    if (s_heap.used_bytes != 0 || s_heap.large_in_use != 0) {
+        fprintf(stderr, "fuzz: %zu bytes left after freeing everything\n", s_heap.used_bytes);
+        bad = 1;
+    }
+    return bad;
+}
+
+/* A label re-set to text of similar length keeps its block */
+static int check_reuse(void)
+{
+    char *p = (char *)slab_heap_alloc(&s_heap, 9);
+    strcpy(p, "1234.5 W");
+    char *q = (char *)slab_heap_realloc(&s_heap, p, 12);
+    if (q != p || strcmp(q, "1234.5 W") != 0) {
+        fprintf(stderr, "reuse: same-class realloc moved the block\n");
+        return 1;
+    }
+    q = (char *)slab_heap_realloc(&s_heap, q, 100);
+    if (q == p || strcmp(q, "1234.5 W") != 0) {
+        fprintf(stderr, "reuse: growing out of the class kept the block\n");
+        return 1;
+    }
+    slab_heap_free(&s_heap, q);
+    return 0;
+}
+
+/* ---- LVGL-shaped traces ---- */
+#define LABELS  13
+#define TASKS   48
+#define OBJS    400
+
+static void *s_labels[LABELS];
+static void *s_tasks[TASKS * 2];
+static void *s_objs[OBJS * 3];
+
+/* One live-view frame: draw tasks plus their descriptors, label texts
+ * re-set, every 30th frame a layer buffer */
+static void trace_frame(const allocator_t *a, uint32_t f)
+{
+    for (int i = 0; i < LABELS; i++) {
+        const size_t len = 5 + (f * 7 + i * 3) % 8;
+        s_labels[i] = a->realloc(s_labels[i], len + 1);
+        memset(s_labels[i], 'x', len);
+    }
+    for (int i = 0; i < TASKS; i++) {
+        s_tasks[2 * i] = a->alloc(112);
+        s_tasks[2 * i + 1] = a->alloc(24 + (i % 6) * 28);
+    }
+    if (f % 30 == 0) {
+        void *layer = a->alloc(64 * 64 * 2);
+        a->free(layer);
+    }
+    for (int i = 0; i < TASKS * 2; i++) {
+        a->free(s_tasks[i]);
+    }
+}
+
+/* A screen: object, style list and text per widget, torn down out of order */
+static void trace_screen(const allocator_t *a)
+{
+    for (int i = 0; i < OBJS; i++) {
+        s_objs[3 * i] = a->alloc(88);
+        s_objs[3 * i + 1] = a->alloc(16 * (1 + i % 4));
+        s_objs[3 * i + 2] = a->alloc(4 + i % 40);
+    }
+    for (int i = 0; i < OBJS * 3; i++) {
+        const int j = (int)((i * 7919u) % (OBJS * 3));
+        a->free(s_objs[j]);
+    }
+}
+
+static void emit(const char *line)
+{
+    fputs(line, stderr);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 20000;
+    int verbose = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) frames = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-v")) verbose = 1;
+        else {
+            fprintf(stderr, "usage: %s [-r frames] [-v]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    slab_heap_init(&s_heap, &s_backend);
+    if (check_reuse() || check_fuzz()) {
+        return 1;
+    }
+    fprintf(stderr, "fuzz: ok, %u arena(s)\n", s_heap.arenas);
+
+    fprintf(stderr, "%-7s %12s %12s\n", "", "frame ns/op", "screen ns/op");
+    for (size_t k = 0; k < sizeof(s_allocators) / sizeof(s_allocators[0]); k++) {
+        const allocator_t *a = &s_allocators[k];
+        const uint64_t frame_ops = (uint64_t)frames * (LABELS + TASKS * 4) + frames / 30 * 2;
+        const uint32_t screens = frames / 20 + 1;
+
+        slab_heap_reset_stats(&s_heap);
+        uint64_t t0 = now_ns();
+        for (uint32_t f = 0; f < frames; f++) {
+            trace_frame(a, f);
+        }
+        const uint64_t t_frame = now_ns() - t0;
+
+        t0 = now_ns();
+        for (uint32_t i = 0; i < screens; i++) {
+            trace_screen(a);
+        }
+        const uint64_t t_screen = now_ns() - t0;
+
+        for (int i = 0; i < LABELS; i++) {
+            a->free(s_labels[i]);
+            s_labels[i] = NULL;
+        }
+        fprintf(stderr, "%-7s %12.1f %12.1f\n", a->name, (double)t_frame / frame_ops,
+                (double)t_screen / ((uint64_t)screens * OBJS * 6));
+        if (verbose && k == 0) {
+            slab_heap_print(&s_heap, emit);
+        }
+    }
+    return 0;
+}
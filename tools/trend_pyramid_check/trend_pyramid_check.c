@@ -0,0 +1,297 @@
+/*
+ * trend_pyramid_check - check the min/max/mean trend pyramid
+ * (src/trend/trend_pyramid.c) on a Linux host.
+ *
+ *   cc -O2 -o trend_pyramid_check tools/trend_pyramid_check/trend_pyramid_check.c
+ *   ./trend_pyramid_check [-v]
+ *
+ * Three days of synthetic channels at 4 Hz with jittered timestamps and
+ * gaps of seconds, minutes and hours (longer than the 1 s and 10 s rings) are
+ * pushed, with a full copy of the history kept aside. Every few simulated
+ * minutes, windows from 20 s to a week are queried at several column counts;
+ * every column must hold the exact min, max and mean of the samples its
+ * bucket covers, computed from the copy, or be empty where the level has
+ * dropped them. Then a query is timed against aggregating the raw samples of
+ * the same window, which is what scrolling back without the pyramid costs.
+ * -v prints the timing.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/trend/trend_pyramid.c"
+
+#define CH          3
+#define PERIOD_MS   250
+#define DAYS        3
+#define HISTORY     (DAYS * 86400 * (1000 / PERIOD_MS) + 1000)
+#define EMPTY       INT32_MAX
+#define MAX_COLUMNS 250
+
+static uint64_t s_t[HISTORY];
+static int16_t s_v[HISTORY][CH];
+static uint32_t s_n;
+static uint32_t s_rng = 4711;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Triangle wave of the given period and peak-to-peak amplitude */
+static int32_t tri(uint64_t t, uint32_t period, int32_t amp)
+{
+    const uint32_t p = (uint32_t)(t % period), half = period / 2;
+    return (int32_t)((int64_t)(p < half ? p : period - p) * amp / half);
+}
+
+/*
+ * A pressure with a daily cycle and pulsation, a slow temperature, and a
+ * ratio channel whose rare spikes run past int16 to exercise the clamp.
+ */
+static void signal_at(uint64_t t, int32_t *v)
+{
+    v[0] = 900 + tri(t, 86400000u, 400) + tri(t, 590, 60) - 30;
+    v[1] = 300 + tri(t, 7200000u, 120);
+    v[2] = 1000 + (int32_t)(rnd() % 11) - 5;
+    if (rnd() % 5000 == 0) v[2] = (rnd() & 1) ? 40000 : -40000;
+}
+
+static int16_t clamp16(int32_t v)
+{
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+
+/* First sample at or after t */
+static uint32_t lower(uint64_t t)
+{
+    uint32_t lo = 0, hi = s_n;
+
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (s_t[mid] < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * What bucket i of level k should read. A level only holds what has been
+ * folded into it, i.e. the samples before the open bucket of the level below.
+ */
+static void expect(const trend_pyramid_t *p, int k, uint64_t i, uint32_t ch, int32_t *mn, int32_t *mx, int32_t *mean)
+{
+    const trend_level_t *l = &p->level[k];
+    uint64_t end = (i + 1) * l->bucket_ms;
+
+    *mn = *mx = *mean = EMPTY;
+    if (i > l->next || (i < l->next && l->next - i > l->cap)) return;
+    if (k > 0) {
+        const uint64_t horizon = p->level[k - 1].next * p->level[k - 1].bucket_ms;
+        if (horizon < end) end = horizon;
+    }
+
+    int64_t sum = 0;
+    uint32_t n = 0;
+    for (uint32_t j = lower(i * l->bucket_ms); j < s_n && s_t[j] < end; j++) {
+        const int32_t v = s_v[j][ch];
+        if (n == 0 || v < *mn) *mn = v;
+        if (n == 0 || v > *mx) *mx = v;
+        sum += v;
+        n++;
+    }
+    if (n) *mean = mean_of(sum, n);
+}
+
+static int verify(const trend_pyramid_t *p, uint64_t from, uint64_t to, uint32_t columns)
+{
+    static int32_t mn[MAX_COLUMNS], mx[MAX_COLUMNS], mean[MAX_COLUMNS];
+
+    for (uint32_t ch = 0; ch < CH; ch++) {
+        const int k = trend_pyramid_query(p, ch, from, to, columns, EMPTY, mn, mx, mean);
+        if (k < 0) {
+            fprintf(stderr, "query %llu..%llu: no level\n", (unsigned long long)from, (unsigned long long)to);
+            return 1;
+        }
+        const uint32_t b = p->level[k].bucket_ms;
+        if (k < TREND_PYRAMID_LEVELS - 1 && (to - 1) / b - from / b + 1 > columns) {
+            fprintf(stderr, "query %llu..%llu in %u columns: level %d has too many buckets\n",
+                    (unsigned long long)from, (unsigned long long)to, columns, k);
+            return 1;
+        }
+        for (uint32_t c = 0; c < columns; c++) {
+            const uint64_t t = from + (to - from) * c / columns;
+            int32_t emn, emx, emean;
+            expect(p, k, t / b, ch, &emn, &emx, &emean);
+            if (mn[c] != emn || mx[c] != emx || mean[c] != emean) {
+                fprintf(stderr, "ch %u level %d column %u (t %llu): got %d/%d/%d, expected %d/%d/%d\n",
+                        ch, k, c, (unsigned long long)t, mn[c], mx[c], mean[c], emn, emx, emean);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int check_history(trend_pyramid_t *p, void *mem)
+{
+    static const uint32_t spans_s[] = { 20, 240, 3600, 3 * 3600, 12 * 3600, 86400, 3 * 86400, 7 * 86400 };
+    static const uint32_t columns[] = { MAX_COLUMNS, 100, 37 };
+    uint64_t t = 1234567, next_check = t;
+    uint32_t queries = 0, gaps = 0;
+    int used[TREND_PYRAMID_LEVELS] = { 0 };
+
+    trend_pyramid_init(p, CH, mem);
+    const uint64_t end = t + (uint64_t)DAYS * 86400000u;
+
+    while (t < end && s_n < HISTORY) {
+        int32_t v[CH];
+        signal_at(t, v);
+        trend_pyramid_push(p, t, v);
+        s_t[s_n] = t;
+        for (int ch = 0; ch < CH; ch++) s_v[s_n][ch] = clamp16(v[ch]);
+        s_n++;
+
+        /* Jitter, and now and then the producer stops for a while */
+        t += PERIOD_MS - 20 + rnd() % 41;
+        const uint32_t r = rnd() % 200000;
+        if (r < 40) {
+            t += 1000 + rnd() % 60000;
+            gaps++;
+        } else if (r < 44) {
+            t += 1800000 + rnd() % (8 * 3600000u);
+            gaps++;
+        }
+
+        if (t >= next_check) {
+            const uint32_t span = spans_s[rnd() % (sizeof(spans_s) / sizeof(spans_s[0]))];
+            const uint32_t cols = columns[rnd() % (sizeof(columns) / sizeof(columns[0]))];
+            /* Mostly ending now, as the live view does; sometimes scrolled back */
+            uint64_t to = p->last_ms + 1;
+            if (rnd() % 3 == 0) to -= rnd() % (to < 86400000u ? to : 86400000u);
+            const uint64_t from = to > span * 1000ull ? to - span * 1000ull : 0;
+            if (verify(p, from, to, cols)) return 1;
+            used[trend_pyramid_query(p, 0, from, to, cols, EMPTY, NULL, NULL, NULL)]++;
+            queries++;
+            next_check = t + 60000 + rnd() % 300000;
+        }
+    }
+
+    /* Every span once more at the end, over the full history */
+    for (size_t i = 0; i < sizeof(spans_s) / sizeof(spans_s[0]); i++) {
+        const uint64_t to = p->last_ms + 1;
+        const uint64_t from = to > spans_s[i] * 1000ull ? to - spans_s[i] * 1000ull : 0;
+        if (verify(p, from, to, MAX_COLUMNS)) return 1;
+        queries++;
+    }
+
+    fprintf(stderr, "check:      %u samples over %d days, %u gaps, %u queries exact (levels %d/%d/%d/%d)\n",
+            s_n, DAYS, gaps, queries, used[0], used[1], used[2], used[3]);
+    return 0;
+}
+
+/* Scrolling back without the pyramid: aggregate every raw sample in the window */
+static void aggregate_raw(uint64_t from, uint64_t to, uint32_t columns, int32_t *mn, int32_t *mx, int32_t *mean)
+{
+    uint32_t j = lower(from);
+
+    for (uint32_t c = 0; c < columns; c++) {
+        const uint64_t col_end = from + (to - from) * (c + 1) / columns;
+        int32_t lo = EMPTY, hi = EMPTY;
+        int64_t sum = 0;
+        uint32_t n = 0;
+        for (; j < s_n && s_t[j] < col_end; j++) {
+            const int32_t v = s_v[j][0];
+            if (n == 0 || v < lo) lo = v;
+            if (n == 0 || v > hi) hi = v;
+            sum += v;
+            n++;
+        }
+        mn[c] = lo;
+        mx[c] = hi;
+        mean[c] = n ? mean_of(sum, n) : EMPTY;
+    }
+}
+
+static void bench(const trend_pyramid_t *filled, int verbose)
+{
+    static const uint32_t spans_s[] = { 60, 3600, 8 * 3600, 86400, 3 * 86400 };
+    static int32_t mn[MAX_COLUMNS], mx[MAX_COLUMNS], mean[MAX_COLUMNS];
+    void *mem = malloc(trend_pyramid_storage_bytes(CH));
+    trend_pyramid_t p;
+    const uint32_t n = 4000000;
+    volatile int32_t sink = 0;
+
+    trend_pyramid_init(&p, CH, mem);
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        const int32_t v[CH] = { (int32_t)(1000 + (i * 7919u) % 200), 300, 1000 };
+        trend_pyramid_push(&p, (uint64_t)i * PERIOD_MS, v);
+    }
+    const uint64_t t_push = now_ns() - t0;
+
+    if (verbose) {
+        printf("storage:    %zu bytes for %d channels (%zu per channel)\n",
+               trend_pyramid_storage_bytes(CH), CH, trend_pyramid_storage_bytes(1));
+        printf("push:       %.1f ns/sample (%d channels)\n", (double)t_push / n, CH);
+    }
+
+    const uint64_t to = filled->last_ms + 1;
+    for (size_t i = 0; i < sizeof(spans_s) / sizeof(spans_s[0]); i++) {
+        const uint64_t from = to > spans_s[i] * 1000ull ? to - spans_s[i] * 1000ull : 0;
+        const uint32_t reps = 2000;
+        int k = 0;
+
+        t0 = now_ns();
+        for (uint32_t r = 0; r < reps; r++) {
+            k = trend_pyramid_query(filled, 0, from, to, MAX_COLUMNS, EMPTY, mn, mx, mean);
+            sink += mn[r % MAX_COLUMNS];
+        }
+        const uint64_t t_query = now_ns() - t0;
+
+        const uint32_t raw_reps = spans_s[i] > 86400 ? 5 : 50;
+        t0 = now_ns();
+        for (uint32_t r = 0; r < raw_reps; r++) {
+            aggregate_raw(from, to, MAX_COLUMNS, mn, mx, mean);
+            sink += mn[r % MAX_COLUMNS];
+        }
+        const uint64_t t_raw = now_ns() - t0;
+
+        if (verbose) {
+            printf("%6u s:   pyramid %.2f us (level %d), raw %.1f us (%u samples)\n", spans_s[i],
+                   (double)t_query / reps / 1000.0, k, (double)t_raw / raw_reps / 1000.0,
+                   lower(to) - lower(from));
+        }
+    }
+    free(mem);
+    (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+    const int verbose = argc > 1 && !strcmp(argv[1], "-v");
+    trend_pyramid_t p;
+
+    if (argc > 1 && !verbose) {
+        fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+        return 2;
+    }
+    void *mem = malloc(trend_pyramid_storage_bytes(CH));
+    if (check_history(&p, mem)) {
+        return 1;
+    }
+    bench(&p, verbose);
+    free(mem);
+    return 0;
+}
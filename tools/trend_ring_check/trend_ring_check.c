@@ -0,0 +1,213 @@
+/*
+ * trend_ring_check - check the min/max-decimated trend ring
+ * (src/trend/trend_ring.c) on a Linux host.
+ *
+ *   cc -O2 -o trend_ring_check tools/trend_ring_check/trend_ring_check.c
+ *   ./trend_ring_check [-v]
+ *
+ * A pressure-like signal (slow sag, pump pulsation, the odd spike) is pushed
+ * in random bursts with random window changes in between, using the live
+ * view's geometry. After every step each column on screen must hold the exact
+ * min/max of the samples it covers, computed from a full copy of the
+ * history, whether it was built up sample by sample or rebuilt by a window
+ * change. Half the window changes go through the unlocked fold with pushes
+ * landing before and after the fold, as the acquisition task does while the
+ * LVGL task rebuilds; pushes before it overwrite the oldest samples it
+ * reads. Then pushing is timed against re-decimating the whole window per
+ * chart refresh, which is what the column ring avoids. -v prints the timing.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../../src/trend/trend_ring.c"
+
+#define CAP       6000      /* 60 s at 100 Hz, as in ui_trend.cpp */
+#define COLUMNS   250
+#define EMPTY     INT32_MAX
+#define HISTORY   200000
+
+static int16_t s_hist[HISTORY];
+static uint32_t s_rng = 4711;
+
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1103515245u + 12345u;
+    return s_rng >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Triangle wave of the given period and peak-to-peak amplitude */
+static int32_t tri(uint32_t n, uint32_t period, int32_t amp)
+{
+    const uint32_t p = n % period, half = period / 2;
+    return (int32_t)((p < half ? p : period - p) * (uint32_t)amp / half);
+}
+
+/* 100 Hz samples: a 30 s sag of 150 PSI, 1.7 Hz pulsation of 40, spikes */
+static int16_t signal_at(uint32_t n)
+{
+    int32_t v = 1100 - tri(n, 3000, 150) + tri(n, 59, 40);
+    if (rnd() % 997 == 0) v += (int32_t)(rnd() % 400) - 200;
+    return (int16_t)v;
+}
+
+/* Every column on screen against the history */
+static int verify(const trend_ring_t *r, const char *when)
+{
+    const uint64_t per = r->per_col;
+
+    for (uint32_t k = 0; k < r->columns; k++) {
+        const uint32_t slot = (uint32_t)((r->slot + r->columns - k) % r->columns);
+        int32_t mn = EMPTY, mx = EMPTY;
+
+        if (r->col >= k) {
+            const uint64_t c = r->col - k;
+            const uint64_t end = (c + 1) * per < r->total ? (c + 1) * per : r->total;
+            for (uint64_t n = c * per; n < end; n++) {
+                if (mn == EMPTY || s_hist[n] < mn) mn = s_hist[n];
+                if (mx == EMPTY || s_hist[n] > mx) mx = s_hist[n];
+            }
+        }
+        if (r->col_min[slot] != mn || r->col_max[slot] != mx) {
+            fprintf(stderr, "%s: total %llu window %u column -%u: got %d..%d, expected %d..%d\n",
+                    when, (unsigned long long)r->total, trend_ring_window(r), k,
+                    r->col_min[slot], r->col_max[slot], mn, mx);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void push_burst(trend_ring_t *r, uint32_t burst)
+{
+    for (uint32_t i = 0; i < burst; i++) {
+        s_hist[r->total] = signal_at((uint32_t)r->total);
+        trend_ring_push(r, s_hist[r->total]);
+    }
+}
+
+static int check_columns(void)
+{
+    static const uint32_t windows[] = { 1, 250, 500, 1000, 3000, 6000, 777, 9000 };
+    static int32_t scratch[2 * COLUMNS];
+    void *mem = malloc(trend_ring_storage_bytes(CAP, COLUMNS));
+    trend_ring_t r;
+    trend_ring_fold_t f;
+    uint32_t steps = 0;
+
+    trend_ring_init(&r, CAP, COLUMNS, EMPTY, mem);
+    if (verify(&r, "init")) return 1;
+
+    while (r.total < HISTORY - 1000) {
+        push_burst(&r, rnd() % 500);
+        if (verify(&r, "push")) return 1;
+
+        if (rnd() % 3 == 0) {
+            const uint32_t want = windows[rnd() % (sizeof(windows) / sizeof(windows[0]))];
+            uint32_t got;
+            if (rnd() % 2) {
+                got = trend_ring_set_window(&r, want);
+            } else {
+                got = trend_ring_fold_begin(&r, want, scratch, &f);
+                push_burst(&r, rnd() % 3 ? rnd() % 8 : rnd() % 300);
+                trend_ring_fold(&r, &f);
+                push_burst(&r, rnd() % 8);
+                trend_ring_fold_end(&r, &f);
+            }
+            if (got > CAP || got % COLUMNS || (want <= CAP && got < want)) {
+                fprintf(stderr, "window %u: got %u\n", want, got);
+                return 1;
+            }
+            if (verify(&r, "window")) return 1;
+        }
+        steps++;
+    }
+    free(mem);
+    fprintf(stderr, "check:      %u steps, %llu samples, columns exact after pushes and window changes, locked and unlocked\n",
+            steps, (unsigned long long)r.total);
+    return 0;
+}
+
+/* What a chart without the column ring would do on every refresh */
+static void decimate_window(const trend_ring_t *r, int32_t *mn, int32_t *mx)
+{
+    const uint32_t per = r->per_col, w = trend_ring_window(r);
+    uint32_t idx = (r->head + r->cap - w) % r->cap;
+
+    for (uint32_t c = 0; c < r->columns; c++) {
+        int32_t lo = INT32_MAX, hi = INT32_MIN;
+        for (uint32_t i = 0; i < per; i++) {
+            const int32_t v = r->samples[idx];
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+            idx = (idx + 1 == r->cap) ? 0 : idx + 1;
+        }
+        mn[c] = lo;
+        mx[c] = hi;
+    }
+}
+
+static void bench(int verbose)
+{
+    void *mem = malloc(trend_ring_storage_bytes(CAP, COLUMNS));
+    static int32_t mn[COLUMNS], mx[COLUMNS];
+    trend_ring_t r;
+    const uint32_t n = 2000000, refreshes = 20000;
+
+    trend_ring_init(&r, CAP, COLUMNS, EMPTY, mem);
+    trend_ring_set_window(&r, CAP);
+
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        trend_ring_push(&r, (int16_t)(1000 + (i * 7919u) % 200));
+    }
+    const uint64_t t_push = now_ns() - t0;
+
+    t0 = now_ns();
+    int32_t lo = 0, hi = 0;
+    volatile int32_t sink = 0;
+    for (uint32_t i = 0; i < refreshes; i++) {
+        trend_ring_range(&r, &lo, &hi);
+        sink += hi - lo;
+    }
+    const uint64_t t_range = now_ns() - t0;
+
+    t0 = now_ns();
+    for (uint32_t i = 0; i < refreshes; i++) {
+        decimate_window(&r, mn, mx);
+    }
+    const uint64_t t_full = now_ns() - t0;
+
+    if (verbose) {
+        printf("push:       %.1f ns/sample\n", (double)t_push / n);
+        printf("refresh:    %.2f us (range over %u columns)\n", (double)t_range / refreshes / 1000.0, COLUMNS);
+        printf("full pass:  %.2f us (re-decimating %u samples)\n", (double)t_full / refreshes / 1000.0, CAP);
+    }
+    free(mem);
+    (void)sink;
+}
+
+int main(int argc, char **argv)
+{
+    const int verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+    if (argc > 1 && !verbose) {
+        fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+        return 2;
+    }
+    if (check_columns()) {
+        return 1;
+    }
+    bench(verbose);
+    return 0;
+}